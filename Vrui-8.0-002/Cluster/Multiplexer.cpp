@@ -29,6 +29,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -279,6 +280,76 @@ Packet* Multiplexer::allocatePacket(void)
 	return new Packet;
 	}
 
+unsigned int Multiplexer::receiveDatagrams(void* const buffers[],ssize_t datagramSizes[],unsigned int numBuffers,bool wait)
+	{
+	#ifdef __linux__
+	
+	/* Receive all waiting datagrams up to the number of buffers with a single system call: */
+	struct iovec iovecs[maxBatchSize];
+	struct mmsghdr headers[maxBatchSize];
+	memset(headers,0,numBuffers*sizeof(struct mmsghdr));
+	for(unsigned int i=0;i<numBuffers;++i)
+		{
+		iovecs[i].iov_base=buffers[i];
+		iovecs[i].iov_len=Packet::maxRawPacketSize;
+		headers[i].msg_hdr.msg_iov=&iovecs[i];
+		headers[i].msg_hdr.msg_iovlen=1;
+		}
+	int numReceived=recvmmsg(socketFd,headers,numBuffers,wait?MSG_WAITFORONE:MSG_DONTWAIT,0);
+	if(numReceived<=0)
+		return 0;
+	
+	/* Return the sizes of the received datagrams: */
+	for(int i=0;i<numReceived;++i)
+		datagramSizes[i]=ssize_t(headers[i].msg_len);
+	return (unsigned int)numReceived;
+	
+	#else
+	
+	/* Receive a single datagram: */
+	datagramSizes[0]=recv(socketFd,buffers[0],Packet::maxRawPacketSize,wait?0:MSG_DONTWAIT);
+	return datagramSizes[0]>=0?1:0;
+	
+	#endif
+	}
+
+void Multiplexer::sendDatagrams(const void* const datagrams[],const size_t datagramSizes[],unsigned int numDatagrams)
+	{
+	#ifdef __linux__
+	
+	/* Prepare message headers for all datagrams: */
+	struct iovec iovecs[maxBatchSize];
+	struct mmsghdr headers[maxBatchSize];
+	memset(headers,0,numDatagrams*sizeof(struct mmsghdr));
+	for(unsigned int i=0;i<numDatagrams;++i)
+		{
+		iovecs[i].iov_base=const_cast<void*>(datagrams[i]);
+		iovecs[i].iov_len=datagramSizes[i];
+		headers[i].msg_hdr.msg_name=otherAddress;
+		headers[i].msg_hdr.msg_namelen=sizeof(sockaddr_in);
+		headers[i].msg_hdr.msg_iov=&iovecs[i];
+		headers[i].msg_hdr.msg_iovlen=1;
+		}
+	
+	/* Send the datagrams with as few system calls as possible; drop the rest on error like individual sendto calls would: */
+	unsigned int numSent=0;
+	while(numSent<numDatagrams)
+		{
+		int result=sendmmsg(socketFd,headers+numSent,numDatagrams-numSent,0);
+		if(result<=0)
+			break;
+		numSent+=(unsigned int)result;
+		}
+	
+	#else
+	
+	/* Send the datagrams one at a time: */
+	for(unsigned int i=0;i<numDatagrams;++i)
+		sendto(socketFd,datagrams[i],datagramSizes[i],0,(const sockaddr*)otherAddress,sizeof(sockaddr_in));
+	
+	#endif
+	}
+
 void Multiplexer::processAcknowledgment(Multiplexer::LockedPipe& pipeState,int slaveIndex,unsigned int streamPos)
 	{
 	/* Check if the reported stream position points into the packet queue: */
@@ -369,10 +440,10 @@ void* Multiplexer::packetHandlingThreadMaster(void)
 	while(numConnectedSlaves<numSlaves)
 		{
 		/* Wait for a connection initialization packet: */
-		ssize_t numBytesReceived=recv(socketFd,messageBuffer,Packet::maxRawPacketSize,0);
+		ssize_t numBytesReceived=recv(socketFd,messageBuffers,Packet::maxRawPacketSize,0);
 		if(numBytesReceived==sizeof(Message))
 			{
-			Message* msg=static_cast<Message*>(messageBuffer);
+			Message* msg=reinterpret_cast<Message*>(messageBuffers);
 			if(msg->nodeIndex&0x80000000U) // Check if the message is from a slave
 				{
 				unsigned int slaveIndex=(msg->nodeIndex&0x7fffffffU)-1;
@@ -402,11 +473,30 @@ void* Multiplexer::packetHandlingThreadMaster(void)
 	connectionCond.broadcast();
 	}
 	
+	/* Set up the batch of message buffers: */
+	void* batchBuffers[maxBatchSize];
+	for(unsigned int i=0;i<maxBatchSize;++i)
+		batchBuffers[i]=messageBuffers+i*Packet::maxRawPacketSize;
+	ssize_t batchSizes[maxBatchSize];
+	unsigned int numBatchMessages=0;
+	unsigned int nextBatchMessage=0;
+	
 	/* Handle messages from the slaves: */
 	while(true)
 		{
-		/* Wait for a message from any slave: */
-		ssize_t numBytesReceived=recv(socketFd,messageBuffer,Packet::maxRawPacketSize,0);
+		/* Wait for a batch of messages from any slaves if the current batch has been handled: */
+		if(nextBatchMessage==numBatchMessages)
+			{
+			numBatchMessages=receiveDatagrams(batchBuffers,batchSizes,maxBatchSize,true);
+			nextBatchMessage=0;
+			if(numBatchMessages==0)
+				continue;
+			}
+		
+		/* Handle the next message from the current batch: */
+		void* messageBuffer=batchBuffers[nextBatchMessage];
+		ssize_t numBytesReceived=batchSizes[nextBatchMessage];
+		++nextBatchMessage;
 		if(numBytesReceived>0&&size_t(numBytesReceived)>=sizeof(Message))
 			{
 			/* Check that the message is not the echo of a server message: */
@@ -633,16 +723,27 @@ void* Multiplexer::packetHandlingThreadMaster(void)
 										Misc::throwStdErr("Cluster::Multiplexer: Node %u: Fatal packet loss detected at stream position %u",msgNodeIndex,msg->streamPos);
 									
 									{
-									/* Resend all recent packets in order: */
+									/* Resend all recent packets in order, in batches: */
 									// SocketMutex::Lock socketLock(socketMutex);
+									const void* datagrams[maxBatchSize];
+									size_t datagramSizes[maxBatchSize];
+									unsigned int numDatagrams=0;
 									for(;packet!=0;packet=packet->succ)
 										{
-										sendto(socketFd,&packet->pipeId,packet->packetSize+2*sizeof(unsigned int),0,(const sockaddr*)otherAddress,sizeof(sockaddr_in));
+										datagrams[numDatagrams]=&packet->pipeId;
+										datagramSizes[numDatagrams]=packet->packetSize+2*sizeof(unsigned int);
+										if(++numDatagrams==maxBatchSize)
+											{
+											sendDatagrams(datagrams,datagramSizes,numDatagrams);
+											numDatagrams=0;
+											}
 										#if CLUSTER_CONFIG_DEBUG_MULTIPLEXER
 										++pipeState->numResentPackets;
 										pipeState->numResentBytes+=packet->packetSize;
 										#endif
 										}
+									if(numDatagrams>0)
+										sendDatagrams(datagrams,datagramSizes,numDatagrams);
 									}
 									}
 								}
@@ -803,49 +904,64 @@ void* Multiplexer::packetHandlingThreadSlave(void)
 	
 	unsigned int sendAckIn=nodeIndex-1;
 	
+	/* Set up the batch of receive packets: */
+	ssize_t batchSizes[maxBatchSize];
+	unsigned int numBatchPackets=0;
+	unsigned int nextBatchPacket=0;
+	
 	/* Handle messages from the master: */
 	while(true)
 		{
-		/* Wait for the next packet, and request a ping packet if no data arrives during the timeout: */
-		bool havePacket=false;
-		for(int i=0;i<maxPingRequests&&!havePacket;++i)
+		if(nextBatchPacket==numBatchPackets)
 			{
-			/* Wait until the "silence period" is over: */
-			fd_set readFdSet;
-			FD_ZERO(&readFdSet);
-			FD_SET(socketFd,&readFdSet);
-			struct timeval timeout=pingTimeout;
-			if(select(socketFd+1,&readFdSet,0,0,&timeout)>=0&&FD_ISSET(socketFd,&readFdSet))
-				havePacket=true;
-			else
+			/* Wait for the next packet, and request a ping packet if no data arrives during the timeout: */
+			bool havePacket=false;
+			for(int i=0;i<maxPingRequests&&!havePacket;++i)
 				{
-				/* Send a ping request packet: */
-				Message msg(sendNodeIndex,Message::PING);
+				/* Wait until the "silence period" is over: */
+				fd_set readFdSet;
+				FD_ZERO(&readFdSet);
+				FD_SET(socketFd,&readFdSet);
+				struct timeval timeout=pingTimeout;
+				if(select(socketFd+1,&readFdSet,0,0,&timeout)>=0&&FD_ISSET(socketFd,&readFdSet))
+					havePacket=true;
+				else
+					{
+					/* Send a ping request packet: */
+					Message msg(sendNodeIndex,Message::PING);
+					{
+					// SocketMutex::Lock socketLock(socketMutex);
+					for(int i=0;i<slaveMessageBurstSize;++i)
+						sendto(socketFd,&msg,sizeof(Message),0,(const sockaddr*)otherAddress,sizeof(struct sockaddr_in));
+					}
+					}
+				}
+			if(!havePacket)
 				{
-				// SocketMutex::Lock socketLock(socketMutex);
-				for(int i=0;i<slaveMessageBurstSize;++i)
-					sendto(socketFd,&msg,sizeof(Message),0,(const sockaddr*)otherAddress,sizeof(struct sockaddr_in));
+				/* Signal an error: */
+				Misc::throwStdErr("Cluster::Multiplexer: Node %u: Communication error",nodeIndex);
 				}
+			
+			/* Read all waiting packets up to the batch size: */
+			void* batchBuffers[maxBatchSize];
+			for(unsigned int i=0;i<maxBatchSize;++i)
+				batchBuffers[i]=&slaveThreadPackets[i]->pipeId;
+			numBatchPackets=receiveDatagrams(batchBuffers,batchSizes,maxBatchSize,false);
+			nextBatchPacket=0;
+			if(numBatchPackets==0)
+				{
+				#if CLUSTER_CONFIG_DEBUG_MULTIPLEXER
+				std::cerr<<"Node "<<nodeIndex<<": Error "<<errno<<" on receive"<<std::endl;
+				#endif
+				continue;
 				}
 			}
-		if(!havePacket)
-			{
-			/* Signal an error: */
-			Misc::throwStdErr("Cluster::Multiplexer: Node %u: Communication error",nodeIndex);
-			}
 		
-		/* Read the waiting packet: */
-		ssize_t numBytesReceived=recv(socketFd,&slaveThreadPacket->pipeId,Packet::maxRawPacketSize,0);
-		if(numBytesReceived<0)
-			{
-			/* Try to recover from this error: */
-			#if CLUSTER_CONFIG_DEBUG_MULTIPLEXER
-			std::cerr<<"Node "<<nodeIndex<<": Error "<<errno<<" on receive, slaveThreadPacket="<<slaveThreadPacket<<std::endl;
-			#endif
-			delete slaveThreadPacket;
-			slaveThreadPacket=newPacket();
-			}
-		else if(size_t(numBytesReceived)>=2*sizeof(unsigned int))
+		/* Handle the next packet from the current batch; packets appended to a delivery queue are replaced in the batch: */
+		Packet*& slaveThreadPacket=slaveThreadPackets[nextBatchPacket];
+		ssize_t numBytesReceived=batchSizes[nextBatchPacket];
+		++nextBatchPacket;
+		if(size_t(numBytesReceived)>=2*sizeof(unsigned int))
 			{
 			slaveThreadPacket->packetSize=size_t(numBytesReceived-2*sizeof(unsigned int));
 			
@@ -1058,8 +1174,7 @@ Multiplexer::Multiplexer(unsigned int sNumSlaves,unsigned int sNodeIndex,std::st
 	 newPipes(17),
 	 lastPipeId(0),
 	 pipeStateTable(17),
-	 messageBuffer(0),
-	 slaveThreadPacket(0),
+	 messageBuffers(0),
 	 masterMessageBurstSize(1),slaveMessageBurstSize(1),
 	 connectionWaitTimeout(0.5),
 	 pingTimeout(10.0),maxPingRequests(3),
@@ -1068,6 +1183,9 @@ Multiplexer::Multiplexer(unsigned int sNumSlaves,unsigned int sNodeIndex,std::st
 	 sendBufferSize(20),
 	 packetPoolHead(0)
 	{
+	for(unsigned int i=0;i<maxBatchSize;++i)
+		slaveThreadPackets[i]=0;
+	
 	/* Lookup master's IP address: */
 	struct hostent* masterEntry=gethostbyname(masterHostName.c_str());
 	if(masterEntry==0)
@@ -1163,15 +1281,24 @@ Multiplexer::Multiplexer(unsigned int sNumSlaves,unsigned int sNodeIndex,std::st
 		otherAddress->sin_addr.s_addr=htonl(masterNetAddress.s_addr);
 		}
 	
+	/* Pre-fill the packet pool to cover the send queue of one pipe plus one receive batch: */
+	for(unsigned int i=0;i<sendBufferSize+maxBatchSize;++i)
+		{
+		Packet* packet=allocatePacket();
+		packet->succ=packetPoolHead;
+		packetPoolHead=packet;
+		}
+	
 	/* Create the packet handling thread: */
 	if(nodeIndex==0)
 		{
-		messageBuffer=new unsigned char[Packet::maxRawPacketSize];
+		messageBuffers=new unsigned char[maxBatchSize*Packet::maxRawPacketSize];
 		packetHandlingThread.start(this,&Multiplexer::packetHandlingThreadMaster);
 		}
 	else
 		{
-		slaveThreadPacket=newPacket();
+		for(unsigned int i=0;i<maxBatchSize;++i)
+			slaveThreadPackets[i]=newPacket();
 		packetHandlingThread.start(this,&Multiplexer::packetHandlingThreadSlave);
 		}
 	}
@@ -1182,9 +1309,10 @@ Multiplexer::~Multiplexer(void)
 	packetHandlingThread.cancel();
 	packetHandlingThread.join();
 	
-	/* Delete the packet handling thread's receive packet: */
-	delete slaveThreadPacket;
-	delete[] static_cast<unsigned char*>(messageBuffer);
+	/* Delete the packet handling thread's receive packets and buffers: */
+	for(unsigned int i=0;i<maxBatchSize;++i)
+		delete slaveThreadPackets[i];
+	delete[] messageBuffers;
 	
 	/* Close all leftover pipes: */
 	for(PipeHasher::Iterator psIt=pipeStateTable.begin();psIt!=pipeStateTable.end();++psIt)
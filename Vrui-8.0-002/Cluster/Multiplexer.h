@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef CLUSTER_MULTIPLEXER_INCLUDED
 #define CLUSTER_MULTIPLEXER_INCLUDED
 
+#include <sys/types.h>
 #include <string>
 #include <Misc/HashTable.h>
 #include <Misc/Time.h>
@@ -175,6 +176,8 @@ class Multiplexer
 	
 	typedef Threads::Spinlock SocketMutex; // Type of mutex to serialize write access to the UDP socket
 	
+	static const unsigned int maxBatchSize=32; // Maximum number of datagrams received or re-sent by the packet handling thread in a single system call
+	
 	/* Elements: */
 	private:
 	unsigned int numSlaves; // Number of slaves in the multicast group
@@ -189,9 +192,9 @@ class Multiplexer
 	NewPipeHasher newPipes; // Hash table to map from thread IDs to pipe states not completely opened yet
 	unsigned int lastPipeId; // ID of the most-recently created pipe
 	PipeHasher pipeStateTable; // Hash table to map from pipe IDs to pipe state table entries
-	void* messageBuffer; // A buffer to receive message packets on the master node
+	unsigned char* messageBuffers; // A batch of buffers to receive message packets on the master node
 	Threads::Thread packetHandlingThread; // Packet handling thread
-	Packet* slaveThreadPacket; // Pointer to the one packet always held by the packet handling thread on slave nodes
+	Packet* slaveThreadPackets[maxBatchSize]; // Batch of packets always held by the packet handling thread on slave nodes to receive stream packets
 	int masterMessageBurstSize; // Number of server messages sent in a single burst
 	int slaveMessageBurstSize; // Number of client messages sent in a single burst
 	Misc::Time connectionWaitTimeout; // Timeout between connection messages from the slaves
@@ -205,6 +208,8 @@ class Multiplexer
 	
 	/* Private methods: */
 	Packet* allocatePacket(void);
+	unsigned int receiveDatagrams(void* const buffers[],ssize_t datagramSizes[],unsigned int numBuffers,bool wait); // Receives up to the given number (at most maxBatchSize) of datagrams into the given buffers of maximum raw packet size; blocks until the first datagram arrives if wait is true; returns the number of received datagrams
+	void sendDatagrams(const void* const datagrams[],const size_t datagramSizes[],unsigned int numDatagrams); // Sends the given number (at most maxBatchSize) of datagrams to the other end of the multicast connection
 	void processAcknowledgment(LockedPipe& pipeState,int slaveIndex,unsigned int streamPos); // Processes an acknowlegment (positive or implied-positive) from a slave
 	void* packetHandlingThreadMaster(void); // Packet handling thread method for the master
 	void* packetHandlingThreadSlave(void); // Packet handling thread method for the slaves
@@ -20,7 +20,13 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "ImageViewer.h"
 
 #include <string.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <string>
 #include <stdexcept>
+#include <Misc/SizedTypes.h>
+#include <Misc/ThrowStdErr.h>
 #include <Misc/MessageLogger.h>
 #include <Math/Math.h>
 #include <Math/Constants.h>
@@ -35,6 +41,11 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include <Images/RGBImage.h>
 #include <Images/ReadImageFile.h>
 #include <Images/WriteImageFile.h>
+#include <Images/GetImageFileSize.h>
+#include <Images/TilePyramid.h>
+#include <Images/CreateTilePyramid.h>
+#include <Images/TilePyramidRenderer.h>
+#include <Cluster/MulticastPipe.h>
 #include <Vrui/Vrui.h>
 #include <Vrui/ToolManager.h>
 
@@ -818,18 +829,63 @@ ImageViewer::Color ImageViewer::getPixel(unsigned int x,unsigned int y) const
 		}
 	}
 
+void ImageViewer::tilesLoadedCallback(const Images::TilePyramidRenderer& renderer)
+	{
+	/* Redraw the image to show the new tiles: */
+	Vrui::requestUpdate();
+	}
+
 ImageViewer::ImageViewer(int& argc,char**& argv)
-	:Vrui::Application(argc,argv)
+	:Vrui::Application(argc,argv),
+	 image(0),pyramid(0),pyramidRenderer(0)
 	{
 	/* Parse the command line: */
 	const char* imageFileName=0;
 	bool printInfo=false;
+	bool tiled=false;
+	unsigned int tileSize=256;
+	size_t textureMemorySize=256;
+	size_t cacheMemorySize=512;
+	const char* pyramidFileName=0;
 	for(int i=1;i<argc;++i)
 		{
 		if(argv[i][0]=='-')
 			{
 			if(strcasecmp(argv[i]+1,"p")==0)
 				printInfo=true;
+			else if(strcasecmp(argv[i]+1,"tiled")==0)
+				tiled=true;
+			else if(strcasecmp(argv[i]+1,"tileSize")==0)
+				{
+				if(i+1<argc)
+					tileSize=atoi(argv[++i]);
+				else
+					Misc::userError("ImageViewer: Ignoring dangling -tileSize option");
+				}
+			else if(strcasecmp(argv[i]+1,"textureMemory")==0)
+				{
+				if(i+1<argc)
+					textureMemorySize=atoi(argv[++i]);
+				else
+					Misc::userError("ImageViewer: Ignoring dangling -textureMemory option");
+				}
+			else if(strcasecmp(argv[i]+1,"cacheMemory")==0)
+				{
+				if(i+1<argc)
+					cacheMemorySize=atoi(argv[++i]);
+				else
+					Misc::userError("ImageViewer: Ignoring dangling -cacheMemory option");
+				}
+			else if(strcasecmp(argv[i]+1,"pyramid")==0)
+				{
+				if(i+1<argc)
+					{
+					pyramidFileName=argv[++i];
+					tiled=true;
+					}
+				else
+					Misc::userError("ImageViewer: Ignoring dangling -pyramid option");
+				}
 			}
 		else if(imageFileName==0)
 			imageFileName=argv[i];
@@ -837,6 +893,83 @@ ImageViewer::ImageViewer(int& argc,char**& argv)
 	if(imageFileName==0)
 		throw std::runtime_error("ImageViewer: No image file name provided");
 	
+	if(!tiled)
+		{
+		/* Display images that would not fit into a single texture from a tile pyramid: */
+		try
+			{
+			unsigned int imageSize[2];
+			Images::getImageFileSize(imageFileName,imageSize[0],imageSize[1]);
+			tiled=imageSize[0]>16384U||imageSize[1]>16384U;
+			}
+		catch(const std::runtime_error&)
+			{
+			/* Let the image reader handle the image file */
+			}
+		}
+	
+	if(tiled)
+		{
+		/* In a cluster, only the master node creates the tile pyramid file on the shared file system while the slave nodes wait: */
+		Cluster::MulticastPipe* pipe=Vrui::openPipe();
+		std::string pyramidName=pyramidFileName!=0?pyramidFileName:std::string(imageFileName)+".pyramid";
+		if(pipe==0||pipe->isMaster())
+			{
+			/* Create the tile pyramid file if it does not exist or is older than the image file: */
+			try
+				{
+				struct stat imageStat,pyramidStat;
+				if(stat(pyramidName.c_str(),&pyramidStat)!=0||(stat(imageFileName,&imageStat)==0&&pyramidStat.st_mtime<imageStat.st_mtime))
+					{
+					Misc::formattedUserNote("ImageViewer: Creating tile pyramid %s from image %s",pyramidName.c_str(),imageFileName);
+					Images::createTilePyramid(imageFileName,pyramidName.c_str(),tileSize);
+					}
+				}
+			catch(...)
+				{
+				/* Tell the slave nodes that the tile pyramid could not be created: */
+				if(pipe!=0)
+					{
+					pipe->write<Misc::UInt8>(0);
+					pipe->flush();
+					delete pipe;
+					}
+				throw;
+				}
+			
+			/* Tell the slave nodes that the tile pyramid is ready: */
+			if(pipe!=0)
+				{
+				pipe->write<Misc::UInt8>(1);
+				pipe->flush();
+				}
+			}
+		else
+			{
+			/* Wait until the master node has created the tile pyramid: */
+			if(pipe->read<Misc::UInt8>()==0)
+				{
+				delete pipe;
+				Misc::throwStdErr("ImageViewer: Master node could not create tile pyramid %s",pyramidName.c_str());
+				}
+			}
+		delete pipe;
+		
+		/* Open the tile pyramid and create a renderer for it: */
+		pyramid=new Images::TilePyramid(pyramidName.c_str());
+		pyramidRenderer=new Images::TilePyramidRenderer(*pyramid,textureMemorySize*1024*1024,cacheMemorySize*1024*1024);
+		pyramidRenderer->setRedrawCallback(Misc::createFunctionCall(&ImageViewer::tilesLoadedCallback));
+		
+		if(printInfo)
+			{
+			/* Display image size and format: */
+			Misc::formattedUserNote("Image: %s\nSize: %u x %u pixels\nFormat: %u %s of %u %s%s\nComponent type: %s\nTile pyramid: %s, %u levels of %u x %u pixel tiles",imageFileName,pyramid->getSize(0),pyramid->getSize(1),pyramid->getNumChannels(),pyramid->getNumChannels()!=1?"channels":"channel",(unsigned int)(Images::TilePyramid::getChannelSize(pyramid->getScalarType())),Images::TilePyramid::getChannelSize(pyramid->getScalarType())!=1?"bytes":"byte",pyramid->getNumChannels()!=1?" each":"",pyramid->getScalarType()==GL_UNSIGNED_SHORT?"unsigned 16-bit integer":"unsigned 8-bit integer",pyramidName.c_str(),pyramid->getNumLevels(),pyramid->getTileSize(),pyramid->getTileSize());
+			}
+		
+		/* Pixel-level tools need the image in memory: */
+		return;
+		}
+	
 	/* Load the image into the texture set: */
 	Images::BaseImage loadImage=Images::readGenericImageFile(imageFileName);
 	Images::TextureSet::Texture& tex=textures.addTexture(loadImage,GL_TEXTURE_2D,loadImage.getInternalFormat(),0U);
@@ -899,6 +1032,8 @@ ImageViewer::ImageViewer(int& argc,char**& argv)
 
 ImageViewer::~ImageViewer(void)
 	{
+	delete pyramidRenderer;
+	delete pyramid;
 	}
 
 void ImageViewer::display(GLContextData& contextData) const
@@ -908,31 +1043,44 @@ void ImageViewer::display(GLContextData& contextData) const
 	glEnable(GL_TEXTURE_2D);
 	glTexEnvi(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_REPLACE);
 	
-	/* Get the texture set's GL state: */
-	Images::TextureSet::GLState* texGLState=textures.getGLState(contextData);
-	
-	/* Bind the texture object: */
-	const Images::TextureSet::GLState::Texture& tex=texGLState->bindTexture(0U);
-	const Images::BaseImage& image=tex.getImage();
-	
-	/* Query the range of texture coordinates: */
-	const GLfloat* texMin=tex.getTexCoordMin();
-	const GLfloat* texMax=tex.getTexCoordMax();
-	
-	/* Draw the image: */
-	glBegin(GL_QUADS);
-	glTexCoord2f(texMin[0],texMin[1]);
-	glVertex2i(0,0);
-	glTexCoord2f(texMax[0],texMin[1]);
-	glVertex2i(image.getSize(0),0);
-	glTexCoord2f(texMax[0],texMax[1]);
-	glVertex2i(image.getSize(0),image.getSize(1));
-	glTexCoord2f(texMin[0],texMax[1]);
-	glVertex2i(0,image.getSize(1));
-	glEnd();
-	
-	/* Protect the texture object: */
-	glBindTexture(GL_TEXTURE_2D,0);
+	unsigned int size[2];
+	if(pyramidRenderer!=0)
+		{
+		/* Draw the image's visible tiles: */
+		pyramidRenderer->glRenderAction(contextData);
+		for(int i=0;i<2;++i)
+			size[i]=pyramid->getSize(i);
+		}
+	else
+		{
+		/* Get the texture set's GL state: */
+		Images::TextureSet::GLState* texGLState=textures.getGLState(contextData);
+		
+		/* Bind the texture object: */
+		const Images::TextureSet::GLState::Texture& tex=texGLState->bindTexture(0U);
+		const Images::BaseImage& image=tex.getImage();
+		for(int i=0;i<2;++i)
+			size[i]=image.getSize(i);
+		
+		/* Query the range of texture coordinates: */
+		const GLfloat* texMin=tex.getTexCoordMin();
+		const GLfloat* texMax=tex.getTexCoordMax();
+		
+		/* Draw the image: */
+		glBegin(GL_QUADS);
+		glTexCoord2f(texMin[0],texMin[1]);
+		glVertex2i(0,0);
+		glTexCoord2f(texMax[0],texMin[1]);
+		glVertex2i(size[0],0);
+		glTexCoord2f(texMax[0],texMax[1]);
+		glVertex2i(size[0],size[1]);
+		glTexCoord2f(texMin[0],texMax[1]);
+		glVertex2i(0,size[1]);
+		glEnd();
+		
+		/* Protect the texture object: */
+		glBindTexture(GL_TEXTURE_2D,0);
+		}
 	
 	/* Draw the image's backside: */
 	glDisable(GL_TEXTURE_2D);
@@ -941,9 +1089,9 @@ void ImageViewer::display(GLContextData& contextData) const
 	glBegin(GL_QUADS);
 	glNormal3f(0.0f,0.0f,-1.0f);
 	glVertex2i(0,0);
-	glVertex2i(0,image.getSize(1));
-	glVertex2i(image.getSize(0),image.getSize(1));
-	glVertex2i(image.getSize(0),0);
+	glVertex2i(0,size[1]);
+	glVertex2i(size[0],size[1]);
+	glVertex2i(size[0],0);
 	glEnd();
 	
 	/* Restore OpenGL state: */
@@ -952,12 +1100,21 @@ void ImageViewer::display(GLContextData& contextData) const
 
 void ImageViewer::resetNavigation(void)
 	{
-	/* Access the image: */
-	const Images::BaseImage& image=textures.getTexture(0U).getImage();
+	/* Access the image's size: */
+	Vrui::Scalar w,h;
+	if(pyramid!=0)
+		{
+		w=Vrui::Scalar(pyramid->getSize(0));
+		h=Vrui::Scalar(pyramid->getSize(1));
+		}
+	else
+		{
+		const Images::BaseImage& image=textures.getTexture(0U).getImage();
+		w=Vrui::Scalar(image.getSize(0));
+		h=Vrui::Scalar(image.getSize(1));
+		}
 	
 	/* Reset the Vrui navigation transformation: */
-	Vrui::Scalar w(image.getSize(0));
-	Vrui::Scalar h(image.getSize(1));
 	Vrui::Point center(Math::div2(w),Math::div2(h),Vrui::Scalar(0.05));
 	Vrui::Scalar size=Math::sqrt(Math::sqr(w)+Math::sqr(h));
 	Vrui::setNavigationTransformation(center,size,Vrui::Vector(0,1,0));
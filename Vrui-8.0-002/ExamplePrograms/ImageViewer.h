@@ -29,6 +29,12 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include <Vrui/Tool.h>
 #include <Vrui/GenericToolFactory.h>
 
+/* Forward declarations: */
+namespace Images {
+class TilePyramid;
+class TilePyramidRenderer;
+}
+
 class ImageViewer:public Vrui::Application
 	{
 	/* Embedded classes: */
@@ -109,10 +115,13 @@ class ImageViewer:public Vrui::Application
 	
 	/* Elements: */
 	Images::TextureSet textures; // Texture set containing the image to be displayed
-	const Images::BaseImage* image; // Pointer to the image
+	const Images::BaseImage* image; // Pointer to the image, or null if the image is displayed from a tile pyramid
+	Images::TilePyramid* pyramid; // Tile pyramid containing an image too large to be held in memory, or null
+	Images::TilePyramidRenderer* pyramidRenderer; // Renderer streaming the tile pyramid's visible tiles, or null
 	
 	/* Private methods: */
 	Color getPixel(unsigned int x,unsigned int y) const; // Returns an RGBA color for the given pixel position
+	static void tilesLoadedCallback(const Images::TilePyramidRenderer& renderer); // Callback called when the tile pyramid renderer loaded new tiles
 	
 	/* Constructors and destructors: */
 	public:
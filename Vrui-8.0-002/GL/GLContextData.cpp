@@ -39,31 +39,38 @@ Methods of class GLContextData:
 
 GLContextData::GLContextData(GLContext& sContext,int sTableSize,float sWaterMark,float sGrowRate)
 	:context(sContext),
-	 itemHash(sTableSize,sWaterMark,sGrowRate),
 	 lightTracker(new GLLightTracker),
 	 clipPlaneTracker(new GLClipPlaneTracker)
 	{
+	/* Reserve room in the item list: */
+	if(sTableSize>0)
+		items.reserve(sTableSize);
 	}
 
 GLContextData::~GLContextData(void)
 	{
 	/* Delete all data items in this context: */
-	for(ItemHash::Iterator it=itemHash.begin();!it.isFinished();++it)
-		delete it->getDest();
+	for(ItemList::iterator iIt=items.begin();iIt!=items.end();++iIt)
+		delete *iIt;
 	
 	/* Delete the state trackers: */
 	delete lightTracker;
 	delete clipPlaneTracker;
 	}
 
+unsigned int GLContextData::allocateSlot(void)
+	{
+	return GLThingManager::theThingManager.allocateSlot();
+	}
+
 void GLContextData::initThing(const GLObject* thing)
 	{
 	GLThingManager::theThingManager.initThing(thing);
 	}
 
-void GLContextData::destroyThing(const GLObject* thing)
+void GLContextData::destroyThing(const GLObject* thing,unsigned int slot)
 	{
-	GLThingManager::theThingManager.destroyThing(thing);
+	GLThingManager::theThingManager.destroyThing(thing,slot);
 	}
 
 void GLContextData::orderThings(const GLObject* thing1,const GLObject* thing2)
@@ -23,7 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef GLCONTEXTDATA_INCLUDED
 #define GLCONTEXTDATA_INCLUDED
 
-#include <Misc/HashTable.h>
+#include <vector>
 #include <Misc/CallbackData.h>
 #include <Misc/CallbackList.h>
 #include <GL/TLSHelper.h>
@@ -36,6 +36,8 @@ class GLClipPlaneTracker;
 
 class GLContextData
 	{
+	friend class GLThingManager;
+	
 	/* Embedded classes: */
 	public:
 	struct CurrentContextDataChangedCallbackData:public Misc::CallbackData
@@ -53,24 +55,36 @@ class GLContextData
 		};
 	
 	private:
-	typedef Misc::HashTable<const GLObject*,GLObject::DataItem*> ItemHash; // Class for hash table mapping pointers to data items
+	typedef std::vector<GLObject::DataItem*> ItemList; // Type for lists of data items indexed by their things' context data slots
 	
 	/* Elements: */
 	static Misc::CallbackList currentContextDataChangedCallbacks; // List of callbacks called whenever the current context data object changes
 	static GL_THREAD_LOCAL(GLContextData*) currentContextData; // Pointer to the current context data object (associated with the current OpenGL context)
 	GLContext& context; // A reference to the OpenGL context with which this data store is associated
-	ItemHash itemHash; // A hash table for the context
+	ItemList items; // List of data items in the context, indexed by their things' context data slots; null for unrealized things
 	GLLightTracker* lightTracker; // An object to track the OpenGL context's lighting state
 	GLClipPlaneTracker* clipPlaneTracker; // An object to track the OpenGL context's clipping plane state
 	
+	/* Private methods: */
+	void removeSlot(unsigned int slot) // Deletes the data item stored in the given context data slot
+		{
+		if(slot<items.size())
+			{
+			/* Delete the data item (hopefully freeing all resources): */
+			delete items[slot];
+			items[slot]=0;
+			}
+		}
+	
 	/* Constructors and destructors: */
 	public:
-	GLContextData(GLContext& sContext,int sTableSize,float sWaterMark =0.9f,float sGrowRate =1.7312543); // Constructs an empty context
+	GLContextData(GLContext& sContext,int sTableSize,float sWaterMark =0.9f,float sGrowRate =1.7312543); // Constructs an empty context with room for the given number of data items; water mark and grow rate are ignored
 	~GLContextData(void);
 	
 	/* Methods to manage object initializations and clean-ups: */
+	static unsigned int allocateSlot(void); // Returns a context data slot for a new thing
 	static void initThing(const GLObject* thing); // Marks a thing for context initialization
-	static void destroyThing(const GLObject* thing); // Marks a thing for context data removal
+	static void destroyThing(const GLObject* thing,unsigned int slot); // Marks a thing, which uses the given context data slot, for context data removal
 	static void orderThings(const GLObject* thing1,const GLObject* thing2); // Asks thing manager to always initialize thing1 before thing2
 	static void resetThingManager(void); // Resets the thing manager
 	static void shutdownThingManager(void); // Shuts down the thing manager
@@ -90,37 +104,30 @@ class GLContextData
 	/* Methods to store/retrieve context data items: */
 	bool isRealized(const GLObject* thing) const
 		{
-		return itemHash.isEntry(thing);
+		return thing->contextDataSlot<items.size()&&items[thing->contextDataSlot]!=0;
 		}
 	void addDataItem(const GLObject* thing,GLObject::DataItem* dataItem)
 		{
-		itemHash.setEntry(ItemHash::Entry(thing,dataItem));
+		/* Grow the item list if necessary: */
+		if(thing->contextDataSlot>=items.size())
+			items.resize(thing->contextDataSlot+1,0);
+		
+		items[thing->contextDataSlot]=dataItem;
 		}
 	template <class DataItemParam>
 	DataItemParam* retrieveDataItem(const GLObject* thing)
 		{
 		/* Find the data item associated with the given thing: */
-		ItemHash::Iterator dataIt=itemHash.findEntry(thing);
-		if(dataIt.isFinished())
+		if(thing->contextDataSlot>=items.size())
 			return 0;
-		else
-			{
-			/* Cast the data item's pointer to the requested type and return it: */
-			return dynamic_cast<DataItemParam*>(dataIt->getDest());
-			}
+		
+		/* Cast the data item's pointer to the requested type and return it: */
+		return dynamic_cast<DataItemParam*>(items[thing->contextDataSlot]);
 		}
 	void removeDataItem(const GLObject* thing)
 		{
-		/* Find the data item associated with the given thing: */
-		ItemHash::Iterator dataIt=itemHash.findEntry(thing);
-		if(!dataIt.isFinished())
-			{
-			/* Delete the data item (hopefully freeing all resources): */
-			delete dataIt->getDest();
-			
-			/* Remove the data item from the hash table: */
-			itemHash.removeEntry(dataIt);
-			}
+		/* Delete the data item associated with the given thing: */
+		removeSlot(thing->contextDataSlot);
 		}
 	
 	/* Methods to retrieve other context-related state: */
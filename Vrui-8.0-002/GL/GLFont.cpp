@@ -32,6 +32,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GL/GLTexEnvTemplates.h>
 #include <GL/GLTexCoordTemplates.h>
 #include <GL/GLVertexTemplates.h>
+#include <GL/GLContextData.h>
+#include <GL/Extensions/GLARBVertexBufferObject.h>
 #include <GL/Config.h>
 
 /*********************************
@@ -48,6 +50,32 @@ void GLFont::CharInfo::read(IO::File& file)
 	file.read(spanOffset);
 	}
 
+/*********************************
+Methods of class GLFont::DataItem:
+*********************************/
+
+GLFont::DataItem::DataItem(void)
+	:atlasTextureObjectId(0),atlasAntialiasing(false),
+	 vertexBufferObjectId(0)
+	{
+	/* Create the glyph atlas texture object: */
+	glGenTextures(1,&atlasTextureObjectId);
+	
+	/* Create a vertex buffer object to stream batched quads if the extension is supported: */
+	if(GLARBVertexBufferObject::isSupported())
+		{
+		GLARBVertexBufferObject::initExtension();
+		glGenBuffersARB(1,&vertexBufferObjectId);
+		}
+	}
+
+GLFont::DataItem::~DataItem(void)
+	{
+	glDeleteTextures(1,&atlasTextureObjectId);
+	if(vertexBufferObjectId!=0)
+		glDeleteBuffersARB(1,&vertexBufferObjectId);
+	}
+
 /***********************
 Methods of class GLFont:
 ***********************/
@@ -420,6 +448,180 @@ void GLFont::uploadStringTexture(const char* string,const GLFont::Color& stringB
 	delete[] image;
 	}
 
+void GLFont::layoutGlyphAtlas(void)
+	{
+	/* Calculate the width of each character's glyph raster image: */
+	GLsizei maxGlyphWidth=0;
+	for(GLsizei i=0;i<numCharacters;++i)
+		{
+		CharInfo& ci=characters[i];
+		const unsigned char* rasterLine=&rasterLines[ci.rasterLineOffset];
+		const unsigned char* span=&spans[ci.spanOffset];
+		GLsizei glyphWidth=0;
+		for(int y=-ci.descent;y<ci.ascent;++y,++rasterLine)
+			{
+			/* Find the right edge of the last span in this line: */
+			GLsizei x=0;
+			int numSpans=int(*rasterLine);
+			for(int j=0;j<numSpans;++j,++span)
+				{
+				x+=GLsizei((*span)>>3);
+				if(((*span)&0x07)!=0)
+					{
+					x+=GLsizei((*span)&0x07);
+					if(glyphWidth<x)
+						glyphWidth=x;
+					}
+				}
+			}
+		ci.glyphWidth=GLshort(glyphWidth);
+		if(maxGlyphWidth<glyphWidth)
+			maxGlyphWidth=glyphWidth;
+		}
+	
+	/*********************************************************************
+	Pack the glyph cells of all characters into rows of equal height. Each
+	cell surrounds its glyph with two empty texels on every side: one for
+	the antialiasing filter's footprint, and one to let linear texture
+	interpolation fade to transparent at the edges of a glyph quad, as it
+	fades to the background color in a string's texture image. The
+	atlas's lower-left corner holds a block of opaque texels from which
+	background quads are textured.
+	*********************************************************************/
+	
+	GLint rowHeight=fontHeight+2;
+	for(atlasWidth=64;atlasWidth<maxGlyphWidth+4;atlasWidth<<=1)
+		;
+	while(true)
+		{
+		/* Lay out all glyph cells for the current atlas width: */
+		GLint x=3;
+		GLint y=0;
+		for(GLsizei i=0;i<numCharacters;++i)
+			{
+			CharInfo& ci=characters[i];
+			if(ci.glyphWidth>0)
+				{
+				/* Start a new row if the cell doesn't fit into the current one: */
+				GLint cellWidth=ci.glyphWidth+4;
+				if(x+cellWidth>atlasWidth)
+					{
+					x=0;
+					y+=rowHeight;
+					}
+				ci.atlasX=GLshort(x);
+				ci.atlasY=GLshort(y);
+				x+=cellWidth;
+				}
+			}
+		
+		/* Stop once the atlas is no taller than it is wide: */
+		if(y+rowHeight<=atlasWidth)
+			{
+			for(atlasHeight=1;atlasHeight<y+rowHeight;atlasHeight<<=1)
+				;
+			break;
+			}
+		atlasWidth<<=1;
+		}
+	}
+
+void GLFont::uploadGlyphAtlas(void) const
+	{
+	/* Create an alpha-only texture image holding the coverage of all glyphs: */
+	GLubyte* image=new GLubyte[atlasWidth*atlasHeight];
+	memset(image,0,atlasWidth*atlasHeight);
+	
+	/* Create the block of opaque texels for background quads: */
+	for(int y=0;y<3;++y)
+		for(int x=0;x<3;++x)
+			image[atlasWidth*y+x]=GLubyte(255);
+	
+	/* Copy all glyphs into their cells: */
+	for(GLsizei charIndex=0;charIndex<numCharacters;++charIndex)
+		{
+		const CharInfo* ciPtr=&characters[charIndex];
+		if(ciPtr->glyphWidth==0)
+			continue;
+		const unsigned char* rasterLine=&rasterLines[ciPtr->rasterLineOffset];
+		const unsigned char* span=&spans[ciPtr->spanOffset];
+		
+		/* Copy all raster lines: */
+		GLubyte* cellPtr=&image[atlasWidth*(ciPtr->atlasY+2)+ciPtr->atlasX+2];
+		for(int y=0;y<ciPtr->descent+ciPtr->ascent;++y,++rasterLine)
+			{
+			/* Copy all spans in this line: */
+			GLubyte* texPtr=cellPtr+atlasWidth*y;
+			int numSpans=int(*rasterLine);
+			for(int i=0;i<numSpans;++i,++span)
+				{
+				texPtr+=int((*span)>>3);
+				int numPixels=int((*span)&0x07);
+				for(int j=0;j<numPixels;++j,++texPtr)
+					*texPtr=GLubyte(255);
+				}
+			}
+		
+		if(antialiasing)
+			{
+			/*************************************************************
+			Run the same in-place low-pass filter as on string texture
+			images on the glyph and the ring of texels around it:
+			*************************************************************/
+			
+			GLubyte* filterPtr=&image[atlasWidth*(ciPtr->atlasY+1)+ciPtr->atlasX+1];
+			GLsizei filterWidth=ciPtr->glyphWidth+2;
+			GLsizei filterHeight=ciPtr->descent+ciPtr->ascent+2;
+			
+			/* Low-pass filter each cell column using a 1D tent filter: */
+			for(GLsizei x=0;x<filterWidth;++x)
+				{
+				GLubyte* iPtr=filterPtr+x;
+				GLuint last=iPtr[0];
+				iPtr[0]=GLubyte((last*3U+GLuint(iPtr[atlasWidth])+2U)>>2);
+				iPtr+=atlasWidth;
+				for(GLsizei y=2;y<filterHeight;++y,iPtr+=atlasWidth)
+					{
+					GLuint nextLast=iPtr[0];
+					iPtr[0]=GLubyte((last+nextLast*2U+GLuint(iPtr[atlasWidth])+2U)>>2);
+					last=nextLast;
+					}
+				iPtr[0]=GLubyte((last+GLuint(iPtr[0])*3U+2U)>>2);
+				}
+			
+			/* Low-pass filter each cell row using a 1D tent filter: */
+			for(GLsizei y=0;y<filterHeight;++y)
+				{
+				GLubyte* iPtr=filterPtr+atlasWidth*y;
+				GLuint last=iPtr[0];
+				iPtr[0]=GLubyte((last*3U+GLuint(iPtr[1])+2U)>>2);
+				++iPtr;
+				for(GLsizei x=2;x<filterWidth;++x,++iPtr)
+					{
+					GLuint nextLast=iPtr[0];
+					iPtr[0]=GLubyte((last+nextLast*2U+GLuint(iPtr[1])+2U)>>2);
+					last=nextLast;
+					}
+				iPtr[0]=GLubyte((last+GLuint(iPtr[0])*3U+2U)>>2);
+				}
+			}
+		}
+	
+	/* Upload the created texture image: */
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS,0);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS,0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+	glTexImage2D(GL_TEXTURE_2D,0,GL_ALPHA8,atlasWidth,atlasHeight,0,GL_ALPHA,GL_UNSIGNED_BYTE,image);
+	
+	/* Clean up and return: */
+	delete[] image;
+	}
+
 void GLFont::loadFont(IO::File& file)
 	{
 	/* Load the font file header: */
@@ -456,6 +658,9 @@ void GLFont::loadFont(IO::File& file)
 	for(GLint i=0;i<10;++i)
 		totalWidth+=characters[i+GLint('0')-firstCharacter].width;
 	averageWidth=GLfloat(totalWidth)/(10.0f*GLfloat(fontHeight));
+	
+	/* Lay out the glyph atlas: */
+	layoutGlyphAtlas();
 	}
 
 GLFont::GLFont(const char* fontName)
@@ -464,6 +669,7 @@ GLFont::GLFont(const char* fontName)
 	 numRasterLines(0),rasterLines(0),
 	 numSpans(0),spans(0),
 	 fontHeight(0),textureHeight(0),
+	 atlasWidth(0),atlasHeight(0),
 	 textHeight(1.0),hAlignment(Left),vAlignment(Baseline),
 	 antialiasing(false)
 	{
@@ -526,6 +732,19 @@ GLFont::~GLFont(void)
 	delete[] spans;
 	}
 
+void GLFont::initContext(GLContextData& contextData) const
+	{
+	/* Create a data item: */
+	DataItem* dataItem=new DataItem;
+	contextData.addDataItem(this,dataItem);
+	
+	/* Upload the glyph atlas: */
+	glBindTexture(GL_TEXTURE_2D,dataItem->atlasTextureObjectId);
+	uploadGlyphAtlas();
+	dataItem->atlasAntialiasing=antialiasing;
+	glBindTexture(GL_TEXTURE_2D,0);
+	}
+
 GLFont::Vector GLFont::calcStringSize(GLsizei stringWidth) const
 	{
 	/* Return the string's scaled width: */
@@ -751,3 +970,177 @@ void GLFont::drawString(const GLFont::Vector& origin,const char* string) const
 	glEnd();
 	glPopAttrib();
 	}
+
+bool GLFont::hasGlyphAtlas(GLContextData& contextData) const
+	{
+	return contextData.isRealized(this);
+	}
+
+void GLFont::addStringQuads(const GLString& string,const GLFont::Box& stringBox,const GLFont::Color& stringBackgroundColor,const GLFont::Color& stringForegroundColor,std::vector<GLFont::GlyphVertex>& backgroundVertices,std::vector<GLFont::GlyphVertex>& glyphVertices) const
+	{
+	/* Calculate the texel-space rectangle of the string's texture coordinate box: */
+	GLfloat texSize[2];
+	texSize[0]=GLfloat(string.textureWidth);
+	texSize[1]=GLfloat(textureHeight);
+	GLfloat tMin[2],tMax[2];
+	for(int i=0;i<2;++i)
+		{
+		tMin[i]=string.textureBox.origin[i]*texSize[i];
+		tMax[i]=(string.textureBox.origin[i]+string.textureBox.size[i])*texSize[i];
+		}
+	
+	/* Bail out if the string is clipped away completely: */
+	if(tMin[0]>=tMax[0]||tMin[1]>=tMax[1])
+		return;
+	
+	/* Calculate the mapping from texel space to model space: */
+	GLfloat scale[2],offset[2];
+	for(int i=0;i<2;++i)
+		{
+		scale[i]=stringBox.size[i]/(tMax[i]-tMin[i]);
+		offset[i]=stringBox.origin[i]-tMin[i]*scale[i];
+		}
+	GLfloat z=stringBox.origin[2];
+	
+	/* Add a background quad textured from the atlas's opaque block: */
+	GlyphVertex v;
+	v.texCoord=GlyphVertex::TexCoord(1.5f/GLfloat(atlasWidth),1.5f/GLfloat(atlasHeight));
+	v.color=stringBackgroundColor;
+	v.position=stringBox.getCorner(0);
+	backgroundVertices.push_back(v);
+	v.position=stringBox.getCorner(1);
+	backgroundVertices.push_back(v);
+	v.position=stringBox.getCorner(3);
+	backgroundVertices.push_back(v);
+	v.position=stringBox.getCorner(2);
+	backgroundVertices.push_back(v);
+	
+	if(string.string!=0)
+		{
+		/* Add a quad for each character whose glyph cell overlaps the texture coordinate box: */
+		v.color=stringForegroundColor;
+		GLfloat atlasScale[2];
+		atlasScale[0]=1.0f/GLfloat(atlasWidth);
+		atlasScale[1]=1.0f/GLfloat(atlasHeight);
+		int x=maxLeftLap+1;
+		for(const char* cPtr=string.string;*cPtr!=0&&GLfloat(x-maxLeftLap-2)<tMax[0];++cPtr)
+			{
+			int charIndex=int(*cPtr)-firstCharacter;
+			if(charIndex>=0&&charIndex<numCharacters)
+				{
+				const CharInfo* ciPtr=&characters[charIndex];
+				if(ciPtr->glyphWidth>0)
+					{
+					/* Calculate the glyph cell's texel-space rectangle in the string and in the atlas: */
+					GLfloat cellMin[2],cellMax[2],atlasMin[2];
+					cellMin[0]=GLfloat(x+ciPtr->glyphOffset-2);
+					cellMax[0]=cellMin[0]+GLfloat(ciPtr->glyphWidth+4);
+					cellMin[1]=GLfloat(baseLine-ciPtr->descent-2);
+					cellMax[1]=GLfloat(baseLine+ciPtr->ascent+2);
+					atlasMin[0]=GLfloat(ciPtr->atlasX);
+					atlasMin[1]=GLfloat(ciPtr->atlasY);
+					
+					/* Clip the glyph cell against the texture coordinate box: */
+					GLfloat qMin[2],qMax[2];
+					bool visible=true;
+					for(int i=0;i<2;++i)
+						{
+						qMin[i]=cellMin[i]>tMin[i]?cellMin[i]:tMin[i];
+						qMax[i]=cellMax[i]<tMax[i]?cellMax[i]:tMax[i];
+						visible=visible&&qMin[i]<qMax[i];
+						}
+					
+					if(visible)
+						{
+						/* Add a quad mapping the clipped glyph cell from the atlas into model space: */
+						GLfloat pMin[2],pMax[2],aMin[2],aMax[2];
+						for(int i=0;i<2;++i)
+							{
+							pMin[i]=qMin[i]*scale[i]+offset[i];
+							pMax[i]=qMax[i]*scale[i]+offset[i];
+							aMin[i]=(atlasMin[i]+qMin[i]-cellMin[i])*atlasScale[i];
+							aMax[i]=(atlasMin[i]+qMax[i]-cellMin[i])*atlasScale[i];
+							}
+						v.texCoord=GlyphVertex::TexCoord(aMin[0],aMin[1]);
+						v.position=GlyphVertex::Position(pMin[0],pMin[1],z);
+						glyphVertices.push_back(v);
+						v.texCoord=GlyphVertex::TexCoord(aMax[0],aMin[1]);
+						v.position=GlyphVertex::Position(pMax[0],pMin[1],z);
+						glyphVertices.push_back(v);
+						v.texCoord=GlyphVertex::TexCoord(aMax[0],aMax[1]);
+						v.position=GlyphVertex::Position(pMax[0],pMax[1],z);
+						glyphVertices.push_back(v);
+						v.texCoord=GlyphVertex::TexCoord(aMin[0],aMax[1]);
+						v.position=GlyphVertex::Position(pMin[0],pMax[1],z);
+						glyphVertices.push_back(v);
+						}
+					}
+				
+				x+=ciPtr->width;
+				}
+			}
+		}
+	}
+
+void GLFont::drawStringQuads(const std::vector<GLFont::GlyphVertex>& backgroundVertices,const std::vector<GLFont::GlyphVertex>& glyphVertices,GLContextData& contextData) const
+	{
+	/* Retrieve the context data item: */
+	DataItem* dataItem=contextData.retrieveDataItem<DataItem>(this);
+	
+	/* Bind the glyph atlas texture: */
+	glBindTexture(GL_TEXTURE_2D,dataItem->atlasTextureObjectId);
+	
+	/* Check if the glyph atlas needs to be re-created after a change of antialiasing mode: */
+	if(dataItem->atlasAntialiasing!=antialiasing)
+		{
+		uploadGlyphAtlas();
+		dataItem->atlasAntialiasing=antialiasing;
+		}
+	
+	/* Set up the vertex arrays: */
+	GLsizei numBackgroundVertices=GLsizei(backgroundVertices.size());
+	GLsizei numGlyphVertices=GLsizei(glyphVertices.size());
+	const GlyphVertex* backgroundPtr=numBackgroundVertices!=0?&backgroundVertices.front():0;
+	const GlyphVertex* glyphPtr=numGlyphVertices!=0?&glyphVertices.front():0;
+	GLint firstGlyphVertex=0;
+	if(dataItem->vertexBufferObjectId!=0)
+		{
+		/* Stream all quads into the vertex buffer, background quads first: */
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB,dataItem->vertexBufferObjectId);
+		glBufferDataARB(GL_ARRAY_BUFFER_ARB,(numBackgroundVertices+numGlyphVertices)*sizeof(GlyphVertex),0,GL_STREAM_DRAW_ARB);
+		if(numBackgroundVertices!=0)
+			glBufferSubDataARB(GL_ARRAY_BUFFER_ARB,0,numBackgroundVertices*sizeof(GlyphVertex),backgroundPtr);
+		if(numGlyphVertices!=0)
+			glBufferSubDataARB(GL_ARRAY_BUFFER_ARB,numBackgroundVertices*sizeof(GlyphVertex),numGlyphVertices*sizeof(GlyphVertex),glyphPtr);
+		backgroundPtr=0;
+		glyphPtr=0;
+		firstGlyphVertex=numBackgroundVertices;
+		}
+	GLVertexArrayParts::enable(GlyphVertex::getPartsMask());
+	glNormal3f(0.0f,0.0f,1.0f);
+	
+	/* Draw all background quads: */
+	if(numBackgroundVertices!=0)
+		{
+		glVertexPointer(backgroundPtr);
+		glDrawArrays(GL_QUADS,0,numBackgroundVertices);
+		}
+	
+	/* Draw all glyph quads on top of the background quads, blending by glyph coverage: */
+	if(numGlyphVertices!=0)
+		{
+		glPushAttrib(GL_COLOR_BUFFER_BIT|GL_ENABLE_BIT|GL_POLYGON_BIT);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(-1.0f,-1.0f);
+		glVertexPointer(glyphPtr);
+		glDrawArrays(GL_QUADS,firstGlyphVertex,numGlyphVertices);
+		glPopAttrib();
+		}
+	
+	/* Reset the vertex arrays: */
+	GLVertexArrayParts::disable(GlyphVertex::getPartsMask());
+	if(dataItem->vertexBufferObjectId!=0)
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB,0);
+	}
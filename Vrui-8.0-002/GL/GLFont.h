@@ -22,19 +22,22 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef GLFONT_INCLUDED
 #define GLFONT_INCLUDED
 
+#include <vector>
 #include <Misc/Endianness.h>
 #include <GL/gl.h>
 #include <GL/GLColor.h>
 #include <GL/GLVector.h>
 #include <GL/GLBox.h>
+#include <GL/GLVertex.h>
 #include <GL/GLString.h>
+#include <GL/GLObject.h>
 
 /* Forward declarations: */
 namespace IO {
 class File;
 }
 
-class GLFont
+class GLFont:public GLObject
 	{
 	/* Embedded classes: */
 	public:
@@ -42,6 +45,7 @@ class GLFont
 	typedef GLVector<GLfloat,3> Vector; // Type for model space vectors and points
 	typedef GLBox<GLfloat,3> Box; // Type for model space boxes
 	typedef GLBox<GLfloat,2> TBox; // Type for texture space boxes
+	typedef GLVertex<GLfloat,2,GLubyte,4,void,GLfloat,3> GlyphVertex; // Type for vertices of quads rendering strings from the glyph atlas
 	
 	enum HAlignment
 		{
@@ -65,10 +69,27 @@ class GLFont
 		GLsizei rasterLineOffset; // Offset of raster line descriptors in main array
 		GLsizei spanOffset; // Offset of span descriptors in main array
 		
+		/* Glyph atlas description: */
+		GLshort glyphWidth; // Width of character glyph's raster image
+		GLshort atlasX,atlasY; // Position of the character's glyph cell in the glyph atlas
+		
 		/* Methods: */
 		void read(IO::File& file); // Reads a CharInfo structure from a font file
 		};
 	
+	struct DataItem:public GLObject::DataItem
+		{
+		/* Elements: */
+		public:
+		GLuint atlasTextureObjectId; // ID of texture object holding the font's glyph atlas
+		bool atlasAntialiasing; // Antialiasing flag with which the glyph atlas was last uploaded
+		GLuint vertexBufferObjectId; // ID of vertex buffer object to stream batched quads, or 0 if vertex buffer objects are not supported
+		
+		/* Constructors and destructors: */
+		DataItem(void);
+		virtual ~DataItem(void);
+		};
+	
 	/* Elements: */
 	GLint firstCharacter; // Index of first character in font
 	GLsizei numCharacters; // Number of characters in font
@@ -83,6 +104,7 @@ class GLFont
 	GLint baseLine; // Position of baseline
 	GLsizei textureHeight; // Height of a texture image to hold a single line of text
 	GLfloat averageWidth; // Average width of a character box
+	GLsizei atlasWidth,atlasHeight; // Size of the texture image holding the glyphs of all characters
 	
 	/* Current font status: */
 	GLfloat textHeight; // Scaled height of font
@@ -98,13 +120,18 @@ class GLFont
 	void uploadStringTexture(const char* string,const Color& stringBackgroundColor,const Color& stringForegroundColor,GLsizei stringWidth,GLsizei textureWidth) const; // Creates and uploads a texture for a string using the given colors
 	void uploadStringTexture(const char* string,const Color& stringBackgroundColor,const Color& stringForegroundColor,GLsizei selectionStart,GLsizei selectionEnd,const Color& selectionBackgroundColor,const Color& selectionForegroundColor,GLsizei stringWidth,GLsizei textureWidth) const; // Creates and uploads a texture for a string using the given colors, selection range, and selection colors
 	void loadFont(IO::File& file); // Loads font from given file
+	void layoutGlyphAtlas(void); // Calculates the glyph widths and glyph atlas positions of all characters
+	void uploadGlyphAtlas(void) const; // Creates and uploads the glyph atlas texture image into the currently bound texture object
 	
 	/* Constructors and Destructors: */
 	public:
 	GLFont(const char* fontName); // Creates a GL font from a font file
-	~GLFont(void);
+	virtual ~GLFont(void);
 	
-	/* Methods: */
+	/* Methods from GLObject: */
+	virtual void initContext(GLContextData& contextData) const;
+	
+	/* New methods: */
 	bool isValid(void) const // Checks if the font object was created successfully
 		{
 		return characters!=0;
@@ -219,6 +246,11 @@ class GLFont
 	void uploadStringTexture(const char* string,const Color& stringBackgroundColor,const Color& stringForegroundColor,GLsizei selectionStart,GLsizei selectionEnd,const Color& selectionBackgroundColor,const Color& selectionForegroundColor) const; // Uploads a string's texture image with the given colors, selection range, and selection colors
 	void uploadStringTexture(const GLString& string,const Color& stringBackgroundColor,const Color& stringForegroundColor,GLsizei selectionStart,GLsizei selectionEnd,const Color& selectionBackgroundColor,const Color& selectionForegroundColor) const; // Ditto
 	void drawString(const Vector& origin,const char* string) const; // Draws a simple, one-line string
+	
+	/* Methods to render strings as batches of quads from the glyph atlas: */
+	bool hasGlyphAtlas(GLContextData& contextData) const; // Returns true if the font's glyph atlas has been created in the given OpenGL context
+	void addStringQuads(const GLString& string,const Box& stringBox,const Color& stringBackgroundColor,const Color& stringForegroundColor,std::vector<GlyphVertex>& backgroundVertices,std::vector<GlyphVertex>& glyphVertices) const; // Appends a background quad and glyph quads rendering the given string's current texture coordinate box into the given model-space box to the given vertex lists
+	void drawStringQuads(const std::vector<GlyphVertex>& backgroundVertices,const std::vector<GlyphVertex>& glyphVertices,GLContextData& contextData) const; // Draws background quads and then glyph quads from the glyph atlas; changes the current texture binding
 	};
 
 #endif
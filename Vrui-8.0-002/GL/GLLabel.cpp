@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GL/GLLabel.h>
 
+#include <algorithm>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLTexCoordTemplates.h>
@@ -41,49 +42,48 @@ GL_THREAD_LOCAL(GLLabel::DeferredRenderer*) GLLabel::DeferredRenderer::currentDe
 Methods of class GLLabel::DeferredRenderer:
 ******************************************/
 
-GLLabel::DeferredRenderer::DeferredRenderer(GLContextData& sContextData)
-	:contextData(sContextData),
-	 previousDeferredRenderer(currentDeferredRenderer)
-	{
-	/* Install the deferred renderer: */
-	currentDeferredRenderer=this;
-	}
-
-GLLabel::DeferredRenderer::~DeferredRenderer(void)
-	{
-	/* Draw all undrawn labels: */
-	draw();
-	
-	/* Uninstall the deferred renderer: */
-	currentDeferredRenderer=previousDeferredRenderer;
-	}
-
-void GLLabel::DeferredRenderer::draw(void)
+void GLLabel::DeferredRenderer::drawQuads(size_t labelsBegin,size_t labelsEnd)
 	{
-	/* Bail out if no labels were gathered: */
-	if(gatheredLabels.empty())
-		return;
+	/* Collect the quads of all labels: */
+	for(size_t i=labelsBegin;i<labelsEnd;++i)
+		{
+		const GLLabel* l=gatheredLabels[i];
+		l->font->addStringQuads(*l,l->labelBox,l->background,l->foreground,backgroundVertices,glyphVertices);
+		}
 	
-	/* Save and set up OpenGL state: */
-	GLLightTracker* lt=contextData.getLightTracker();
-	if(lt->isLightingEnabled()&&!lt->isSpecularColorSeparate())
+	/* Draw all quads using vertex colors: */
+	glTexEnvMode(GLTexEnvEnums::TEXTURE_ENV,GLTexEnvEnums::MODULATE);
+	if(contextData.getLightTracker()->isLightingEnabled())
 		{
-		/* Temporarily turn on separate specular color handling: */
-		glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL,GL_SEPARATE_SPECULAR_COLOR);
+		/*****************************************************************
+		Lit labels take their vertex colors as ambient and diffuse material
+		colors. This differs from per-label textures, which modulate a lit
+		white quad by the label's colors, only where the lit white quad
+		would be clamped, or if the current material has an emissive color.
+		*****************************************************************/
+		
+		glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
+		glEnable(GL_COLOR_MATERIAL);
 		}
+	gatheredLabels[labelsBegin]->font->drawStringQuads(backgroundVertices,glyphVertices,contextData);
 	
+	/* Clear the vertex lists for the next batch: */
+	backgroundVertices.clear();
+	glyphVertices.clear();
+	}
+
+void GLLabel::DeferredRenderer::drawTextures(size_t labelsBegin,size_t labelsEnd)
+	{
 	/* Set appropriate texture mode for current lighting state: */
-	glPushAttrib(GL_ENABLE_BIT|GL_TEXTURE_BIT);
-	glEnable(GL_TEXTURE_2D);
-	glTexEnvMode(GLTexEnvEnums::TEXTURE_ENV,lt->isLightingEnabled()?GLTexEnvEnums::MODULATE:GLTexEnvEnums::REPLACE);
+	glTexEnvMode(GLTexEnvEnums::TEXTURE_ENV,contextData.getLightTracker()->isLightingEnabled()?GLTexEnvEnums::MODULATE:GLTexEnvEnums::REPLACE);
 	
-	/* Draw each gathered label: */
-	for(std::vector<const GLLabel*>::iterator lIt=gatheredLabels.begin();lIt!=gatheredLabels.end();++lIt)
+	/* Draw each label: */
+	for(size_t i=labelsBegin;i<labelsEnd;++i)
 		{
-		const GLLabel* l=*lIt;
+		const GLLabel* l=gatheredLabels[i];
 		
 		/* Retrieve the context data item: */
-		GLLabel::DataItem* dataItem=contextData.retrieveDataItem<GLLabel::DataItem>(*lIt);
+		GLLabel::DataItem* dataItem=contextData.retrieveDataItem<GLLabel::DataItem>(l);
 		
 		/* Bind the label texture: */
 		glBindTexture(GL_TEXTURE_2D,dataItem->textureObjectId);
@@ -112,6 +112,63 @@ void GLLabel::DeferredRenderer::draw(void)
 		glVertex(l->labelBox.getCorner(2));
 		glEnd();
 		}
+	}
+
+GLLabel::DeferredRenderer::DeferredRenderer(GLContextData& sContextData)
+	:contextData(sContextData),
+	 previousDeferredRenderer(currentDeferredRenderer)
+	{
+	/* Install the deferred renderer: */
+	currentDeferredRenderer=this;
+	}
+
+GLLabel::DeferredRenderer::~DeferredRenderer(void)
+	{
+	/* Draw all undrawn labels: */
+	draw();
+	
+	/* Uninstall the deferred renderer: */
+	currentDeferredRenderer=previousDeferredRenderer;
+	}
+
+void GLLabel::DeferredRenderer::draw(void)
+	{
+	/* Bail out if no labels were gathered: */
+	if(gatheredLabels.empty())
+		return;
+	
+	/* Save and set up OpenGL state: */
+	GLLightTracker* lt=contextData.getLightTracker();
+	if(lt->isLightingEnabled()&&!lt->isSpecularColorSeparate())
+		{
+		/* Temporarily turn on separate specular color handling: */
+		glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL,GL_SEPARATE_SPECULAR_COLOR);
+		}
+	glPushAttrib(GL_CURRENT_BIT|GL_ENABLE_BIT|GL_LIGHTING_BIT|GL_TEXTURE_BIT);
+	glEnable(GL_TEXTURE_2D);
+	
+	/* Draw the gathered labels in batches of labels sharing the same font: */
+	size_t batchBegin=0;
+	while(batchBegin<gatheredLabels.size())
+		{
+		/* Move all remaining labels sharing the first remaining label's font to the front: */
+		const GLFont* font=gatheredLabels[batchBegin]->font;
+		size_t batchEnd=batchBegin+1;
+		for(size_t i=batchEnd;i<gatheredLabels.size();++i)
+			if(gatheredLabels[i]->font==font)
+				{
+				std::swap(gatheredLabels[batchEnd],gatheredLabels[i]);
+				++batchEnd;
+				}
+		
+		/* Draw the batch from the font's glyph atlas, or from per-label textures if the atlas does not exist yet: */
+		if(font->hasGlyphAtlas(contextData))
+			drawQuads(batchBegin,batchEnd);
+		else
+			drawTextures(batchBegin,batchEnd);
+		
+		batchBegin=batchEnd;
+		}
 	
 	/* Reset OpenGL state: */
 	glBindTexture(GL_TEXTURE_2D,0);
@@ -396,54 +453,9 @@ void GLLabel::draw(GLContextData& contextData) const
 	if(DeferredRenderer::addLabel(this))
 		return;
 	
-	/* Retrieve the context data item: */
-	DataItem* dataItem=contextData.retrieveDataItem<DataItem>(this);
-	
-	/* Save and set up OpenGL state: */
-	GLLightTracker* lt=contextData.getLightTracker();
-	if(lt->isLightingEnabled()&&!lt->isSpecularColorSeparate())
-		{
-		/* Temporarily turn on separate specular color handling: */
-		glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL,GL_SEPARATE_SPECULAR_COLOR);
-		}
-	
-	/* Set appropriate texture mode for current lighting state: */
-	glPushAttrib(GL_ENABLE_BIT|GL_TEXTURE_BIT);
-	glEnable(GL_TEXTURE_2D);
-	glTexEnvMode(GLTexEnvEnums::TEXTURE_ENV,lt->isLightingEnabled()?GLTexEnvEnums::MODULATE:GLTexEnvEnums::REPLACE);
-	
-	/* Bind the label texture: */
-	glBindTexture(GL_TEXTURE_2D,dataItem->textureObjectId);
-	
-	/* Check if the texture object needs to be updated: */
-	if(dataItem->version!=version)
-		{
-		/* Upload the string's texture image: */
-		font->uploadStringTexture(*this,background,foreground);
-		
-		/* Update the texture version number: */
-		dataItem->version=version;
-		}
-	
-	/* Draw a textured quad: */
-	glColor4f(1.0f,1.0f,1.0f,background[3]);
-	glBegin(GL_QUADS);
-	glNormal3f(0.0f,0.0f,1.0f);
-	glTexCoord(textureBox.getCorner(0));
-	glVertex(labelBox.getCorner(0));
-	glTexCoord(textureBox.getCorner(1));
-	glVertex(labelBox.getCorner(1));
-	glTexCoord(textureBox.getCorner(3));
-	glVertex(labelBox.getCorner(3));
-	glTexCoord(textureBox.getCorner(2));
-	glVertex(labelBox.getCorner(2));
-	glEnd();
-	
-	/* Reset OpenGL state: */
-	glBindTexture(GL_TEXTURE_2D,0);
-	glPopAttrib();
-	if(lt->isLightingEnabled()&&!lt->isSpecularColorSeparate())
-		glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL,GL_SINGLE_COLOR);
+	/* Draw the label immediately through a temporary deferred renderer: */
+	DeferredRenderer deferredRenderer(contextData);
+	DeferredRenderer::addLabel(this);
 	}
 
 void GLLabel::draw(GLsizei selectionStart,GLsizei selectionEnd,const GLLabel::Color& selectionBackgroundColor,const GLLabel::Color& selectionForegroundColor,GLContextData& contextData) const
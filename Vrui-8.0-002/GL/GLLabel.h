@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef GLLABEL_INCLUDED
 #define GLLABEL_INCLUDED
 
+#include <stddef.h>
 #include <vector>
 #include <GL/gl.h>
 #include <GL/TLSHelper.h>
@@ -29,9 +30,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GL/GLBox.h>
 #include <GL/GLString.h>
 #include <GL/GLObject.h>
-
-/* Forward declarations: */
-class GLFont;
+#include <GL/GLFont.h>
 
 class GLLabel:public GLString,public GLObject
 	{
@@ -48,6 +47,12 @@ class GLLabel:public GLString,public GLObject
 		GLContextData& contextData; // Reference to the OpenGL context data object
 		DeferredRenderer* previousDeferredRenderer; // Pointer to the deferred renderer that was suspended when this one was installed
 		std::vector<const GLLabel*> gatheredLabels; // List of gathered GLLabel objects
+		std::vector<GLFont::GlyphVertex> backgroundVertices; // List of background quad vertices to batch labels sharing the same font
+		std::vector<GLFont::GlyphVertex> glyphVertices; // List of glyph quad vertices to batch labels sharing the same font
+		
+		/* Private methods: */
+		void drawQuads(size_t labelsBegin,size_t labelsEnd); // Draws the given range of gathered labels, which share the same font, as one batch of quads from the font's glyph atlas
+		void drawTextures(size_t labelsBegin,size_t labelsEnd); // Draws the given range of gathered labels as quads textured with each label's own string texture
 		
 		/* Constructors and destructors: */
 		public:
@@ -55,7 +60,7 @@ class GLLabel:public GLString,public GLObject
 		~DeferredRenderer(void); // Destroys the deferred renderer and uninstalls it after rendering gathered labels
 		
 		/* Methods: */
-		void draw(void); // Draws all gathered GLLabel objects and clears the list
+		void draw(void); // Draws all gathered GLLabel objects in one batch per font and clears the list
 		static bool addLabel(const GLLabel* label); // Adds a GLLabel object to the deferred renderer's list; returns false if label needs to be drawn immediately
 		};
 	
@@ -164,7 +169,7 @@ class GLLabel:public GLString,public GLObject
 	void clipBox(const Box& clipBox); // Clips the label to the given box and adjusts texture coordinates accordingly
 	GLint calcCharacterIndex(GLfloat modelPos) const; // Returns the position of the string's character at the given model-space position
 	GLfloat calcCharacterPos(GLint characterPos) const; // Returns the model space position of the right edge of the given character
-	void draw(GLContextData& contextData) const; // Draws the label at the current model-space position and size
+	void draw(GLContextData& contextData) const; // Draws the label at the current model-space position and size; when lit, label colors act as ambient and diffuse material colors
 	void draw(GLsizei selectionStart,GLsizei selectionEnd,const Color& selectionBackgroundColor,const Color& selectionForegroundColor,GLContextData& contextData) const; // Ditto, with additional selection range and selection colors
 	};
 
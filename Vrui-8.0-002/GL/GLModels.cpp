@@ -23,42 +23,198 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GL/GLModels.h>
 
-void glDrawCube(GLfloat size)
+namespace {
+
+/*****************************************************************
+Helper classes to send model geometry to OpenGL in immediate mode,
+or to collect it into indexed triangle lists:
+*****************************************************************/
+
+class ImmediateModelWriter
+	{
+	/* Methods: */
+	public:
+	void begin(GLenum mode)
+		{
+		glBegin(mode);
+		}
+	void normal(GLfloat x,GLfloat y,GLfloat z)
+		{
+		glNormal3f(x,y,z);
+		}
+	void normal(const GLfloat n[3])
+		{
+		glNormal3fv(n);
+		}
+	void vertex(GLfloat x,GLfloat y,GLfloat z)
+		{
+		glVertex3f(x,y,z);
+		}
+	void vertex(const GLfloat v[3])
+		{
+		glVertex3fv(v);
+		}
+	void end(void)
+		{
+		glEnd();
+		}
+	};
+
+class TriangleModelWriter
+	{
+	/* Elements: */
+	private:
+	std::vector<GLModelVertex>& vertices; // List of vertices to which to append
+	std::vector<GLuint>& triangles; // List of triangle vertex indices to which to append
+	GLenum mode; // Primitive type of the current begin/end block
+	GLModelVertex::Normal currentNormal; // Current normal vector
+	unsigned int numVertices; // Number of vertices received in the current begin/end block
+	GLuint first; // Index of first vertex received in the current begin/end block
+	GLuint last[3]; // Indices of the three most recently received vertices, in order of arrival
+	
+	/* Private methods: */
+	void addTriangle(GLuint v0,GLuint v1,GLuint v2)
+		{
+		triangles.push_back(v0);
+		triangles.push_back(v1);
+		triangles.push_back(v2);
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	TriangleModelWriter(std::vector<GLModelVertex>& sVertices,std::vector<GLuint>& sTriangles)
+		:vertices(sVertices),triangles(sTriangles),
+		 mode(GL_TRIANGLES),currentNormal(0.0f,0.0f,1.0f),numVertices(0),first(0)
+		{
+		last[0]=last[1]=last[2]=0;
+		}
+	
+	/* Methods: */
+	void begin(GLenum newMode)
+		{
+		mode=newMode;
+		numVertices=0;
+		}
+	void normal(GLfloat x,GLfloat y,GLfloat z)
+		{
+		currentNormal=GLModelVertex::Normal(x,y,z);
+		}
+	void normal(const GLfloat n[3])
+		{
+		currentNormal=GLModelVertex::Normal(n);
+		}
+	void vertex(GLfloat x,GLfloat y,GLfloat z)
+		{
+		/* Store the vertex: */
+		GLuint v=GLuint(vertices.size());
+		vertices.push_back(GLModelVertex(currentNormal,GLModelVertex::Position(x,y,z)));
+		
+		/* Split the current primitive into triangles with the same orientations as OpenGL's: */
+		switch(mode)
+			{
+			case GL_TRIANGLES:
+				triangles.push_back(v);
+				break;
+			
+			case GL_TRIANGLE_STRIP:
+				if(numVertices>=2)
+					{
+					if(numVertices%2==0)
+						addTriangle(last[1],last[2],v);
+					else
+						addTriangle(last[2],last[1],v);
+					}
+				break;
+			
+			case GL_TRIANGLE_FAN:
+				if(numVertices>=2)
+					addTriangle(first,last[2],v);
+				break;
+			
+			case GL_QUADS:
+				if(numVertices%4==2)
+					addTriangle(last[1],last[2],v);
+				else if(numVertices%4==3)
+					addTriangle(last[0],last[2],v);
+				break;
+			
+			case GL_QUAD_STRIP:
+				if(numVertices>=3&&numVertices%2==1)
+					{
+					addTriangle(last[0],last[1],v);
+					addTriangle(last[0],v,last[2]);
+					}
+				break;
+			}
+		
+		/* Remember the vertex: */
+		if(numVertices==0)
+			first=v;
+		last[0]=last[1];
+		last[1]=last[2];
+		last[2]=v;
+		++numVertices;
+		}
+	void vertex(const GLfloat v[3])
+		{
+		vertex(v[0],v[1],v[2]);
+		}
+	void end(void)
+		{
+		}
+	};
+
+}
+
+template <class ModelWriterParam>
+inline void writeCube(GLfloat size,ModelWriterParam& writer)
 	{
 	GLfloat s=0.5f*size;
 	
-	glBegin(GL_QUADS);
-	glNormal3f(-1.0f,0.0f,0.0f);
-	glVertex3f(-s,-s,-s);
-	glVertex3f(-s,-s, s);
-	glVertex3f(-s, s, s);
-	glVertex3f(-s, s,-s);
-	glNormal3f(1.0f,0.0f,0.0f);
-	glVertex3f( s,-s,-s);
-	glVertex3f( s, s,-s);
-	glVertex3f( s, s, s);
-	glVertex3f( s,-s, s);
-	glNormal3f(0.0f,-1.0f,0.0f);
-	glVertex3f(-s,-s,-s);
-	glVertex3f( s,-s,-s);
-	glVertex3f( s,-s, s);
-	glVertex3f(-s,-s, s);
-	glNormal3f(0.0f,1.0f,0.0f);
-	glVertex3f(-s, s,-s);
-	glVertex3f(-s, s, s);
-	glVertex3f( s, s, s);
-	glVertex3f( s, s,-s);
-	glNormal3f(0.0f,0.0f,-1.0f);
-	glVertex3f(-s,-s,-s);
-	glVertex3f(-s, s,-s);
-	glVertex3f( s, s,-s);
-	glVertex3f( s,-s,-s);
-	glNormal3f(0.0f,0.0f,1.0f);
-	glVertex3f(-s,-s, s);
-	glVertex3f( s,-s, s);
-	glVertex3f( s, s, s);
-	glVertex3f(-s, s, s);
-	glEnd();
+	writer.begin(GL_QUADS);
+	writer.normal(-1.0f,0.0f,0.0f);
+	writer.vertex(-s,-s,-s);
+	writer.vertex(-s,-s, s);
+	writer.vertex(-s, s, s);
+	writer.vertex(-s, s,-s);
+	writer.normal(1.0f,0.0f,0.0f);
+	writer.vertex( s,-s,-s);
+	writer.vertex( s, s,-s);
+	writer.vertex( s, s, s);
+	writer.vertex( s,-s, s);
+	writer.normal(0.0f,-1.0f,0.0f);
+	writer.vertex(-s,-s,-s);
+	writer.vertex( s,-s,-s);
+	writer.vertex( s,-s, s);
+	writer.vertex(-s,-s, s);
+	writer.normal(0.0f,1.0f,0.0f);
+	writer.vertex(-s, s,-s);
+	writer.vertex(-s, s, s);
+	writer.vertex( s, s, s);
+	writer.vertex( s, s,-s);
+	writer.normal(0.0f,0.0f,-1.0f);
+	writer.vertex(-s,-s,-s);
+	writer.vertex(-s, s,-s);
+	writer.vertex( s, s,-s);
+	writer.vertex( s,-s,-s);
+	writer.normal(0.0f,0.0f,1.0f);
+	writer.vertex(-s,-s, s);
+	writer.vertex( s,-s, s);
+	writer.vertex( s, s, s);
+	writer.vertex(-s, s, s);
+	writer.end();
+	}
+
+void glDrawCube(GLfloat size)
+	{
+	ImmediateModelWriter writer;
+	writeCube(size,writer);
+	}
+
+void glGenerateCube(GLfloat size,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles)
+	{
+	TriangleModelWriter writer(vertices,triangles);
+	writeCube(size,writer);
 	}
 
 void glDrawBox(const GLfloat min[3],const GLfloat max[3])
@@ -233,7 +389,8 @@ void glDrawSphereMercatorWithTexture(GLfloat radius,GLsizei numStrips,GLsizei nu
 	glEnd();
 	}
 
-inline void combine(const GLfloat p100[3],const GLfloat p010[3],const GLfloat p001[3],GLfloat w0,GLfloat w1,GLfloat radius)
+template <class ModelWriterParam>
+inline void combine(ModelWriterParam& writer,const GLfloat p100[3],const GLfloat p010[3],const GLfloat p001[3],GLfloat w0,GLfloat w1,GLfloat radius)
 	{
 	GLfloat w2=1.0f-w0-w1;
 	GLfloat result[3];
@@ -246,13 +403,14 @@ inline void combine(const GLfloat p100[3],const GLfloat p010[3],const GLfloat p0
 	resultLen=sqrtf(resultLen);
 	for(int i=0;i<3;++i)
 		result[i]/=resultLen;
-	glNormal3fv(result);
+	writer.normal(result);
 	for(int i=0;i<3;++i)
 		result[i]*=radius;
-	glVertex3fv(result);
+	writer.vertex(result);
 	}
 
-inline void combine(const GLfloat p00[3],const GLfloat p10[3],const GLfloat p01[3],const GLfloat p11[3],GLfloat wx,GLfloat wy,GLfloat radius)
+template <class ModelWriterParam>
+inline void combine(ModelWriterParam& writer,const GLfloat p00[3],const GLfloat p10[3],const GLfloat p01[3],const GLfloat p11[3],GLfloat wx,GLfloat wy,GLfloat radius)
 	{
 	GLfloat result[3];
 	GLfloat resultLen=0.0f;
@@ -275,13 +433,14 @@ inline void combine(const GLfloat p00[3],const GLfloat p10[3],const GLfloat p01[
 	resultLen=sqrtf(resultLen);
 	for(int i=0;i<3;++i)
 		result[i]/=resultLen;
-	glNormal3fv(result);
+	writer.normal(result);
 	for(int i=0;i<3;++i)
 		result[i]*=radius;
-	glVertex3fv(result);
+	writer.vertex(result);
 	}
 
-void glDrawSphereIcosahedron(GLfloat radius,GLsizei numStrips)
+template <class ModelWriterParam>
+inline void writeSphereIcosahedron(GLfloat radius,GLsizei numStrips,ModelWriterParam& writer)
 	{
 	/* Construct static icosahedron model: */
 	const GLfloat b0=0.525731112119133606f; // b0=sqrt((5.0-sqrt(5.0))/10);
@@ -297,7 +456,7 @@ void glDrawSphereIcosahedron(GLfloat radius,GLsizei numStrips)
 		{
 		GLfloat botW=GLfloat(strip)/GLfloat(numStrips);
 		GLfloat topW=GLfloat(strip+1)/GLfloat(numStrips);
-		glBegin(GL_TRIANGLE_STRIP);
+		writer.begin(GL_TRIANGLE_STRIP);
 		for(int i=0;i<10;i+=2)
 			{
 			const GLfloat* p00=vUnit[stripIndices[i+1]];
@@ -308,13 +467,13 @@ void glDrawSphereIcosahedron(GLfloat radius,GLsizei numStrips)
 				{
 				GLfloat leftW=GLfloat(j)/GLfloat(numStrips);
 				// GLfloat rightW=GLfloat(j+1)/GLfloat(numStrips);
-				combine(p00,p10,p01,p11,leftW,topW,radius);
-				combine(p00,p10,p01,p11,leftW,botW,radius);
+				combine(writer,p00,p10,p01,p11,leftW,topW,radius);
+				combine(writer,p00,p10,p01,p11,leftW,botW,radius);
 				}
-			combine(p00,p10,p01,p11,1.0f,topW,radius);
-			combine(p00,p10,p01,p11,1.0f,botW,radius);
+			combine(writer,p00,p10,p01,p11,1.0f,topW,radius);
+			combine(writer,p00,p10,p01,p11,1.0f,botW,radius);
 			}
-		glEnd();
+		writer.end();
 		}
 	
 	for(int cap=0;cap<2;++cap)
@@ -324,8 +483,8 @@ void glDrawSphereIcosahedron(GLfloat radius,GLsizei numStrips)
 			{
 			GLfloat botW=GLfloat(strip)/GLfloat(numStrips);
 			GLfloat topW=GLfloat(strip+1)/GLfloat(numStrips);
-			glBegin(GL_TRIANGLE_STRIP);
-			combine(vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],topW,0.0f,radius);
+			writer.begin(GL_TRIANGLE_STRIP);
+			combine(writer,vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],topW,0.0f,radius);
 			for(int i=1;i<6;++i)
 				{
 				const GLfloat* p100=vUnit[fanIndices[cap][0]];
@@ -334,72 +493,98 @@ void glDrawSphereIcosahedron(GLfloat radius,GLsizei numStrips)
 				for(int j=0;j<numStrips-strip;++j)
 					{
 					GLfloat leftW=GLfloat(j)/GLfloat(numStrips);
-					combine(p100,p001,p010,botW,leftW,radius);
-					combine(p100,p001,p010,topW,leftW,radius);
+					combine(writer,p100,p001,p010,botW,leftW,radius);
+					combine(writer,p100,p001,p010,topW,leftW,radius);
 					}
 				}
-			combine(vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],botW,0.0f,radius);
-			glEnd();
+			combine(writer,vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],botW,0.0f,radius);
+			writer.end();
 			}
 		
 		/* Render the cap triangle fan: */
-		glBegin(GL_TRIANGLE_FAN);
-		combine(vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],1.0f,0.0f,radius);
+		writer.begin(GL_TRIANGLE_FAN);
+		combine(writer,vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],1.0f,0.0f,radius);
 		GLfloat botW=GLfloat(numStrips-1)/GLfloat(numStrips);
 		for(int i=1;i<6;++i)
-			combine(vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][i+1]],vUnit[fanIndices[cap][i]],botW,0.0f,radius);
-		combine(vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],botW,0.0f,radius);
-		glEnd();
+			combine(writer,vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][i+1]],vUnit[fanIndices[cap][i]],botW,0.0f,radius);
+		combine(writer,vUnit[fanIndices[cap][0]],vUnit[fanIndices[cap][2]],vUnit[fanIndices[cap][1]],botW,0.0f,radius);
+		writer.end();
 		}
 	}
 
-void glDrawCylinder(GLfloat radius,GLfloat height,GLsizei numStrips)
+void glDrawSphereIcosahedron(GLfloat radius,GLsizei numStrips)
+	{
+	ImmediateModelWriter writer;
+	writeSphereIcosahedron(radius,numStrips,writer);
+	}
+
+void glGenerateSphereIcosahedron(GLfloat radius,GLsizei numStrips,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles)
+	{
+	TriangleModelWriter writer(vertices,triangles);
+	writeSphereIcosahedron(radius,numStrips,writer);
+	}
+
+template <class ModelWriterParam>
+inline void writeCylinder(GLfloat radius,GLfloat height,GLsizei numStrips,ModelWriterParam& writer)
 	{
 	const GLfloat pi=GLfloat(M_PI);
 	
 	GLfloat h=0.5f*height;
 	
 	/* Draw bottom circle: */
-	glBegin(GL_TRIANGLE_FAN);
-	glNormal3f(0.0f,0.0f,-1.0f);
-	glVertex3f(0.0f,0.0f,-h);
+	writer.begin(GL_TRIANGLE_FAN);
+	writer.normal(0.0f,0.0f,-1.0f);
+	writer.vertex(0.0f,0.0f,-h);
 	for(int j=numStrips;j>=0;--j)
 		{
 		GLfloat lng=GLfloat(j)*(2.0f*pi)/GLfloat(numStrips);
 		GLfloat x=cosf(lng);
 		GLfloat y=sinf(lng);
-		glVertex3f(x*radius,y*radius,-h);
+		writer.vertex(x*radius,y*radius,-h);
 		}
-	glEnd();
+	writer.end();
 	
 	/* Draw mantle: */
-	glBegin(GL_QUAD_STRIP);
+	writer.begin(GL_QUAD_STRIP);
 	for(int j=0;j<=numStrips;++j)
 		{
 		GLfloat lng=GLfloat(j)*(2.0f*pi)/GLfloat(numStrips);
 		GLfloat x=cosf(lng);
 		GLfloat y=sinf(lng);
-		glNormal3f(x,y,0.0f);
-		glVertex3f(x*radius,y*radius,h);
-		glVertex3f(x*radius,y*radius,-h);
+		writer.normal(x,y,0.0f);
+		writer.vertex(x*radius,y*radius,h);
+		writer.vertex(x*radius,y*radius,-h);
 		}
-	glEnd();
+	writer.end();
 	
 	/* Draw top circle: */
-	glBegin(GL_TRIANGLE_FAN);
-	glNormal3f(0.0f,0.0f,1.0f);
-	glVertex3f(0.0f,0.0f,h);
+	writer.begin(GL_TRIANGLE_FAN);
+	writer.normal(0.0f,0.0f,1.0f);
+	writer.vertex(0.0f,0.0f,h);
 	for(int j=0;j<=numStrips;++j)
 		{
 		GLfloat lng=GLfloat(j)*(2.0f*pi)/GLfloat(numStrips);
 		GLfloat x=cosf(lng);
 		GLfloat y=sinf(lng);
-		glVertex3f(x*radius,y*radius,h);
+		writer.vertex(x*radius,y*radius,h);
 		}
-	glEnd();
+	writer.end();
 	}
 
-void glDrawCone(GLfloat radius,GLfloat height,GLsizei numStrips)
+void glDrawCylinder(GLfloat radius,GLfloat height,GLsizei numStrips)
+	{
+	ImmediateModelWriter writer;
+	writeCylinder(radius,height,numStrips,writer);
+	}
+
+void glGenerateCylinder(GLfloat radius,GLfloat height,GLsizei numStrips,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles)
+	{
+	TriangleModelWriter writer(vertices,triangles);
+	writeCylinder(radius,height,numStrips,writer);
+	}
+
+template <class ModelWriterParam>
+inline void writeCone(GLfloat radius,GLfloat height,GLsizei numStrips,ModelWriterParam& writer)
 	{
 	const GLfloat pi=GLfloat(M_PI);
 	
@@ -411,33 +596,46 @@ void glDrawCone(GLfloat radius,GLfloat height,GLsizei numStrips)
 	zn*=rn;
 	
 	/* Draw bottom circle: */
-	glBegin(GL_TRIANGLE_FAN);
-	glNormal3f(0.0f,0.0f,-1.0f);
-	glVertex3f(0.0f,0.0f,z0);
+	writer.begin(GL_TRIANGLE_FAN);
+	writer.normal(0.0f,0.0f,-1.0f);
+	writer.vertex(0.0f,0.0f,z0);
 	for(int j=numStrips;j>=0;--j)
 		{
 		GLfloat lng=GLfloat(j)*(2.0f*pi)/GLfloat(numStrips);
 		GLfloat x=cosf(lng);
 		GLfloat y=sinf(lng);
-		glVertex3f(x*radius,y*radius,z0);
+		writer.vertex(x*radius,y*radius,z0);
 		}
-	glEnd();
+	writer.end();
 	
 	/* Draw mantle: */
-	glBegin(GL_QUAD_STRIP);
+	writer.begin(GL_QUAD_STRIP);
 	for(int j=0;j<=numStrips;++j)
 		{
 		GLfloat lng=GLfloat(j)*(2.0f*pi)/GLfloat(numStrips);
 		GLfloat x=cosf(lng);
 		GLfloat y=sinf(lng);
-		glNormal3f(x*rn,y*rn,zn);
-		glVertex3f(0.0f,0.0f,z1);
-		glVertex3f(x*radius,y*radius,z0);
+		writer.normal(x*rn,y*rn,zn);
+		writer.vertex(0.0f,0.0f,z1);
+		writer.vertex(x*radius,y*radius,z0);
 		}
-	glEnd();
+	writer.end();
+	}
+
+void glDrawCone(GLfloat radius,GLfloat height,GLsizei numStrips)
+	{
+	ImmediateModelWriter writer;
+	writeCone(radius,height,numStrips,writer);
+	}
+
+void glGenerateCone(GLfloat radius,GLfloat height,GLsizei numStrips,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles)
+	{
+	TriangleModelWriter writer(vertices,triangles);
+	writeCone(radius,height,numStrips,writer);
 	}
 
-static void glDrawBox(const GLfloat center[3],const GLfloat halfSize[3],int sideMask)
+template <class ModelWriterParam>
+inline void writeBox(ModelWriterParam& writer,const GLfloat center[3],const GLfloat halfSize[3],int sideMask)
 	{
 	static const GLfloat vertices[8][3]={{-1.0f,-1.0f,-1.0f},{ 1.0f,-1.0f,-1.0f},{-1.0f, 1.0f,-1.0f},{ 1.0f, 1.0f,-1.0f},
 	                                     {-1.0f,-1.0f, 1.0f},{ 1.0f,-1.0f, 1.0f},{-1.0f, 1.0f, 1.0f},{ 1.0f, 1.0f, 1.0f}};
@@ -448,16 +646,17 @@ static void glDrawBox(const GLfloat center[3],const GLfloat halfSize[3],int side
 	for(int side=0;side<6;++side)
 		if(sideMask&(1<<side))
 			{
-			glNormal3fv(normals[side]);
+			writer.normal(normals[side]);
 			for(int i=0;i<4;++i)
 				{
 				const GLfloat* v=vertices[sides[side][i]];
-				glVertex3f(center[0]+v[0]*halfSize[0],center[1]+v[1]*halfSize[1],center[2]+v[2]*halfSize[2]);
+				writer.vertex(center[0]+v[0]*halfSize[0],center[1]+v[1]*halfSize[1],center[2]+v[2]*halfSize[2]);
 				}
 			}
 	}
 
-void glDrawWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize)
+template <class ModelWriterParam>
+inline void writeWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize,ModelWriterParam& writer)
 	{
 	GLfloat cs=cubeSize*0.5f;
 	GLfloat es=edgeSize*0.5f;
@@ -465,7 +664,7 @@ void glDrawWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize)
 	GLfloat halfSize[3];
 	GLfloat center[3];
 	
-	glBegin(GL_QUADS);
+	writer.begin(GL_QUADS);
 	
 	/* Render box vertices: */
 	halfSize[0]=halfSize[1]=halfSize[2]=vs;
@@ -473,7 +672,7 @@ void glDrawWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize)
 		{
 		for(int i=0;i<3;++i)
 			center[i]=vertex&(1<<i)?cs:-cs;
-		glDrawBox(center,halfSize,0x3f);
+		writeBox(writer,center,halfSize,0x3f);
 		}
 	
 	/* Render box edges: */
@@ -486,11 +685,23 @@ void glDrawWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize)
 			center[dim]=0.0f;
 			for(int i=0;i<2;++i)
 				center[(i+dim+1)%3]=edge&(1<<i)?cs:-cs;
-			glDrawBox(center,halfSize,0x3f&~(0x3<<(dim*2)));
+			writeBox(writer,center,halfSize,0x3f&~(0x3<<(dim*2)));
 			}
 		}
 	
-	glEnd();
+	writer.end();
+	}
+
+void glDrawWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize)
+	{
+	ImmediateModelWriter writer;
+	writeWireframeCube(cubeSize,edgeSize,vertexSize,writer);
+	}
+
+void glGenerateWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles)
+	{
+	TriangleModelWriter writer(vertices,triangles);
+	writeWireframeCube(cubeSize,edgeSize,vertexSize,writer);
 	}
 
 void glDrawArrow(GLfloat shaftRadius,GLfloat tipRadius,GLfloat tipHeight,GLfloat totalHeight,GLsizei numStrips)
@@ -22,7 +22,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef GLMODELS_INCLUDED
 #define GLMODELS_INCLUDED
 
+#include <vector>
 #include <GL/gl.h>
+#include <GL/GLVertex.h>
+
+typedef GLVertex<void,0,void,0,GLfloat,GLfloat,3> GLModelVertex; // Type for vertices of models collected into indexed triangle lists
 
 void glDrawCube(GLfloat size);
 void glDrawBox(const GLfloat min[3],const GLfloat max[3]);
@@ -34,4 +38,11 @@ void glDrawCone(GLfloat radius,GLfloat height,GLsizei numStrips);
 void glDrawWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize);
 void glDrawArrow(GLfloat shaftRadius,GLfloat tipRadius,GLfloat tipHeight,GLfloat totalHeight,GLsizei numStrips);
 
+/* Functions to append the same models to vertex lists and triangle vertex index lists, for rendering from vertex arrays: */
+void glGenerateCube(GLfloat size,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles);
+void glGenerateSphereIcosahedron(GLfloat radius,GLsizei numStrips,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles);
+void glGenerateCylinder(GLfloat radius,GLfloat height,GLsizei numStrips,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles);
+void glGenerateCone(GLfloat radius,GLfloat height,GLsizei numStrips,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles);
+void glGenerateWireframeCube(GLfloat cubeSize,GLfloat edgeSize,GLfloat vertexSize,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles);
+
 #endif
@@ -41,6 +41,7 @@ void GLObject::init(void)
 	}
 
 GLObject::GLObject(bool autoInit)
+	:contextDataSlot(GLContextData::allocateSlot())
 	{
 	if(autoInit)
 		{
@@ -50,6 +51,7 @@ GLObject::GLObject(bool autoInit)
 	}
 
 GLObject::GLObject(const GLObject& source)
+	:contextDataSlot(GLContextData::allocateSlot())
 	{
 	/* Mark the object for context initialization: */
 	GLContextData::initThing(this);
@@ -58,5 +60,5 @@ GLObject::GLObject(const GLObject& source)
 GLObject::~GLObject(void)
 	{
 	/* Mark the object's context data item for destruction: */
-	GLContextData::destroyThing(this);
+	GLContextData::destroyThing(this,contextDataSlot);
 	}
@@ -28,6 +28,8 @@ class GLContextData;
 
 class GLObject
 	{
+	friend class GLContextData;
+	
 	/* Embedded classes: */
 	public:
 	struct DataItem // Base class for context data items
@@ -39,6 +41,10 @@ class GLObject
 			}
 		};
 	
+	/* Elements: */
+	private:
+	unsigned int contextDataSlot; // Unique index under which the object's data items are stored in every OpenGL context
+	
 	/* Protected methods: */
 	protected:
 	void dependsOn(const GLObject* thing) const; // Method declaring that this GLObject depends on another GLObject being initialized before it in every context
@@ -48,6 +54,10 @@ class GLObject
 	public:
 	GLObject(bool autoInit =true); // Marks the object for context initialization if the given flag is true; otherwise, init() method must be called at some later point
 	GLObject(const GLObject& source); // Copy constructor
+	GLObject& operator=(const GLObject& source) // Assignment operator; keeps the object's context data slot
+		{
+		return *this;
+		}
 	virtual ~GLObject(void); // Destroys the object and its associated context data item
 	
 	/* Methods: */
@@ -38,7 +38,8 @@ Methods of class GLThingManager:
 GLThingManager::GLThingManager(void)
 	:active(true),
 	 firstNewAction(0),lastNewAction(0),
-	 firstProcessAction(0)
+	 firstProcessAction(0),
+	 numSlots(0)
 	{
 	}
 
@@ -86,6 +87,22 @@ void GLThingManager::shutdown(void)
 	}
 	}
 
+unsigned int GLThingManager::allocateSlot(void)
+	{
+	Threads::Mutex::Lock slotLock(slotMutex);
+	
+	/* Reuse a released slot if there is one: */
+	if(!freeSlots.empty())
+		{
+		unsigned int result=freeSlots.back();
+		freeSlots.pop_back();
+		return result;
+		}
+	
+	/* Hand out a new slot: */
+	return numSlots++;
+	}
+
 void GLThingManager::initThing(const GLObject* thing)
 	{
 	{
@@ -95,6 +112,7 @@ void GLThingManager::initThing(const GLObject* thing)
 		/* Append the new thing action to the new action list: */
 		ThingAction* newAction=new ThingAction;
 		newAction->thing=thing;
+		newAction->slot=0;
 		newAction->action=ThingAction::INIT;
 		newAction->succ=0;
 		if(lastNewAction!=0)
@@ -106,7 +124,7 @@ void GLThingManager::initThing(const GLObject* thing)
 	}
 	}
 
-void GLThingManager::destroyThing(const GLObject* thing)
+void GLThingManager::destroyThing(const GLObject* thing,unsigned int slot)
 	{
 	Threads::Mutex::Lock newActionLock(newActionMutex);
 	if(active)
@@ -120,20 +138,16 @@ void GLThingManager::destroyThing(const GLObject* thing)
 		
 		if(taPtr2!=0)
 			{
-			/* Thing has pending initialization; remove it: */
-			if(taPtr1!=0)
-				taPtr1->succ=taPtr2->succ;
-			else
-				firstNewAction=taPtr2->succ;
-			if(taPtr2->succ==0)
-				lastNewAction=taPtr1;
-			delete taPtr2;
+			/* Thing has pending initialization; replace it with a destruction action to release the thing's slot: */
+			taPtr2->slot=slot;
+			taPtr2->action=ThingAction::DESTROY;
 			}
 		else
 			{
 			/* Append a destruction action to the list: */
 			ThingAction* newAction=new ThingAction;
 			newAction->thing=thing;
+			newAction->slot=slot;
 			newAction->action=ThingAction::DESTROY;
 			newAction->succ=0;
 			if(lastNewAction!=0)
@@ -186,12 +200,19 @@ void GLThingManager::orderThings(const GLObject* thing1,const GLObject* thing2)
 void GLThingManager::processActions(void)
 	{
 	/* Delete the old process list: */
+	{
+	Threads::Mutex::Lock slotLock(slotMutex);
 	while(firstProcessAction!=0)
 		{
+		/* Release the slot of a destroyed thing, whose data items have been removed from all contexts: */
+		if(firstProcessAction->action==ThingAction::DESTROY)
+			freeSlots.push_back(firstProcessAction->slot);
+		
 		ThingAction* succ=firstProcessAction->succ;
 		delete firstProcessAction;
 		firstProcessAction=succ;
 		}
+	}
 	
 	/* Move the new action list to the process list: */
 	{
@@ -214,8 +235,8 @@ void GLThingManager::updateThings(GLContextData& contextData) const
 			}
 		else
 			{
-			/* Delete the context data item associated with the thing: */
-			contextData.removeDataItem(taPtr->thing);
+			/* Delete the context data item associated with the thing's slot: */
+			contextData.removeSlot(taPtr->slot);
 			}
 		}
 	}
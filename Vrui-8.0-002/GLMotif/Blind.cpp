@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/Blind.h>
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -45,6 +46,12 @@ Vector Blind::calcNaturalSize(void) const
 	return calcExteriorSize(preferredSize);
 	}
 
+bool Blind::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(Blind);
+	}
+
 void Blind::draw(GLContextData& contextData) const
 	{
 	/* Draw the parent class widget: */
@@ -38,6 +38,7 @@ class Blind:public Widget
 	
 	/* Methods inherited from Widget: */
 	virtual Vector calcNaturalSize(void) const;
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	
 	/* New methods: */
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/Button.h>
 
+#include <typeinfo>
 #include <GLMotif/StyleSheet.h>
 #include <GLMotif/Event.h>
 #include <GLMotif/Container.h>
@@ -185,6 +186,12 @@ void Button::setBackgroundColor(const Color& newBackgroundColor)
 		}
 	}
 
+bool Button::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a button can be cached, as arming changes its border type and background color via update(): */
+	return typeid(*this)==typeid(Button);
+	}
+
 void Button::setArmedBackgroundColor(const Color& newArmedBackgroundColor)
 	{
 	/* Store the new armed color: */
@@ -93,6 +93,7 @@ class Button:public Label
 	virtual void pointerMotion(Event& event);
 	virtual void setBorderType(BorderType newBorderType);
 	virtual void setBackgroundColor(const Color& newBackgroundColor);
+	virtual bool isCacheable(void) const;
 	
 	/* New methods: */
 	const Color& getArmedBackgroundColor(void) const // Returns the background color used when the button is armed
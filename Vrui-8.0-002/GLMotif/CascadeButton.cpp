@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/CascadeButton.h>
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLNormalTemplates.h>
@@ -168,6 +169,9 @@ void CascadeButton::setBackgroundColor(const Color& newBackgroundColor)
 	
 	/* Let the arrow glyph track the background color: */
 	arrow.setGlyphColor(newBackgroundColor);
+	
+	/* Invalidate the visual representation, as the base class method does not while the button is armed: */
+	update();
 	}
 
 void CascadeButton::updateVariables(void)
@@ -177,6 +181,12 @@ void CascadeButton::updateVariables(void)
 		popup->updateVariables();
 	}
 
+bool CascadeButton::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a cascade button can be cached, as its popup is drawn as a separate top level widget: */
+	return typeid(*this)==typeid(CascadeButton);
+	}
+
 bool CascadeButton::findRecipient(Event& event)
 	{
 	foundWidget=0;
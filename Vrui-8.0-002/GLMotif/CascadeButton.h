@@ -62,6 +62,7 @@ class CascadeButton:public DecoratedButton
 	virtual void resize(const Box& newExterior);
 	virtual void setBackgroundColor(const Color& newBackgroundColor);
 	virtual void updateVariables(void);
+	virtual bool isCacheable(void) const;
 	virtual bool findRecipient(Event& event);
 	virtual void pointerButtonDown(Event& event);
 	virtual void pointerButtonUp(Event& event);
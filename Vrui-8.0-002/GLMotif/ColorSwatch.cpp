@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/ColorSwatch.h>
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -46,6 +47,12 @@ Vector ColorSwatch::calcNaturalSize(void) const
 	return calcExteriorSize(preferredSize);
 	}
 
+bool ColorSwatch::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(ColorSwatch);
+	}
+
 void ColorSwatch::draw(GLContextData& contextData) const
 	{
 	/* Draw the parent class widget: */
@@ -39,6 +39,7 @@ class ColorSwatch:public Widget
 	
 	/* Methods inherited from Widget: */
 	virtual Vector calcNaturalSize(void) const;
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	
 	/* New methods: */
@@ -47,6 +47,16 @@ void Container::updateVariables(void)
 		child->updateVariables();
 	}
 
+bool Container::areChildrenCacheable(void) const
+	{
+	/* Check if all children can be cached: */
+	Container* self=const_cast<Container*>(this); // Child traversal methods are not const
+	Widget* child;
+	for(child=self->getFirstChild();child!=0&&child->isCacheable();child=self->getNextChild(child))
+		;
+	return child==0;
+	}
+
 Widget* Container::findChild(const char* childName)
 	{
 	/* Traverse all children in the container until the first name matches: */
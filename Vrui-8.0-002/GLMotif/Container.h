@@ -39,6 +39,7 @@ class Container:public Widget
 			delete child;
 			}
 		}
+	bool areChildrenCacheable(void) const; // Returns true if all of the container's children can be cached; for use by derived classes' isCacheable methods
 	
 	/* Constructors and destructors: */
 	public:
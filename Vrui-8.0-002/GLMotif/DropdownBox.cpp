@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GLMotif/DropdownBox.h>
 
 #include <stdio.h>
+#include <typeinfo>
 #include <Math/Math.h>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
@@ -271,6 +272,12 @@ void DropdownBox::updateVariables(void)
 		}
 	}
 
+bool DropdownBox::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a dropdown box can be cached, as its item list is drawn as a separate top level widget: */
+	return typeid(*this)==typeid(DropdownBox);
+	}
+
 void DropdownBox::draw(GLContextData& contextData) const
 	{
 	/* Draw the base class widget: */
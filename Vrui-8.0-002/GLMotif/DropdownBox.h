@@ -114,6 +114,7 @@ class DropdownBox:public Label,public VariableTracker
 	virtual void resize(const Box& newExterior);
 	virtual void setBackgroundColor(const Color& newBackgroundColor);
 	virtual void updateVariables(void);
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	virtual bool findRecipient(Event& event);
 	virtual void pointerButtonDown(Event& event);
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/Glyph.h>
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GLMotif/StyleSheet.h>
@@ -87,6 +88,12 @@ void Glyph::setForegroundColor(const Color& newForegroundColor)
 	update();
 	}
 
+bool Glyph::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(Glyph);
+	}
+
 void Glyph::draw(GLContextData& contextData) const
 	{
 	/* Draw the glyph: */
@@ -42,6 +42,7 @@ class Glyph:public Widget
 	virtual ZRange calcZRange(void) const;
 	virtual void resize(const Box& newExterior);
 	virtual void setForegroundColor(const Color& newForegroundColor);
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	
 	/* New methods: */
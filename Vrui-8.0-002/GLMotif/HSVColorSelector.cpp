@@ -586,6 +586,9 @@ void HSVColorSelector::setIndicatorSize(GLfloat newIndicatorSize)
 	{
 	/* Set the new indicator size: */
 	indicatorSize=newIndicatorSize;
+	
+	/* Invalidate the visual representation: */
+	update();
 	}
 
 Color HSVColorSelector::getCurrentColor(void) const
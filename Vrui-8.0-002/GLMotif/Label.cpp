@@ -20,6 +20,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
 #include <string.h>
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -247,6 +248,12 @@ void Label::setForegroundColor(const Color& newForegroundColor)
 	updateColors();
 	}
 
+bool Label::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(Label);
+	}
+
 void Label::draw(GLContextData& contextData) const
 	{
 	/* Draw parent class decorations: */
@@ -57,6 +57,7 @@ class Label:public Widget
 	virtual void resize(const Box& newExterior);
 	virtual void setBackgroundColor(const Color& newBackgroundColor);
 	virtual void setForegroundColor(const Color& newForegroundColor);
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	virtual void setEnabled(bool newEnabled);
 	
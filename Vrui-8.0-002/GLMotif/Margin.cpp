@@ -20,6 +20,7 @@ with the GLMotif Widget Library; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -106,6 +107,12 @@ Margin::Margin(const char* sName,Container* sParent,bool sManageChild)
 		manageChild();
 	}
 
+bool Margin::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a margin can be cached if its child can be cached: */
+	return typeid(*this)==typeid(Margin)&&areChildrenCacheable();
+	}
+
 void Margin::draw(GLContextData& contextData) const
 	{
 	/* Draw the grandparent class widget: */
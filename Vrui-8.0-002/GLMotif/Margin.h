@@ -44,6 +44,7 @@ class Margin:public SingleChildContainer
 	Margin(const char* sName,Container* sParent,bool manageChild =true);
 	
 	/* Methods inherited from Widget: */
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	
 	/* New methods: */
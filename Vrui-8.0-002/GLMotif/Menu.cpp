@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GLMotif/Menu.h>
 
 #include <stdio.h>
+#include <typeinfo>
 #include <GLMotif/StyleSheet.h>
 #include <GLMotif/Event.h>
 #include <GLMotif/WidgetManager.h>
@@ -129,6 +130,12 @@ void Menu::pointerMotion(Event& event)
 
 #endif
 
+bool Menu::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a menu can be cached if all its entries can be cached: */
+	return typeid(*this)==typeid(Menu)&&areChildrenCacheable();
+	}
+
 void Menu::addChild(Widget* newChild)
 	{
 	/* Get the style sheet: */
@@ -84,6 +84,9 @@ class Menu:public RowColumn
 	
 	#endif
 	
+	/* Methods inherited from Widget: */
+	virtual bool isCacheable(void) const;
+	
 	/* Methods inherited from Container: */
 	virtual void addChild(Widget* newChild);
 	
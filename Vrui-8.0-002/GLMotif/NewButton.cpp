@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/NewButton.h>
 
+#include <typeinfo>
 #include <GLMotif/StyleSheet.h>
 #include <GLMotif/Event.h>
 #include <GLMotif/Blind.h>
@@ -244,6 +245,12 @@ void NewButton::setBackgroundColor(const Color& newBackgroundColor)
 		}
 	}
 
+bool NewButton::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a button can be cached if its child can be cached, as arming changes its background color via update(): */
+	return typeid(*this)==typeid(NewButton)&&areChildrenCacheable();
+	}
+
 void NewButton::addChild(Widget* newChild)
 	{
 	/* Children of buttons default to no border: */
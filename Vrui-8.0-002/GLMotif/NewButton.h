@@ -97,6 +97,7 @@ class NewButton:public SingleChildContainer
 	virtual void setBorderType(BorderType newBorderType);
 	virtual void setForegroundColor(const Color& newForegroundColor);
 	virtual void setBackgroundColor(const Color& newBackgroundColor);
+	virtual bool isCacheable(void) const;
 	
 	/* Methods inherited from Container: */
 	virtual void addChild(Widget* newChild);
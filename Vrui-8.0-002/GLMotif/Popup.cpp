@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/Popup.h>
 
+#include <typeinfo>
 #include <Math/Math.h>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
@@ -161,6 +162,12 @@ void Popup::resize(const Box& newExterior)
 	Container::resize(newExterior);
 	}
 
+bool Popup::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a popup can be cached if its title and its child can be cached: */
+	return typeid(*this)==typeid(Popup)&&(title==0||title->isCacheable())&&areChildrenCacheable();
+	}
+
 void Popup::draw(GLContextData& contextData) const
 	{
 	/* Draw the parent class widget: */
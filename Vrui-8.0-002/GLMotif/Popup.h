@@ -58,6 +58,7 @@ class Popup:public SingleChildContainer
 	virtual Vector calcNaturalSize(void) const;
 	virtual ZRange calcZRange(void) const;
 	virtual void resize(const Box& newExterior);
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	
 	/* Methods from class Container: */
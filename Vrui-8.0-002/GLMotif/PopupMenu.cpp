@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GLMotif/PopupMenu.h>
 
 #include <stdio.h>
+#include <typeinfo>
 #include <GLMotif/StyleSheet.h>
 #include <GLMotif/Event.h>
 #include <GLMotif/RowColumn.h>
@@ -72,6 +73,12 @@ Vector PopupMenu::calcHotSpot(void) const
 	return result;
 	}
 
+bool PopupMenu::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a popup menu can be cached if its title and its menu can be cached: */
+	return typeid(*this)==typeid(PopupMenu)&&(title==0||title->isCacheable())&&areChildrenCacheable();
+	}
+
 bool PopupMenu::findRecipient(Event& event)
 	{
 	foundButton=armedButton;
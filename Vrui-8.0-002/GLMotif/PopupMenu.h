@@ -52,6 +52,7 @@ class PopupMenu:public Popup
 	
 	/* Methods inherited from Widget: */
 	virtual Vector calcHotSpot(void) const;
+	virtual bool isCacheable(void) const;
 	virtual bool findRecipient(Event& event);
 	virtual void pointerButtonDown(Event& event);
 	virtual void pointerButtonUp(Event& event);
@@ -22,12 +22,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/PopupWindow.h>
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
-#if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-#include <GL/GLContextData.h>
-#endif
 #include <GL/GLFont.h>
 #include <GLMotif/StyleSheet.h>
 #include <GLMotif/Event.h>
@@ -64,9 +62,6 @@ PopupWindow::PopupWindow(const char* sName,WidgetManager* sManager,const char* s
 	 resizableMask(0x3),
 	 childBorderWidth(0.0f),
 	 isResizing(false)
-	 #if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-	 ,version(1)
-	 #endif
 	{
 	/* Get the style sheet: */
 	const StyleSheet* ss=manager->getStyleSheet();
@@ -94,9 +89,6 @@ PopupWindow::PopupWindow(const char* sName,WidgetManager* sManager,const char* s
 	 resizableMask(0x3),
 	 childBorderWidth(0.0f),
 	 isResizing(false)
-	 #if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-	 ,version(1)
-	 #endif
 	{
 	/* Get the style sheet: */
 	const StyleSheet* ss=manager->getStyleSheet();
@@ -273,38 +265,14 @@ Vector PopupWindow::calcHotSpot(void) const
 	return titleBar->calcHotSpot();
 	}
 
-#if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-
-void PopupWindow::update(void)
+bool PopupWindow::isCacheable(void) const
 	{
-	/* Increment the visual representation's version number: */
-	++version;
+	/* Derived classes have to opt in on their own; otherwise, a popup window can be cached if its title bar, buttons, and child can be cached: */
+	return typeid(*this)==typeid(PopupWindow)&&titleBar->isCacheable()&&(hideButton==0||hideButton->isCacheable())&&(closeButton==0||closeButton->isCacheable())&&areChildrenCacheable();
 	}
 
-#endif
-
 void PopupWindow::draw(GLContextData& contextData) const
 	{
-	#if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-	/* Retrieve the data item: */
-	DataItem* dataItem=contextData.retrieveDataItem<DataItem>(this);
-	
-	/* Check if the display list's contents are current: */
-	if(dataItem->version==version)
-		{
-		/* Render the geometry stored in the display list: */
-		glCallList(dataItem->displayListId);
-		
-		/* Bail out: */
-		return;
-		}
-	else
-		{
-		/* Cache the popup window's visual representation into the display list: */
-		glNewList(dataItem->displayListId,GL_COMPILE_AND_EXECUTE);
-		}
-	#endif
-	
 	/* Draw the popup window's back side: */
 	Box back=getExterior().offset(Vector(0.0,0.0,getZRange().first));
 	glColor(borderColor);
@@ -391,17 +359,6 @@ void PopupWindow::draw(GLContextData& contextData) const
 	/* Draw the child: */
 	if(child!=0)
 		child->draw(contextData);
-	
-	#if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-	if(dataItem->version!=version)
-		{
-		/* Finish caching the popup window's visual representation: */
-		glEndList();
-		
-		/* Mark the display list as up-to-date: */
-		dataItem->version=version;
-		}
-	#endif
 	}
 
 bool PopupWindow::findRecipient(Event& event)
@@ -622,17 +579,6 @@ void PopupWindow::requestResize(Widget* requestChild,const Vector& newExteriorSi
 		}
 	}
 
-#if GLMOTIF_POPUPWINDOW_USE_RENDERCACHE
-
-void PopupWindow::initContext(GLContextData& contextData) const
-	{
-	/* Create a data item and store it in the OpenGL context: */
-	DataItem* dataItem=new DataItem;
-	contextData.addDataItem(this,dataItem);
-	}
-
-#endif
-
 void PopupWindow::setTitleBorderWidth(GLfloat newTitleBorderWidth)
 	{
 	/* Set border width of the title bar: */
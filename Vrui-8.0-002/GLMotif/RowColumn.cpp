@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/RowColumn.h>
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -345,6 +346,12 @@ void RowColumn::updateVariables(void)
 		(*cIt)->updateVariables();
 	}
 
+bool RowColumn::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a row/column container can be cached if all its children can be cached: */
+	return typeid(*this)==typeid(RowColumn)&&areChildrenCacheable();
+	}
+
 void RowColumn::draw(GLContextData& contextData) const
 	{
 	/* Draw the parent class widget: */
@@ -85,6 +85,7 @@ class RowColumn:public Container
 	virtual ZRange calcZRange(void) const;
 	virtual void resize(const Box& newExterior);
 	virtual void updateVariables(void);
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	virtual bool findRecipient(Event& event);
 	
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/ScrollBar.h>
 
+#include <typeinfo>
 #include <Misc/Utility.h>
 #include <Math/Math.h>
 #include <GL/gl.h>
@@ -260,6 +261,12 @@ void ScrollBar::setBackgroundColor(const Color& newBackgroundColor)
 		arrows[i].setGlyphColor(newBackgroundColor);
 	}
 
+bool ScrollBar::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(ScrollBar);
+	}
+
 void ScrollBar::draw(GLContextData& contextData) const
 	{
 	/* Draw parent class decorations: */
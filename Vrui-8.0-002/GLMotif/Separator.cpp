@@ -20,6 +20,7 @@ with the GLMotif Widget Library; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -125,6 +126,12 @@ void Separator::resize(const Box& newExterior)
 		}
 	}
 
+bool Separator::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(Separator);
+	}
+
 void Separator::draw(GLContextData& contextData) const
 	{
 	/* Draw the parent class widget: */
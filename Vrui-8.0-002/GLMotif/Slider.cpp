@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <GLMotif/Slider.h>
 
+#include <typeinfo>
 #include <Math/Math.h>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
@@ -329,6 +330,12 @@ void Slider::updateVariables(void)
 		}
 	}
 
+bool Slider::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(Slider);
+	}
+
 void Slider::draw(GLContextData& contextData) const
 	{
 	/* Draw parent class decorations: */
@@ -988,6 +995,9 @@ void Slider::addNotch(double newNotchValue)
 	
 	/* Update the notch positions: */
 	positionNotches();
+	
+	/* Invalidate the visual representation: */
+	update();
 	}
 
 void Slider::removeNotch(double notchValue)
@@ -1003,6 +1013,9 @@ void Slider::removeNotch(double notchValue)
 	
 	/* Update the notch positions: */
 	positionNotches();
+	
+	/* Invalidate the visual representation: */
+	update();
 	}
 
 void Slider::setValue(double newValue)
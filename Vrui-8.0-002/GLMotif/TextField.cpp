@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <string>
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -195,6 +196,12 @@ void TextField::updateVariables(void)
 		}
 	}
 
+bool TextField::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a text field can be cached, as editing, selection, and focus changes call update(): */
+	return typeid(*this)==typeid(TextField);
+	}
+
 void TextField::draw(GLContextData& contextData) const
 	{
 	if(editable&&focus)
@@ -651,6 +658,9 @@ void TextField::setEditable(bool newEditable)
 	{
 	/* Set the text field's editable flag: */
 	editable=newEditable;
+	
+	/* Invalidate the visual representation, as a focused text field draws its cursor only while editable: */
+	update();
 	}
 
 void TextField::setSelection(int newAnchorPos,int newCursorPos)
@@ -105,6 +105,7 @@ class TextField:public Label,public VariableTracker
 	virtual Vector calcNaturalSize(void) const;
 	virtual void resize(const Box& newExterior);
 	virtual void updateVariables(void);
+	virtual bool isCacheable(void) const;
 	virtual void draw(GLContextData& contextData) const;
 	virtual void pointerButtonDown(Event& event);
 	virtual void pointerButtonUp(Event& event);
@@ -22,6 +22,7 @@ with the GLMotif Widget Library; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
+#include <typeinfo>
 #include <GLMotif/StyleSheet.h>
 
 #include <GLMotif/TitleBar.h>
@@ -76,4 +77,10 @@ TitleBar::TitleBar(const char* sName,Container* sParent,const char* sLabel,bool
 		manageChild();
 	}
 
+bool TitleBar::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own: */
+	return typeid(*this)==typeid(TitleBar);
+	}
+
 }
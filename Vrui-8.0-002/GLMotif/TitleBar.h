@@ -36,6 +36,9 @@ class TitleBar:public Label,public Draggable
 	public:
 	TitleBar(const char* sName,Container* sParent,const char* sLabel,const GLFont* sFont,bool manageChild =true); // Deprecated
 	TitleBar(const char* sName,Container* sParent,const char* sLabel,bool manageChild =true);
+	
+	/* Methods from class Widget: */
+	virtual bool isCacheable(void) const;
 	};
 
 }
@@ -19,6 +19,7 @@ with the GLMotif Widget Library; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
+#include <typeinfo>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
 #include <GL/GLVertexTemplates.h>
@@ -194,6 +195,9 @@ void ToggleButton::setSet(bool newSet)
 		for(int i=0;i<4;++i)
 			toggleInner[i][2]=decorationBox.origin[2]+toggleBorderWidth;
 		}
+	
+	/* Invalidate the visual representation: */
+	update();
 	}
 
 ToggleButton::ToggleButton(const char* sName,Container* sParent,const char* sLabel,const GLFont* sFont,bool sManageChild)
@@ -276,6 +280,12 @@ void ToggleButton::updateVariables(void)
 		}
 	}
 
+bool ToggleButton::isCacheable(void) const
+	{
+	/* Derived classes have to opt in on their own; otherwise, a toggle button can be cached, as setting and arming the toggle call update(): */
+	return typeid(*this)==typeid(ToggleButton);
+	}
+
 void ToggleButton::setToggleType(ToggleButton::ToggleType newToggleType)
 	{
 	toggleType=newToggleType;
@@ -83,6 +83,7 @@ class ToggleButton:public DecoratedButton,public VariableTracker
 	virtual ZRange calcZRange(void) const;
 	virtual void resize(const Box& newExterior);
 	virtual void updateVariables(void);
+	virtual bool isCacheable(void) const;
 	
 	/* Methods from class VariableTracker: */
 	template <class VariableTypeParam>
@@ -107,6 +108,9 @@ class ToggleButton:public DecoratedButton,public VariableTracker
 	void setToggleColor(const Color& newToggleColor)
 		{
 		toggleColor=newToggleColor;
+		
+		/* Invalidate the visual representation: */
+		update();
 		}
 	void setToggle(bool newSet)
 		{
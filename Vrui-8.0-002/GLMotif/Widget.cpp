@@ -268,11 +268,27 @@ void Widget::updateVariables(void)
 
 void Widget::update(void)
 	{
-	if(parent!=0&&isManaged)
+	if(parent!=0)
 		{
-		/* Notify the parent widget of the update: */
-		parent->update();
+		if(isManaged)
+			{
+			/* Notify the parent widget of the update: */
+			parent->update();
+			}
 		}
+	else
+		{
+		/* Notify the widget manager that a top level widget changed: */
+		WidgetManager* manager=getManager();
+		if(manager!=0)
+			manager->updateWidget(this);
+		}
+	}
+
+bool Widget::isCacheable(void) const
+	{
+	/* Derived widget classes have to declare that they report all visual changes: */
+	return false;
 	}
 
 void Widget::draw(GLContextData&) const
@@ -140,6 +140,7 @@ class Widget
 	virtual void setForegroundColor(const Color& newForegroundColor); // Changes a widget's foreground color
 	virtual void updateVariables(void); // Method to ask a widget and/or its children to update their internal state to that of potentially tracked variables
 	virtual void update(void); // Method called whenever a widget changes its visual representation, to facilitate render caching
+	virtual bool isCacheable(void) const; // Returns true if the widget calls update() on every change to its visual representation, and its rendering can therefore be cached; classes opt in individually, and do not pass the opt-in on to derived classes
 	virtual void draw(GLContextData& contextData) const; // Draws the widget
 	
 	/* User interaction events: */
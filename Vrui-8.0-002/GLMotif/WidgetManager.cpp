@@ -25,6 +25,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <string.h>
 #include <Math/Constants.h>
 #include <GL/gl.h>
+#include <GL/GLContextData.h>
+#include <GL/GLLightTracker.h>
 #include <GL/GLLabel.h>
 #include <GL/GLTransformationWrappers.h>
 #include <GLMotif/WidgetArranger.h>
@@ -41,7 +43,8 @@ Methods of class WidgetManager::PopupBinding:
 
 WidgetManager::PopupBinding::PopupBinding(Widget* sTopLevelWidget,const WidgetManager::Transformation& sWidgetToWorld,WidgetManager::PopupBinding* sParent,WidgetManager::PopupBinding* sSucc)
 	:topLevelWidget(sTopLevelWidget),widgetToWorld(sWidgetToWorld),visible(true),
-	 parent(sParent),pred(0),succ(sSucc),firstSecondary(0)
+	 parent(sParent),pred(0),succ(sSucc),firstSecondary(0),
+	 version(1)
 	{
 	}
 
@@ -141,6 +144,14 @@ WidgetManager::PopupBinding* WidgetManager::PopupBinding::findTopLevelWidget(con
 	return foundBinding;
 	}
 
+void WidgetManager::PopupBinding::drawTopLevelWidget(GLContextData& contextData) const
+	{
+	/* Draw the top level widget and render all its labels in batches: */
+	GLLabel::DeferredRenderer dr(contextData);
+	topLevelWidget->draw(contextData);
+	dr.draw();
+	}
+
 void WidgetManager::PopupBinding::draw(bool overlayWidgets,GLContextData& contextData) const
 	{
 	if(visible)
@@ -154,12 +165,48 @@ void WidgetManager::PopupBinding::draw(bool overlayWidgets,GLContextData& contex
 		for(PopupBinding* bPtr=firstSecondary;bPtr!=0;bPtr=bPtr->succ)
 			bPtr->draw(overlayWidgets,contextData);
 		
-		/* Draw the top level widget: */
-		{
-		GLLabel::DeferredRenderer dr(contextData);
-		topLevelWidget->draw(contextData);
-		dr.draw();
-		}
+		/* Retrieve the context data item; it does not exist yet if the binding was created during the current frame: */
+		DataItem* dataItem=contextData.retrieveDataItem<DataItem>(this);
+		bool lightingEnabled=contextData.getLightTracker()->isLightingEnabled();
+		
+		/* Check if the display list holds the top level widget's current visual representation: */
+		bool cached=dataItem!=0&&dataItem->cachedVersion==version&&dataItem->cachedLightingEnabled==lightingEnabled;
+		if(cached)
+			{
+			/* Render the cached geometry: */
+			glCallList(dataItem->displayListId);
+			}
+		else if(dataItem!=0&&dataItem->cachedVersion!=version&&dataItem->drawnVersion==version&&dataItem->drawnCacheable)
+			{
+			/*****************************************************************
+			The top level widget did not change since the previous frame, and
+			all its per-context state has been initialized by now; cache its
+			visual representation. Draw it directly first, so that any pending
+			texture uploads, e.g., of label textures or of a font's glyph
+			atlas, are executed now instead of being recorded into the display
+			list:
+			*****************************************************************/
+			
+			drawTopLevelWidget(contextData);
+			glNewList(dataItem->displayListId,GL_COMPILE);
+			drawTopLevelWidget(contextData);
+			glEndList();
+			dataItem->cachedVersion=version;
+			dataItem->cachedLightingEnabled=lightingEnabled;
+			cached=true;
+			}
+		else
+			{
+			if(dataItem!=0&&dataItem->drawnVersion!=version)
+				{
+				/* Remember the new visual representation, and check once whether the widget tree reports all its changes: */
+				dataItem->drawnVersion=version;
+				dataItem->drawnCacheable=topLevelWidget->isCacheable();
+				}
+			
+			/* Draw the top level widget directly while it is changing: */
+			drawTopLevelWidget(contextData);
+			}
 		
 		if(overlayWidgets)
 			{
@@ -170,11 +217,10 @@ void WidgetManager::PopupBinding::draw(bool overlayWidgets,GLContextData& contex
 			GLboolean colorMask[4];
 			glGetBooleanv(GL_COLOR_WRITEMASK,colorMask);
 			glColorMask(GL_FALSE,GL_FALSE,GL_FALSE,GL_FALSE);
-			{
-			GLLabel::DeferredRenderer dr(contextData);
-			topLevelWidget->draw(contextData);
-			dr.draw();
-			}
+			if(cached)
+				glCallList(dataItem->displayListId);
+			else
+				drawTopLevelWidget(contextData);
 			glColorMask(colorMask[0],colorMask[1],colorMask[2],colorMask[3]);
 			glDepthRange(depthRange[0],depthRange[1]);
 			}
@@ -183,6 +229,13 @@ void WidgetManager::PopupBinding::draw(bool overlayWidgets,GLContextData& contex
 		}
 	}
 
+void WidgetManager::PopupBinding::initContext(GLContextData& contextData) const
+	{
+	/* Create a data item and store it in the OpenGL context: */
+	DataItem* dataItem=new DataItem;
+	contextData.addDataItem(this,dataItem);
+	}
+
 /******************************
 Methods of class WidgetManager:
 ******************************/
@@ -376,6 +429,14 @@ void WidgetManager::unmanageWidget(Widget* widget)
 		}
 	}
 
+void WidgetManager::updateWidget(Widget* topLevelWidget)
+	{
+	/* Invalidate the cached visual representation of the widget if it is popped up: */
+	PopupBindingMap::Iterator pbmIt=popupBindingMap.findEntry(topLevelWidget);
+	if(!pbmIt.isFinished())
+		++pbmIt->getDest()->version;
+	}
+
 void WidgetManager::popupPrimaryWidget(Widget* topLevelWidget)
 	{
 	/* Pop up with a default widget transformation: */
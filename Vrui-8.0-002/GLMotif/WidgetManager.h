@@ -29,6 +29,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Misc/HashTable.h>
 #include <Misc/ThrowStdErr.h>
 #include <Geometry/OrthogonalTransformation.h>
+#include <GL/gl.h>
+#include <GL/GLObject.h>
 #include <GLMotif/Types.h>
 #include <GLMotif/WidgetAttribute.h>
 
@@ -99,10 +101,34 @@ class WidgetManager
 		};
 	
 	private:
-	struct PopupBinding // Structure to bind top level widgets
+	struct PopupBinding:public GLObject // Structure to bind top level widgets
 		{
-		/* Elements: */
+		/* Embedded classes: */
 		public:
+		struct DataItem:public GLObject::DataItem
+			{
+			/* Elements: */
+			public:
+			GLuint displayListId; // ID of display list caching the rendering of the top level widget
+			unsigned int drawnVersion; // Version number of the top level widget's visual representation drawn in the most recent frame
+			bool drawnCacheable; // Flag whether the top level widget's most recently drawn visual representation can be cached
+			unsigned int cachedVersion; // Version number of the top level widget's visual representation stored in the display list
+			bool cachedLightingEnabled; // Lighting state with which the display list was compiled
+			
+			/* Constructors and destructors: */
+			DataItem(void)
+				:displayListId(glGenLists(1)),
+				 drawnVersion(0),drawnCacheable(false),
+				 cachedVersion(0),cachedLightingEnabled(false)
+				{
+				}
+			virtual ~DataItem(void)
+				{
+				glDeleteLists(displayListId,1);
+				}
+			};
+		
+		/* Elements: */
 		Widget* topLevelWidget; // Pointer to top level widget
 		Transformation widgetToWorld; // Transformation from widget to world coordinates or owner widget's coordinates
 		bool visible; // Flag if top level widget should be drawn
@@ -110,6 +136,7 @@ class WidgetManager
 		PopupBinding* pred; // Pointer to previous binding in same hierarchy level
 		PopupBinding* succ; // Pointer to next binding in same hierarchy level
 		PopupBinding* firstSecondary; // Pointer to first secondary top level window
+		unsigned int version; // Version number of the top level widget's visual representation
 		
 		/* Constructors and destructors: */
 		PopupBinding(Widget* sTopLevelWidget,const Transformation& sWidgetToWorld,PopupBinding* sParent,PopupBinding* sSucc);
@@ -120,7 +147,11 @@ class WidgetManager
 		PopupBinding* getSucc(void); // Ditto
 		PopupBinding* findTopLevelWidget(const Point& point);
 		PopupBinding* findTopLevelWidget(const Ray& ray,Scalar& lambda);
+		void drawTopLevelWidget(GLContextData& contextData) const; // Draws the top level widget directly
 		void draw(bool overlayWidgets,GLContextData& contextData) const;
+		
+		/* Methods from class GLObject: */
+		virtual void initContext(GLContextData& contextData) const;
 		};
 	
 	typedef Misc::HashTable<const Widget*,PopupBinding*> PopupBindingMap; // Type to map top-level widgets to their popup bindings
@@ -289,6 +320,7 @@ class WidgetManager
 		return drawOverlayWidgets;
 		}
 	void unmanageWidget(Widget* widget); // Tells the widget manager that the given widget is about to be destroyed; only called from Widget's destructor
+	void updateWidget(Widget* topLevelWidget); // Tells the widget manager that the visual representation of the given top level widget changed; only called from Widget::update
 	template <class AttributeParam>
 	void setWidgetAttribute(const Widget* widget,const AttributeParam& attribute) // Associates an attribute of arbitrary type with a widget; deletes previous attribute
 		{
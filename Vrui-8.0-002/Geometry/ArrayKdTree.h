@@ -25,8 +25,10 @@ Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #ifndef GEOMETRY_ARRAYKDTREE_INCLUDED
 #define GEOMETRY_ARRAYKDTREE_INCLUDED
 
+#include <vector>
 #include <Geometry/Point.h>
 #include <Geometry/Box.h>
+#include <Math/Constants.h>
 #include <Geometry/ClosePointSet.h>
 
 #define GEOMETRY_ARRAYKDTREE_TRAVERSAL_EXPLICIT_RECURSION 1
@@ -61,6 +63,148 @@ class ArrayKdTree
 			}
 		};
 	
+	static const int leafSize=8; // Maximum number of nodes in subtrees that are scanned linearly during searches
+	
+	struct ClosestPointQuery // Structure to collect the single closest point during a search
+		{
+		/* Elements: */
+		public:
+		const StoredPoint* closestPoint; // Closest point found so far
+		Scalar minDist2; // Squared distance to the closest point found so far
+		
+		/* Constructors and destructors: */
+		ClosestPointQuery(void)
+			:closestPoint(0),minDist2(Math::Constants<Scalar>::max)
+			{
+			}
+		
+		/* Methods: */
+		Scalar getMaxSqrDist(void) const
+			{
+			return minDist2;
+			}
+		void insertPoint(const StoredPoint& point,Scalar dist2)
+			{
+			if(minDist2>dist2)
+				{
+				closestPoint=&point;
+				minDist2=dist2;
+				}
+			}
+		};
+	
+	struct SphereQuery // Structure to collect all points inside a sphere during a search
+		{
+		/* Elements: */
+		public:
+		Scalar radius2; // Squared sphere radius
+		std::vector<const StoredPoint*>& points; // List of found points
+		
+		/* Constructors and destructors: */
+		SphereQuery(Scalar sRadius2,std::vector<const StoredPoint*>& sPoints)
+			:radius2(sRadius2),points(sPoints)
+			{
+			}
+		
+		/* Methods: */
+		Scalar getMaxSqrDist(void) const
+			{
+			return radius2;
+			}
+		void insertPoint(const StoredPoint& point,Scalar dist2)
+			{
+			points.push_back(&point);
+			}
+		};
+	
+	struct BatchClosestPointQuery // Structure to run single queries of a batch of closest point queries
+		{
+		/* Elements: */
+		public:
+		const ArrayKdTree& tree;
+		const Point* queryPositions;
+		const StoredPoint** closestPoints;
+		
+		/* Constructors and destructors: */
+		BatchClosestPointQuery(const ArrayKdTree& sTree,const Point* sQueryPositions,const StoredPoint** sClosestPoints)
+			:tree(sTree),queryPositions(sQueryPositions),closestPoints(sClosestPoints)
+			{
+			}
+		
+		/* Methods: */
+		void operator()(int queryIndex) const
+			{
+			ClosestPointQuery query;
+			tree.searchTree(queryPositions[queryIndex],query);
+			closestPoints[queryIndex]=query.closestPoint;
+			}
+		};
+	
+	struct BatchClosestPointsQuery // Structure to run single queries of a batch of k-nearest neighbor queries
+		{
+		/* Elements: */
+		public:
+		const ArrayKdTree& tree;
+		const Point* queryPositions;
+		ClosePointSet* closestPoints;
+		
+		/* Constructors and destructors: */
+		BatchClosestPointsQuery(const ArrayKdTree& sTree,const Point* sQueryPositions,ClosePointSet* sClosestPoints)
+			:tree(sTree),queryPositions(sQueryPositions),closestPoints(sClosestPoints)
+			{
+			}
+		
+		/* Methods: */
+		void operator()(int queryIndex) const
+			{
+			closestPoints[queryIndex].clear();
+			tree.searchTree(queryPositions[queryIndex],closestPoints[queryIndex]);
+			}
+		};
+	
+	struct BatchSphereQuery // Structure to run single queries of a batch of fixed-radius queries
+		{
+		/* Elements: */
+		public:
+		const ArrayKdTree& tree;
+		const Point* queryPositions;
+		Scalar radius2;
+		std::vector<const StoredPoint*>* points;
+		
+		/* Constructors and destructors: */
+		BatchSphereQuery(const ArrayKdTree& sTree,const Point* sQueryPositions,Scalar sRadius2,std::vector<const StoredPoint*>* sPoints)
+			:tree(sTree),queryPositions(sQueryPositions),radius2(sRadius2),points(sPoints)
+			{
+			}
+		
+		/* Methods: */
+		void operator()(int queryIndex) const
+			{
+			points[queryIndex].clear();
+			SphereQuery query(radius2,points[queryIndex]);
+			tree.searchTree(queryPositions[queryIndex],query);
+			}
+		};
+	
+	template <class BatchQueryParam>
+	struct BatchQueryWorker // Structure to run a range of queries from a batch of queries in a thread
+		{
+		/* Elements: */
+		public:
+		const BatchQueryParam* batchQuery; // Functor running single queries
+		const int* queryOrder; // Order in which to run the batch's queries
+		int begin,end; // Range of query order indices handled by this worker
+		
+		/* Methods: */
+		void* run(void)
+			{
+			for(int i=begin;i<end;++i)
+				(*batchQuery)(queryOrder[i]);
+			
+			return 0;
+			}
+		};
+	
 	/* Elements: */
 	private:
 	int numNodes; // Total number of nodes in kd-tree
@@ -87,6 +231,8 @@ class ArrayKdTree
 		}
 	template <class TraversalFunctionParam>
 	void traverseTreeInBox(int left,int right,int splitDimension,const Box& box,TraversalFunctionParam& traversalFunction) const; // Traverses sub-kd-tree in prefix order and calls traversal function for each node inside the given box
+	template <class BatchQueryParam>
+	void runBatchQuery(int numQueries,const Point queryPositions[],const BatchQueryParam& batchQuery,int numThreads) const; // Runs a batch of queries in order of their descent through the tree, using the given number of threads
 	#if !GEOMETRY_ARRAYKDTREE_TRAVERSAL_EXPLICIT_RECURSION
 	template <class DirectedTraversalFunctionParam>
 	void traverseTreeDirected(int left,int right,int splitDimension,DirectedTraversalFunctionParam& traversalFunction) const; // Traverses sub-kd-tree in directed order and calls traversal function for each node
@@ -174,6 +320,12 @@ class ArrayKdTree
 	const StoredPoint& findClosePoint(const Point& queryPosition) const; // Returns a stored point that is close to the query position
 	const StoredPoint& findClosestPoint(const Point& queryPosition) const; // Returns the stored point closest to the query position
 	ClosePointSet& findClosestPoints(const Point& queryPosition,ClosePointSet& closestPoints) const; // Returns a set of closest points
+	std::vector<const StoredPoint*>& findPointsInSphere(const Point& center,Scalar radius,std::vector<const StoredPoint*>& points) const; // Replaces the given list with all stored points inside the given sphere, in no particular order
+	template <class QueryParam>
+	void searchTree(const Point& queryPosition,QueryParam& query) const; // Passes stored points to the given query object, which provides getMaxSqrDist and insertPoint methods like ClosePointSet; skips all points farther away than the query's current maximum distance
+	void findClosestPoint(int numQueries,const Point queryPositions[],const StoredPoint* closestPoints[],int numThreads =1) const; // Stores the stored point closest to each query position in the given array, or null if the tree is empty; uses the given number of threads
+	void findClosestPoints(int numQueries,const Point queryPositions[],ClosePointSet closestPoints[],int numThreads =1) const; // Fills the given array of close point sets, pre-sized by the caller, with the closest points to each query position; uses the given number of threads
+	void findPointsInSphere(int numQueries,const Point queryPositions[],Scalar radius,std::vector<const StoredPoint*> points[],int numThreads =1) const; // Fills the given array of lists with the stored points inside the sphere of the given radius around each query position; uses the given number of threads
 	};
 
 }
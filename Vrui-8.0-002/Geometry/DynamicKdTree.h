@@ -0,0 +1,204 @@
+/***********************************************************************
+DynamicKdTree - Class to store k-dimensional points in a forest of
+static kd-trees of exponentially increasing sizes, to support
+incremental insertion and removal of points.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Templatized Geometry Library (TGL).
+
+The Templatized Geometry Library is free software; you can redistribute
+it and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Templatized Geometry Library is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Templatized Geometry Library; if not, write to the Free
+Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef GEOMETRY_DYNAMICKDTREE_INCLUDED
+#define GEOMETRY_DYNAMICKDTREE_INCLUDED
+
+#include <vector>
+#include <Math/Constants.h>
+#include <Geometry/ClosePointSet.h>
+#include <Geometry/ArrayKdTree.h>
+
+namespace Geometry {
+
+template <class StoredPointParam>
+class DynamicKdTree
+	{
+	/* Embedded classes: */
+	public:
+	typedef StoredPointParam StoredPoint; // Type of points stored in kd-tree (typically with some associated value)
+	typedef typename StoredPoint::Point Point; // Type for positions
+	typedef typename Point::Scalar Scalar; // Scalar type used by points
+	static const int dimension=Point::dimension; // Dimension of points and kd-tree
+	typedef Geometry::ClosePointSet<StoredPoint> ClosePointSet; // Type for nearest neighbours query results
+	typedef unsigned int PointId; // Type for handles identifying inserted points
+	
+	private:
+	struct Entry:public StoredPoint // Structure for points stored in the kd-tree forest
+		{
+		/* Elements: */
+		public:
+		PointId id; // Handle of the point
+		bool removed; // Flag if the point has been removed, but is still stored in its kd-tree
+		};
+	
+	typedef ArrayKdTree<Entry> Tree; // Type for static kd-trees in the forest
+	
+	struct Location // Structure to find the entry of a point handle
+		{
+		/* Elements: */
+		public:
+		int level; // Level of the kd-tree containing the entry, or -1 if the handle is unused
+		int index; // Index of the entry in its kd-tree's node array
+		};
+	
+	struct ClosestPointQuery // Structure to collect the single closest point during a search
+		{
+		/* Elements: */
+		public:
+		const StoredPoint* closestPoint; // Closest point found so far
+		Scalar minDist2; // Squared distance to the closest point found so far
+		
+		/* Constructors and destructors: */
+		ClosestPointQuery(void)
+			:closestPoint(0),minDist2(Math::Constants<Scalar>::max)
+			{
+			}
+		
+		/* Methods: */
+		Scalar getMaxSqrDist(void) const
+			{
+			return minDist2;
+			}
+		void insertPoint(const Entry& entry,Scalar dist2)
+			{
+			if(!entry.removed&&minDist2>dist2)
+				{
+				closestPoint=&entry;
+				minDist2=dist2;
+				}
+			}
+		};
+	
+	struct ClosestPointsQuery // Structure to collect the closest points during a search
+		{
+		/* Elements: */
+		public:
+		ClosePointSet& closestPoints; // Set of closest points found so far
+		
+		/* Constructors and destructors: */
+		ClosestPointsQuery(ClosePointSet& sClosestPoints)
+			:closestPoints(sClosestPoints)
+			{
+			}
+		
+		/* Methods: */
+		Scalar getMaxSqrDist(void) const
+			{
+			return closestPoints.getMaxSqrDist();
+			}
+		void insertPoint(const Entry& entry,Scalar dist2)
+			{
+			if(!entry.removed)
+				closestPoints.insertPoint(entry,dist2);
+			}
+		};
+	
+	struct SphereQuery // Structure to collect all points inside a sphere during a search
+		{
+		/* Elements: */
+		public:
+		Scalar radius2; // Squared sphere radius
+		std::vector<const StoredPoint*>& points; // List of found points
+		
+		/* Constructors and destructors: */
+		SphereQuery(Scalar sRadius2,std::vector<const StoredPoint*>& sPoints)
+			:radius2(sRadius2),points(sPoints)
+			{
+			}
+		
+		/* Methods: */
+		Scalar getMaxSqrDist(void) const
+			{
+			return radius2;
+			}
+		void insertPoint(const Entry& entry,Scalar dist2)
+			{
+			if(!entry.removed)
+				points.push_back(&entry);
+			}
+		};
+	
+	static const int maxNumLevels=32; // Maximum number of kd-trees in the forest; kd-tree on level i holds at most 2^i entries
+	
+	/* Elements: */
+	private:
+	Tree levels[maxNumLevels]; // Array of kd-trees of increasing sizes; empty kd-trees have no nodes
+	int levelNumPoints[maxNumLevels]; // Number of non-removed entries in each kd-tree
+	int numPoints; // Total number of non-removed points in the forest
+	int numRemovedPoints; // Total number of removed entries still stored in the forest's kd-trees
+	std::vector<Location> locations; // Locations of the entries of all point handles
+	std::vector<PointId> freeIds; // List of unused point handles smaller than the size of the locations array
+	
+	/* Private methods: */
+	void buildLevel(int level); // Creates the balanced kd-tree on the given level after its entries have been stored, and updates their locations
+	
+	/* Constructors and destructors: */
+	public:
+	DynamicKdTree(void); // Creates an empty forest
+	private:
+	DynamicKdTree(const DynamicKdTree& source); // Prohibit copy constructor
+	DynamicKdTree& operator=(const DynamicKdTree& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	int getNumPoints(void) const // Returns the number of points in the forest
+		{
+		return numPoints;
+		}
+	PointId insertPoint(const StoredPoint& newPoint); // Inserts the given point into the forest and returns a handle to it
+	void removePoint(PointId pointId); // Removes the point of the given handle from the forest; handle becomes invalid
+	const StoredPoint& getPoint(PointId pointId) const // Returns the point of the given handle
+		{
+		const Location& location=locations[pointId];
+		return levels[location.level].getNode(location.index);
+		}
+	void clear(void); // Removes all points from the forest and invalidates all handles
+	void compact(void); // Rebuilds the forest from its non-removed points to free the space taken by removed points
+	template <class TraversalFunctionParam>
+	void traverseTree(TraversalFunctionParam& traversalFunction) const // Calls traversal function for each point in the forest, in unspecified order
+		{
+		for(int level=0;level<maxNumLevels;++level)
+			{
+			const Entry* entries=levels[level].accessPoints();
+			int numEntries=levels[level].getNumNodes();
+			for(int i=0;i<numEntries;++i)
+				if(!entries[i].removed)
+					traversalFunction(static_cast<const StoredPoint&>(entries[i]));
+			}
+		}
+	
+	/* Query methods; returned point pointers remain valid until the next insertion or removal: */
+	const StoredPoint* findClosestPoint(const Point& queryPosition) const; // Returns the point closest to the query position, or null if the forest is empty
+	ClosePointSet& findClosestPoints(const Point& queryPosition,ClosePointSet& closestPoints) const; // Returns a set of closest points
+	std::vector<const StoredPoint*>& findPointsInSphere(const Point& center,Scalar radius,std::vector<const StoredPoint*>& points) const; // Replaces the given list with all points inside the given sphere, in no particular order
+	};
+
+}
+
+#if !defined(GEOMETRY_DYNAMICKDTREE_IMPLEMENTATION)
+#include <Geometry/DynamicKdTree.icpp>
+#endif
+
+#endif
@@ -23,9 +23,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <IO/CSVSource.h>
 
 #include <ctype.h>
-#include <math.h>
 #include <string>
 #include <Misc/ThrowStdErr.h>
+#include <IO/NumberParser.h>
 
 namespace IO {
 
@@ -101,6 +101,34 @@ class TypeName<std::string>
 		}
 	};
 
+/*************************************************************
+Helper functions to select number parsers for numeric types:
+*************************************************************/
+
+inline const char* parseValue(const char* begin,const char* end,unsigned int& value)
+	{
+	return NumberParser::parseUnsignedInteger(begin,end,value);
+	}
+
+inline const char* parseValue(const char* begin,const char* end,int& value)
+	{
+	return NumberParser::parseInteger(begin,end,value);
+	}
+
+inline const char* parseValue(const char* begin,const char* end,double& value)
+	{
+	return NumberParser::parseNumber(begin,end,value);
+	}
+
+inline const char* parseValue(const char* begin,const char* end,float& value)
+	{
+	double tempValue;
+	const char* result=NumberParser::parseNumber(begin,end,tempValue);
+	if(result!=0)
+		value=float(tempValue);
+	return result;
+	}
+
 }
 
 /***************************************
@@ -257,91 +285,74 @@ bool CSVSource::convertNumber(int& nextChar,int& value)
 template <>
 bool CSVSource::convertNumber(int& nextChar,double& value)
 	{
+	/* Collect the number's characters one at a time: */
+	std::string number;
+	
 	/* Check for optional sign: */
-	bool negated=false;
-	if(nextChar=='-')
+	if(nextChar=='-'||nextChar=='+')
 		{
-		negated=true;
+		number.push_back(char(nextChar));
 		nextChar=source->getChar();
 		}
-	else if(nextChar=='+')
-		nextChar=source->getChar();
 	
 	/* Keep track if any digits have been read: */
 	bool haveDigit=false;
 	
 	/* Read an integral number part: */
-	value=0.0;
 	while(nextChar>='0'&&nextChar<='9')
 		{
 		haveDigit=true;
-		value=value*10.0+double(nextChar-'0');
+		number.push_back(char(nextChar));
 		nextChar=source->getChar();
 		}
 	
 	/* Check for a period: */
 	if(nextChar=='.')
 		{
+		number.push_back(char(nextChar));
 		nextChar=source->getChar();
 		
 		/* Read a fractional number part: */
-		double fraction=0.0;
-		double fractionBase=1.0;
 		while(nextChar>='0'&&nextChar<='9')
 			{
 			haveDigit=true;
-			fraction=fraction*10.0+double(nextChar-'0');
-			fractionBase*=10.0;
+			number.push_back(char(nextChar));
 			nextChar=source->getChar();
 			}
-		
-		value+=fraction/fractionBase;
 		}
 	
 	/* Signal a conversion error if no digits were read in the integral or fractional part: */
 	if(!haveDigit)
 		return false;
 	
-	/* Negate the result if a minus sign was read: */
-	if(negated)
-		value=-value;
-	
 	/* Check for an exponent indicator: */
 	if(nextChar=='e'||nextChar=='E')
 		{
+		number.push_back(char(nextChar));
 		nextChar=source->getChar();
 		
 		/* Read a plus or minus sign: */
-		bool exponentNegated=false;
-		if(nextChar=='-')
+		if(nextChar=='-'||nextChar=='+')
 			{
-			exponentNegated=true;
+			number.push_back(char(nextChar));
 			nextChar=source->getChar();
 			}
-		else if(nextChar=='+')
-			nextChar=source->getChar();
 		
 		/* Signal a conversion error if the next character is not a digit: */
 		if(nextChar<'0'||nextChar>'9')
 			return false;
 		
-		/* Read the first exponent digit: */
-		double exponent=double(nextChar-'0');
-		nextChar=source->getChar();
-		
-		/* Read the rest of the exponent digits: */
+		/* Read the exponent digits: */
 		while(nextChar>='0'&&nextChar<='9')
 			{
-			exponent=exponent*10.0+double(nextChar-'0');
+			number.push_back(char(nextChar));
 			nextChar=source->getChar();
 			}
-		
-		/* Multiply the mantissa with the exponent: */
-		if(exponentNegated)
-			exponent=-exponent;
-		value*=pow(10.0,exponent);
 		}
 	
+	/* Convert the collected characters, including the string's terminating NUL character: */
+	NumberParser::parseNumber(number.c_str(),number.c_str()+number.size()+1,value);
+	
 	return true;
 	}
 
@@ -382,9 +393,79 @@ void CSVSource::setQuote(int newQuote)
 	quote=newQuote;
 	}
 
+template <class ValueParam>
+inline
+bool
+CSVSource::readFieldInBuffer(
+	ValueParam& value)
+	{
+	/* Access the rest of the read buffer: */
+	void* buffer;
+	size_t bufferSize=source->readInBuffer(buffer);
+	const char* bufferBegin=static_cast<const char*>(buffer);
+	const char* bufferEnd=bufferBegin+bufferSize;
+	const char* cPtr=bufferBegin;
+	
+	/* Check for quote: */
+	bool quoted=(unsigned char)(*cPtr)==quote;
+	if(quoted)
+		++cPtr;
+	
+	/* Skip whitespace: */
+	while(cPtr!=bufferEnd&&isspace((unsigned char)(*cPtr))&&(unsigned char)(*cPtr)!=fieldSeparator&&(unsigned char)(*cPtr)!=recordSeparator)
+		++cPtr;
+	
+	/* Read the numeric value: */
+	cPtr=parseValue(cPtr,bufferEnd,value);
+	if(cPtr!=0)
+		{
+		/* Skip whitespace: */
+		while(cPtr!=bufferEnd&&isspace((unsigned char)(*cPtr))&&(unsigned char)(*cPtr)!=fieldSeparator&&(unsigned char)(*cPtr)!=recordSeparator)
+			++cPtr;
+		
+		/* Skip the closing quote of a quoted field: */
+		if(quoted)
+			{
+			if(cPtr!=bufferEnd&&(unsigned char)(*cPtr)==quote)
+				++cPtr;
+			else
+				cPtr=0;
+			}
+		}
+	
+	/* Check that the field ends in a field or record separator inside the read buffer: */
+	if(cPtr!=0&&cPtr!=bufferEnd)
+		{
+		if((unsigned char)(*cPtr)==fieldSeparator)
+			{
+			/* Start a new field: */
+			++fieldIndex;
+			source->putBackInBuffer(bufferEnd-(cPtr+1));
+			return true;
+			}
+		else if((unsigned char)(*cPtr)==recordSeparator)
+			{
+			/* Start a new record: */
+			fieldIndex=0;
+			++recordIndex;
+			source->putBackInBuffer(bufferEnd-(cPtr+1));
+			return true;
+			}
+		}
+	
+	/* Restore the character source's read position: */
+	source->putBackInBuffer(bufferSize);
+	return false;
+	}
+
 template <class ValueParam>
 ValueParam CSVSource::readField(void)
 	{
+	/* Try reading the field directly inside the read buffer first: */
+	ValueParam result(0);
+	if(source->canReadImmediately()&&readFieldInBuffer(result))
+		return result;
+	
 	/* Read the field's first character: */
 	int nextChar=source->getChar();
 	
@@ -401,7 +482,6 @@ ValueParam CSVSource::readField(void)
 		nextChar=source->getChar();
 	
 	/* Read the numeric value: */
-	ValueParam result(0);
 	bool success=convertNumber(nextChar,result);
 	
 	/* Skip whitespace: */
@@ -59,6 +59,8 @@ class CSVSource
 	bool skipRestOfField(bool quoted,int nextChar); // Skips the rest of the current field starting with the given character; returns true if any characters were skipped; throws format error if the end of the field cannot be determined reliably
 	template <class ValueParam>
 	bool convertNumber(int& nextChar,ValueParam& value); // Converts characters in a field into a numeric value of the given type; returns false on conversion error
+	template <class ValueParam>
+	bool readFieldInBuffer(ValueParam& value); // Reads a numeric field of the given type directly inside the character source's read buffer; returns false and leaves the source unchanged if the field is malformed or might extend past the end of the buffer
 	
 	/* Constructors and destructors: */
 	public:
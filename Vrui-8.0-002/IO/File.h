@@ -296,6 +296,10 @@ class File:public Threads::RefCounted
 		/* Reset the read pointer: */
 		readPtr-=putbackSize;
 		}
+	size_t getPutBackSize(void) const // Returns the amount of previously read data that can be put back into the read buffer
+		{
+		return readPtr-readBuffer;
+		}
 	void readRaw(void* buffer,size_t bufferSize) // Reads exactly the given amount of data into the provided buffer; blocks until read complete
 		{
 		/* Check if there is enough data in the read buffer: */
@@ -0,0 +1,259 @@
+/***********************************************************************
+NumberParser - Functions to convert decimal numbers stored in character
+ranges, such as the read buffers of files, into integer or correctly
+rounded floating-point values.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the I/O Support Library (IO).
+
+The I/O Support Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The I/O Support Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the I/O Support Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <IO/NumberParser.h>
+
+#include <stdlib.h>
+#include <float.h>
+#include <string.h>
+#include <string>
+#include <Misc/SizedTypes.h>
+
+namespace IO {
+
+namespace NumberParser {
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+inline bool isDigit(char c)
+	{
+	return (unsigned char)(c-'0')<10U;
+	}
+
+const Misc::UInt64 maxMantissa=1000000000000000000ULL; // Mantissa value above which another digit might overflow 64 bits
+
+const double powersOfTen[23]= // Powers of ten that are exactly representable as double values
+	{
+	1.0e0,1.0e1,1.0e2,1.0e3,1.0e4,1.0e5,1.0e6,1.0e7,1.0e8,1.0e9,
+	1.0e10,1.0e11,1.0e12,1.0e13,1.0e14,1.0e15,1.0e16,1.0e17,1.0e18,1.0e19,
+	1.0e20,1.0e21,1.0e22
+	};
+
+#if LDBL_MANT_DIG==64&&(defined(__i386__)||defined(__x86_64__))
+
+const long double extendedPowersOfTen[28]= // Powers of ten that are exactly representable as 80-bit extended-precision values
+	{
+	1.0e0L,1.0e1L,1.0e2L,1.0e3L,1.0e4L,1.0e5L,1.0e6L,1.0e7L,1.0e8L,1.0e9L,
+	1.0e10L,1.0e11L,1.0e12L,1.0e13L,1.0e14L,1.0e15L,1.0e16L,1.0e17L,1.0e18L,1.0e19L,
+	1.0e20L,1.0e21L,1.0e22L,1.0e23L,1.0e24L,1.0e25L,1.0e26L,1.0e27L
+	};
+
+#endif
+
+double convertWithLibc(const char* begin,const char* end) // Converts the given number using the C library
+	{
+	/* Copy the number into a NUL-terminated string, avoiding allocation for typical lengths: */
+	size_t length=end-begin;
+	char buffer[64];
+	if(length<sizeof(buffer))
+		{
+		memcpy(buffer,begin,length);
+		buffer[length]='\0';
+		return strtod(buffer,0);
+		}
+	else
+		{
+		std::string number(begin,end);
+		return strtod(number.c_str(),0);
+		}
+	}
+
+}
+
+const char* parseUnsignedInteger(const char* begin,const char* end,unsigned int& value)
+	{
+	/* Bail out if the range does not start with a digit: */
+	const char* cPtr=begin;
+	if(cPtr==end||!isDigit(*cPtr))
+		return 0;
+	
+	/* Read all digits: */
+	unsigned int result=0;
+	for(;cPtr!=end&&isDigit(*cPtr);++cPtr)
+		result=result*10+(unsigned int)(*cPtr-'0');
+	
+	/* Bail out if the number might continue past the end of the range: */
+	if(cPtr==end)
+		return 0;
+	
+	value=result;
+	return cPtr;
+	}
+
+const char* parseInteger(const char* begin,const char* end,int& value)
+	{
+	/* Read a plus or minus sign: */
+	const char* cPtr=begin;
+	if(cPtr==end)
+		return 0;
+	bool negate=*cPtr=='-';
+	if(*cPtr=='-'||*cPtr=='+')
+		++cPtr;
+	
+	/* Read the absolute value: */
+	unsigned int absValue;
+	cPtr=parseUnsignedInteger(cPtr,end,absValue);
+	if(cPtr!=0)
+		value=negate?-int(absValue):int(absValue);
+	
+	return cPtr;
+	}
+
+const char* parseNumber(const char* begin,const char* end,double& value)
+	{
+	/* Read a plus or minus sign: */
+	const char* cPtr=begin;
+	if(cPtr==end)
+		return 0;
+	bool negate=*cPtr=='-';
+	if(*cPtr=='-'||*cPtr=='+')
+		++cPtr;
+	
+	/*********************************************************************
+	Accumulate at least 18 significant digits into a 64-bit integer
+	mantissa, and keep track of the decimal exponent of the mantissa's
+	last digit and of whether any non-zero digits had to be dropped:
+	*********************************************************************/
+	
+	Misc::UInt64 mantissa=0;
+	int exponent=0;
+	bool truncated=false;
+	bool haveDigit=false;
+	
+	/* Read an integral number part: */
+	for(;cPtr!=end&&isDigit(*cPtr);++cPtr)
+		{
+		haveDigit=true;
+		if(mantissa<maxMantissa)
+			mantissa=mantissa*10U+Misc::UInt64(*cPtr-'0');
+		else
+			{
+			++exponent;
+			truncated=truncated||*cPtr!='0';
+			}
+		}
+	if(cPtr==end)
+		return 0;
+	
+	/* Check for a period: */
+	if(*cPtr=='.')
+		{
+		/* Read a fractional number part: */
+		for(++cPtr;cPtr!=end&&isDigit(*cPtr);++cPtr)
+			{
+			haveDigit=true;
+			if(mantissa<maxMantissa)
+				{
+				mantissa=mantissa*10U+Misc::UInt64(*cPtr-'0');
+				--exponent;
+				}
+			else
+				truncated=truncated||*cPtr!='0';
+			}
+		if(cPtr==end)
+			return 0;
+		}
+	
+	/* Bail out if no digits were read in the integral or fractional part: */
+	if(!haveDigit)
+		return 0;
+	
+	/* Check for an exponent indicator: */
+	if(*cPtr=='e'||*cPtr=='E')
+		{
+		/* Read a plus or minus sign: */
+		if(++cPtr==end)
+			return 0;
+		bool negateExponent=*cPtr=='-';
+		if(*cPtr=='-'||*cPtr=='+')
+			++cPtr;
+		
+		/* Bail out if there are no digits in the exponent: */
+		if(cPtr==end||!isDigit(*cPtr))
+			return 0;
+		
+		/* Read the exponent, saturating it far outside the range of double values: */
+		int exp10=0;
+		for(;cPtr!=end&&isDigit(*cPtr);++cPtr)
+			if(exp10<100000)
+				exp10=exp10*10+int(*cPtr-'0');
+		if(cPtr==end)
+			return 0;
+		
+		exponent+=negateExponent?-exp10:exp10;
+		}
+	
+	/* Convert the mantissa and exponent into a double value: */
+	if(mantissa==0U)
+		{
+		/* The number is zero regardless of its exponent: */
+		value=negate?-0.0:0.0;
+		}
+	else if(!truncated&&mantissa<=(Misc::UInt64(1)<<53)&&exponent>=-22&&exponent<=22)
+		{
+		/* Both the mantissa and the power of ten are exact; a single multiplication or division rounds correctly: */
+		double result=double(mantissa);
+		if(exponent<0)
+			result/=powersOfTen[-exponent];
+		else
+			result*=powersOfTen[exponent];
+		value=negate?-result:result;
+		}
+	else
+		{
+		#if LDBL_MANT_DIG==64&&(defined(__i386__)||defined(__x86_64__))
+		if(!truncated&&exponent>=-27&&exponent<=27)
+			{
+			/* Calculate the value in extended precision, which rounds the full mantissa times the exact power of ten once: */
+			long double result=(long double)(mantissa);
+			if(exponent<0)
+				result/=extendedPowersOfTen[-exponent];
+			else
+				result*=extendedPowersOfTen[exponent];
+			
+			/* Rounding to double precision is correct unless the extended result lies within one unit of a halfway point: */
+			Misc::UInt64 resultBits;
+			memcpy(&resultBits,&result,sizeof(Misc::UInt64)); // The x87 extended format stores the full 64-bit significand in its low-order bytes
+			unsigned int roundBits=(unsigned int)(resultBits&0x7ffU);
+			if(roundBits<0x3ffU||roundBits>0x401U)
+				{
+				value=negate?-double(result):double(result);
+				return cPtr;
+				}
+			}
+		#endif
+		
+		/* Fall back to the C library's correctly rounded conversion, which accepts a superset of the syntax parsed above: */
+		value=convertWithLibc(begin,cPtr);
+		}
+	
+	return cPtr;
+	}
+
+}
+
+}
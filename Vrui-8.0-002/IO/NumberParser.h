@@ -0,0 +1,51 @@
+/***********************************************************************
+NumberParser - Functions to convert decimal numbers stored in character
+ranges, such as the read buffers of files, into integer or correctly
+rounded floating-point values.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the I/O Support Library (IO).
+
+The I/O Support Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The I/O Support Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the I/O Support Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef IO_NUMBERPARSER_INCLUDED
+#define IO_NUMBERPARSER_INCLUDED
+
+/**********************************************************************
+All parsers read a number starting at the beginning of the given
+character range and return a pointer to the first character following
+the number. They return a null pointer if the range does not start with
+a number of the requested syntax, or if the number might continue past
+the end of the range; callers that need to distinguish the two cases
+must terminate the range with a non-number character.
+Floating-point numbers have the syntax
+[+|-][digits][.[digits]][(e|E)[+|-]digits]
+with at least one digit in the integral or fractional part.
+**********************************************************************/
+
+namespace IO {
+
+namespace NumberParser {
+
+const char* parseUnsignedInteger(const char* begin,const char* end,unsigned int& value); // Parses an unsigned decimal integer
+const char* parseInteger(const char* begin,const char* end,int& value); // Parses a signed decimal integer
+const char* parseNumber(const char* begin,const char* end,double& value); // Parses a floating-point number and rounds it correctly to the nearest double value
+
+}
+
+}
+
+#endif
@@ -22,7 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <IO/ValueSource.h>
 
 #include <ctype.h>
-#include <math.h>
+#include <IO/NumberParser.h>
 
 namespace IO {
 
@@ -30,6 +30,55 @@ namespace IO {
 Methods of class ValueSource:
 ****************************/
 
+template <class ValueParam>
+inline
+bool
+ValueSource::parseInBuffer(
+	const char* (*parser)(const char*,const char*,ValueParam&),
+	ValueParam& value)
+	{
+	/* Bail out if the last read character can not be put back, or if the read buffer is empty: */
+	if(lastChar<0||source->getPutBackSize()==0||!source->canReadImmediately())
+		return false;
+	
+	/* Access the rest of the read buffer starting at the last read character: */
+	source->putBackInBuffer(1);
+	void* buffer;
+	size_t bufferSize=source->readInBuffer(buffer);
+	const char* bufferBegin=static_cast<const char*>(buffer);
+	const char* bufferEnd=bufferBegin+bufferSize;
+	
+	/* Parse the value unless the last read character was replaced via ungetChar: */
+	const char* cPtr=0;
+	if((unsigned char)(*bufferBegin)==lastChar)
+		cPtr=parser(bufferBegin,bufferEnd,value);
+	if(cPtr==0)
+		{
+		/* Restore the character source's read position: */
+		source->putBackInBuffer(bufferSize-1);
+		return false;
+		}
+	
+	/* Skip whitespace inside the read buffer: */
+	while(cPtr!=bufferEnd&&(cc[(unsigned char)(*cPtr)]&WHITESPACE))
+		++cPtr;
+	
+	if(cPtr!=bufferEnd)
+		{
+		/* Take the next character from the read buffer and put the rest back: */
+		lastChar=(unsigned char)(*cPtr);
+		source->putBackInBuffer(bufferEnd-(cPtr+1));
+		}
+	else
+		{
+		/* Continue skipping whitespace in the character source: */
+		lastChar=source->getChar();
+		skipWs();
+		}
+	
+	return true;
+	}
+
 char ValueSource::processEscape(void)
 	{
 	/* Skip the escape character: */
@@ -591,6 +640,11 @@ std::string ValueSource::readString(void)
 
 int ValueSource::readInteger(void)
 	{
+	/* Try parsing the number directly inside the read buffer first: */
+	int result;
+	if(parseInBuffer(&NumberParser::parseInteger,result))
+		return result;
+	
 	/* Read a plus or minus sign: */
 	bool negate=lastChar=='-';
 	if(lastChar=='-'||lastChar=='+')
@@ -601,7 +655,7 @@ int ValueSource::readInteger(void)
 		throw NumberError();
 	
 	/* Read an integral number part: */
-	int result=0;
+	result=0;
 	while(cc[lastChar]&DIGIT)
 		{
 		result=result*10+int(lastChar-'0');
@@ -621,12 +675,17 @@ int ValueSource::readInteger(void)
 
 unsigned int ValueSource::readUnsignedInteger(void)
 	{
+	/* Try parsing the number directly inside the read buffer first: */
+	unsigned int result;
+	if(parseInBuffer(&NumberParser::parseUnsignedInteger,result))
+		return result;
+	
 	/* Signal an error if the next character is not a digit: */
 	if(!(cc[lastChar]&DIGIT))
 		throw NumberError();
 	
 	/* Read an integral number part: */
-	unsigned int result=0;
+	result=0;
 	while(cc[lastChar]&DIGIT)
 		{
 		result=result*10+(unsigned int)(lastChar-'0');
@@ -642,74 +701,77 @@ unsigned int ValueSource::readUnsignedInteger(void)
 
 double ValueSource::readNumber(void)
 	{
+	/* Try parsing the number directly inside the read buffer first: */
+	double result;
+	if(parseInBuffer(&NumberParser::parseNumber,result))
+		return result;
+	
+	/* Collect the number's characters one at a time: */
+	std::string number;
+	
 	/* Read a plus or minus sign: */
-	bool negate=lastChar=='-';
 	if(lastChar=='-'||lastChar=='+')
+		{
+		number.push_back(char(lastChar));
 		lastChar=source->getChar();
+		}
 	
 	/* Read an integral number part: */
 	bool haveDigit=false;
-	double result=0.0;
 	while(cc[lastChar]&DIGIT)
 		{
 		haveDigit=true;
-		result=result*10.0+double(lastChar-'0');
+		number.push_back(char(lastChar));
 		lastChar=source->getChar();
 		}
 	
 	/* Check for a period: */
 	if(lastChar=='.')
 		{
+		number.push_back(char(lastChar));
 		lastChar=source->getChar();
 		
 		/* Read a fractional number part: */
-		double fraction=0.0;
-		double fractionBase=1.0;
 		while(cc[lastChar]&DIGIT)
 			{
 			haveDigit=true;
-			fraction=fraction*10.0+double(lastChar-'0');
-			fractionBase*=10.0;
+			number.push_back(char(lastChar));
 			lastChar=source->getChar();
 			}
-		
-		result+=fraction/fractionBase;
 		}
 	
 	/* Signal an error if no digits were read in the integral or fractional part: */
 	if(!haveDigit)
 		throw NumberError();
 	
-	/* Negate the result if a minus sign was read: */
-	if(negate)
-		result=-result;
-	
 	/* Check for an exponent indicator: */
 	if(lastChar=='e'||lastChar=='E')
 		{
+		number.push_back(char(lastChar));
 		lastChar=source->getChar();
 		
 		/* Read a plus or minus sign: */
-		bool negateExponent=lastChar=='-';
 		if(lastChar=='-'||lastChar=='+')
+			{
+			number.push_back(char(lastChar));
 			lastChar=source->getChar();
+			}
 		
 		/* Check if there are any digits in the exponent: */
 		if(!(cc[lastChar]&DIGIT))
 			throw NumberError();
 		
 		/* Read the exponent: */
-		double exponent=0.0;
 		while(cc[lastChar]&DIGIT)
 			{
-			exponent=exponent*10.0+double(lastChar-'0');
+			number.push_back(char(lastChar));
 			lastChar=source->getChar();
 			}
-		
-		/* Multiply the mantissa with the exponent: */
-		result*=pow(10.0,negateExponent?-exponent:exponent);
 		}
 	
+	/* Convert the collected characters, including the string's terminating NUL character: */
+	NumberParser::parseNumber(number.c_str(),number.c_str()+number.size()+1,result);
+	
 	/* Skip whitespace: */
 	while(cc[lastChar]&WHITESPACE)
 		lastChar=source->getChar();
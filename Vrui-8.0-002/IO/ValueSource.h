@@ -63,6 +63,8 @@ class ValueSource
 	
 	/* Private methods: */
 	char processEscape(void); // Processes an escape sequence from the character source
+	template <class ValueParam>
+	bool parseInBuffer(const char* (*parser)(const char*,const char*,ValueParam&),ValueParam& value); // Parses a value starting at the last read character directly inside the character source's read buffer and skips whitespace after it; returns false and leaves the source unchanged if the value is malformed or might extend past the end of the buffer
 	
 	/* Constructors and destructors: */
 	public:
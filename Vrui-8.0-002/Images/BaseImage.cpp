@@ -25,10 +25,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <stddef.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <vector>
 #include <stdexcept>
 #include <Misc/SizedTypes.h>
+#include <Threads/Thread.h>
 #include <IO/File.h>
 #include <Math/Math.h>
+#include <Math/Constants.h>
 #include <GL/Extensions/GLEXTFramebufferObject.h>
 
 namespace Images {
@@ -76,10 +81,127 @@ BaseImage::ImageRepresentation::~ImageRepresentation(void)
 
 namespace {
 
+/***********************************************************************
+Helper classes and functions to process images in parallel bands of rows:
+***********************************************************************/
+
+class RowKernel // Base class for image processing kernels calculating each destination row independently
+	{
+	/* Constructors and destructors: */
+	public:
+	virtual ~RowKernel(void)
+		{
+		}
+	
+	/* Methods: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const =0; // Calculates the destination rows in the given half-open range
+	};
+
+class RowBandWorker // Class to process one band of destination rows in a background thread
+	{
+	/* Elements: */
+	public:
+	const RowKernel* kernel; // The image processing kernel
+	unsigned int rowBegin,rowEnd; // Range of destination rows to process
+	
+	/* Methods: */
+	void* run(void)
+		{
+		kernel->processRows(rowBegin,rowEnd);
+		return 0;
+		}
+	};
+
+pthread_t mainThread=pthread_self(); // The thread that loaded the library, i.e., the application's main thread
+
+inline bool isMainThread(void) // Returns true if the calling thread is the application's main thread
+	{
+	return pthread_equal(pthread_self(),mainThread)!=0;
+	}
+
+void processRowBands(const RowKernel& kernel,unsigned int numRows,size_t rowCost)
+	{
+	/* Don't split images into bands smaller than a minimum amount of work: */
+	static const size_t minBandCost=size_t(128)*size_t(1024);
+	size_t maxNumBands=(size_t(numRows)*rowCost)/minBandCost;
+	if(maxNumBands>size_t(numRows))
+		maxNumBands=numRows;
+	
+	/* Only split images when called from the main thread, to not oversubscribe the CPUs when called from background image loaders: */
+	unsigned int numBands=isMainThread()?BaseImage::getNumThreads():1U;
+	if(numBands>maxNumBands)
+		numBands=(unsigned int)(maxNumBands);
+	if(numBands<=1)
+		{
+		/* Process the entire image in the calling thread: */
+		kernel.processRows(0,numRows);
+		return;
+		}
+	
+	/* Split the destination rows into one contiguous band per thread: */
+	std::vector<RowBandWorker> workers(numBands);
+	for(unsigned int i=0;i<numBands;++i)
+		{
+		workers[i].kernel=&kernel;
+		workers[i].rowBegin=(unsigned int)((size_t(numRows)*size_t(i))/size_t(numBands));
+		workers[i].rowEnd=(unsigned int)((size_t(numRows)*size_t(i+1))/size_t(numBands));
+		}
+	
+	/* Process all but the first band in background threads, and the first band in the calling thread: */
+	Threads::Thread* threads=new Threads::Thread[numBands];
+	for(unsigned int i=1;i<numBands;++i)
+		threads[i].start(&workers[i],&RowBandWorker::run);
+	workers[0].run();
+	
+	/* Wait for all background threads to finish: */
+	for(unsigned int i=1;i<numBands;++i)
+		threads[i].join();
+	delete[] threads;
+	}
+
 /*******************************************************
 Helper classes and functions for basic image operations:
 *******************************************************/
 
+/***********************************************************************
+The following kernels take the number of channels as a template
+parameter, so that the compiler can unroll and vectorize their inner
+loops for the common pixel formats.
+***********************************************************************/
+
+template <class ScalarParam,unsigned int numChannelsParam>
+class DropAlphaKernel:public RowKernel // Kernel to drop the alpha channel from an image with the given number of non-alpha channels
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Image width
+	
+	/* Constructors and destructors: */
+	public:
+	DropAlphaKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(source.getWidth())
+		{
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Drop the alpha value of all pixels: */
+		const ScalarParam* sPtr=sPixels+size_t(rowBegin)*width*(numChannelsParam+1);
+		ScalarParam* dPtr=dPixels+size_t(rowBegin)*width*numChannelsParam;
+		for(size_t i=size_t(rowEnd-rowBegin)*width;i>0;--i,sPtr+=numChannelsParam+1,dPtr+=numChannelsParam)
+			{
+			/* Copy the non-alpha channels: */
+			for(unsigned int j=0;j<numChannelsParam;++j)
+				dPtr[j]=sPtr[j];
+			}
+		}
+	};
+
 template <class ScalarParam>
 inline
 void
@@ -87,19 +209,12 @@ dropAlphaTyped(
 	const BaseImage& source,
 	BaseImage& dest)
 	{
-	/* Drop the alpha value of all pixels: */
-	unsigned int numChannels=dest.getNumChannels();
-	const ScalarParam* sPtr=static_cast<const ScalarParam*>(source.getPixels());
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
-	for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i)
-		{
-		/* Copy the non-alpha channels: */
-		for(size_t j=0;j<numChannels;++j)
-			*(dPtr++)=*(sPtr++);
-		
-		/* Skip the source's alpha channel: */
-		++sPtr;
-		}
+	/* Delegate to a kernel for the image's number of channels: */
+	size_t rowCost=source.getRowStride();
+	if(dest.getNumChannels()==3)
+		processRowBands(DropAlphaKernel<ScalarParam,3>(source,dest),source.getHeight(),rowCost);
+	else
+		processRowBands(DropAlphaKernel<ScalarParam,1>(source,dest),source.getHeight(),rowCost);
 	}
 
 void dropAlphaImpl(const BaseImage& source,BaseImage& dest)
@@ -144,6 +259,44 @@ void dropAlphaImpl(const BaseImage& source,BaseImage& dest)
 		}
 	}
 
+template <class ScalarParam,unsigned int numChannelsParam>
+class AddAlphaKernel:public RowKernel // Kernel to add a constant alpha channel to an image with the given number of channels
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Image width
+	ScalarParam alpha; // Alpha value to add
+	
+	/* Constructors and destructors: */
+	public:
+	AddAlphaKernel(const BaseImage& source,BaseImage& dest,ScalarParam sAlpha)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(source.getWidth()),
+		 alpha(sAlpha)
+		{
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Add the constant alpha value to all pixels: */
+		const ScalarParam* sPtr=sPixels+size_t(rowBegin)*width*numChannelsParam;
+		ScalarParam* dPtr=dPixels+size_t(rowBegin)*width*(numChannelsParam+1);
+		for(size_t i=size_t(rowEnd-rowBegin)*width;i>0;--i,sPtr+=numChannelsParam,dPtr+=numChannelsParam+1)
+			{
+			/* Copy the non-alpha channels: */
+			for(unsigned int j=0;j<numChannelsParam;++j)
+				dPtr[j]=sPtr[j];
+			
+			/* Add an alpha value to the destination: */
+			dPtr[numChannelsParam]=alpha;
+			}
+		}
+	};
+
 template <class ScalarParam>
 inline
 void
@@ -152,19 +305,12 @@ addAlphaTyped(
 	BaseImage& dest,
 	ScalarParam alpha)
 	{
-	/* Add the constant alpha value to all pixels: */
-	unsigned int numChannels=source.getNumChannels();
-	const ScalarParam* sPtr=static_cast<const ScalarParam*>(source.getPixels());
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
-	for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i)
-		{
-		/* Copy the non-alpha channels: */
-		for(size_t j=0;j<numChannels;++j)
-			*(dPtr++)=*(sPtr++);
-		
-		/* Add an alpha value to the destination: */
-		*(dPtr++)=alpha;
-		}
+	/* Delegate to a kernel for the image's number of channels: */
+	size_t rowCost=dest.getRowStride();
+	if(source.getNumChannels()==3)
+		processRowBands(AddAlphaKernel<ScalarParam,3>(source,dest,alpha),source.getHeight(),rowCost);
+	else
+		processRowBands(AddAlphaKernel<ScalarParam,1>(source,dest,alpha),source.getHeight(),rowCost);
 	}
 
 void addAlphaImpl(const BaseImage& source,BaseImage& dest,double alpha)
@@ -209,6 +355,42 @@ void addAlphaImpl(const BaseImage& source,BaseImage& dest,double alpha)
 		}
 	}
 
+template <class ScalarParam,class WeightParam,unsigned int numChannelsParam>
+class ToGreyIntKernel:public RowKernel // Kernel to convert an integer RGB or RGBA image to luminance or luminance-alpha
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Image width
+	
+	/* Constructors and destructors: */
+	public:
+	ToGreyIntKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(source.getWidth())
+		{
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Convert all pixels to luminance and retain an existing alpha channel: */
+		const ScalarParam* sPtr=sPixels+size_t(rowBegin)*width*numChannelsParam;
+		ScalarParam* dPtr=dPixels+size_t(rowBegin)*width*(numChannelsParam-2);
+		for(size_t i=size_t(rowEnd-rowBegin)*width;i>0;--i,sPtr+=numChannelsParam,dPtr+=numChannelsParam-2)
+			{
+			/* Calculate pixel luminance: */
+			dPtr[0]=ScalarParam((WeightParam(sPtr[0])*WeightParam(77)+WeightParam(sPtr[1])*WeightParam(150)+WeightParam(sPtr[2])*WeightParam(29))>>WeightParam(8));
+			
+			/* Copy alpha channel: */
+			if(numChannelsParam==4)
+				dPtr[1]=sPtr[3];
+			}
+		}
+	};
+
 template <class ScalarParam,class WeightParam>
 inline
 void
@@ -216,31 +398,49 @@ toGreyTypedInt(
 	const BaseImage& source,
 	BaseImage& dest)
 	{
-	/* Convert all pixels to luminance and retain an existing alpha channel: */
-	const ScalarParam* sPtr=static_cast<const ScalarParam*>(source.getPixels());
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
+	/* Delegate to a kernel for the image's number of channels: */
+	size_t rowCost=source.getRowStride();
 	if(source.getNumChannels()==4)
+		processRowBands(ToGreyIntKernel<ScalarParam,WeightParam,4>(source,dest),source.getHeight(),rowCost);
+	else
+		processRowBands(ToGreyIntKernel<ScalarParam,WeightParam,3>(source,dest),source.getHeight(),rowCost);
+	}
+
+template <class ScalarParam,unsigned int numChannelsParam>
+class ToGreyFloatKernel:public RowKernel // Kernel to convert a floating-point RGB or RGBA image to luminance or luminance-alpha
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Image width
+	
+	/* Constructors and destructors: */
+	public:
+	ToGreyFloatKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(source.getWidth())
 		{
-		/* Convert RGBA to LUMINANCE_ALPHA: */
-		for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i,sPtr+=4)
-			{
-			/* Calculate pixel luminance: */
-			*(dPtr++)=ScalarParam((WeightParam(sPtr[0])*WeightParam(77)+WeightParam(sPtr[1])*WeightParam(150)+WeightParam(sPtr[2])*WeightParam(29))>>WeightParam(8));
-			
-			/* Copy alpha channel: */
-			*(dPtr++)=sPtr[3];
-			}
 		}
-	else
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
 		{
-		/* Convert RGB to LUMINANCE: */
-		for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i,sPtr+=3)
+		/* Convert all pixels to luminance and retain an existing alpha channel: */
+		const ScalarParam* sPtr=sPixels+size_t(rowBegin)*width*numChannelsParam;
+		ScalarParam* dPtr=dPixels+size_t(rowBegin)*width*(numChannelsParam-2);
+		for(size_t i=size_t(rowEnd-rowBegin)*width;i>0;--i,sPtr+=numChannelsParam,dPtr+=numChannelsParam-2)
 			{
 			/* Calculate pixel luminance: */
-			*(dPtr++)=ScalarParam((WeightParam(sPtr[0])*WeightParam(77)+WeightParam(sPtr[1])*WeightParam(150)+WeightParam(sPtr[2])*WeightParam(29))>>WeightParam(8));
+			dPtr[0]=sPtr[0]*ScalarParam(0.299)+sPtr[1]*ScalarParam(0.587)+sPtr[2]*ScalarParam(0.114);
+			
+			/* Copy alpha channel: */
+			if(numChannelsParam==4)
+				dPtr[1]=sPtr[3];
 			}
 		}
-	}
+	};
 
 template <class ScalarParam>
 inline
@@ -249,30 +449,12 @@ toGreyTypedFloat(
 	const BaseImage& source,
 	BaseImage& dest)
 	{
-	/* Convert all pixels to luminance and retain an existing alpha channel: */
-	const ScalarParam* sPtr=static_cast<const ScalarParam*>(source.getPixels());
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
+	/* Delegate to a kernel for the image's number of channels: */
+	size_t rowCost=source.getRowStride();
 	if(source.getNumChannels()==4)
-		{
-		/* Convert RGBA to LUMINANCE_ALPHA: */
-		for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i,sPtr+=4)
-			{
-			/* Calculate pixel luminance: */
-			*(dPtr++)=sPtr[0]*ScalarParam(0.299)+sPtr[1]*ScalarParam(0.587)+sPtr[2]*ScalarParam(0.114);
-			
-			/* Copy alpha channel: */
-			*(dPtr++)=sPtr[3];
-			}
-		}
+		processRowBands(ToGreyFloatKernel<ScalarParam,4>(source,dest),source.getHeight(),rowCost);
 	else
-		{
-		/* Convert RGB to LUMINANCE: */
-		for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i,sPtr+=3)
-			{
-			/* Calculate pixel luminance: */
-			*(dPtr++)=sPtr[0]*ScalarParam(0.299)+sPtr[1]*ScalarParam(0.587)+sPtr[2]*ScalarParam(0.114);
-			}
-		}
+		processRowBands(ToGreyFloatKernel<ScalarParam,3>(source,dest),source.getHeight(),rowCost);
 	}
 
 void toGreyImpl(const BaseImage& source,BaseImage& dest)
@@ -317,41 +499,57 @@ void toGreyImpl(const BaseImage& source,BaseImage& dest)
 		}
 	}
 
-template <class ScalarParam>
-inline
-void
-toRgbTyped(
-	const BaseImage& source,
-	BaseImage& dest)
+template <class ScalarParam,unsigned int numChannelsParam>
+class ToRgbKernel:public RowKernel // Kernel to convert a luminance or luminance-alpha image to RGB or RGBA
 	{
-	/* Convert all pixels to RGB and retain an existing alpha channel: */
-	const ScalarParam* sPtr=static_cast<const ScalarParam*>(source.getPixels());
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
-	if(source.getNumChannels()==2)
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Image width
+	
+	/* Constructors and destructors: */
+	public:
+	ToRgbKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(source.getWidth())
 		{
-		/* Convert LUMINANCE_ALPHA to RGBA: */
-		for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i,sPtr+=2)
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Convert all pixels to RGB and retain an existing alpha channel: */
+		const ScalarParam* sPtr=sPixels+size_t(rowBegin)*width*numChannelsParam;
+		ScalarParam* dPtr=dPixels+size_t(rowBegin)*width*(numChannelsParam+2);
+		for(size_t i=size_t(rowEnd-rowBegin)*width;i>0;--i,sPtr+=numChannelsParam,dPtr+=numChannelsParam+2)
 			{
 			/* Copy pixel luminance: */
-			*(dPtr++)=sPtr[0];
-			*(dPtr++)=sPtr[0];
-			*(dPtr++)=sPtr[0];
+			dPtr[0]=sPtr[0];
+			dPtr[1]=sPtr[0];
+			dPtr[2]=sPtr[0];
 			
 			/* Copy alpha channel: */
-			*(dPtr++)=sPtr[1];
+			if(numChannelsParam==2)
+				dPtr[3]=sPtr[1];
 			}
 		}
+	};
+
+template <class ScalarParam>
+inline
+void
+toRgbTyped(
+	const BaseImage& source,
+	BaseImage& dest)
+	{
+	/* Delegate to a kernel for the image's number of channels: */
+	size_t rowCost=dest.getRowStride();
+	if(source.getNumChannels()==2)
+		processRowBands(ToRgbKernel<ScalarParam,2>(source,dest),source.getHeight(),rowCost);
 	else
-		{
-		/* Convert LUMINANCE to RGB: */
-		for(size_t i=size_t(source.getSize(0))*size_t(source.getSize(1));i>0;--i,++sPtr)
-			{
-			/* Copy pixel luminance: */
-			*(dPtr++)=sPtr[0];
-			*(dPtr++)=sPtr[0];
-			*(dPtr++)=sPtr[0];
-			}
-		}
+		processRowBands(ToRgbKernel<ScalarParam,1>(source,dest),source.getHeight(),rowCost);
 	}
 
 void toRgbImpl(const BaseImage& source,BaseImage& dest)
@@ -396,6 +594,50 @@ void toRgbImpl(const BaseImage& source,BaseImage& dest)
 		}
 	}
 
+template <class ScalarParam,class AccumParam,unsigned int numChannelsParam>
+class ShrinkIntKernel:public RowKernel // Kernel to average 2x2 pixel blocks of an integer image; numChannelsParam==0 handles any number of channels
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Destination image width
+	unsigned int numChannels; // Number of image channels
+	
+	/* Constructors and destructors: */
+	public:
+	ShrinkIntKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(dest.getWidth()),
+		 numChannels(source.getNumChannels())
+		{
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Average all blocks of 2x2 pixels in the source image: */
+		const unsigned int nc=numChannelsParam!=0?numChannelsParam:numChannels;
+		const size_t dStride=width*nc;
+		const size_t sStride=dStride*2;
+		for(unsigned int y=rowBegin;y<rowEnd;++y)
+			{
+			const ScalarParam* s0Ptr=sPixels+size_t(y)*sStride*2;
+			const ScalarParam* s1Ptr=s0Ptr+sStride;
+			ScalarParam* dPtr=dPixels+size_t(y)*dStride;
+			for(size_t x=0;x<width;++x,s0Ptr+=nc*2,s1Ptr+=nc*2,dPtr+=nc)
+				for(unsigned int i=0;i<nc;++i)
+					{
+					/* Average the current 2x2 pixel block: */
+					AccumParam sum0=AccumParam(s0Ptr[i])+AccumParam(s0Ptr[nc+i]);
+					AccumParam sum1=AccumParam(s1Ptr[i])+AccumParam(s1Ptr[nc+i]);
+					dPtr[i]=ScalarParam((sum0+sum1+2)>>2);
+					}
+			}
+		}
+	};
+
 template <class ScalarParam,class AccumParam>
 inline
 void
@@ -403,28 +645,72 @@ shrinkTypedInt(
 	const BaseImage& source,
 	BaseImage& dest)
 	{
-	/* Average all blocks of 2x2 pixels in the source image: */
-	unsigned int nc=source.getNumChannels();
-	const ScalarParam* sRow0Ptr=static_cast<const ScalarParam*>(source.getPixels());
-	const ptrdiff_t sStride=source.getSize(0)*nc;
-	const ScalarParam* sRow1Ptr=sRow0Ptr+sStride;
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
-	for(unsigned int y=0;y<source.getSize(1);y+=2,sRow0Ptr+=sStride*2,sRow1Ptr+=sStride*2)
+	/* Delegate to a kernel for the image's number of channels: */
+	size_t rowCost=source.getRowStride()*2;
+	switch(source.getNumChannels())
+		{
+		case 1:
+			processRowBands(ShrinkIntKernel<ScalarParam,AccumParam,1>(source,dest),dest.getHeight(),rowCost);
+			break;
+		
+		case 2:
+			processRowBands(ShrinkIntKernel<ScalarParam,AccumParam,2>(source,dest),dest.getHeight(),rowCost);
+			break;
+		
+		case 3:
+			processRowBands(ShrinkIntKernel<ScalarParam,AccumParam,3>(source,dest),dest.getHeight(),rowCost);
+			break;
+		
+		case 4:
+			processRowBands(ShrinkIntKernel<ScalarParam,AccumParam,4>(source,dest),dest.getHeight(),rowCost);
+			break;
+		
+		default:
+			processRowBands(ShrinkIntKernel<ScalarParam,AccumParam,0>(source,dest),dest.getHeight(),rowCost);
+		}
+	}
+
+template <class ScalarParam>
+class ShrinkFloatKernel:public RowKernel // Kernel to average 2x2 pixel blocks of a floating-point image
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t width; // Destination image width
+	unsigned int numChannels; // Number of image channels
+	
+	/* Constructors and destructors: */
+	public:
+	ShrinkFloatKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 width(dest.getWidth()),
+		 numChannels(source.getNumChannels())
+		{
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
 		{
-		const ScalarParam* s0Ptr=sRow0Ptr;
-		const ScalarParam* s1Ptr=sRow1Ptr;
-		for(unsigned int x=0;x<source.getSize(0);x+=2,s0Ptr+=nc,s1Ptr+=nc)
+		/* Average all blocks of 2x2 pixels in the source image: */
+		const unsigned int nc=numChannels;
+		const size_t dStride=width*nc;
+		const size_t sStride=dStride*2;
+		for(unsigned int y=rowBegin;y<rowEnd;++y)
 			{
-			for(unsigned int i=0;i<source.getNumChannels();++i,++s0Ptr,++s1Ptr,++dPtr)
-				{
-				/* Average the current 2x2 pixel block: */
-				AccumParam sum0=AccumParam(s0Ptr[0])+AccumParam(s0Ptr[nc]);
-				AccumParam sum1=AccumParam(s1Ptr[0])+AccumParam(s1Ptr[nc]);
-				*dPtr=ScalarParam((sum0+sum1+2)>>2);
-				}
+			const ScalarParam* s0Ptr=sPixels+size_t(y)*sStride*2;
+			const ScalarParam* s1Ptr=s0Ptr+sStride;
+			ScalarParam* dPtr=dPixels+size_t(y)*dStride;
+			for(size_t x=0;x<width;++x,s0Ptr+=nc*2,s1Ptr+=nc*2,dPtr+=nc)
+				for(unsigned int i=0;i<nc;++i)
+					{
+					/* Average the current 2x2 pixel block: */
+					dPtr[i]=(s0Ptr[i]+s0Ptr[nc+i]+s1Ptr[i]+s1Ptr[nc+i])*ScalarParam(0.25);
+					}
 			}
 		}
-	}
+	};
 
 template <class ScalarParam>
 inline
@@ -433,25 +719,257 @@ shrinkTypedFloat(
 	const BaseImage& source,
 	BaseImage& dest)
 	{
-	/* Average all blocks of 2x2 pixels in the source image: */
-	unsigned int nc=source.getNumChannels();
-	const ScalarParam* sRow0Ptr=static_cast<const ScalarParam*>(source.getPixels());
-	const ptrdiff_t sStride=source.getSize(0)*nc;
-	const ScalarParam* sRow1Ptr=sRow0Ptr+sStride;
-	ScalarParam* dPtr=static_cast<ScalarParam*>(dest.modifyPixels());
-	for(unsigned int y=0;y<source.getSize(1);y+=2,sRow0Ptr+=sStride*2,sRow1Ptr+=sStride*2)
+	processRowBands(ShrinkFloatKernel<ScalarParam>(source,dest),dest.getHeight(),source.getRowStride()*2);
+	}
+
+/***********************************************************************
+Helper classes and functions to resample images to the next mipmap
+level using arbitrary sizes and filters:
+***********************************************************************/
+
+struct FilterTaps // Structure describing the source pixels contributing to one destination pixel along one image axis
+	{
+	/* Elements: */
+	public:
+	unsigned int first; // Index of the first contributing source pixel
+	unsigned int num; // Number of contributing source pixels
+	size_t weightIndex; // Index of the first contributing source pixel's weight in the weight array
+	};
+
+inline double lanczos3(double x) // Returns the three-lobed Lanczos kernel at the given position
+	{
+	if(x==0.0)
+		return 1.0;
+	if(x<=-3.0||x>=3.0)
+		return 0.0;
+	double px=Math::Constants<double>::pi*x;
+	return 3.0*Math::sin(px)*Math::sin(px/3.0)/(px*px);
+	}
+
+template <class WeightParam>
+inline
+void
+calcFilterTaps(
+	unsigned int sourceSize,
+	unsigned int destSize,
+	BaseImage::MipmapFilter filter,
+	std::vector<FilterTaps>& taps,
+	std::vector<WeightParam>& weights)
+	{
+	double scale=double(sourceSize)/double(destSize);
+	double radius=filter==BaseImage::LANCZOS_FILTER?scale*3.0:scale*0.5;
+	std::vector<double> w;
+	taps.resize(destSize);
+	for(unsigned int i=0;i<destSize;++i)
+		{
+		/* Find the range of source pixels under the filter, and clamp it to the source image: */
+		double center=(double(i)+0.5)*scale;
+		int rawFirst=int(Math::floor(center-radius));
+		int rawLast=int(Math::ceil(center+radius))-1;
+		int first=Math::max(rawFirst,0);
+		int last=Math::min(rawLast,int(sourceSize)-1);
+		
+		/* Accumulate the weights of all source pixels, replicating edge pixels: */
+		w.assign(last-first+1,0.0);
+		double weightSum=0.0;
+		for(int j=rawFirst;j<=rawLast;++j)
+			{
+			double weight;
+			if(filter==BaseImage::LANCZOS_FILTER)
+				weight=lanczos3((double(j)+0.5-center)/scale);
+			else
+				weight=Math::max(Math::min(double(j+1),center+radius)-Math::max(double(j),center-radius),0.0);
+			w[Math::clamp(j,first,last)-first]+=weight;
+			weightSum+=weight;
+			}
+		
+		/* Trim source pixels with zero weight from both ends: */
+		int wFirst=0;
+		int wLast=last-first;
+		while(wFirst<wLast&&w[wFirst]==0.0)
+			++wFirst;
+		while(wLast>wFirst&&w[wLast]==0.0)
+			--wLast;
+		
+		/* Store the normalized weights: */
+		taps[i].first=(unsigned int)(first+wFirst);
+		taps[i].num=(unsigned int)(wLast-wFirst+1);
+		taps[i].weightIndex=weights.size();
+		for(int j=wFirst;j<=wLast;++j)
+			weights.push_back(WeightParam(w[j]/weightSum));
+		}
+	}
+
+template <class ScalarParam,class AccumParam,bool integralParam =Math::Constants<ScalarParam>::isIntegral>
+class AccumConverter // Helper class to convert filtered sums back to image scalars
+	{
+	/* Methods: */
+	public:
+	static ScalarParam convert(AccumParam value)
+		{
+		return ScalarParam(value);
+		}
+	};
+
+template <class ScalarParam,class AccumParam>
+class AccumConverter<ScalarParam,AccumParam,true> // Specialized version for integer image scalars, which rounds and clamps
+	{
+	/* Methods: */
+	public:
+	static ScalarParam convert(AccumParam value)
+		{
+		value=Math::floor(value+AccumParam(0.5));
+		if(value<=AccumParam(Math::Constants<ScalarParam>::min))
+			return Math::Constants<ScalarParam>::min;
+		else if(value>=AccumParam(Math::Constants<ScalarParam>::max))
+			return Math::Constants<ScalarParam>::max;
+		else
+			return ScalarParam(value);
+		}
+	};
+
+template <class ScalarParam,class AccumParam,unsigned int numChannelsParam>
+class ResampleKernel:public RowKernel // Kernel to resample an image using separable filters; numChannelsParam==0 handles any number of channels
+	{
+	/* Elements: */
+	private:
+	const ScalarParam* sPixels; // Source image's pixels
+	ScalarParam* dPixels; // Destination image's pixels
+	size_t sWidth,dWidth; // Source and destination image widths
+	unsigned int numChannels; // Number of image channels
+	std::vector<FilterTaps> xTaps,yTaps; // Filter taps for each destination column and row
+	std::vector<AccumParam> xWeights,yWeights; // Weights of the filter taps
+	unsigned int maxNumYTaps; // Maximum number of source rows contributing to any destination row
+	
+	/* Private methods: */
+	void filterRow(unsigned int sourceRow,AccumParam* sourceRowBuffer,AccumParam* row) const // Filters the given source row horizontally
 		{
-		const ScalarParam* s0Ptr=sRow0Ptr;
-		const ScalarParam* s1Ptr=sRow1Ptr;
-		for(unsigned int x=0;x<source.getSize(0);x+=2,s0Ptr+=nc,s1Ptr+=nc)
+		const unsigned int nc=numChannelsParam!=0?numChannelsParam:numChannels;
+		
+		/* Convert the source row to the accumulator type: */
+		const size_t sStride=sWidth*nc;
+		const ScalarParam* sRowPtr=sPixels+size_t(sourceRow)*sStride;
+		for(size_t i=0;i<sStride;++i)
+			sourceRowBuffer[i]=AccumParam(sRowPtr[i]);
+		
+		/* Calculate the destination pixels: */
+		for(size_t x=0;x<dWidth;++x,row+=nc)
 			{
-			for(unsigned int i=0;i<source.getNumChannels();++i,++s0Ptr,++s1Ptr,++dPtr)
+			const FilterTaps& xt=xTaps[x];
+			const AccumParam* xw=&xWeights[xt.weightIndex];
+			const AccumParam* sPtr=sourceRowBuffer+size_t(xt.first)*nc;
+			for(unsigned int i=0;i<nc;++i)
+				row[i]=sPtr[i]*xw[0];
+			for(unsigned int t=1;t<xt.num;++t)
 				{
-				/* Average the current 2x2 pixel block: */
-				*dPtr=(s0Ptr[0]+s0Ptr[nc]+s1Ptr[0]+s1Ptr[nc])*ScalarParam(0.25);
+				sPtr+=nc;
+				for(unsigned int i=0;i<nc;++i)
+					row[i]+=sPtr[i]*xw[t];
 				}
 			}
 		}
+	
+	/* Constructors and destructors: */
+	public:
+	ResampleKernel(const BaseImage& source,BaseImage& dest,BaseImage::MipmapFilter filter)
+		:sPixels(static_cast<const ScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<ScalarParam*>(dest.modifyPixels())),
+		 sWidth(source.getWidth()),dWidth(dest.getWidth()),
+		 numChannels(source.getNumChannels()),
+		 maxNumYTaps(0)
+		{
+		/* Calculate the filter taps in both directions: */
+		calcFilterTaps(source.getWidth(),dest.getWidth(),filter,xTaps,xWeights);
+		calcFilterTaps(source.getHeight(),dest.getHeight(),filter,yTaps,yWeights);
+		for(std::vector<FilterTaps>::iterator ytIt=yTaps.begin();ytIt!=yTaps.end();++ytIt)
+			maxNumYTaps=Math::max(maxNumYTaps,ytIt->num);
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Create a ring buffer of horizontally filtered source rows, so that each source row is only filtered once: */
+		const size_t dStride=dWidth*numChannels;
+		std::vector<AccumParam> rowBuffer(dStride*(maxNumYTaps+1)+sWidth*numChannels);
+		AccumParam* rowCache=&rowBuffer[dStride];
+		AccumParam* sourceRowBuffer=rowCache+dStride*maxNumYTaps;
+		std::vector<unsigned int> cachedRows(maxNumYTaps,~0U);
+		
+		for(unsigned int y=rowBegin;y<rowEnd;++y)
+			{
+			/* Filter the source rows under the destination row vertically: */
+			const FilterTaps& yt=yTaps[y];
+			const AccumParam* yw=&yWeights[yt.weightIndex];
+			AccumParam* acc=&rowBuffer[0];
+			for(unsigned int t=0;t<yt.num;++t)
+				{
+				/* Filter the source row horizontally if it is not in the ring buffer yet: */
+				unsigned int sourceRow=yt.first+t;
+				unsigned int slot=sourceRow%maxNumYTaps;
+				AccumParam* row=rowCache+size_t(slot)*dStride;
+				if(cachedRows[slot]!=sourceRow)
+					{
+					filterRow(sourceRow,sourceRowBuffer,row);
+					cachedRows[slot]=sourceRow;
+					}
+				
+				/* Accumulate the filtered source row: */
+				AccumParam w=yw[t];
+				if(t==0)
+					{
+					for(size_t i=0;i<dStride;++i)
+						acc[i]=row[i]*w;
+					}
+				else
+					{
+					for(size_t i=0;i<dStride;++i)
+						acc[i]+=row[i]*w;
+					}
+				}
+			
+			/* Store the destination row: */
+			ScalarParam* dPtr=dPixels+size_t(y)*dStride;
+			for(size_t i=0;i<dStride;++i)
+				dPtr[i]=AccumConverter<ScalarParam,AccumParam>::convert(acc[i]);
+			}
+		}
+	};
+
+template <class ScalarParam,class AccumParam>
+inline
+void
+resampleTyped(
+	const BaseImage& source,
+	BaseImage& dest,
+	BaseImage::MipmapFilter filter)
+	{
+	/* Estimate the work per destination row from the number of source rows contributing to it: */
+	size_t rowCost=(size_t(source.getRowStride())*size_t(source.getHeight()))/size_t(dest.getHeight());
+	if(filter==BaseImage::LANCZOS_FILTER)
+		rowCost*=6;
+	
+	/* Delegate to a kernel for the image's number of channels: */
+	switch(source.getNumChannels())
+		{
+		case 1:
+			processRowBands(ResampleKernel<ScalarParam,AccumParam,1>(source,dest,filter),dest.getHeight(),rowCost);
+			break;
+		
+		case 2:
+			processRowBands(ResampleKernel<ScalarParam,AccumParam,2>(source,dest,filter),dest.getHeight(),rowCost);
+			break;
+		
+		case 3:
+			processRowBands(ResampleKernel<ScalarParam,AccumParam,3>(source,dest,filter),dest.getHeight(),rowCost);
+			break;
+		
+		case 4:
+			processRowBands(ResampleKernel<ScalarParam,AccumParam,4>(source,dest,filter),dest.getHeight(),rowCost);
+			break;
+		
+		default:
+			processRowBands(ResampleKernel<ScalarParam,AccumParam,0>(source,dest,filter),dest.getHeight(),rowCost);
+		}
 	}
 
 /***************************************************************************
@@ -713,8 +1231,128 @@ inline GLdouble convertColorScalar<GLushort,GLdouble>(GLushort value)
 	return GLdouble(value)/65535.0;
 	}
 
+/************************************************************
+Helper classes and functions to convert images between scalar types:
+************************************************************/
+
+template <class SourceScalarParam,class DestScalarParam>
+class ConvertScalarKernel:public RowKernel // Kernel to convert all pixel components of an image to another scalar type
+	{
+	/* Elements: */
+	private:
+	const SourceScalarParam* sPixels; // Source image's pixels
+	DestScalarParam* dPixels; // Destination image's pixels
+	size_t rowSize; // Number of pixel components in an image row
+	
+	/* Constructors and destructors: */
+	public:
+	ConvertScalarKernel(const BaseImage& source,BaseImage& dest)
+		:sPixels(static_cast<const SourceScalarParam*>(source.getPixels())),
+		 dPixels(static_cast<DestScalarParam*>(dest.modifyPixels())),
+		 rowSize(size_t(source.getWidth())*size_t(source.getNumChannels()))
+		{
+		}
+	
+	/* Methods from class RowKernel: */
+	virtual void processRows(unsigned int rowBegin,unsigned int rowEnd) const
+		{
+		/* Convert all pixel components in the row range: */
+		const SourceScalarParam* sPtr=sPixels+size_t(rowBegin)*rowSize;
+		DestScalarParam* dPtr=dPixels+size_t(rowBegin)*rowSize;
+		for(size_t i=size_t(rowEnd-rowBegin)*rowSize;i>0;--i,++sPtr,++dPtr)
+			*dPtr=convertColorScalar<SourceScalarParam,DestScalarParam>(*sPtr);
+		}
+	};
+
+template <class SourceScalarParam>
+inline
+void
+convertScalarTypeTyped(
+	const BaseImage& source,
+	BaseImage& dest)
+	{
+	/* Delegate to a kernel for the destination image's scalar type: */
+	size_t rowCost=source.getRowStride()+dest.getRowStride();
+	switch(dest.getScalarType())
+		{
+		case GL_BYTE:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLbyte>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_UNSIGNED_BYTE:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLubyte>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_SHORT:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLshort>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_UNSIGNED_SHORT:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLushort>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_INT:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLint>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_UNSIGNED_INT:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLuint>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_FLOAT:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLfloat>(source,dest),source.getHeight(),rowCost);
+			break;
+		
+		case GL_DOUBLE:
+			processRowBands(ConvertScalarKernel<SourceScalarParam,GLdouble>(source,dest),source.getHeight(),rowCost);
+			break;
+		}
+	}
+
+void convertScalarTypeImpl(const BaseImage& source,BaseImage& dest)
+	{
+	/* Delegate to a typed version of this function: */
+	switch(source.getScalarType())
+		{
+		case GL_BYTE:
+			convertScalarTypeTyped<GLbyte>(source,dest);
+			break;
+		
+		case GL_UNSIGNED_BYTE:
+			convertScalarTypeTyped<GLubyte>(source,dest);
+			break;
+		
+		case GL_SHORT:
+			convertScalarTypeTyped<GLshort>(source,dest);
+			break;
+		
+		case GL_UNSIGNED_SHORT:
+			convertScalarTypeTyped<GLushort>(source,dest);
+			break;
+		
+		default:
+			throw std::runtime_error("Images::BaseImage::convertScalarType: Image has unsupported scalar type");
+		}
+	}
+
 }
 
+/**********************************
+Static elements of class BaseImage:
+**********************************/
+
+namespace {
+
+unsigned int getNumCpus(void) // Returns the number of online CPUs
+	{
+	long numCpus=sysconf(_SC_NPROCESSORS_ONLN);
+	return numCpus>1?(unsigned int)(numCpus):1U;
+	}
+
+}
+
+unsigned int BaseImage::numThreads=getNumCpus();
+
 /**************************
 Methods of class BaseImage:
 **************************/
@@ -827,6 +1465,11 @@ void BaseImage::write(IO::File& imageFile) const
 		}
 	}
 
+void BaseImage::setNumThreads(unsigned int newNumThreads)
+	{
+	numThreads=newNumThreads!=0?newNumThreads:getNumCpus();
+	}
+
 BaseImage BaseImage::dropAlpha(void) const
 	{
 	/* Process the image based on its format: */
@@ -990,6 +1633,130 @@ BaseImage BaseImage::shrink(void) const
 	return result;
 	}
 
+BaseImage BaseImage::downsample(BaseImage::MipmapFilter filter) const
+	{
+	/* Use the exact 2x2 box filter if the image's size is even: */
+	if(filter==BOX_FILTER&&rep->size[0]%2==0&&rep->size[1]%2==0)
+		return shrink();
+	
+	/* Create a reduced-size image with the same pixel format, using OpenGL's rule for mipmap level sizes: */
+	BaseImage result(Math::max(rep->size[0]/2,1U),Math::max(rep->size[1]/2,1U),rep->numChannels,rep->channelSize,rep->format,rep->scalarType);
+	
+	/* Delegate to a typed version of this function: */
+	switch(rep->scalarType)
+		{
+		case GL_BYTE:
+			resampleTyped<signed char,float>(*this,result,filter);
+			break;
+		
+		case GL_UNSIGNED_BYTE:
+			resampleTyped<unsigned char,float>(*this,result,filter);
+			break;
+		
+		case GL_SHORT:
+			resampleTyped<signed short,float>(*this,result,filter);
+			break;
+		
+		case GL_UNSIGNED_SHORT:
+			resampleTyped<unsigned short,float>(*this,result,filter);
+			break;
+		
+		case GL_INT:
+			resampleTyped<signed int,double>(*this,result,filter);
+			break;
+		
+		case GL_UNSIGNED_INT:
+			resampleTyped<unsigned int,double>(*this,result,filter);
+			break;
+		
+		case GL_FLOAT:
+			resampleTyped<float,float>(*this,result,filter);
+			break;
+		
+		case GL_DOUBLE:
+			resampleTyped<double,double>(*this,result,filter);
+			break;
+		
+		default:
+			throw std::runtime_error("Images::BaseImage::downsample: Image has unsupported pixel format");
+		}
+	
+	return result;
+	}
+
+BaseImage BaseImage::convertScalarType(GLenum newScalarType) const
+	{
+	/* Return the image unchanged if it already has the requested scalar type: */
+	if(rep->scalarType==newScalarType)
+		return *this;
+	
+	/* Determine the storage size of the new scalar type: */
+	unsigned int newChannelSize;
+	switch(newScalarType)
+		{
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			newChannelSize=1;
+			break;
+		
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+			newChannelSize=2;
+			break;
+		
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_FLOAT:
+			newChannelSize=4;
+			break;
+		
+		case GL_DOUBLE:
+			newChannelSize=8;
+			break;
+		
+		default:
+			throw std::runtime_error("Images::BaseImage::convertScalarType: Unsupported scalar type");
+		}
+	
+	/* Convert the image's pixel components into a new image of the same size and format: */
+	BaseImage result(rep->size[0],rep->size[1],rep->numChannels,newChannelSize,rep->format,newScalarType);
+	convertScalarTypeImpl(*this,result);
+	
+	return result;
+	}
+
+BaseImage BaseImage::padToPowerOfTwo(void) const
+	{
+	/* Calculate the padded image size as the next power of two: */
+	unsigned int paddedSize[2];
+	for(int i=0;i<2;++i)
+		for(paddedSize[i]=1;paddedSize[i]<rep->size[i];paddedSize[i]<<=1)
+			;
+	
+	/* Return the image unchanged if its size already is a power of two: */
+	if(paddedSize[0]==rep->size[0]&&paddedSize[1]==rep->size[1])
+		return *this;
+	
+	/* Create the padded image: */
+	BaseImage result(paddedSize[0],paddedSize[1],rep->numChannels,rep->channelSize,rep->format,rep->scalarType);
+	size_t pixelSize=size_t(rep->numChannels)*size_t(rep->channelSize);
+	size_t rowSize=size_t(rep->size[0])*pixelSize;
+	ptrdiff_t dRowStride=result.getRowStride();
+	char* dRowPtr=static_cast<char*>(result.replacePixels());
+	for(unsigned int y=0;y<paddedSize[1];++y,dRowPtr+=dRowStride)
+		{
+		/* Copy the source row, or the last source row for padding rows: */
+		memcpy(dRowPtr,getPixelRow(y<rep->size[1]?y:rep->size[1]-1),rowSize);
+		
+		/* Replicate the row's last pixel into the padding columns: */
+		const char* lastPixel=dRowPtr+rowSize-pixelSize;
+		for(char* dPtr=dRowPtr+rowSize;dPtr!=dRowPtr+dRowStride;dPtr+=pixelSize)
+			memcpy(dPtr,lastPixel,pixelSize);
+		}
+	
+	return result;
+	}
+
 GLenum BaseImage::getInternalFormat(void) const
 	{
 	/* Guess an appropriate internal image format: */
@@ -1092,25 +1859,34 @@ void BaseImage::glTexImage2DMipmap(GLenum target,GLint internalFormat,bool padIm
 	else
 		{
 		/* Create mipmaps manually by successively downsampling this image: */
-		BaseImage level=*this;
-		GLint levelIndex=0;
-		while(true)
-			{
-			/* Upload the current level texture image: */
-			level.glTexImage2D(target,levelIndex,internalFormat,padImageSize);
-			++levelIndex;
-			
-			/* Bail out if we can't shrink further: */
-			if(level.getSize(0)%2!=0||level.getSize(1)%2!=0)
-				break;
-			
-			/* Downsample the current level image: */
-			level=level.shrink();
-			}
+		glTexImage2DMipmap(target,internalFormat,BOX_FILTER,padImageSize);
+		}
+	}
+
+void BaseImage::glTexImage2DMipmap(GLenum target,GLint internalFormat,BaseImage::MipmapFilter filter,bool padImageSize) const
+	{
+	/* Pad the base level image once, so that all downsampled levels have power-of-two sizes as well: */
+	BaseImage level=padImageSize?padToPowerOfTwo():*this;
+	
+	/* Upload all mipmap levels down to a single pixel: */
+	GLint levelIndex=0;
+	while(true)
+		{
+		/* Upload the current level texture image: */
+		level.glTexImage2D(target,levelIndex,internalFormat);
+		
+		/* Bail out if the current level is a single pixel: */
+		if(level.getSize(0)==1&&level.getSize(1)==1)
+			break;
 		
-		/* Set the texture's mipmap level range: */
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAX_LEVEL,levelIndex-1);
+		/* Downsample the current level image: */
+		level=level.downsample(filter);
+		++levelIndex;
 		}
+	
+	/* Set the texture's mipmap level range: */
+	glTexParameteri(target,GL_TEXTURE_BASE_LEVEL,0);
+	glTexParameteri(target,GL_TEXTURE_MAX_LEVEL,levelIndex);
 	}
 
 void BaseImage::glTexSubImage2D(GLenum target,GLint level,GLint xOffset,GLint yOffset) const
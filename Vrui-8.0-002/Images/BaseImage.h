@@ -37,6 +37,14 @@ namespace Images {
 
 class BaseImage
 	{
+	/* Embedded classes: */
+	public:
+	enum MipmapFilter // Enumerated type for filters used to calculate mipmap levels
+		{
+		BOX_FILTER, // Averages the source pixels covered by each destination pixel
+		LANCZOS_FILTER // Three-lobed Lanczos filter; preserves more detail, but can ring around sharp edges
+		};
+	
 	private:
 	struct ImageRepresentation // Structure to represent an image to allow non-copy sharing and passing of images
 		{
@@ -70,6 +78,7 @@ class BaseImage
 	
 	/* Elements: */
 	private:
+	static unsigned int numThreads; // Maximum number of threads used by image processing methods called from the main thread
 	ImageRepresentation* rep; // Pointer to a (shared) image representation
 	
 	/* Private methods: */
@@ -122,6 +131,11 @@ class BaseImage
 		}
 	
 	/* Methods: */
+	static unsigned int getNumThreads(void) // Returns the maximum number of threads used by image processing methods called from the main thread
+		{
+		return numThreads;
+		}
+	static void setNumThreads(unsigned int newNumThreads); // Sets the maximum number of threads used by image processing methods called from the main thread; 0 uses one thread per online CPU. Methods called from other threads always run in the calling thread
 	bool isValid(void) const // Returns if the image has a valid representation
 		{
 		return rep!=0;
@@ -193,12 +207,15 @@ class BaseImage
 		}
 	void write(IO::File& imageFile) const; // Writes the image in internal format to the given binary file
 	
-	/* Basic image processing methods: */
+	/* Basic image processing methods; when called from the main thread, these process large images in parallel bands of rows: */
 	BaseImage dropAlpha(void) const; // Returns a new image with the alpha channel dropped; returns itself when there is no alpha channel
 	BaseImage addAlpha(double alpha) const; // Returns a new image with an alpha channel of the given alpha value in [0, 1] added; returns itself without changing the alpha channel if there is already one
 	BaseImage toGrey(void) const; // Returns a new image representing this image's luminance; returns itself if the image is already greyscale; retains existing alpha channel
 	BaseImage toRgb(void) const; // Returns a new image representing this greyscale image in RGB color space; returns itself if the image is already RGB; retains existing alpha channel
+	BaseImage convertScalarType(GLenum newScalarType) const; // Returns a new image with the same format whose pixel components are converted to the given scalar type; returns itself if the image already has the given scalar type; only supports 8-bit and 16-bit source images
 	BaseImage shrink(void) const; // Returns a version of this image downsampled by a factor of two (for mipmap generation); assumes size of image is even in both directions
+	BaseImage downsample(MipmapFilter filter =BOX_FILTER) const; // Returns the next mipmap level of this image using the given filter; new size is half the old size rounded down, but at least one pixel
+	BaseImage padToPowerOfTwo(void) const; // Returns a version of this image padded to the next power of two in both directions by replicating its last column and row; returns itself if its size already is a power of two
 	
 	/* OpenGL interface methods: */
 	GLenum getInternalFormat(void) const; // Returns an internal OpenGL texture format compatible with this image
@@ -216,6 +233,7 @@ class BaseImage
 		/* Call the general function with a guessed internal format: */
 		glTexImage2DMipmap(target,getInternalFormat(),padImageSize);
 		}
+	void glTexImage2DMipmap(GLenum target,GLint internalFormat,MipmapFilter filter,bool padImageSize =false) const; // Uploads an image as a full mipmap starting at level 0, calculating all levels on the CPU using the given filter
 	void glTexSubImage2D(GLenum target,GLint level,GLint xOffset,GLint yOffset) const; // Uploads an image as a part of a larger OpenGL texture
 	void glTexSubImage3D(GLenum target,GLint level,GLint xOffset,GLint yOffset,GLint zOffset) const; // Uploads an image as a (part of) single slice of an OpenGL 3D texture
 	};
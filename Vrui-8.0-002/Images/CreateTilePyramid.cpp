@@ -0,0 +1,168 @@
+/***********************************************************************
+CreateTilePyramid - Function to create an on-disk tile pyramid from an
+image file, streaming the image if its file format allows it.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Images/CreateTilePyramid.h>
+
+#include <string.h>
+#include <vector>
+#include <stdexcept>
+#include <Misc/ThrowStdErr.h>
+#include <GL/gl.h>
+#include <Images/Config.h>
+#include <Images/BaseImage.h>
+#include <Images/ImageFileFormats.h>
+#include <Images/ReadImageFile.h>
+#include <Images/TilePyramidBuilder.h>
+#if IMAGES_CONFIG_HAVE_TIFF
+#include <IO/File.h>
+#include <IO/OpenFile.h>
+#include <Images/TIFFReader.h>
+#endif
+
+namespace Images {
+
+namespace {
+
+#if IMAGES_CONFIG_HAVE_TIFF
+
+/***********************************************************************
+Helper class to assemble complete image rows from the pixel stream of a
+tiled TIFF image, which delivers each row of tiles one tile at a time:
+***********************************************************************/
+
+class TIFFTileRowAssembler
+	{
+	/* Elements: */
+	private:
+	TilePyramidBuilder& builder; // Builder receiving assembled image rows
+	uint32 width,height; // Image size
+	uint32 tileHeight; // Height of the image's tiles
+	size_t rowSize; // Size of an image row in bytes
+	std::vector<unsigned char> tileRowBuffer; // Buffer holding one row of tiles, top pixel row first
+	
+	/* Constructors and destructors: */
+	public:
+	TIFFTileRowAssembler(TilePyramidBuilder& sBuilder,const TIFFReader& reader)
+		:builder(sBuilder),
+		 width(reader.getWidth()),height(reader.getHeight()),
+		 tileHeight(reader.getTileHeight()),
+		 rowSize(size_t(width)*builder.getPixelSize()),
+		 tileRowBuffer(size_t(tileHeight)*rowSize)
+		{
+		}
+	
+	/* Methods: */
+	static void pixelStreamingCallback(uint32 x,uint32 y,uint32 w,uint16 channel,const uint8* pixels,void* userData)
+		{
+		TIFFTileRowAssembler* thisPtr=static_cast<TIFFTileRowAssembler*>(userData);
+		
+		/* Find the row of tiles containing the pixel row: */
+		uint32 tileRowTop=thisPtr->height-1-((thisPtr->height-1-y)/thisPtr->tileHeight)*thisPtr->tileHeight;
+		uint32 tileRowBottom=tileRowTop+1>thisPtr->tileHeight?tileRowTop+1-thisPtr->tileHeight:0;
+		
+		/* Copy the pixels into the row of tiles: */
+		size_t pixelSize=thisPtr->builder.getPixelSize();
+		memcpy(&thisPtr->tileRowBuffer[size_t(tileRowTop-y)*thisPtr->rowSize+size_t(x)*pixelSize],pixels,size_t(w)*pixelSize);
+		
+		if(x+w==thisPtr->width&&y==tileRowBottom)
+			{
+			/* Pass the completed row of tiles to the builder from the top down: */
+			const unsigned char* rowPtr=&thisPtr->tileRowBuffer[0];
+			for(uint32 row=tileRowTop+1;row!=tileRowBottom;--row,rowPtr+=thisPtr->rowSize)
+				thisPtr->builder.addRow(rowPtr);
+			}
+		}
+	};
+
+/***********************************************************************
+Callback to pass complete rows from the pixel stream of a stripped TIFF
+image directly to a tile pyramid builder:
+***********************************************************************/
+
+void stripRowCallback(uint32 x,uint32 y,uint32 w,uint16 channel,const uint8* pixels,void* userData)
+	{
+	static_cast<TilePyramidBuilder*>(userData)->addRow(pixels);
+	}
+
+void createTIFFTilePyramid(const char* imageFileName,const char* pyramidFileName,unsigned int tileSize)
+	{
+	/* Create a TIFF image reader: */
+	IO::FilePtr file=IO::openFile(imageFileName);
+	TIFFReader reader(*file);
+	
+	/* Check the image format: */
+	if(reader.getNumSamples()<1||reader.getNumSamples()>4)
+		Misc::throwStdErr("Images::createTilePyramid: Unsupported number %u of channels in image file %s",(unsigned int)(reader.getNumSamples()),imageFileName);
+	if(reader.isIndexed())
+		Misc::throwStdErr("Images::createTilePyramid: Unsupported indexed color in image file %s",imageFileName);
+	if(reader.isPlanar()&&reader.getNumSamples()>1)
+		Misc::throwStdErr("Images::createTilePyramid: Unsupported planar sample layout in image file %s",imageFileName);
+	GLenum scalarType=GL_NONE;
+	if(reader.hasUnsignedIntSamples()&&reader.getNumBits()==8)
+		scalarType=GL_UNSIGNED_BYTE;
+	else if(reader.hasUnsignedIntSamples()&&reader.getNumBits()==16)
+		scalarType=GL_UNSIGNED_SHORT;
+	else
+		Misc::throwStdErr("Images::createTilePyramid: Unsupported sample format in image file %s",imageFileName);
+	
+	/* Stream the image into a tile pyramid builder: */
+	TilePyramidBuilder builder(pyramidFileName,reader.getWidth(),reader.getHeight(),reader.getNumSamples(),scalarType,tileSize);
+	if(reader.isTiled())
+		{
+		TIFFTileRowAssembler assembler(builder,reader);
+		reader.streamTiles(&TIFFTileRowAssembler::pixelStreamingCallback,&assembler);
+		}
+	else
+		reader.streamStrips(stripRowCallback,&builder);
+	
+	if(!builder.isFinished())
+		Misc::throwStdErr("Images::createTilePyramid: Incomplete image data in image file %s",imageFileName);
+	}
+
+#endif
+
+}
+
+void createTilePyramid(const char* imageFileName,const char* pyramidFileName,unsigned int tileSize)
+	{
+	#if IMAGES_CONFIG_HAVE_TIFF
+	if(getImageFileFormat(imageFileName)==IFF_TIFF)
+		{
+		/* Stream the TIFF image: */
+		createTIFFTilePyramid(imageFileName,pyramidFileName,tileSize);
+		return;
+		}
+	#endif
+	
+	/* Read the entire image: */
+	BaseImage image=readGenericImageFile(imageFileName);
+	if(image.getScalarType()!=GL_UNSIGNED_BYTE&&image.getScalarType()!=GL_UNSIGNED_SHORT)
+		Misc::throwStdErr("Images::createTilePyramid: Unsupported sample format in image file %s",imageFileName);
+	
+	/* Pass the image's rows to a tile pyramid builder from the top down: */
+	TilePyramidBuilder builder(pyramidFileName,image.getWidth(),image.getHeight(),image.getNumChannels(),image.getScalarType(),tileSize);
+	const unsigned char* rowPtr=static_cast<const unsigned char*>(image.getPixels())+ptrdiff_t(image.getHeight()-1)*image.getRowStride();
+	for(unsigned int y=image.getHeight();y>0;--y,rowPtr-=image.getRowStride())
+		builder.addRow(rowPtr);
+	}
+
+}
@@ -0,0 +1,32 @@
+/***********************************************************************
+CreateTilePyramid - Function to create an on-disk tile pyramid from an
+image file, streaming the image if its file format allows it.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef IMAGES_CREATETILEPYRAMID_INCLUDED
+#define IMAGES_CREATETILEPYRAMID_INCLUDED
+
+namespace Images {
+
+void createTilePyramid(const char* imageFileName,const char* pyramidFileName,unsigned int tileSize =256); // Creates a tile pyramid file from an image file; streams TIFF images strip by strip or tile by tile, and reads images of other formats into memory
+
+}
+
+#endif
@@ -170,14 +170,28 @@ const TextureSet::GLState::Texture& TextureSet::GLState::bindTexture(TextureSet:
 	/* Check if the texture image is outdated: */
 	if(t.imageVersion!=s.imageVersion)
 		{
-		/* Upload the new texture image into the base mipmap level: */
-		s.image.glTexImage2D(s.target,s.mipmapRange[0],s.internalFormat,!haveNpotdTextures);
+		/* Pad the new texture image to a power-of-two size if required, and upload it into the base mipmap level: */
+		BaseImage image=haveNpotdTextures?s.image:s.image.padToPowerOfTwo();
+		image.glTexImage2D(s.target,s.mipmapRange[0],s.internalFormat,false);
 		
-		/* Check if mipmap levels are requested and automatic mipmap generation is supported: */
-		if(s.mipmapRange[1]>s.mipmapRange[0]&&haveGenerateMipmap)
+		/* Check if mipmap levels are requested: */
+		if(s.mipmapRange[1]>s.mipmapRange[0])
 			{
-			/* Auto-generate all requested mipmap levels: */
-			glGenerateMipmapEXT(s.target);
+			if(s.mipmapFilter==BaseImage::BOX_FILTER&&haveGenerateMipmap)
+				{
+				/* Auto-generate all requested mipmap levels: */
+				glGenerateMipmapEXT(s.target);
+				}
+			else
+				{
+				/* Generate the requested mipmap levels on the CPU and upload them level by level: */
+				BaseImage level=image;
+				for(GLint levelIndex=s.mipmapRange[0]+1;levelIndex<=s.mipmapRange[1]&&(level.getWidth()>1U||level.getHeight()>1U);++levelIndex)
+					{
+					level=level.downsample(s.mipmapFilter);
+					level.glTexImage2D(s.target,levelIndex,s.internalFormat,false);
+					}
+				}
 			}
 		
 		/* Mark the cached image as up-to-date: */
@@ -221,6 +235,7 @@ TextureSet::Texture& TextureSet::addTexture(const Images::BaseImage& newImage,GL
 	newTexture.target=newTarget;
 	newTexture.internalFormat=newInternalFormat;
 	newTexture.imageVersion=1U;
+	newTexture.mipmapFilter=BaseImage::BOX_FILTER;
 	newTexture.wrapModes[0]=GL_CLAMP;
 	newTexture.wrapModes[1]=GL_CLAMP;
 	newTexture.filterModes[0]=GL_NEAREST;
@@ -260,6 +275,7 @@ TextureSet::Texture& TextureSet::addTexture(const Images::BaseImage& newImage,GL
 	newTexture.target=newTarget;
 	newTexture.internalFormat=newInternalFormat;
 	newTexture.imageVersion=1U;
+	newTexture.mipmapFilter=BaseImage::BOX_FILTER;
 	newTexture.wrapModes[0]=GL_CLAMP;
 	newTexture.wrapModes[1]=GL_CLAMP;
 	newTexture.filterModes[0]=GL_NEAREST;
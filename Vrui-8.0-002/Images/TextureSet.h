@@ -47,6 +47,7 @@ class TextureSet:public GLObject
 		GLenum internalFormat; // Internal texture format for the source image
 		unsigned int imageVersion; // Version number of the source image to invalidate cached textures
 		GLint mipmapRange[2]; // Minimum and maximum mipmap levels
+		BaseImage::MipmapFilter mipmapFilter; // Filter to generate mipmap levels; non-box filters generate levels on the CPU
 		GLenum wrapModes[2]; // Horizontal and vertical texture wrapping modes
 		GLenum filterModes[2]; // Minification and magnification texture filtering modes
 		unsigned int settingsVersion; // Version number of texture settings to invalidate cached settings
@@ -88,6 +89,10 @@ class TextureSet:public GLObject
 			{
 			return mipmapRange;
 			}
+		BaseImage::MipmapFilter getMipmapFilter(void) const // Returns the filter to generate mipmap levels
+			{
+			return mipmapFilter;
+			}
 		const GLenum* getWrapModes(void) const // Returns the image's texture wrapping modes
 			{
 			return wrapModes;
@@ -106,6 +111,14 @@ class TextureSet:public GLObject
 			++imageVersion;
 			++settingsVersion;
 			}
+		void setMipmapFilter(BaseImage::MipmapFilter newMipmapFilter) // Sets the filter to generate mipmap levels
+			{
+			/* Update the mipmap filter: */
+			mipmapFilter=newMipmapFilter;
+			
+			/* Invalidate the cached image version to regenerate mipmap levels: */
+			++imageVersion;
+			}
 		void setWrapModes(GLenum newWrapS,GLenum newWrapT) // Sets the image's texture wrapping modes
 			{
 			/* Update the wrapping modes: */
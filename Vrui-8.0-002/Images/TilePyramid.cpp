@@ -0,0 +1,136 @@
+/***********************************************************************
+TilePyramid - Class to read tiles from an on-disk mipmap pyramid of
+square image tiles, to display images that are too large to be held in
+memory or in a single texture.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Images/TilePyramid.h>
+
+#include <string.h>
+#include <Misc/ThrowStdErr.h>
+#include <IO/OpenFile.h>
+
+namespace Images {
+
+/************************************
+Static elements of class TilePyramid:
+************************************/
+
+const char TilePyramid::fileHeader[24]="Vrui Tile Pyramid v1.0\n";
+
+/****************************
+Methods of class TilePyramid:
+****************************/
+
+TilePyramid::TilePyramid(const char* pyramidFileName)
+	:file(IO::openSeekableFile(pyramidFileName)),
+	 numChannels(0),scalarType(GL_NONE),tileSize(0)
+	{
+	file->setEndianness(Misc::LittleEndian);
+	
+	/* Check the file header: */
+	char header[sizeof(fileHeader)];
+	file->readRaw(header,sizeof(fileHeader));
+	if(memcmp(header,fileHeader,sizeof(fileHeader))!=0)
+		Misc::throwStdErr("Images::TilePyramid: %s is not a tile pyramid file",pyramidFileName);
+	
+	/* Read the pyramid's format: */
+	for(int i=0;i<2;++i)
+		size[i]=file->read<Misc::UInt32>();
+	numChannels=file->read<Misc::UInt32>();
+	scalarType=GLenum(file->read<Misc::UInt32>());
+	tileSize=file->read<Misc::UInt32>();
+	unsigned int numLevels=file->read<Misc::UInt32>();
+	if(size[0]==0||size[1]==0||numChannels<1||numChannels>4||getChannelSize(scalarType)==0||tileSize<2)
+		Misc::throwStdErr("Images::TilePyramid: Tile pyramid file %s has invalid format",pyramidFileName);
+	
+	/* Calculate the pyramid's layout: */
+	calcLevels(size,tileSize,levels);
+	if(levels.size()!=numLevels)
+		Misc::throwStdErr("Images::TilePyramid: Tile pyramid file %s has mismatching number of levels",pyramidFileName);
+	
+	/* Read the tile index from the end of the file: */
+	file->setReadPosAbs(file->getSize()-IO::SeekableFile::Offset(sizeof(Misc::UInt64)));
+	file->setReadPosAbs(IO::SeekableFile::Offset(file->read<Misc::UInt64>()));
+	tileOffsets.resize(levels.back().firstTile+1);
+	file->read(&tileOffsets.front(),tileOffsets.size());
+	}
+
+void TilePyramid::calcLevels(const unsigned int imageSize[2],unsigned int tileSize,std::vector<TilePyramid::Level>& levels)
+	{
+	levels.clear();
+	
+	/* Halve the image size until it fits into a single tile: */
+	unsigned int tileStride=tileSize-1;
+	Level level;
+	level.firstTile=0;
+	for(int i=0;i<2;++i)
+		level.size[i]=imageSize[i];
+	while(true)
+		{
+		/* Calculate the number of overlapping tiles needed to cover the level: */
+		for(int i=0;i<2;++i)
+			level.numTiles[i]=level.size[i]>1?(level.size[i]-1+tileStride-1)/tileStride:1;
+		levels.push_back(level);
+		if(level.numTiles[0]==1&&level.numTiles[1]==1)
+			break;
+		
+		/* Go to the next level: */
+		level.firstTile+=level.numTiles[0]*level.numTiles[1];
+		for(int i=0;i<2;++i)
+			level.size[i]=(level.size[i]+1)/2;
+		}
+	}
+
+size_t TilePyramid::getChannelSize(GLenum scalarType)
+	{
+	switch(scalarType)
+		{
+		case GL_UNSIGNED_BYTE:
+			return 1;
+		
+		case GL_UNSIGNED_SHORT:
+			return 2;
+		
+		default:
+			return 0;
+		}
+	}
+
+GLenum TilePyramid::getFormat(unsigned int numChannels)
+	{
+	static const GLenum formats[4]={GL_LUMINANCE,GL_LUMINANCE_ALPHA,GL_RGB,GL_RGBA};
+	return formats[numChannels-1];
+	}
+
+void TilePyramid::readTile(unsigned int tileIndex,void* tileData) const
+	{
+	Threads::Mutex::Lock fileLock(fileMutex);
+	
+	/* Read the tile's sample data: */
+	file->setReadPosAbs(IO::SeekableFile::Offset(tileOffsets[tileIndex]));
+	size_t numSamples=size_t(tileSize)*size_t(tileSize)*size_t(numChannels);
+	if(scalarType==GL_UNSIGNED_SHORT)
+		file->read(static_cast<Misc::UInt16*>(tileData),numSamples);
+	else
+		file->readRaw(tileData,numSamples);
+	}
+
+}
@@ -0,0 +1,141 @@
+/***********************************************************************
+TilePyramid - Class to read tiles from an on-disk mipmap pyramid of
+square image tiles, to display images that are too large to be held in
+memory or in a single texture.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef IMAGES_TILEPYRAMID_INCLUDED
+#define IMAGES_TILEPYRAMID_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+#include <Misc/SizedTypes.h>
+#include <IO/SeekableFile.h>
+#include <Threads/Mutex.h>
+#include <GL/gl.h>
+
+namespace Images {
+
+class TilePyramid
+	{
+	/* Embedded classes: */
+	public:
+	struct Level // Structure describing one level of a tile pyramid
+		{
+		/* Elements: */
+		public:
+		unsigned int size[2]; // Width and height of the level's image in pixels
+		unsigned int numTiles[2]; // Number of tiles in x and y
+		unsigned int firstTile; // Index of the level's first tile in the pyramid
+		};
+	
+	/*********************************************************************
+	Pyramid file layout, all in little endian: 24-byte file header,
+	UInt32 image width, image height, number of channels, scalar type
+	(GLenum), tile size, and number of levels, followed by the tiles'
+	sample data in arbitrary order, followed by one UInt64 file offset
+	per tile in pyramid order, followed by the UInt64 file offset of the
+	tile index.
+	
+	Level 0 is the full-resolution image; each following level halves
+	the previous level's size, rounding up, until the level fits into a
+	single tile. Tiles are square, stored bottom row first, and overlap
+	their right and top neighbors by one pixel to allow seamless linear
+	interpolation. Tile (x, y) on a level covers the level's pixels
+	[x*(tileSize-1), x*(tileSize-1)+tileSize) horizontally, and likewise
+	vertically; pixels outside the level's image replicate its edge.
+	*********************************************************************/
+	
+	static const char fileHeader[24]; // Identifier at the beginning of tile pyramid files
+	
+	/* Elements: */
+	private:
+	mutable Threads::Mutex fileMutex; // Mutex serializing access to the pyramid file
+	IO::SeekableFilePtr file; // The pyramid file
+	unsigned int size[2]; // Width and height of the full-resolution image in pixels
+	unsigned int numChannels; // Number of channels per pixel
+	GLenum scalarType; // Scalar type of pixel channels, GL_UNSIGNED_BYTE or GL_UNSIGNED_SHORT
+	unsigned int tileSize; // Width and height of each tile in pixels
+	std::vector<Level> levels; // Levels of the tile pyramid, from full resolution to one tile
+	std::vector<Misc::UInt64> tileOffsets; // File offsets of all tiles' sample data in pyramid order
+	
+	/* Constructors and destructors: */
+	public:
+	TilePyramid(const char* pyramidFileName); // Opens the tile pyramid file of the given name
+	private:
+	TilePyramid(const TilePyramid& source); // Prohibit copy constructor
+	TilePyramid& operator=(const TilePyramid& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	static void calcLevels(const unsigned int imageSize[2],unsigned int tileSize,std::vector<Level>& levels); // Calculates the layout of the tile pyramid for an image of the given size
+	static size_t getChannelSize(GLenum scalarType); // Returns the size of a channel of the given scalar type in bytes, or zero if the type is not supported
+	static GLenum getFormat(unsigned int numChannels); // Returns the OpenGL pixel format for the given number of channels
+	const unsigned int* getSize(void) const // Returns the size of the full-resolution image
+		{
+		return size;
+		}
+	unsigned int getSize(int dimension) const // Returns the width or height of the full-resolution image
+		{
+		return size[dimension];
+		}
+	unsigned int getNumChannels(void) const // Returns the number of channels per pixel
+		{
+		return numChannels;
+		}
+	GLenum getScalarType(void) const // Returns the scalar type of pixel channels
+		{
+		return scalarType;
+		}
+	GLenum getFormat(void) const // Returns the OpenGL pixel format of tiles
+		{
+		return getFormat(numChannels);
+		}
+	unsigned int getTileSize(void) const // Returns the width and height of each tile in pixels
+		{
+		return tileSize;
+		}
+	size_t getTileDataSize(void) const // Returns the size of a tile's sample data in bytes
+		{
+		return size_t(tileSize)*size_t(tileSize)*size_t(numChannels)*getChannelSize(scalarType);
+		}
+	unsigned int getNumLevels(void) const // Returns the number of levels in the pyramid
+		{
+		return levels.size();
+		}
+	const Level& getLevel(unsigned int level) const // Returns the layout of the given pyramid level
+		{
+		return levels[level];
+		}
+	unsigned int getNumTiles(void) const // Returns the total number of tiles in the pyramid
+		{
+		return tileOffsets.size();
+		}
+	unsigned int getTileIndex(unsigned int level,unsigned int tileX,unsigned int tileY) const // Returns the pyramid index of the given tile
+		{
+		const Level& l=levels[level];
+		return l.firstTile+tileY*l.numTiles[0]+tileX;
+		}
+	void readTile(unsigned int tileIndex,void* tileData) const; // Reads the sample data of the tile of the given pyramid index into the given buffer; can be called from multiple threads
+	};
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+/***********************************************************************
+TilePyramidBuilder - Class to create an on-disk tile pyramid from an
+image that is streamed in row by row, using memory proportional to the
+image's width instead of its size.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Images/TilePyramidBuilder.h>
+
+#include <string.h>
+#include <stdexcept>
+#include <Misc/ThrowStdErr.h>
+#include <IO/OpenFile.h>
+
+namespace Images {
+
+namespace {
+
+/***********************************************************************
+Helper function to combine two adjacent rows of a pyramid level into one
+row of the next level by averaging 2x2 pixel blocks:
+***********************************************************************/
+
+template <class SampleParam>
+inline
+void
+reduceRow(
+	const void* evenRow,
+	const void* oddRow,
+	unsigned int width,
+	unsigned int numChannels,
+	void* reducedRow)
+	{
+	const SampleParam* r0=static_cast<const SampleParam*>(evenRow);
+	const SampleParam* r1=static_cast<const SampleParam*>(oddRow);
+	SampleParam* rPtr=static_cast<SampleParam*>(reducedRow);
+	for(unsigned int x=0;x<width;x+=2)
+		{
+		/* Replicate the last column if the row has an odd number of pixels: */
+		unsigned int x0=x*numChannels;
+		unsigned int x1=x+1<width?x0+numChannels:x0;
+		for(unsigned int c=0;c<numChannels;++c,++rPtr)
+			*rPtr=SampleParam(((unsigned int)(r0[x0+c])+(unsigned int)(r0[x1+c])+(unsigned int)(r1[x0+c])+(unsigned int)(r1[x1+c])+2U)>>2);
+		}
+	}
+
+}
+
+/***********************************
+Methods of class TilePyramidBuilder:
+***********************************/
+
+void TilePyramidBuilder::writeTileRow(TilePyramidBuilder::LevelState& level)
+	{
+	size_t rowSize=size_t(level.paddedWidth)*pixelSize;
+	size_t tileRowSize=size_t(tileSize)*pixelSize;
+	size_t tileStride=size_t(tileSize-1)*pixelSize;
+	size_t numSamples=size_t(tileSize)*size_t(tileSize)*size_t(numChannels);
+	Misc::UInt64* tileOffsetPtr=&tileOffsets[level.layout.firstTile+level.tileRow*level.layout.numTiles[0]];
+	for(unsigned int tileX=0;tileX<level.layout.numTiles[0];++tileX,++tileOffsetPtr)
+		{
+		/* Assemble the tile from the tile row buffer: */
+		const unsigned char* sPtr=&level.tileRowBuffer[tileX*tileStride];
+		unsigned char* tPtr=&tileBuffer[0];
+		for(unsigned int y=0;y<tileSize;++y,sPtr+=rowSize,tPtr+=tileRowSize)
+			memcpy(tPtr,sPtr,tileRowSize);
+		
+		/* Write the tile to the file: */
+		*tileOffsetPtr=Misc::UInt64(file->getWritePos());
+		if(scalarType==GL_UNSIGNED_SHORT)
+			file->write(reinterpret_cast<const Misc::UInt16*>(&tileBuffer[0]),numSamples);
+		else
+			file->writeRaw(&tileBuffer[0],numSamples);
+		}
+	}
+
+void TilePyramidBuilder::addLevelRow(unsigned int levelIndex,const unsigned char* row)
+	{
+	LevelState& level=levels[levelIndex];
+	unsigned int width=level.layout.size[0];
+	size_t rowSize=size_t(level.paddedWidth)*pixelSize;
+	
+	/* Copy the row into the tile row buffer and replicate its last pixel into the padding: */
+	unsigned int bufferRow=level.nextRow-level.tileRow*(tileSize-1);
+	unsigned char* bufferRowPtr=&level.tileRowBuffer[bufferRow*rowSize];
+	memcpy(bufferRowPtr,row,width*pixelSize);
+	for(unsigned int x=width;x<level.paddedWidth;++x)
+		memcpy(bufferRowPtr+x*pixelSize,row+(width-1)*pixelSize,pixelSize);
+	
+	/* Replicate the level's top row into the part of the top row of tiles that lies above the level: */
+	if(level.nextRow==level.layout.size[1]-1)
+		for(unsigned int y=bufferRow+1;y<tileSize;++y)
+			memcpy(&level.tileRowBuffer[y*rowSize],bufferRowPtr,rowSize);
+	
+	/* Propagate the row to the next level: */
+	if(levelIndex+1<levels.size())
+		{
+		if(level.nextRow&0x1U)
+			{
+			/* Keep the row until the even row below it arrives: */
+			memcpy(&level.oddRow[0],row,width*pixelSize);
+			level.haveOddRow=true;
+			}
+		else
+			{
+			/* Combine the row with the odd row above it, or with itself if it is the level's top row: */
+			const unsigned char* oddRow=level.haveOddRow?&level.oddRow[0]:row;
+			if(scalarType==GL_UNSIGNED_SHORT)
+				reduceRow<Misc::UInt16>(row,oddRow,width,numChannels,&level.reducedRow[0]);
+			else
+				reduceRow<Misc::UInt8>(row,oddRow,width,numChannels,&level.reducedRow[0]);
+			level.haveOddRow=false;
+			addLevelRow(levelIndex+1,&level.reducedRow[0]);
+			}
+		}
+	
+	if(bufferRow==0)
+		{
+		/* Write the completed row of tiles: */
+		writeTileRow(level);
+		
+		if(level.tileRow>0)
+			{
+			/* Start the next row of tiles below, which overlaps the completed row by one pixel row: */
+			memcpy(&level.tileRowBuffer[(tileSize-1)*rowSize],bufferRowPtr,rowSize);
+			--level.tileRow;
+			}
+		}
+	
+	--level.nextRow;
+	}
+
+void TilePyramidBuilder::finish(void)
+	{
+	/* Write the tile index and its offset: */
+	Misc::UInt64 indexOffset=Misc::UInt64(file->getWritePos());
+	file->write(&tileOffsets.front(),tileOffsets.size());
+	file->write(indexOffset);
+	
+	/* Close the pyramid file and release all buffers: */
+	file=0;
+	std::vector<unsigned char>().swap(tileBuffer);
+	for(std::vector<LevelState>::iterator lIt=levels.begin();lIt!=levels.end();++lIt)
+		{
+		std::vector<unsigned char>().swap(lIt->tileRowBuffer);
+		std::vector<unsigned char>().swap(lIt->oddRow);
+		std::vector<unsigned char>().swap(lIt->reducedRow);
+		}
+	}
+
+TilePyramidBuilder::TilePyramidBuilder(const char* pyramidFileName,unsigned int sWidth,unsigned int sHeight,unsigned int sNumChannels,GLenum sScalarType,unsigned int sTileSize)
+	:numChannels(sNumChannels),scalarType(sScalarType),
+	 pixelSize(size_t(numChannels)*TilePyramid::getChannelSize(scalarType)),
+	 tileSize(sTileSize)
+	{
+	size[0]=sWidth;
+	size[1]=sHeight;
+	
+	/* Check the image format: */
+	if(size[0]==0||size[1]==0)
+		throw std::runtime_error("Images::TilePyramidBuilder: Empty image");
+	if(numChannels<1||numChannels>4)
+		Misc::throwStdErr("Images::TilePyramidBuilder: Unsupported number %u of channels",numChannels);
+	if(pixelSize==0)
+		throw std::runtime_error("Images::TilePyramidBuilder: Unsupported channel scalar type");
+	if(tileSize<2)
+		Misc::throwStdErr("Images::TilePyramidBuilder: Invalid tile size %u",tileSize);
+	
+	/* Set up the state of all pyramid levels: */
+	std::vector<TilePyramid::Level> layouts;
+	TilePyramid::calcLevels(size,tileSize,layouts);
+	levels.resize(layouts.size());
+	for(unsigned int i=0;i<layouts.size();++i)
+		{
+		LevelState& level=levels[i];
+		level.layout=layouts[i];
+		level.paddedWidth=level.layout.numTiles[0]*(tileSize-1)+1;
+		level.nextRow=level.layout.size[1]-1;
+		level.tileRow=level.layout.numTiles[1]-1;
+		level.tileRowBuffer.resize(size_t(tileSize)*size_t(level.paddedWidth)*pixelSize);
+		if(i+1<layouts.size())
+			{
+			level.oddRow.resize(size_t(level.layout.size[0])*pixelSize);
+			level.reducedRow.resize(size_t(layouts[i+1].size[0])*pixelSize);
+			}
+		level.haveOddRow=false;
+		}
+	tileBuffer.resize(size_t(tileSize)*size_t(tileSize)*pixelSize);
+	tileOffsets.resize(layouts.back().firstTile+1);
+	
+	/* Create the pyramid file and write its header: */
+	file=IO::openSeekableFile(pyramidFileName,IO::File::WriteOnly);
+	file->setEndianness(Misc::LittleEndian);
+	file->writeRaw(TilePyramid::fileHeader,sizeof(TilePyramid::fileHeader));
+	for(int i=0;i<2;++i)
+		file->write(Misc::UInt32(size[i]));
+	file->write(Misc::UInt32(numChannels));
+	file->write(Misc::UInt32(scalarType));
+	file->write(Misc::UInt32(tileSize));
+	file->write(Misc::UInt32(levels.size()));
+	}
+
+void TilePyramidBuilder::addRow(const void* row)
+	{
+	if(isFinished())
+		throw std::runtime_error("Images::TilePyramidBuilder::addRow: All image rows have already been added");
+	
+	/* Add the row to the full-resolution level, which propagates it through the pyramid: */
+	addLevelRow(0,static_cast<const unsigned char*>(row));
+	
+	/* Finish the pyramid file after the bottom row: */
+	if(isFinished())
+		finish();
+	}
+
+}
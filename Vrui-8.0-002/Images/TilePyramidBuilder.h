@@ -0,0 +1,96 @@
+/***********************************************************************
+TilePyramidBuilder - Class to create an on-disk tile pyramid from an
+image that is streamed in row by row, using memory proportional to the
+image's width instead of its size.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef IMAGES_TILEPYRAMIDBUILDER_INCLUDED
+#define IMAGES_TILEPYRAMIDBUILDER_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+#include <Misc/SizedTypes.h>
+#include <IO/SeekableFile.h>
+#include <GL/gl.h>
+#include <Images/TilePyramid.h>
+
+namespace Images {
+
+class TilePyramidBuilder
+	{
+	/* Embedded classes: */
+	private:
+	struct LevelState // Structure holding the state of one pyramid level during streaming
+		{
+		/* Elements: */
+		public:
+		TilePyramid::Level layout; // The level's layout
+		unsigned int paddedWidth; // Width of the level's tile row buffer in pixels
+		unsigned int nextRow; // Index of the next row to be received by the level
+		unsigned int tileRow; // Index of the tile row currently being filled
+		std::vector<unsigned char> tileRowBuffer; // Buffer holding one row of tiles, with bottom pixel row first
+		std::vector<unsigned char> oddRow; // Buffer holding the last received odd row to be combined with the following even row
+		bool haveOddRow; // Flag if the odd row buffer holds a row
+		std::vector<unsigned char> reducedRow; // Buffer to pass a reduced row to the next level
+		};
+	
+	/* Elements: */
+	IO::SeekableFilePtr file; // The pyramid file being written
+	unsigned int size[2]; // Width and height of the full-resolution image in pixels
+	unsigned int numChannels; // Number of channels per pixel
+	GLenum scalarType; // Scalar type of pixel channels
+	size_t pixelSize; // Size of a pixel in bytes
+	unsigned int tileSize; // Width and height of each tile in pixels
+	std::vector<LevelState> levels; // States of all pyramid levels
+	std::vector<unsigned char> tileBuffer; // Buffer to assemble a tile before writing it to the file
+	std::vector<Misc::UInt64> tileOffsets; // File offsets of all written tiles in pyramid order
+	
+	/* Private methods: */
+	void writeTileRow(LevelState& level); // Writes the level's current row of tiles to the file
+	void addLevelRow(unsigned int levelIndex,const unsigned char* row); // Adds the next row to the given pyramid level and propagates it to the next level
+	void finish(void); // Writes the tile index after the last row has been received
+	
+	/* Constructors and destructors: */
+	public:
+	TilePyramidBuilder(const char* pyramidFileName,unsigned int sWidth,unsigned int sHeight,unsigned int sNumChannels,GLenum sScalarType,unsigned int sTileSize =256); // Creates a pyramid file for an image of the given size and pixel format; scalar type must be GL_UNSIGNED_BYTE or GL_UNSIGNED_SHORT
+	private:
+	TilePyramidBuilder(const TilePyramidBuilder& source); // Prohibit copy constructor
+	TilePyramidBuilder& operator=(const TilePyramidBuilder& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	size_t getPixelSize(void) const // Returns the size of a pixel in bytes
+		{
+		return pixelSize;
+		}
+	unsigned int getNextRow(void) const // Returns the index of the next expected image row
+		{
+		return levels[0].nextRow;
+		}
+	bool isFinished(void) const // Returns true if all image rows have been received and the pyramid file is complete
+		{
+		return levels[0].nextRow==~0U;
+		}
+	void addRow(const void* row); // Adds the next image row of interleaved pixels; rows must be added from the top (row height-1) to the bottom (row 0) of the image
+	};
+
+}
+
+#endif
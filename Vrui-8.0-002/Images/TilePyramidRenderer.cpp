@@ -0,0 +1,621 @@
+/***********************************************************************
+TilePyramidRenderer - Class to render an image stored in an on-disk
+tile pyramid by loading the visible tiles at the appropriate resolution
+in background threads and caching them as textures under a fixed memory
+budget.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Images/TilePyramidRenderer.h>
+
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <Misc/MessageLogger.h>
+#include <Math/Math.h>
+#include <Math/Constants.h>
+#include <GL/gl.h>
+#include <GL/GLContextData.h>
+#include <Images/TilePyramid.h>
+
+namespace Images {
+
+namespace {
+
+/***********************************************************************
+Helper function to test a rectangle in the z=0 plane against the view
+frustum, and to calculate the projected size of one of its pixels in
+window pixels:
+***********************************************************************/
+
+bool projectRectangle(const GLdouble pmv[16],const GLint viewport[4],const double extent[2][2],const double numPixels[2],double& pixelSize)
+	{
+	/* Transform the rectangle's corners to clip coordinates: */
+	double clip[4][4];
+	for(int corner=0;corner<4;++corner)
+		{
+		double x=extent[0][corner&0x1];
+		double y=extent[1][(corner>>1)&0x1];
+		for(int i=0;i<4;++i)
+			clip[corner][i]=pmv[i]*x+pmv[4+i]*y+pmv[12+i];
+		}
+	
+	/* Cull the rectangle if all its corners are outside the same frustum plane: */
+	for(int i=0;i<3;++i)
+		{
+		bool allBelow=true;
+		bool allAbove=true;
+		for(int corner=0;corner<4;++corner)
+			{
+			allBelow=allBelow&&clip[corner][i]<-clip[corner][3];
+			allAbove=allAbove&&clip[corner][i]>clip[corner][3];
+			}
+		if(allBelow||allAbove)
+			return false;
+		}
+	
+	/* Calculate the corners' window positions: */
+	double window[4][2];
+	for(int corner=0;corner<4;++corner)
+		{
+		/* Assume infinite pixel size if the rectangle crosses the eye plane: */
+		if(clip[corner][3]<=0.0)
+			{
+			pixelSize=Math::Constants<double>::max;
+			return true;
+			}
+		for(int i=0;i<2;++i)
+			window[corner][i]=(clip[corner][i]/clip[corner][3]+1.0)*0.5*double(viewport[2+i]);
+		}
+	
+	/* Calculate the maximum projected pixel size along the rectangle's four edges: */
+	static const int edges[4][3]={{0,1,0},{2,3,0},{0,2,1},{1,3,1}};
+	pixelSize=0.0;
+	for(int edge=0;edge<4;++edge)
+		{
+		const double* w0=window[edges[edge][0]];
+		const double* w1=window[edges[edge][1]];
+		double length=Math::sqrt(Math::sqr(w1[0]-w0[0])+Math::sqr(w1[1]-w0[1]));
+		pixelSize=Math::max(pixelSize,length/numPixels[edges[edge][2]]);
+		}
+	
+	return true;
+	}
+
+}
+
+/***********************************************
+Methods of class TilePyramidRenderer::DataItem:
+***********************************************/
+
+TilePyramidRenderer::DataItem::DataItem(unsigned int numSlots)
+	:textureObjectIds(numSlots,0),
+	 slotTiles(numSlots,~0U),slotPasses(numSlots,0U),
+	 tileSlots(101),
+	 pass(0U)
+	{
+	glGenTextures(numSlots,&textureObjectIds[0]);
+	}
+
+TilePyramidRenderer::DataItem::~DataItem(void)
+	{
+	glDeleteTextures(textureObjectIds.size(),&textureObjectIds[0]);
+	}
+
+/************************************
+Methods of class TilePyramidRenderer:
+************************************/
+
+void* TilePyramidRenderer::loaderThreadMethod(void)
+	{
+	size_t tileDataSize=pyramid.getTileDataSize();
+	while(true)
+		{
+		/* Wait for the next load request: */
+		unsigned int tileIndex;
+		{
+		Threads::MutexCond::Lock loaderLock(loaderCond);
+		while(!shutdown&&loadRequests.empty())
+			loaderCond.wait(loaderLock);
+		if(shutdown)
+			break;
+		tileIndex=loadRequests.front();
+		loadRequests.pop_front();
+		loadingTiles.setEntry(TileSet::Entry(tileIndex));
+		}
+		
+		/* Read the tile from the pyramid file without holding the lock: */
+		unsigned char* data=new unsigned char[tileDataSize];
+		try
+			{
+			pyramid.readTile(tileIndex,data);
+			}
+		catch(const std::runtime_error& err)
+			{
+			Misc::formattedConsoleError("Images::TilePyramidRenderer: Unable to load tile %u due to exception %s",tileIndex,err.what());
+			delete[] data;
+			data=0;
+			}
+		
+		/* Store the tile in the tile cache: */
+		{
+		Threads::MutexCond::Lock loaderLock(loaderCond);
+		loadingTiles.removeEntry(tileIndex);
+		if(data==0)
+			{
+			/* Don't request the tile again: */
+			failedTiles.setEntry(TileSet::Entry(tileIndex));
+			}
+		else
+			{
+			/* Evict the least recently used tile that is not being uploaded if the cache is full: */
+			if(tileCache.getNumEntries()>=maxNumCachedTiles)
+				{
+				TileCache::Iterator lruIt=tileCache.end();
+				for(TileCache::Iterator tcIt=tileCache.begin();!tcIt.isFinished();++tcIt)
+					if(tcIt->getDest().numPins==0&&(lruIt.isFinished()||lruIt->getDest().lastUsed>tcIt->getDest().lastUsed))
+						lruIt=tcIt;
+				if(!lruIt.isFinished())
+					{
+					delete[] lruIt->getDest().data;
+					tileCache.removeEntry(lruIt);
+					}
+				}
+			
+			CachedTile cachedTile;
+			cachedTile.data=data;
+			cachedTile.lastUsed=++cacheUseCounter;
+			cachedTile.numPins=0;
+			tileCache.setEntry(TileCache::Entry(tileIndex,cachedTile));
+			}
+		}
+		
+		/* Request another rendering pass to show the new tile: */
+		if(data!=0)
+			requestRedraw();
+		}
+	
+	return 0;
+	}
+
+void TilePyramidRenderer::getTileExtent(const TilePyramidRenderer::TileRef& tile,double extent[2][2]) const
+	{
+	const TilePyramid::Level& level=pyramid.getLevel(tile.level);
+	unsigned int tileSize=pyramid.getTileSize();
+	unsigned int tileStride=tileSize-1;
+	for(int i=0;i<2;++i)
+		{
+		/* Tiles meet halfway between their shared pixels, and extend to the level's edges: */
+		double min=tile.index[i]>0?double(tile.index[i]*tileStride)+0.5:0.0;
+		double max=tile.index[i]+1<level.numTiles[i]?double(tile.index[i]*tileStride+tileSize)-0.5:double(level.size[i]);
+		
+		/* Convert the extent to full-resolution image coordinates: */
+		double scale=double(pyramid.getSize(i))/double(level.size[i]);
+		extent[i][0]=min*scale;
+		extent[i][1]=max*scale;
+		}
+	}
+
+void TilePyramidRenderer::requestTiles(const std::vector<unsigned int>& tileIndices) const
+	{
+	Threads::MutexCond::Lock loaderLock(loaderCond);
+	
+	/* Insert the requests in order of increasing urgency to leave the most urgent request at the front of the queue: */
+	bool haveNewRequests=false;
+	for(std::vector<unsigned int>::const_reverse_iterator tiIt=tileIndices.rbegin();tiIt!=tileIndices.rend();++tiIt)
+		{
+		/* Mark tiles that are already loaded as recently used: */
+		TileCache::Iterator tcIt=tileCache.findEntry(*tiIt);
+		if(!tcIt.isFinished())
+			{
+			tcIt->getDest().lastUsed=++cacheUseCounter;
+			continue;
+			}
+		
+		/* Skip tiles that are currently being loaded or could not be loaded: */
+		if(loadingTiles.isEntry(*tiIt)||failedTiles.isEntry(*tiIt))
+			continue;
+		
+		/* Move the tile to the front of the request queue: */
+		std::deque<unsigned int>::iterator lrIt=std::find(loadRequests.begin(),loadRequests.end(),*tiIt);
+		if(lrIt!=loadRequests.end())
+			loadRequests.erase(lrIt);
+		loadRequests.push_front(*tiIt);
+		haveNewRequests=true;
+		}
+	
+	/* Drop the least urgent requests that would not fit into the tile cache anyway: */
+	while(loadRequests.size()>maxNumCachedTiles)
+		loadRequests.pop_back();
+	
+	/* Wake up the loader threads: */
+	if(haveNewRequests)
+		loaderCond.broadcast();
+	}
+
+void TilePyramidRenderer::requestRedraw(void) const
+	{
+	/* Call the redraw callback while holding its lock, so that it can not be deleted while it is being called: */
+	Threads::Mutex::Lock redrawCallbackLock(redrawCallbackMutex);
+	if(redrawCallback!=0)
+		(*redrawCallback)(*this);
+	}
+
+TilePyramidRenderer::TilePyramidRenderer(const TilePyramid& sPyramid,size_t textureMemorySize,size_t cacheMemorySize,unsigned int numLoaderThreads)
+	:pyramid(sPyramid),
+	 internalFormat(GL_RGB8),
+	 numTextureSlots(0),maxNumUploads(8),lodBias(1.0),maxNumCachedTiles(0),
+	 shutdown(false),
+	 loadingTiles(17),failedTiles(17),tileCache(101),cacheUseCounter(0),
+	 redrawCallback(0)
+	{
+	/* Determine the internal texture format for tiles: */
+	static const GLenum internalFormats[2][4]=
+		{
+		{GL_LUMINANCE8,GL_LUMINANCE8_ALPHA8,GL_RGB8,GL_RGBA8},
+		{GL_LUMINANCE16,GL_LUMINANCE16_ALPHA16,GL_RGB16,GL_RGBA16}
+		};
+	internalFormat=internalFormats[pyramid.getScalarType()==GL_UNSIGNED_SHORT?1:0][pyramid.getNumChannels()-1];
+	
+	/* Calculate the number of tiles fitting into the memory budgets: */
+	size_t tileDataSize=pyramid.getTileDataSize();
+	numTextureSlots=Math::max((unsigned int)(textureMemorySize/tileDataSize),4U);
+	maxNumCachedTiles=Math::max((unsigned int)(cacheMemorySize/tileDataSize),4U);
+	
+	/* Start the loader threads: */
+	for(unsigned int i=0;i<numLoaderThreads;++i)
+		{
+		Threads::Thread* loaderThread=new Threads::Thread;
+		loaderThread->start(this,&TilePyramidRenderer::loaderThreadMethod);
+		loaderThreads.push_back(loaderThread);
+		}
+	}
+
+TilePyramidRenderer::~TilePyramidRenderer(void)
+	{
+	/* Shut down the loader threads: */
+	{
+	Threads::MutexCond::Lock loaderLock(loaderCond);
+	shutdown=true;
+	loaderCond.broadcast();
+	}
+	for(std::vector<Threads::Thread*>::iterator ltIt=loaderThreads.begin();ltIt!=loaderThreads.end();++ltIt)
+		{
+		(*ltIt)->join();
+		delete *ltIt;
+		}
+	
+	/* Release all cached tiles: */
+	for(TileCache::Iterator tcIt=tileCache.begin();!tcIt.isFinished();++tcIt)
+		delete[] tcIt->getDest().data;
+	
+	delete redrawCallback;
+	}
+
+void TilePyramidRenderer::initContext(GLContextData& contextData) const
+	{
+	/* Create a context data item and associate it with this object: */
+	DataItem* dataItem=new DataItem(numTextureSlots);
+	contextData.addDataItem(this,dataItem);
+	}
+
+void TilePyramidRenderer::setMaxNumUploads(unsigned int newMaxNumUploads)
+	{
+	maxNumUploads=newMaxNumUploads;
+	}
+
+void TilePyramidRenderer::setLodBias(double newLodBias)
+	{
+	lodBias=newLodBias;
+	}
+
+void TilePyramidRenderer::setRedrawCallback(TilePyramidRenderer::RedrawCallback* newRedrawCallback)
+	{
+	/* Replace the redraw callback while no thread is calling it: */
+	Threads::Mutex::Lock redrawCallbackLock(redrawCallbackMutex);
+	delete redrawCallback;
+	redrawCallback=newRedrawCallback;
+	}
+
+void TilePyramidRenderer::glRenderAction(GLContextData& contextData) const
+	{
+	/* Get the context data item and start a new rendering pass: */
+	DataItem* dataItem=contextData.retrieveDataItem<DataItem>(this);
+	unsigned int pass=++dataItem->pass;
+	
+	/* Calculate the transformation from model coordinates to clip coordinates: */
+	GLdouble proj[16],mv[16],pmv[16];
+	glGetDoublev(GL_PROJECTION_MATRIX,proj);
+	glGetDoublev(GL_MODELVIEW_MATRIX,mv);
+	for(int j=0;j<4;++j)
+		for(int i=0;i<4;++i)
+			{
+			GLdouble sum=0.0;
+			for(int k=0;k<4;++k)
+				sum+=proj[k*4+i]*mv[j*4+k];
+			pmv[j*4+i]=sum;
+			}
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT,viewport);
+	
+	/* Select the visible tiles from the top level down, refining tiles whose pixels appear too big while the texture cache has room: */
+	unsigned int tileSize=pyramid.getTileSize();
+	unsigned int topLevel=pyramid.getNumLevels()-1;
+	std::vector<TileRef> leafTiles;
+	std::vector<TileRef> current,next;
+	std::vector<double> currentPixelSizes,nextPixelSizes;
+	double extent[2][2];
+	double numPixels[2];
+	TileRef topTile(topLevel,0,0);
+	getTileExtent(topTile,extent);
+	for(int i=0;i<2;++i)
+		numPixels[i]=double(pyramid.getLevel(topLevel).size[i]);
+	double pixelSize;
+	if(projectRectangle(pmv,viewport,extent,numPixels,pixelSize))
+		{
+		current.push_back(topTile);
+		currentPixelSizes.push_back(pixelSize);
+		}
+	unsigned int numSelected=current.size();
+	for(unsigned int level=topLevel;!current.empty();--level)
+		{
+		next.clear();
+		nextPixelSizes.clear();
+		for(unsigned int ti=0;ti<current.size();++ti)
+			{
+			const TileRef& tile=current[ti];
+			bool refined=false;
+			if(level>0&&currentPixelSizes[ti]>lodBias)
+				{
+				/* Find the tile's children on the next-finer level: */
+				const TilePyramid::Level& l=pyramid.getLevel(level);
+				const TilePyramid::Level& cl=pyramid.getLevel(level-1);
+				unsigned int childBegin[2],childEnd[2];
+				for(int i=0;i<2;++i)
+					{
+					childBegin[i]=tile.index[i]*2;
+					childEnd[i]=tile.index[i]+1<l.numTiles[i]?Math::min(childBegin[i]+2,cl.numTiles[i]):cl.numTiles[i];
+					}
+				
+				/* Collect the visible children: */
+				size_t firstChild=next.size();
+				for(unsigned int y=childBegin[1];y<childEnd[1];++y)
+					for(unsigned int x=childBegin[0];x<childEnd[0];++x)
+						{
+						TileRef child(level-1,x,y);
+						getTileExtent(child,extent);
+						for(int i=0;i<2;++i)
+							numPixels[i]=(extent[i][1]-extent[i][0])*double(cl.size[i])/double(pyramid.getSize(i));
+						if(projectRectangle(pmv,viewport,extent,numPixels,pixelSize))
+							{
+							next.push_back(child);
+							nextPixelSizes.push_back(pixelSize);
+							}
+						}
+				
+				/* Keep the children if they fit into the texture cache: */
+				unsigned int numChildren=next.size()-firstChild;
+				if(numSelected-1+numChildren<=numTextureSlots)
+					{
+					numSelected=numSelected-1+numChildren;
+					refined=true;
+					}
+				else
+					{
+					next.erase(next.begin()+firstChild,next.end());
+					nextPixelSizes.resize(firstChild);
+					}
+				}
+			
+			if(!refined)
+				leafTiles.push_back(tile);
+			}
+		
+		current.swap(next);
+		currentPixelSizes.swap(nextPixelSizes);
+		}
+	
+	/* Collect the selected tiles that are not resident, with the top-level tile as fallback for all others, and mark resident tiles as used: */
+	std::vector<unsigned int> missingTiles;
+	unsigned int topTileIndex=pyramid.getTileIndex(topLevel,0,0);
+	Misc::HashTable<unsigned int,unsigned int>::Iterator tsIt=dataItem->tileSlots.findEntry(topTileIndex);
+	if(!tsIt.isFinished())
+		dataItem->slotPasses[tsIt->getDest()]=pass;
+	else
+		missingTiles.push_back(topTileIndex);
+	for(std::vector<TileRef>::iterator ltIt=leafTiles.begin();ltIt!=leafTiles.end();++ltIt)
+		{
+		/* Find the finest resident tile covering the selected tile: */
+		TileRef tile=*ltIt;
+		while(true)
+			{
+			unsigned int tileIndex=pyramid.getTileIndex(tile.level,tile.index[0],tile.index[1]);
+			tsIt=dataItem->tileSlots.findEntry(tileIndex);
+			if(!tsIt.isFinished())
+				{
+				/* Protect the tile from eviction during this pass: */
+				dataItem->slotPasses[tsIt->getDest()]=pass;
+				break;
+				}
+			if(tile.level==ltIt->level&&tileIndex!=topTileIndex)
+				missingTiles.push_back(tileIndex);
+			if(tile.level==topLevel)
+				break;
+			
+			/* Go to the parent tile: */
+			++tile.level;
+			const TilePyramid::Level& l=pyramid.getLevel(tile.level);
+			for(int i=0;i<2;++i)
+				tile.index[i]=Math::min(tile.index[i]/2,l.numTiles[i]-1);
+			}
+		}
+	
+	/* Upload missing tiles that have already been loaded: */
+	if(!missingTiles.empty())
+		{
+		glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+		glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS,0);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS,0);
+		
+		/* Select loaded tiles to upload, and pin them in the tile cache so that they can be uploaded without holding the loader lock: */
+		bool needRedraw=false;
+		std::vector<std::pair<unsigned int,const unsigned char*> > uploads;
+		std::vector<unsigned int> requests;
+		{
+		Threads::MutexCond::Lock loaderLock(loaderCond);
+		for(std::vector<unsigned int>::iterator mtIt=missingTiles.begin();mtIt!=missingTiles.end();++mtIt)
+			{
+			/* Check if the tile has been loaded: */
+			TileCache::Iterator tcIt=tileCache.findEntry(*mtIt);
+			if(tcIt.isFinished())
+				{
+				requests.push_back(*mtIt);
+				continue;
+				}
+			if(uploads.size()>=maxNumUploads)
+				{
+				/* Upload the tile in a later pass: */
+				requests.push_back(*mtIt);
+				needRedraw=true;
+				continue;
+				}
+			
+			/* Pin the tile: */
+			++tcIt->getDest().numPins;
+			tcIt->getDest().lastUsed=++cacheUseCounter;
+			uploads.push_back(std::make_pair(*mtIt,tcIt->getDest().data));
+			}
+		}
+		
+		/* Upload the selected tiles: */
+		for(std::vector<std::pair<unsigned int,const unsigned char*> >::iterator uIt=uploads.begin();uIt!=uploads.end();++uIt)
+			{
+			/* Find the least recently used texture object that is not used in this pass: */
+			unsigned int slot=~0U;
+			unsigned int slotPass=pass;
+			for(unsigned int s=0;s<numTextureSlots;++s)
+				if(slotPass>dataItem->slotPasses[s])
+					{
+					slot=s;
+					slotPass=dataItem->slotPasses[s];
+					}
+			if(slot==~0U)
+				{
+				/* Keep the tile in the cache until a texture object becomes available: */
+				requests.push_back(uIt->first);
+				continue;
+				}
+			
+			/* Evict the texture object's current tile: */
+			if(dataItem->slotTiles[slot]!=~0U)
+				dataItem->tileSlots.removeEntry(dataItem->slotTiles[slot]);
+			
+			/* Upload the tile into the texture object: */
+			glBindTexture(GL_TEXTURE_2D,dataItem->textureObjectIds[slot]);
+			if(dataItem->slotPasses[slot]==0U)
+				{
+				/* Initialize the texture object: */
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_BASE_LEVEL,0);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAX_LEVEL,0);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+				glTexImage2D(GL_TEXTURE_2D,0,internalFormat,tileSize,tileSize,0,pyramid.getFormat(),pyramid.getScalarType(),uIt->second);
+				}
+			else
+				glTexSubImage2D(GL_TEXTURE_2D,0,0,0,tileSize,tileSize,pyramid.getFormat(),pyramid.getScalarType(),uIt->second);
+			dataItem->slotTiles[slot]=uIt->first;
+			dataItem->slotPasses[slot]=pass;
+			dataItem->tileSlots.setEntry(Misc::HashTable<unsigned int,unsigned int>::Entry(uIt->first,slot));
+			}
+		glBindTexture(GL_TEXTURE_2D,0);
+		
+		glPopClientAttrib();
+		
+		/* Unpin the uploaded tiles: */
+		if(!uploads.empty())
+			{
+			Threads::MutexCond::Lock loaderLock(loaderCond);
+			for(std::vector<std::pair<unsigned int,const unsigned char*> >::iterator uIt=uploads.begin();uIt!=uploads.end();++uIt)
+				--tileCache.getEntry(uIt->first).getDest().numPins;
+			}
+		
+		/* Request loading of the remaining missing tiles: */
+		if(!requests.empty())
+			requestTiles(requests);
+		
+		/* Request another pass to upload the remaining loaded tiles: */
+		if(needRedraw)
+			requestRedraw();
+		}
+	
+	/* Draw all selected tiles using their own or the finest resident covering tile's texture: */
+	glPushAttrib(GL_ENABLE_BIT|GL_TEXTURE_BIT);
+	glEnable(GL_TEXTURE_2D);
+	unsigned int tileStride=tileSize-1;
+	for(std::vector<TileRef>::iterator ltIt=leafTiles.begin();ltIt!=leafTiles.end();++ltIt)
+		{
+		/* Find the finest resident tile covering the selected tile: */
+		TileRef tile=*ltIt;
+		while(true)
+			{
+			tsIt=dataItem->tileSlots.findEntry(pyramid.getTileIndex(tile.level,tile.index[0],tile.index[1]));
+			if(!tsIt.isFinished()||tile.level==topLevel)
+				break;
+			++tile.level;
+			const TilePyramid::Level& l=pyramid.getLevel(tile.level);
+			for(int i=0;i<2;++i)
+				tile.index[i]=Math::min(tile.index[i]/2,l.numTiles[i]-1);
+			}
+		if(tsIt.isFinished())
+			continue;
+		
+		/* Calculate the texture coordinates of the selected tile's extent inside the resident tile: */
+		getTileExtent(*ltIt,extent);
+		double texCoords[2][2];
+		const TilePyramid::Level& l=pyramid.getLevel(tile.level);
+		for(int i=0;i<2;++i)
+			{
+			double scale=double(l.size[i])/double(pyramid.getSize(i));
+			double offset=double(tile.index[i]*tileStride);
+			for(int j=0;j<2;++j)
+				texCoords[i][j]=(extent[i][j]*scale-offset)/double(tileSize);
+			}
+		
+		/* Draw the selected tile: */
+		glBindTexture(GL_TEXTURE_2D,dataItem->textureObjectIds[tsIt->getDest()]);
+		glBegin(GL_QUADS);
+		glTexCoord2d(texCoords[0][0],texCoords[1][0]);
+		glVertex2d(extent[0][0],extent[1][0]);
+		glTexCoord2d(texCoords[0][1],texCoords[1][0]);
+		glVertex2d(extent[0][1],extent[1][0]);
+		glTexCoord2d(texCoords[0][1],texCoords[1][1]);
+		glVertex2d(extent[0][1],extent[1][1]);
+		glTexCoord2d(texCoords[0][0],texCoords[1][1]);
+		glVertex2d(extent[0][0],extent[1][1]);
+		glEnd();
+		}
+	glBindTexture(GL_TEXTURE_2D,0);
+	glPopAttrib();
+	}
+
+}
@@ -0,0 +1,149 @@
+/***********************************************************************
+TilePyramidRenderer - Class to render an image stored in an on-disk
+tile pyramid by loading the visible tiles at the appropriate resolution
+in background threads and caching them as textures under a fixed memory
+budget.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Image Handling Library (Images).
+
+The Image Handling Library is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Image Handling Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Image Handling Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef IMAGES_TILEPYRAMIDRENDERER_INCLUDED
+#define IMAGES_TILEPYRAMIDRENDERER_INCLUDED
+
+#include <stddef.h>
+#include <deque>
+#include <vector>
+#include <Misc/HashTable.h>
+#include <Misc/FunctionCalls.h>
+#include <Threads/Mutex.h>
+#include <Threads/MutexCond.h>
+#include <Threads/Thread.h>
+#include <GL/gl.h>
+#include <GL/GLObject.h>
+
+/* Forward declarations: */
+namespace Images {
+class TilePyramid;
+}
+
+namespace Images {
+
+class TilePyramidRenderer:public GLObject
+	{
+	/* Embedded classes: */
+	public:
+	typedef Misc::FunctionCall<const TilePyramidRenderer&> RedrawCallback; // Type for callbacks called when the renderer needs another rendering pass to show newly loaded tiles; can be called from background threads
+	
+	private:
+	struct CachedTile // Structure for a loaded tile held in main memory
+		{
+		/* Elements: */
+		public:
+		unsigned char* data; // The tile's sample data
+		unsigned int lastUsed; // Value of the cache use counter when the tile was last loaded or requested
+		unsigned int numPins; // Number of rendering passes currently uploading the tile's data to a texture; pinned tiles are not evicted
+		};
+	
+	typedef Misc::HashTable<unsigned int,CachedTile> TileCache; // Type for hash tables mapping pyramid indices to loaded tiles
+	typedef Misc::HashTable<unsigned int,void> TileSet; // Type for sets of pyramid indices
+	
+	struct TileRef // Structure identifying a tile in the pyramid
+		{
+		/* Elements: */
+		public:
+		unsigned int level; // Pyramid level
+		unsigned int index[2]; // Tile index in x and y on the level
+		
+		/* Constructors and destructors: */
+		TileRef(unsigned int sLevel,unsigned int sIndexX,unsigned int sIndexY)
+			:level(sLevel)
+			{
+			index[0]=sIndexX;
+			index[1]=sIndexY;
+			}
+		};
+	
+	struct DataItem:public GLObject::DataItem
+		{
+		/* Elements: */
+		public:
+		std::vector<GLuint> textureObjectIds; // Texture objects in the texture cache
+		std::vector<unsigned int> slotTiles; // Pyramid index of the tile held by each texture object, or ~0U
+		std::vector<unsigned int> slotPasses; // Rendering pass in which each texture object was last used, or 0 if the texture object is not allocated
+		Misc::HashTable<unsigned int,unsigned int> tileSlots; // Map from pyramid indices of resident tiles to texture cache slots
+		unsigned int pass; // Counter of rendering passes in this OpenGL context
+		
+		/* Constructors and destructors: */
+		DataItem(unsigned int numSlots);
+		virtual ~DataItem(void);
+		};
+	
+	/* Elements: */
+	const TilePyramid& pyramid; // The rendered tile pyramid
+	GLenum internalFormat; // Internal texture format for tiles
+	unsigned int numTextureSlots; // Number of tile textures in each OpenGL context
+	unsigned int maxNumUploads; // Maximum number of tiles uploaded to textures in each rendering pass
+	double lodBias; // Maximum projected size of a tile pixel in window pixels before a tile is refined
+	unsigned int maxNumCachedTiles; // Maximum number of loaded tiles held in main memory
+	mutable Threads::MutexCond loaderCond; // Condition variable protecting the loader state and waking up loader threads
+	bool shutdown; // Flag to shut down the loader threads
+	mutable std::deque<unsigned int> loadRequests; // Queue of pyramid indices of tiles to load, most urgent first
+	mutable TileSet loadingTiles; // Set of tiles currently being loaded
+	mutable TileSet failedTiles; // Set of tiles that could not be loaded
+	mutable TileCache tileCache; // Cache of loaded tiles
+	mutable unsigned int cacheUseCounter; // Counter to track least-recently used tiles in the cache
+	std::vector<Threads::Thread*> loaderThreads; // Background threads loading tiles from the pyramid file
+	mutable Threads::Mutex redrawCallbackMutex; // Mutex protecting the redraw callback while it is being called or replaced
+	RedrawCallback* redrawCallback; // Callback called when another rendering pass is needed
+	
+	/* Private methods: */
+	void* loaderThreadMethod(void); // Thread method loading requested tiles
+	void getTileExtent(const TileRef& tile,double extent[2][2]) const; // Returns the extent of the given tile in full-resolution image coordinates as [dimension][min/max]
+	void requestTiles(const std::vector<unsigned int>& tileIndices) const; // Requests loading of the given tiles, in order of decreasing urgency
+	void requestRedraw(void) const; // Calls the redraw callback, if there is one
+	
+	/* Constructors and destructors: */
+	public:
+	TilePyramidRenderer(const TilePyramid& sPyramid,size_t textureMemorySize,size_t cacheMemorySize,unsigned int numLoaderThreads =2); // Creates a renderer for the given tile pyramid using the given amounts of texture memory per OpenGL context and of main memory for loaded tiles
+	private:
+	TilePyramidRenderer(const TilePyramidRenderer& source); // Prohibit copy constructor
+	TilePyramidRenderer& operator=(const TilePyramidRenderer& source); // Prohibit assignment operator
+	public:
+	virtual ~TilePyramidRenderer(void);
+	
+	/* Methods from class GLObject: */
+	virtual void initContext(GLContextData& contextData) const;
+	
+	/* New methods: */
+	const TilePyramid& getPyramid(void) const // Returns the rendered tile pyramid
+		{
+		return pyramid;
+		}
+	unsigned int getNumTextureSlots(void) const // Returns the number of tile textures in each OpenGL context
+		{
+		return numTextureSlots;
+		}
+	void setMaxNumUploads(unsigned int newMaxNumUploads); // Sets the maximum number of tiles uploaded to textures in each rendering pass
+	void setLodBias(double newLodBias); // Sets the maximum projected size of a tile pixel in window pixels before a tile is refined
+	void setRedrawCallback(RedrawCallback* newRedrawCallback); // Sets the callback called when another rendering pass is needed; renderer adopts callback object
+	void glRenderAction(GLContextData& contextData) const; // Draws the image into the z=0 plane of the current model coordinate system, covering [0, width]x[0, height]
+	};
+
+}
+
+#endif
@@ -196,6 +196,10 @@ class FactoryManager
 	~FactoryManager(void); // Releases all loaded object classes and DSOs
 	
 	/* Methods: */
+	const std::string& getDsoNameTemplate(void) const // Returns the format string used to create DSO names from class names
+		{
+		return dsoNameTemplate;
+		}
 	const Misc::FileLocator& getDsoLocator(void) const // Returns reference to the DSO file locator
 		{
 		return dsoLocator;
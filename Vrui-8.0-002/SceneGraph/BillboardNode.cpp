@@ -169,4 +169,10 @@ void BillboardNode::alRenderAction(ALRenderState& renderState) const
 	renderState.popTransform(previousTransform);
 	}
 
+Box BillboardNode::calcCullingBox(void) const
+	{
+	/* The billboard transformation depends on the viewer, so the group's extents are unknown: */
+	return Box::full;
+	}
+
 }
@@ -76,6 +76,9 @@ class BillboardNode:public GroupNode
 	virtual void testCollision(SphereCollisionQuery& collisionQuery) const;
 	virtual void glRenderAction(GLRenderState& renderState) const;
 	virtual void alRenderAction(ALRenderState& renderState) const;
+	
+	/* Methods from class GroupNode: */
+	virtual Box calcCullingBox(void) const;
 	};
 
 typedef Misc::Autopointer<BillboardNode> BillboardNodePointer;
@@ -165,6 +165,9 @@ void BoxNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int BoxNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	Point pmin=center.getValue();
 	Point pmax=center.getValue();
 	for(int i=0;i<3;++i)
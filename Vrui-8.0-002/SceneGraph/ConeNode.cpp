@@ -178,6 +178,9 @@ void ConeNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int ConeNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Invalidate the display list: */
 	DisplayList::update();
 	
@@ -111,6 +111,9 @@ void CurveSetNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int CurveSetNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Re-read the curve vertex list: */
 	numVertices.clear();
 	numLineSegments=0;
@@ -173,6 +173,9 @@ void CylinderNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int CylinderNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Invalidate the display list: */
 	DisplayList::update();
 	
@@ -110,4 +110,10 @@ void DOGTransformNode::alRenderAction(ALRenderState& renderState) const
 	renderState.popTransform(previousTransform);
 	}
 
+Box DOGTransformNode::calcCullingBox(void) const
+	{
+	/* The transformation can be changed via setTransform without notifying the parent, so the group's extents are unknown: */
+	return Box::full;
+	}
+
 }
@@ -58,6 +58,9 @@ class DOGTransformNode:public GroupNode
 	virtual void glRenderAction(GLRenderState& renderState) const;
 	virtual void alRenderAction(ALRenderState& renderState) const;
 	
+	/* Methods from class GroupNode: */
+	virtual Box calcCullingBox(void) const;
+	
 	/* New methods: */
 	void setTransform(const DOGTransform& newTransform) // Sets the transformation and performs necessary updates
 		{
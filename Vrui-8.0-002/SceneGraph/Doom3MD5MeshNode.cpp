@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/Doom3MD5MeshNode.h>
 
 #include <string.h>
+#include <SceneGraph/GroupNode.h>
 #include <SceneGraph/VRMLFile.h>
 #include <SceneGraph/GLRenderState.h>
 #include <SceneGraph/Internal/Doom3MD5Mesh.h>
@@ -70,6 +71,9 @@ void Doom3MD5MeshNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int Doom3MD5MeshNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the node's extents might have changed: */
+	GroupNode::invalidateBoundingBoxes();
+	
 	/* Delete the current mesh: */
 	delete mesh;
 	mesh=0;
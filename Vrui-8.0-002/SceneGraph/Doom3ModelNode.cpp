@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <Misc/FileNameExtensions.h>
+#include <SceneGraph/GroupNode.h>
 #include <SceneGraph/VRMLFile.h>
 #include <SceneGraph/GLRenderState.h>
 #include <SceneGraph/Internal/Doom3MaterialManager.h>
@@ -74,6 +75,9 @@ void Doom3ModelNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int Doom3ModelNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the node's extents might have changed: */
+	GroupNode::invalidateBoundingBoxes();
+	
 	/* Delete the current model: */
 	delete mesh;
 	mesh=0;
@@ -25,6 +25,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/ElevationGridNode.h>
 
 #include <string.h>
+#include <algorithm>
+#include <Math/Math.h>
 #include <Math/Constants.h>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
@@ -42,6 +44,57 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 namespace SceneGraph {
 
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+inline GLushort* storeLodQuad(GLushort* iPtr,GLushort v00,GLushort v10,GLushort v01,GLushort v11,bool ccw) // Stores the vertex indices of a level-of-detail tile quad as two triangles
+	{
+	if(ccw)
+		{
+		iPtr[0]=v00;
+		iPtr[1]=v01;
+		iPtr[2]=v11;
+		iPtr[3]=v00;
+		iPtr[4]=v11;
+		iPtr[5]=v10;
+		}
+	else
+		{
+		iPtr[0]=v00;
+		iPtr[1]=v11;
+		iPtr[2]=v01;
+		iPtr[3]=v00;
+		iPtr[4]=v10;
+		iPtr[5]=v11;
+		}
+	return iPtr+6;
+	}
+
+class LodTileFrameComparison // Functor class to sort level-of-detail tiles by descending last use
+	{
+	/* Elements: */
+	private:
+	const std::vector<unsigned int>& tileFrames; // Render pass in which each tile was last used
+	
+	/* Constructors and destructors: */
+	public:
+	LodTileFrameComparison(const std::vector<unsigned int>& sTileFrames)
+		:tileFrames(sTileFrames)
+		{
+		}
+	
+	/* Methods: */
+	bool operator()(int tile0,int tile1) const
+		{
+		return tileFrames[tile0]>tileFrames[tile1];
+		}
+	};
+
+}
+
 /********************************************
 Methods of class ElevationGridNode::DataItem:
 ********************************************/
@@ -50,7 +103,9 @@ ElevationGridNode::DataItem::DataItem(void)
 	:havePrimitiveRestart(GLNVPrimitiveRestart::isSupported()),
 	 vertexBufferObjectId(0),indexBufferObjectId(0),
 	 numQuads(0),numTriangles(0),
-	 version(0)
+	 version(0),
+	 lodIndexBufferObjectId(0),
+	 lodFrame(0),lodVersion(0)
 	{
 	if(GLARBVertexBufferObject::isSupported())
 		{
@@ -62,6 +117,9 @@ ElevationGridNode::DataItem::DataItem(void)
 		
 		/* Create the index buffer object: */
 		glGenBuffersARB(1,&indexBufferObjectId);
+		
+		/* Create the index buffer object for level-of-detail tiles: */
+		glGenBuffersARB(1,&lodIndexBufferObjectId);
 		}
 	
 	if(havePrimitiveRestart)
@@ -77,6 +135,12 @@ ElevationGridNode::DataItem::~DataItem(void)
 	/* Destroy the index buffer object: */
 	if(indexBufferObjectId!=0)
 		glDeleteBuffersARB(1,&indexBufferObjectId);
+	
+	/* Destroy the level-of-detail buffer objects: */
+	if(lodIndexBufferObjectId!=0)
+		glDeleteBuffersARB(1,&lodIndexBufferObjectId);
+	for(std::vector<int>::iterator rtIt=lodResidentTiles.begin();rtIt!=lodResidentTiles.end();++rtIt)
+		glDeleteBuffersARB(1,&lodTileBufferObjectIds[*rtIt]);
 	}
 
 /******************************************
@@ -1248,6 +1312,593 @@ void ElevationGridNode::uploadHoleyQuadTriangleSet(GLuint& numQuads,GLuint& numT
 	delete[] vertices;
 	}
 
+Vector ElevationGridNode::calcQuadNormal(int x,int z) const
+	{
+	/* Calculate the normal scaling factors: */
+	int xDim=xDimension.getValue();
+	Scalar nx=zSpacing.getValue()*heightScale.getValue();
+	Scalar ny=xSpacing.getValue()*zSpacing.getValue();
+	Scalar nz=xSpacing.getValue()*heightScale.getValue();
+	if(!ccw.getValue())
+		{
+		/* Flip normal vectors if quads are oriented clockwise: */
+		nx=-nx;
+		ny=-ny;
+		nz=-nz;
+		}
+	
+	/* Calculate the quad normal as the average of the normals of the quad's two triangles: */
+	const Scalar* h=&(height.getValue(size_t(z)*size_t(xDim)+size_t(x)));
+	if(heightIsY.getValue())
+		return Vector((h[0]-h[1]+h[xDim]-h[xDim+1])*nx,ny*Scalar(2),(h[0]+h[1]-h[xDim]-h[xDim+1])*nz);
+	else
+		{
+		/* Flip the normal vector to account for y,z-swap: */
+		return Vector(-(h[0]-h[1]+h[xDim]-h[xDim+1])*nx,-(h[0]+h[1]-h[xDim]-h[xDim+1])*nz,-ny*Scalar(2));
+		}
+	}
+
+Scalar ElevationGridNode::interpolateLodHeight(const ElevationGridNode::LodTile& tile,int x,int z) const
+	{
+	int xDim=xDimension.getValue();
+	int zDim=zDimension.getValue();
+	int stride=1<<tile.level;
+	
+	/* Find the tile cell containing the grid sample, clamped to the grid's edges: */
+	int xa=tile.x0+((x-tile.x0)/stride)*stride;
+	int xb=Math::min(xa+stride,xDim-1);
+	if(xa>xb)
+		xa=xb;
+	int za=tile.z0+((z-tile.z0)/stride)*stride;
+	int zb=Math::min(za+stride,zDim-1);
+	if(za>zb)
+		za=zb;
+	
+	/* Bilinearly interpolate the heights at the cell's corners: */
+	Scalar wx=xb>xa?Scalar(x-xa)/Scalar(xb-xa):Scalar(0);
+	Scalar wz=zb>za?Scalar(z-za)/Scalar(zb-za):Scalar(0);
+	const Scalar* ha=&(height.getValue(size_t(za)*size_t(xDim)));
+	const Scalar* hb=&(height.getValue(size_t(zb)*size_t(xDim)));
+	Scalar h0=ha[xa]*(Scalar(1)-wx)+ha[xb]*wx;
+	Scalar h1=hb[xa]*(Scalar(1)-wx)+hb[xb]*wx;
+	return (h0*(Scalar(1)-wz)+h1*wz)*heightScale.getValue();
+	}
+
+int ElevationGridNode::createLodTile(int level,int x0,int z0)
+	{
+	int xDim=xDimension.getValue();
+	int zDim=zDimension.getValue();
+	int hComp=2;
+	int zComp=1;
+	if(heightIsY.getValue())
+		std::swap(hComp,zComp);
+	
+	/* Add a new tile to the quadtree: */
+	LodTile newTile;
+	newTile.level=level;
+	newTile.x0=x0;
+	newTile.z0=z0;
+	newTile.box=Box::empty;
+	newTile.error=Scalar(0);
+	newTile.skirtDepth=Scalar(0);
+	for(int i=0;i<4;++i)
+		newTile.children[i]=-1;
+	int tileIndex=int(lodTiles.size());
+	lodTiles.push_back(newTile);
+	
+	if(level>0)
+		{
+		/* Create the tile's children, which cover the tile's area: */
+		int childSize=lodTileCells<<(level-1);
+		for(int i=0;i<4;++i)
+			{
+			int cx=x0+(i&0x1)*childSize;
+			int cz=z0+((i>>1)&0x1)*childSize;
+			if(cx<xDim-1&&cz<zDim-1)
+				{
+				int childIndex=createLodTile(level-1,cx,cz);
+				LodTile& tile=lodTiles[tileIndex];
+				const LodTile& child=lodTiles[childIndex];
+				tile.children[i]=childIndex;
+				tile.box.addBox(child.box);
+				if(tile.error<child.error)
+					tile.error=child.error;
+				}
+			}
+		
+		/* Add the maximum height difference between the tile's surface and its children's surfaces at the children's samples: */
+		LodTile& tile=lodTiles[tileIndex];
+		int childStride=1<<(level-1);
+		Scalar maxDiff(0);
+		for(int j=0;j<=lodTileCells*2;++j)
+			{
+			int z=Math::min(z0+j*childStride,zDim-1);
+			const Scalar* hRow=&(height.getValue(size_t(z)*size_t(xDim)));
+			for(int i=0;i<=lodTileCells*2;++i)
+				{
+				int x=Math::min(x0+i*childStride,xDim-1);
+				Scalar diff=Math::abs(hRow[x]*heightScale.getValue()-interpolateLodHeight(tile,x,z));
+				if(maxDiff<diff)
+					maxDiff=diff;
+				}
+			}
+		tile.error+=maxDiff;
+		}
+	else
+		{
+		/* Calculate the tile's bounding box from its full-resolution samples: */
+		int x1=Math::min(x0+lodTileCells,xDim-1);
+		int z1=Math::min(z0+lodTileCells,zDim-1);
+		Scalar hMin=Math::Constants<Scalar>::max;
+		Scalar hMax=-Math::Constants<Scalar>::max;
+		for(int z=z0;z<=z1;++z)
+			{
+			const Scalar* hRow=&(height.getValue(size_t(z)*size_t(xDim)));
+			for(int x=x0;x<=x1;++x)
+				{
+				Scalar h=hRow[x]*heightScale.getValue();
+				if(hMin>h)
+					hMin=h;
+				if(hMax<h)
+					hMax=h;
+				}
+			}
+		Point pMin,pMax;
+		pMin[0]=origin.getValue()[0]+Scalar(x0)*xSpacing.getValue();
+		pMax[0]=origin.getValue()[0]+Scalar(x1)*xSpacing.getValue();
+		pMin[hComp]=origin.getValue()[hComp]+hMin;
+		pMax[hComp]=origin.getValue()[hComp]+hMax;
+		pMin[zComp]=origin.getValue()[zComp]+Scalar(z0)*zSpacing.getValue();
+		pMax[zComp]=origin.getValue()[zComp]+Scalar(z1)*zSpacing.getValue();
+		LodTile& tile=lodTiles[tileIndex];
+		tile.box.addPoint(pMin);
+		tile.box.addPoint(pMax);
+		}
+	
+	return tileIndex;
+	}
+
+void ElevationGridNode::createLodTiles(void)
+	{
+	int xDim=xDimension.getValue();
+	int zDim=zDimension.getValue();
+	int hComp=heightIsY.getValue()?1:2;
+	
+	/* Limit the tile size such that tile vertices can be indexed by 16-bit indices: */
+	lodTileCells=Math::min(lodTileSize.getValue(),128);
+	
+	/* Determine the level of the root tile, which covers the entire grid: */
+	int maxCells=Math::max(xDim-1,zDim-1);
+	int rootLevel=0;
+	while((lodTileCells<<rootLevel)<maxCells)
+		++rootLevel;
+	
+	/* Create the quadtree: */
+	lodTiles.clear();
+	createLodTile(rootLevel,0,0);
+	
+	/* Calculate the maximum tile error on each level: */
+	std::vector<Scalar> levelErrors(rootLevel+2,Scalar(0));
+	for(std::vector<LodTile>::iterator tIt=lodTiles.begin();tIt!=lodTiles.end();++tIt)
+		if(levelErrors[tIt->level]<tIt->error)
+			levelErrors[tIt->level]=tIt->error;
+	levelErrors[rootLevel+1]=levelErrors[rootLevel];
+	
+	/* Hang each tile's skirts deep enough to cover cracks to neighbors on the next-coarser level, plus a minimum depth to cover T-junction gaps: */
+	Scalar minSkirtDepth=Math::min(xSpacing.getValue(),zSpacing.getValue())*Scalar(0.1);
+	for(std::vector<LodTile>::iterator tIt=lodTiles.begin();tIt!=lodTiles.end();++tIt)
+		{
+		tIt->skirtDepth=levelErrors[tIt->level]+levelErrors[tIt->level+1]+minSkirtDepth;
+		tIt->box.min[hComp]-=tIt->skirtDepth;
+		}
+	
+	/* Enlarge each tile's bounding box to contain its children's skirts; children always follow their parents in the tile array: */
+	for(std::vector<LodTile>::reverse_iterator tIt=lodTiles.rbegin();tIt!=lodTiles.rend();++tIt)
+		for(int i=0;i<4;++i)
+			if(tIt->children[i]>=0)
+				tIt->box.addBox(lodTiles[tIt->children[i]].box);
+	}
+
+void ElevationGridNode::uploadLodTileIndices(void) const
+	{
+	/* Create an index array to render a tile's grid and skirts as a set of triangles: */
+	int tc=lodTileCells;
+	int rowLength=tc+1;
+	glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB,(tc*tc+tc*4)*6*sizeof(GLushort),0,GL_STATIC_DRAW_ARB);
+	GLushort* iPtr=static_cast<GLushort*>(glMapBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,GL_WRITE_ONLY_ARB));
+	bool ccwQuads=ccw.getValue();
+	
+	/* Store the grid quads: */
+	for(int j=0;j<tc;++j)
+		for(int i=0;i<tc;++i)
+			{
+			GLushort v00=GLushort(j*rowLength+i);
+			iPtr=storeLodQuad(iPtr,v00,v00+1,v00+rowLength,v00+rowLength+1,ccwQuads);
+			}
+	
+	/* Store the skirt quads, treating skirt vertices as an additional ring of grid vertices folded downwards: */
+	GLushort bottom=GLushort(rowLength*rowLength);
+	GLushort top=bottom+rowLength;
+	GLushort left=top+rowLength;
+	GLushort right=left+rowLength;
+	for(int i=0;i<tc;++i)
+		{
+		iPtr=storeLodQuad(iPtr,bottom+i,bottom+i+1,i,i+1,ccwQuads);
+		iPtr=storeLodQuad(iPtr,tc*rowLength+i,tc*rowLength+i+1,top+i,top+i+1,ccwQuads);
+		iPtr=storeLodQuad(iPtr,left+i,i*rowLength,left+i+1,(i+1)*rowLength,ccwQuads);
+		iPtr=storeLodQuad(iPtr,i*rowLength+tc,right+i,(i+1)*rowLength+tc,right+i+1,ccwQuads);
+		}
+	
+	glUnmapBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB);
+	}
+
+void ElevationGridNode::calcLodTileVertices(const ElevationGridNode::LodTile& tile,ElevationGridNode::LodVertex* vertices) const
+	{
+	/* Retrieve the elevation grid layout: */
+	int xDim=xDimension.getValue();
+	int zDim=zDimension.getValue();
+	Scalar xSp=xSpacing.getValue();
+	Scalar zSp=zSpacing.getValue();
+	int tc=lodTileCells;
+	int rowLength=tc+1;
+	int stride=1<<tile.level;
+	
+	/* Store the tile's grid vertices, clamping grid indices to the grid's edges: */
+	int hComp=2;
+	int zComp=1;
+	if(heightIsY.getValue())
+		std::swap(hComp,zComp);
+	Scalar hOffset=origin.getValue()[hComp];
+	Scalar zOffset=origin.getValue()[zComp];
+	LodVertex* vPtr=vertices;
+	for(int j=0;j<rowLength;++j)
+		{
+		int z=Math::min(tile.z0+j*stride,zDim-1);
+		for(int i=0;i<rowLength;++i,++vPtr)
+			{
+			int x=Math::min(tile.x0+i*stride,xDim-1);
+			size_t vInd=size_t(z)*size_t(xDim)+size_t(x);
+			
+			/* Calculate the raw vertex position: */
+			Point p;
+			p[0]=origin.getValue()[0]+Scalar(x)*Scalar(xSp);
+			p[hComp]=hOffset+height.getValue(vInd)*heightScale.getValue();
+			p[zComp]=zOffset+Scalar(z)*Scalar(zSp);
+			
+			/* Store the vertex' texture coordinate: */
+			if(imageProjection.getValue()!=0)
+				{
+				/* Retrieve texture coordinates from the image projection node: */
+				vPtr->texCoord=imageProjection.getValue()->calcTexCoord(p);
+				}
+			else if(texCoord.getValue()!=0)
+				vPtr->texCoord=texCoord.getValue()->point.getValue(vInd);
+			else
+				{
+				/* Generate standard texture coordinates: */
+				vPtr->texCoord=LodVertex::TexCoord(Scalar(x)/Scalar(xDim-1),Scalar(z)/Scalar(zDim-1));
+				}
+			
+			/* Store the vertex' color: */
+			if(color.getValue()!=0)
+				vPtr->color=LodVertex::Color(color.getValue()->color.getValue(vInd));
+			else if(colorMap.getValue()!=0)
+				vPtr->color=LodVertex::Color(colorMap.getValue()->mapColor(hOffset+height.getValue(vInd)*heightScale.getValue()));
+			else
+				vPtr->color=LodVertex::Color(255,255,255);
+			
+			/* Calculate the vertex normal from the full-resolution grid: */
+			Vector n;
+			if(normal.getValue()!=0)
+				{
+				n=normal.getValue()->vector.getValue(vInd);
+				if(!heightIsY.getValue())
+					{
+					std::swap(n[1],n[2]);
+					n=-n;
+					}
+				}
+			else
+				{
+				/* Average the quad normals of quads surrounding the vertex: */
+				n=Vector::zero;
+				if(x>0)
+					{
+					if(z>0)
+						n+=calcQuadNormal(x-1,z-1);
+					if(z<zDim-1)
+						n+=calcQuadNormal(x-1,z);
+					}
+				if(x<xDim-1)
+					{
+					if(z>0)
+						n+=calcQuadNormal(x,z-1);
+					if(z<zDim-1)
+						n+=calcQuadNormal(x,z);
+					}
+				}
+			
+			/* Store the vertex position and normal: */
+			n.normalize();
+			vPtr->normal=LodVertex::Normal(n);
+			vPtr->position=LodVertex::Position(p);
+			}
+		}
+	
+	/* Copy the tile's edge vertices into the skirt vertices and lower them: */
+	LodVertex* sPtr=vertices+rowLength*rowLength;
+	for(int i=0;i<rowLength;++i)
+		{
+		sPtr[i]=vertices[i];
+		sPtr[rowLength+i]=vertices[tc*rowLength+i];
+		sPtr[rowLength*2+i]=vertices[i*rowLength];
+		sPtr[rowLength*3+i]=vertices[i*rowLength+tc];
+		}
+	for(int i=0;i<rowLength*4;++i)
+		sPtr[i].position[hComp]-=tile.skirtDepth;
+	}
+
+void* ElevationGridNode::lodLoaderThreadMethod(void)
+	{
+	size_t numVertices=size_t((lodTileCells+1)*(lodTileCells+1)+(lodTileCells+1)*4);
+	while(true)
+		{
+		/* Wait for the next tile request: */
+		int tileIndex;
+		{
+		Threads::MutexCond::Lock loaderLock(lodLoaderCond);
+		while(!lodLoaderShutdown&&lodLoadRequests.empty())
+			lodLoaderCond.wait(loaderLock);
+		if(lodLoaderShutdown)
+			break;
+		tileIndex=lodLoadRequests.front();
+		lodLoadRequests.pop_front();
+		}
+		
+		/* Generate the tile's vertices without holding the lock: */
+		LodVertex* vertices=new LodVertex[numVertices];
+		calcLodTileVertices(lodTiles[tileIndex],vertices);
+		
+		/* Store the vertices in the tile cache: */
+		{
+		Threads::MutexCond::Lock loaderLock(lodLoaderCond);
+		
+		/* Evict the least recently used tile that is not being uploaded if the cache is full: */
+		if(lodNumCachedTiles>=lodMaxCachedTiles)
+			{
+			int lruIndex=-1;
+			for(int i=0;i<int(lodTiles.size());++i)
+				if(lodTileVertices[i]!=0&&lodTilePins[i]==0&&(lruIndex<0||lodTileLastUsed[lruIndex]>lodTileLastUsed[i]))
+					lruIndex=i;
+			if(lruIndex>=0)
+				{
+				delete[] lodTileVertices[lruIndex];
+				lodTileVertices[lruIndex]=0;
+				--lodNumCachedTiles;
+				}
+			}
+		
+		lodTileVertices[tileIndex]=vertices;
+		lodTileLastUsed[tileIndex]=++lodCacheUseCounter;
+		lodTileRequested[tileIndex]=false;
+		++lodNumCachedTiles;
+		}
+		}
+	
+	return 0;
+	}
+
+void ElevationGridNode::startLodLoader(void)
+	{
+	/* Initialize the tile cache: */
+	size_t numTiles=lodTiles.size();
+	lodTileVertices.assign(numTiles,0);
+	lodTileLastUsed.assign(numTiles,0U);
+	lodTilePins.assign(numTiles,0U);
+	lodTileRequested.assign(numTiles,false);
+	lodNumCachedTiles=0;
+	lodCacheUseCounter=0;
+	
+	/* Keep as many generated tiles in main memory as fit into one OpenGL context's graphics memory budget: */
+	size_t numVertices=size_t((lodTileCells+1)*(lodTileCells+1)+(lodTileCells+1)*4);
+	lodMaxCachedTiles=Math::max((size_t(lodMemorySize.getValue())<<20)/(numVertices*sizeof(LodVertex)),size_t(4));
+	
+	/* Generate the root tile's vertices right away, and pin them permanently as the root tile is the fallback for all other tiles: */
+	lodTileVertices[0]=new LodVertex[numVertices];
+	calcLodTileVertices(lodTiles[0],lodTileVertices[0]);
+	lodTilePins[0]=1U;
+	++lodNumCachedTiles;
+	
+	/* Start the tile loader thread: */
+	lodLoaderShutdown=false;
+	lodLoaderThread=new Threads::Thread;
+	lodLoaderThread->start(this,&ElevationGridNode::lodLoaderThreadMethod);
+	}
+
+void ElevationGridNode::stopLodLoader(void)
+	{
+	if(lodLoaderThread!=0)
+		{
+		/* Shut down the tile loader thread: */
+		{
+		Threads::MutexCond::Lock loaderLock(lodLoaderCond);
+		lodLoaderShutdown=true;
+		lodLoaderCond.broadcast();
+		}
+		lodLoaderThread->join();
+		delete lodLoaderThread;
+		lodLoaderThread=0;
+		}
+	
+	/* Release all generated tile vertices: */
+	for(std::vector<LodVertex*>::iterator tvIt=lodTileVertices.begin();tvIt!=lodTileVertices.end();++tvIt)
+		delete[] *tvIt;
+	lodTileVertices.clear();
+	lodTileLastUsed.clear();
+	lodTilePins.clear();
+	lodTileRequested.clear();
+	lodLoadRequests.clear();
+	lodNumCachedTiles=0;
+	}
+
+const ElevationGridNode::LodVertex* ElevationGridNode::pinLodTile(int tileIndex) const
+	{
+	Threads::MutexCond::Lock loaderLock(lodLoaderCond);
+	
+	/* Pin the tile's vertices if they were already generated: */
+	if(lodTileVertices[tileIndex]!=0)
+		{
+		++lodTilePins[tileIndex];
+		lodTileLastUsed[tileIndex]=++lodCacheUseCounter;
+		return lodTileVertices[tileIndex];
+		}
+	
+	/* Request the tile from the loader thread unless it is already queued or being generated: */
+	if(!lodTileRequested[tileIndex])
+		{
+		lodLoadRequests.push_front(tileIndex);
+		lodTileRequested[tileIndex]=true;
+		
+		/* Drop the least urgent requests that would not fit into the tile cache anyway: */
+		while(lodLoadRequests.size()>lodMaxCachedTiles)
+			{
+			lodTileRequested[lodLoadRequests.back()]=false;
+			lodLoadRequests.pop_back();
+			}
+		
+		/* Wake up the loader thread: */
+		lodLoaderCond.signal();
+		}
+	
+	return 0;
+	}
+
+void ElevationGridNode::unpinLodTile(int tileIndex) const
+	{
+	Threads::MutexCond::Lock loaderLock(lodLoaderCond);
+	--lodTilePins[tileIndex];
+	}
+
+void ElevationGridNode::loadLodTile(int tileIndex,const ElevationGridNode::LodVertex* vertices,ElevationGridNode::DataItem* dataItem,GLRenderState& renderState) const
+	{
+	/* Create a vertex buffer object for the tile and upload its vertices: */
+	GLuint& bufferId=dataItem->lodTileBufferObjectIds[tileIndex];
+	glGenBuffersARB(1,&bufferId);
+	renderState.bindVertexBuffer(bufferId);
+	glBufferDataARB(GL_ARRAY_BUFFER_ARB,((lodTileCells+1)*(lodTileCells+1)+(lodTileCells+1)*4)*sizeof(LodVertex),vertices,GL_STATIC_DRAW_ARB);
+	
+	/* Mark the tile as resident: */
+	dataItem->lodTileFrames[tileIndex]=dataItem->lodFrame;
+	dataItem->lodResidentTiles.push_back(tileIndex);
+	}
+
+void ElevationGridNode::glRenderLodTile(int tileIndex,ElevationGridNode::DataItem* dataItem,GLRenderState& renderState,int& numTileLoads) const
+	{
+	typedef GLGeometry::Vertex<Scalar,2,GLubyte,4,Scalar,Scalar,3> Vertex;
+	
+	/* Bail out if the tile is outside the view frustum: */
+	const LodTile& tile=lodTiles[tileIndex];
+	if(!renderState.doesBoxIntersectFrustum(tile.box))
+		return;
+	
+	/* Mark the tile as used to keep it resident as a fallback for its descendants: */
+	dataItem->lodTileFrames[tileIndex]=dataItem->lodFrame;
+	
+	/* Check if the tile's projected error is too large: */
+	if(tile.level>0&&renderState.calcProjectedSize(tile.box,tile.error)>lodError.getValue())
+		{
+		/* Load the tile's missing visible children within the per-pass upload budget: */
+		bool childrenResident=true;
+		for(int i=0;i<4;++i)
+			{
+			int childIndex=tile.children[i];
+			if(childIndex>=0&&dataItem->lodTileBufferObjectIds[childIndex]==0&&renderState.doesBoxIntersectFrustum(lodTiles[childIndex].box))
+				{
+				/* Upload the child's vertices if the loader thread already generated them; otherwise, the child is requested from the loader thread: */
+				const LodVertex* vertices=numTileLoads<lodMaxTileLoads.getValue()?pinLodTile(childIndex):0;
+				if(vertices!=0)
+					{
+					loadLodTile(childIndex,vertices,dataItem,renderState);
+					unpinLodTile(childIndex);
+					++numTileLoads;
+					}
+				else
+					childrenResident=false;
+				}
+			}
+		
+		if(childrenResident)
+			{
+			/* Render the tile's children instead of the tile: */
+			for(int i=0;i<4;++i)
+				if(tile.children[i]>=0)
+					glRenderLodTile(tile.children[i],dataItem,renderState,numTileLoads);
+			
+			return;
+			}
+		}
+	
+	/* Draw the tile's grid and skirts as a set of indexed triangles: */
+	renderState.bindVertexBuffer(dataItem->lodTileBufferObjectIds[tileIndex]);
+	glVertexPointer(static_cast<Vertex*>(0));
+	glDrawElements(GL_TRIANGLES,(lodTileCells*lodTileCells+lodTileCells*4)*6,GL_UNSIGNED_SHORT,0);
+	}
+
+void ElevationGridNode::glRenderLodTiles(ElevationGridNode::DataItem* dataItem,GLRenderState& renderState) const
+	{
+	typedef GLGeometry::Vertex<Scalar,2,GLubyte,4,Scalar,Scalar,3> Vertex;
+	
+	/* Bind the shared index buffer object: */
+	renderState.bindIndexBuffer(dataItem->lodIndexBufferObjectId);
+	
+	/* Check if the resident tiles are current: */
+	if(dataItem->lodVersion!=version)
+		{
+		/* Release all resident tiles: */
+		for(std::vector<int>::iterator rtIt=dataItem->lodResidentTiles.begin();rtIt!=dataItem->lodResidentTiles.end();++rtIt)
+			glDeleteBuffersARB(1,&dataItem->lodTileBufferObjectIds[*rtIt]);
+		dataItem->lodResidentTiles.clear();
+		dataItem->lodTileBufferObjectIds.assign(lodTiles.size(),0);
+		dataItem->lodTileFrames.assign(lodTiles.size(),0);
+		
+		/* Upload the shared vertex indices: */
+		uploadLodTileIndices();
+		
+		/* Mark the tiles as up-to-date: */
+		dataItem->lodVersion=version;
+		}
+	
+	/* Start a new render pass: */
+	++dataItem->lodFrame;
+	int numTileLoads=0;
+	
+	/* Load the root tile unconditionally, as it is the fallback for all other tiles: */
+	if(dataItem->lodTileBufferObjectIds[0]==0)
+		{
+		loadLodTile(0,lodTileVertices[0],dataItem,renderState);
+		++numTileLoads;
+		}
+	
+	/* Render the quadtree: */
+	glRenderLodTile(0,dataItem,renderState,numTileLoads);
+	
+	/* Check if the resident tiles exceed the graphics memory budget: */
+	size_t tileMemorySize=size_t((lodTileCells+1)*(lodTileCells+1)+(lodTileCells+1)*4)*sizeof(Vertex);
+	size_t maxResidentTiles=Math::max((size_t(lodMemorySize.getValue())<<20)/tileMemorySize,size_t(1));
+	std::vector<int>& residentTiles=dataItem->lodResidentTiles;
+	if(residentTiles.size()>maxResidentTiles)
+		{
+		/* Release the least-recently used tiles that were not used during the current render pass: */
+		std::sort(residentTiles.begin(),residentTiles.end(),LodTileFrameComparison(dataItem->lodTileFrames));
+		while(residentTiles.size()>maxResidentTiles&&dataItem->lodTileFrames[residentTiles.back()]!=dataItem->lodFrame)
+			{
+			glDeleteBuffersARB(1,&dataItem->lodTileBufferObjectIds[residentTiles.back()]);
+			dataItem->lodTileBufferObjectIds[residentTiles.back()]=0;
+			residentTiles.pop_back();
+			}
+		}
+	}
+
 ElevationGridNode::ElevationGridNode(void)
 	:colorPerVertex(true),normalPerVertex(true),
 	 creaseAngle(0),
@@ -1258,11 +1909,21 @@ ElevationGridNode::ElevationGridNode(void)
 	 heightIsY(true),
 	 removeInvalids(false),invalidHeight(0),
 	 ccw(true),solid(true),
+	 lodTileSize(0),lodError(2),lodMemorySize(64),lodMaxTileLoads(8),
 	 propMask(0U),
-	 valid(false),indexed(false),version(0)
+	 valid(false),indexed(false),version(0),
+	 lodTileCells(0),
+	 lodLoaderShutdown(false),lodNumCachedTiles(0),lodMaxCachedTiles(0),lodCacheUseCounter(0),
+	 lodLoaderThread(0)
 	{
 	}
 
+ElevationGridNode::~ElevationGridNode(void)
+	{
+	/* Shut down the tile loader thread and release all generated tile vertices: */
+	stopLodLoader();
+	}
+
 const char* ElevationGridNode::getClassName(void) const
 	{
 	return className;
@@ -1331,12 +1992,26 @@ void ElevationGridNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 		vrmlFile.parseField(ccw);
 	else if(strcmp(fieldName,"solid")==0)
 		vrmlFile.parseField(solid);
+	else if(strcmp(fieldName,"lodTileSize")==0)
+		vrmlFile.parseField(lodTileSize);
+	else if(strcmp(fieldName,"lodError")==0)
+		vrmlFile.parseField(lodError);
+	else if(strcmp(fieldName,"lodMemorySize")==0)
+		vrmlFile.parseField(lodMemorySize);
+	else if(strcmp(fieldName,"lodMaxTileLoads")==0)
+		vrmlFile.parseField(lodMaxTileLoads);
 	else
 		GeometryNode::parseField(fieldName,vrmlFile);
 	}
 
 unsigned int ElevationGridNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
+	/* Stop generating tiles for the previous level-of-detail quadtree before any of the elevation grid's state changes: */
+	stopLodLoader();
+	
 	/* Check whether the height field should be loaded from a file: */
 	if(heightUrl.getNumValues()>0)
 		{
@@ -1489,6 +2164,15 @@ unsigned int ElevationGridNode::update(void)
 			}
 		}
 	
+	/* Create a level-of-detail quadtree if requested and if the elevation grid is a regular untransformed grid: */
+	lodTileCells=0;
+	lodTiles.clear();
+	if(valid&&indexed&&pointTransform.getValue()==0&&lodTileSize.getValue()>0)
+		{
+		createLodTiles();
+		startLodLoader();
+		}
+	
 	/* Bump up the elevation grid's version number: */
 	++version;
 	
@@ -1736,9 +2420,6 @@ void ElevationGridNode::glRenderAction(GLRenderState& renderState) const
 	
 	typedef GLGeometry::Vertex<Scalar,2,GLubyte,4,Scalar,Scalar,3> Vertex;
 	
-	/* Bind the vertex buffer object: */
-	renderState.bindVertexBuffer(dataItem->vertexBufferObjectId);
-	
 	/* Set up the vertex arrays: */
 	int vertexArrayParts=Vertex::getPartsMask();
 	if(color.getValue()==0&&colorMap.getValue()==0)
@@ -1747,6 +2428,16 @@ void ElevationGridNode::glRenderAction(GLRenderState& renderState) const
 		vertexArrayParts&=~GLVertexArrayParts::Color;
 		}
 	renderState.enableVertexArrays(vertexArrayParts);
+	
+	if(lodTileCells>0&&dataItem->lodIndexBufferObjectId!=0)
+		{
+		/* Render the elevation grid as a set of view-dependent level-of-detail tiles: */
+		glRenderLodTiles(dataItem,renderState);
+		return;
+		}
+	
+	/* Bind the vertex buffer object: */
+	renderState.bindVertexBuffer(dataItem->vertexBufferObjectId);
 	glVertexPointer(static_cast<Vertex*>(0));
 	
 	if(indexed)
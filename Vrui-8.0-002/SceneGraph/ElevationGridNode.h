@@ -23,10 +23,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef SCENEGRAPH_ELEVATIONGRIDNODE_INCLUDED
 #define SCENEGRAPH_ELEVATIONGRIDNODE_INCLUDED
 
+#include <vector>
+#include <deque>
+#include <Threads/MutexCond.h>
+#include <Threads/Thread.h>
 #include <IO/Directory.h>
 #include <Geometry/Box.h>
 #include <GL/gl.h>
 #include <GL/GLObject.h>
+#include <GL/GLGeometryVertex.h>
 #include <SceneGraph/FieldTypes.h>
 #include <SceneGraph/GeometryNode.h>
 #include <SceneGraph/TextureCoordinateNode.h>
@@ -48,6 +53,20 @@ class ElevationGridNode:public GeometryNode,public GLObject
 	typedef SF<ImageProjectionNodePointer> SFImageProjectionNode;
 	
 	protected:
+	typedef GLGeometry::Vertex<Scalar,2,GLubyte,4,Scalar,Scalar,3> LodVertex; // Type for vertices of level-of-detail tiles
+	
+	struct LodTile // Structure describing a tile in the level-of-detail quadtree
+		{
+		/* Elements: */
+		public:
+		int level; // Tile's level in the quadtree; tiles at level 0 contain the full-resolution grid
+		int x0,z0; // Grid indices of the tile's first sample
+		Box box; // Bounding box of the tile's vertices including its skirts
+		Scalar error; // Maximum height difference between the tile's surface and the full-resolution grid
+		Scalar skirtDepth; // Depth of the skirts hanging down from the tile's edges to hide cracks between tiles of different levels
+		int children[4]; // Indices of the tile's children in the tile array, or -1 for missing children
+		};
+	
 	struct DataItem:public GLObject::DataItem
 		{
 		/* Elements: */
@@ -58,6 +77,12 @@ class ElevationGridNode:public GeometryNode,public GLObject
 		GLuint numQuads; // Number of quads in a non-indexed quad set
 		GLuint numTriangles; // Number of triangles in a non-indexed quad/triangle set
 		unsigned int version; // Version of point set stored in vertex buffer object
+		GLuint lodIndexBufferObjectId; // ID of index buffer object shared by all level-of-detail tiles
+		std::vector<GLuint> lodTileBufferObjectIds; // IDs of vertex buffer objects of all level-of-detail tiles, or 0 for tiles that are not resident
+		std::vector<unsigned int> lodTileFrames; // Level-of-detail render pass in which each resident tile was last used
+		std::vector<int> lodResidentTiles; // Indices of all resident level-of-detail tiles
+		unsigned int lodFrame; // Number of the current level-of-detail render pass
+		unsigned int lodVersion; // Version of elevation grid represented by the resident level-of-detail tiles
 		
 		/* Constructors and destructors: */
 		DataItem(void);
@@ -91,6 +116,10 @@ class ElevationGridNode:public GeometryNode,public GLObject
 	SFFloat invalidHeight; // Value to indicate "invalid" elevations
 	SFBool ccw;
 	SFBool solid;
+	SFInt lodTileSize; // Number of grid cells along each side of a level-of-detail tile; 0 disables level-of-detail rendering
+	SFFloat lodError; // Maximum projected height error of rendered level-of-detail tiles in pixels
+	SFInt lodMemorySize; // Maximum size of level-of-detail tiles kept in graphics memory per OpenGL context, and of generated tiles kept in main memory, in MB
+	SFInt lodMaxTileLoads; // Maximum number of level-of-detail tiles uploaded to graphics memory per render pass
 	
 	/* Derived state: */
 	public:
@@ -102,6 +131,19 @@ class ElevationGridNode:public GeometryNode,public GLObject
 	bool haveInvalids; // Flag whether there are some invalid elevation samples that need to be removed
 	Box bbox; // Bounding box of the elevation grid
 	unsigned int version; // Version number of elevation grid
+	int lodTileCells; // Number of grid cells along each side of a level-of-detail tile, or 0 if level-of-detail rendering is disabled
+	std::vector<LodTile> lodTiles; // Level-of-detail quadtree, with the root tile first
+	mutable Threads::MutexCond lodLoaderCond; // Condition variable protecting the level-of-detail tile cache and waking up the tile loader thread
+	bool lodLoaderShutdown; // Flag to shut down the tile loader thread
+	mutable std::deque<int> lodLoadRequests; // Queue of indices of level-of-detail tiles whose vertices to generate, most urgent first
+	mutable std::vector<LodVertex*> lodTileVertices; // Generated vertices of each level-of-detail tile held in main memory, or 0
+	mutable std::vector<unsigned int> lodTileLastUsed; // Value of the cache use counter when each tile's vertices were last generated or requested
+	mutable std::vector<unsigned int> lodTilePins; // Number of render passes currently uploading each tile's vertices; pinned vertices are not evicted
+	mutable std::vector<bool> lodTileRequested; // Flags whether each tile's vertices are queued for generation or being generated
+	size_t lodNumCachedTiles; // Number of tiles whose vertices are held in main memory
+	size_t lodMaxCachedTiles; // Maximum number of tiles whose vertices are held in main memory
+	mutable unsigned int lodCacheUseCounter; // Counter to track least-recently used tiles in the cache
+	Threads::Thread* lodLoaderThread; // Background thread generating the vertices of requested level-of-detail tiles, or 0
 	
 	/* Private methods: */
 	Point* calcVertices(void) const; // Returns a new-allocated array of vertex positions, untransformed by the point transformation
@@ -111,10 +153,25 @@ class ElevationGridNode:public GeometryNode,public GLObject
 	void uploadIndexedQuadStripSet(bool havePrimitiveRestart) const; // Uploads the elevation grid as a set of indexed quad strips
 	void uploadQuadSet(void) const; // Uploads the elevation grid as a set of quads
 	void uploadHoleyQuadTriangleSet(GLuint& numQuads,GLuint& numTriangles) const; // Uploads the elevation grid as a set of quads and triangles with removal of invalid samples; updates passed number of quads and triangles
+	Vector calcQuadNormal(int x,int z) const; // Returns the non-normalized normal vector of the given quad
+	Scalar interpolateLodHeight(const LodTile& tile,int x,int z) const; // Returns the scaled height of the given tile's surface above the given grid sample
+	int createLodTile(int level,int x0,int z0); // Recursively creates the level-of-detail tile of the given level and first sample and its descendants; returns the tile's index
+	void createLodTiles(void); // Creates the level-of-detail quadtree
+	void uploadLodTileIndices(void) const; // Uploads the vertex indices shared by all level-of-detail tiles
+	void calcLodTileVertices(const LodTile& tile,LodVertex* vertices) const; // Calculates the grid and skirt vertices of the given level-of-detail tile into the given array
+	void* lodLoaderThreadMethod(void); // Thread method generating the vertices of requested level-of-detail tiles
+	void startLodLoader(void); // Generates the root tile's vertices and starts the tile loader thread
+	void stopLodLoader(void); // Shuts down the tile loader thread and releases all generated tile vertices
+	const LodVertex* pinLodTile(int tileIndex) const; // Returns the generated vertices of the given level-of-detail tile and pins them, or requests the tile from the loader thread and returns null
+	void unpinLodTile(int tileIndex) const; // Unpins the vertices of the given level-of-detail tile
+	void loadLodTile(int tileIndex,const LodVertex* vertices,DataItem* dataItem,GLRenderState& renderState) const; // Makes the given level-of-detail tile resident by uploading the given vertices
+	void glRenderLodTile(int tileIndex,DataItem* dataItem,GLRenderState& renderState,int& numTileLoads) const; // Recursively renders the given level-of-detail tile or its descendants
+	void glRenderLodTiles(DataItem* dataItem,GLRenderState& renderState) const; // Renders the elevation grid as a set of view-dependent level-of-detail tiles
 	
 	/* Constructors and destructors: */
 	public:
 	ElevationGridNode(void); // Creates a default elevation grid
+	virtual ~ElevationGridNode(void); // Shuts down the level-of-detail tile loader thread
 	
 	/* Methods from Node: */
 	virtual const char* getClassName(void) const;
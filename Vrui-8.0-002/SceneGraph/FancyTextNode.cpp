@@ -104,6 +104,9 @@ void FancyTextNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int FancyTextNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Check all strings for valid UTF-8 encoding: */
 	for(MFString::ValueList::const_iterator sIt=string.getValues().begin();sIt!=string.getValues().end();++sIt)
 		if(!Misc::UTF8::isValid(sIt->begin(),sIt->end()))
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <SceneGraph/GLRenderState.h>
 
+#include <Math/Constants.h>
 #include <Geometry/Matrix.h>
 #include <GL/gl.h>
 #include <GL/GLColorTemplates.h>
@@ -78,13 +79,14 @@ void GLRenderState::changeVertexArraysMask(int currentMask,int newMask)
 GLRenderState::GLRenderState(GLContextData& sContextData,const DOGTransform& initialTransform,const Point& sBaseViewerPos,const Vector& sBaseUpVector)
 	:contextData(sContextData),
 	 modelviewOutdated(true),
-	 haveTextureTransform(false)
+	 haveTextureTransform(false),
+	 frustumCulling(true),numCulledNodes(0),numDrawnNodes(0)
 	{
 	/* Update the viewer position, up vector, and initial model transformation: */
 	TraversalState::startTraversal(initialTransform,sBaseViewerPos,sBaseUpVector);
 	
-	/* Initialize the view frustum from the current OpenGL context and the initial model transformation: */
-	baseFrustum.setFromGL(currentTransform);
+	/* Initialize the view frustum in eye coordinates from the current OpenGL context's projection matrix; the current transformation maps model coordinates to eye coordinates: */
+	baseFrustum.setFromGL(Frustum::OGTransform::identity);
 	
 	/* Initialize OpenGL state tracking elements: */
 	GLint tempFrontFace;
@@ -197,8 +199,8 @@ void GLRenderState::startTraversal(const DOGTransform& newCurrentTransform,const
 	/* Mark OpenGL's modelview matrix as outdated: */
 	modelviewOutdated=true;
 	
-	/* Initialize the view frustum from the current OpenGL context and the initial model transformation: */
-	baseFrustum.setFromGL(currentTransform);
+	/* Initialize the view frustum in eye coordinates from the current OpenGL context's projection matrix; the current transformation maps model coordinates to eye coordinates: */
+	baseFrustum.setFromGL(Frustum::OGTransform::identity);
 	}
 
 void GLRenderState::setRenderPass(Misc::UInt32 newRenderPass)
@@ -245,14 +247,37 @@ bool GLRenderState::doesBoxIntersectFrustum(const Box& box) const
 		for(int i=0;i<3;++i)
 			p[i]=normal*axis[i]>Scalar(0)?box.max[i]:box.min[i];
 		
-		/* Check if the point is inside the view frustum: */
-		if(!baseFrustum.getFrustumPlane(planeIndex).contains(currentTransform.transform(p)))
+		/* Check if the point is inside the view frustum, i.e., in front of the inward-facing frustum plane: */
+		if(normal*Point(currentTransform.transform(p))<baseFrustum.getFrustumPlane(planeIndex).getOffset())
 			return false;
 		}
 	
 	return true;
 	}
 
+Scalar GLRenderState::calcProjectedSize(const Box& box,Scalar size) const
+	{
+	/* Get the current transformation's direction axes: */
+	Vector axis[3];
+	for(int i=0;i<3;++i)
+		axis[i]=currentTransform.getDirection(i);
+	
+	/* Find the point on the bounding box which is closest to the screen plane: */
+	const Vector& normal=baseFrustum.getScreenPlane().getNormal();
+	Point p;
+	for(int i=0;i<3;++i)
+		p[i]=normal*axis[i]>Scalar(0)?box.min[i]:box.max[i];
+	
+	/* Calculate the projection denominator at the closest point: */
+	Scalar denominator=Scalar(1)-baseFrustum.getEyeScreenDistance()*baseFrustum.getScreenPlane().calcDistance(currentTransform.transform(p));
+	
+	/* Return an infinite size if the box contains or straddles the eye: */
+	if(denominator<=Scalar(0))
+		return Math::Constants<Scalar>::max;
+	
+	return (size*Scalar(currentTransform.getScaling())*baseFrustum.getPixelSize())/denominator;
+	}
+
 void GLRenderState::setTextureTransform(const GLRenderState::TextureTransform& newTextureTransform)
 	{
 	/* Set up the new texture transformation: */
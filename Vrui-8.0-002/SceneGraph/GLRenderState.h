@@ -73,11 +73,14 @@ class GLRenderState:public TraversalState
 	public:
 	GLContextData& contextData; // Context data of the current OpenGL context
 	private:
-	Frustum baseFrustum; // The rendering context's view frustum in initial model coordinates
+	Frustum baseFrustum; // The rendering context's view frustum in eye coordinates
 	Misc::UInt32 initialRenderPass; // The initially active rendering pass
 	Misc::UInt32 currentRenderPass; // The currently active rendering pass
 	bool modelviewOutdated; // Flag if OpenGL's modelview matrix does not correspond to the current model transformation
 	bool haveTextureTransform; // Flag if a texture transformation has been set
+	bool frustumCulling; // Flag whether group nodes skip children that are entirely outside the view frustum
+	unsigned int numCulledNodes; // Number of group nodes that were culled against the view frustum since the render state was created
+	unsigned int numDrawnNodes; // Number of nodes whose OpenGL render actions were called by group nodes since the render state was created
 	
 	/* Elements shadowing current OpenGL state: */
 	public:
@@ -128,6 +131,31 @@ class GLRenderState:public TraversalState
 		}
 	void setRenderPass(Misc::UInt32 newRenderPass); // Switches to the given rendering pass
 	bool doesBoxIntersectFrustum(const Box& box) const; // Returns true if the given box in current model coordinates intersects the view frustum
+	Scalar calcProjectedSize(const Box& box,Scalar size) const; // Returns the largest size in pixels to which the given length in current model coordinates projects anywhere inside the given box in current model coordinates
+	bool isFrustumCullingEnabled(void) const // Returns true if group nodes cull their children against the view frustum
+		{
+		return frustumCulling;
+		}
+	void setFrustumCulling(bool newFrustumCulling) // Enables or disables view frustum culling in group nodes
+		{
+		frustumCulling=newFrustumCulling;
+		}
+	void countCulledNode(void) // Counts a group node that was culled against the view frustum
+		{
+		++numCulledNodes;
+		}
+	void countDrawnNode(void) // Counts a node whose OpenGL render action was called
+		{
+		++numDrawnNodes;
+		}
+	unsigned int getNumCulledNodes(void) const // Returns the number of culled group nodes since the render state was created
+		{
+		return numCulledNodes;
+		}
+	unsigned int getNumDrawnNodes(void) const // Returns the number of drawn nodes since the render state was created
+		{
+		return numDrawnNodes;
+		}
 	void setTextureTransform(const TextureTransform& newTextureTransform); // Sets the given transformation as the new texture transformation
 	void resetTextureTransform(void); // Resets the texture transformation
 	
@@ -188,4 +188,13 @@ void GeodeticToCartesianTransformNode::alRenderAction(ALRenderState& renderState
 	renderState.popTransform(previousTransform);
 	}
 
+Box GeodeticToCartesianTransformNode::calcCullingBox(void) const
+	{
+	/* Transform the group's culling box to the parent's coordinate system: */
+	Box result=getLocalCullingBox();
+	if(!result.isNull()&&!result.isFull())
+		result.transform(transform);
+	return result;
+	}
+
 }
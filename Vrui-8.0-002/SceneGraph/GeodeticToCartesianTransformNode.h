@@ -68,6 +68,9 @@ class GeodeticToCartesianTransformNode:public GroupNode
 	virtual void glRenderAction(GLRenderState& renderState) const;
 	virtual void alRenderAction(ALRenderState& renderState) const;
 	
+	/* Methods from class GroupNode: */
+	virtual Box calcCullingBox(void) const;
+	
 	/* New methods: */
 	const DOGTransform& getTransform(void) const // Returns the current derived transformation
 		{
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <SceneGraph/VRMLFile.h>
+#include <SceneGraph/GroupNode.h>
 
 namespace SceneGraph {
 
@@ -45,6 +46,14 @@ void GeometryNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 		Node::parseField(fieldName,vrmlFile);
 	}
 
+unsigned int GeometryNode::update(void)
+	{
+	/* Invalidate the cached culling boxes of all group nodes, as group nodes are not notified of changes to their geometry nodes: */
+	GroupNode::invalidateBoundingBoxes();
+	
+	return NoCascade;
+	}
+
 void GeometryNode::mustProvideTexCoords(void)
 	{
 	needTexCoords=true;
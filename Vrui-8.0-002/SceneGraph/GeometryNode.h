@@ -59,6 +59,7 @@ class GeometryNode:public Node
 	
 	/* Methods from class Node: */
 	virtual void parseField(const char* fieldName,VRMLFile& vrmlFile);
+	virtual unsigned int update(void);
 	
 	/* New methods: */
 	void mustProvideTexCoords(void); // Flags the geometry node as requiring per-vertex texture coordinates
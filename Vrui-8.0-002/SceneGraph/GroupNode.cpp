@@ -34,6 +34,7 @@ Static elements of class GroupNode:
 **********************************/
 
 const char* GroupNode::className="Group";
+Threads::Atomic<unsigned int> GroupNode::boundingBoxVersion(1);
 
 /**************************
 Methods of class GroupNode:
@@ -42,7 +43,8 @@ Methods of class GroupNode:
 GroupNode::GroupNode(void)
 	:bboxCenter(Point::origin),
 	 bboxSize(Size(-1,-1,-1)),
-	 explicitBoundingBox(0)
+	 explicitBoundingBox(0),
+	 cullingBoxVersion(0)
 	{
 	/* An empty group node does not participate in any processing: */
 	passMask=0x0U;
@@ -184,6 +186,9 @@ unsigned int GroupNode::update(void)
 		explicitBoundingBox=0;
 		}
 	
+	/* Invalidate all cached culling boxes: */
+	invalidateBoundingBoxes();
+	
 	/* Set the new pass mask: */
 	return setPassMask(newPassMask);
 	}
@@ -192,6 +197,9 @@ unsigned int GroupNode::cascadingUpdate(Node& child,unsigned int childUpdateResu
 	{
 	unsigned int result=NoCascade;
 	
+	/* Invalidate all cached culling boxes, as the child's extents might have changed: */
+	invalidateBoundingBoxes();
+	
 	/* Act depending on the node's update result: */
 	if(childUpdateResult==CascadePassAdded)
 		{
@@ -257,10 +265,24 @@ void GroupNode::testCollision(SphereCollisionQuery& collisionQuery) const
 
 void GroupNode::glRenderAction(GLRenderState& renderState) const
 	{
+	/* Skip the group's children if they are entirely outside the view frustum: */
+	if(renderState.isFrustumCullingEnabled())
+		{
+		Box box=getLocalCullingBox();
+		if(!box.isFull()&&(box.isNull()||!renderState.doesBoxIntersectFrustum(box)))
+			{
+			renderState.countCulledNode();
+			return;
+			}
+		}
+	
 	/* Call the OpenGL render actions of all child nodes that participate in the current OpenGL rendering pass in order: */
 	for(ChildList::const_iterator chIt=children.getValues().begin();chIt!=children.getValues().end();++chIt)
 		if((*chIt)->participatesInPass(renderState.getRenderPass()))
+			{
+			renderState.countDrawnNode();
 			(*chIt)->glRenderAction(renderState);
+			}
 	}
 
 void GroupNode::alRenderAction(ALRenderState& renderState) const
@@ -271,8 +293,79 @@ void GroupNode::alRenderAction(ALRenderState& renderState) const
 			(*chIt)->alRenderAction(renderState);
 	}
 
+Box GroupNode::getLocalCullingBox(void) const
+	{
+	/* Check if the cached culling box is current without locking, as it only changes after the scene graph was updated: */
+	unsigned int version=boundingBoxVersion.get();
+	if(cullingBoxVersion==version)
+		{
+		/* Copy the cached culling box and check that it was not recalculated by another rendering thread in the meantime: */
+		__sync_synchronize();
+		Box result=cullingBox;
+		__sync_synchronize();
+		if(cullingBoxVersion==version)
+			return result;
+		}
+	
+	/* Lock the cached culling box, as the group can be rendered from several threads at once: */
+	Threads::Mutex::Lock cullingBoxLock(cullingBoxMutex);
+	
+	/* Check if the cached culling box is still outdated: */
+	version=boundingBoxVersion.get();
+	if(cullingBoxVersion!=version)
+		{
+		Box newCullingBox;
+		if(explicitBoundingBox!=0)
+			{
+			/* Use the explicit bounding box, which is given in the group's own coordinate system: */
+			newCullingBox=*explicitBoundingBox;
+			}
+		else
+			{
+			/* Calculate the union of all children's bounding boxes: */
+			newCullingBox=Box::empty;
+			for(ChildList::const_iterator chIt=children.getValues().begin();chIt!=children.getValues().end()&&!newCullingBox.isFull();++chIt)
+				{
+				const GroupNode* groupChild=dynamic_cast<const GroupNode*>(chIt->getPointer());
+				if(groupChild!=0)
+					{
+					/* Ask the child group for its own culling box: */
+					newCullingBox.addBox(groupChild->calcCullingBox());
+					}
+				else
+					{
+					/* Treat children that render something but don't report their extents as unbounded: */
+					Box childBox=(*chIt)->calcBoundingBox();
+					if(childBox.isNull()&&(*chIt)->participatesInPass(GLRenderPass|GLTransparentRenderPass))
+						newCullingBox=Box::full;
+					else
+						newCullingBox.addBox(childBox);
+					}
+				}
+			}
+		
+		/* Update the cached culling box while marking it as invalid for concurrent readers: */
+		cullingBoxVersion=0;
+		__sync_synchronize();
+		cullingBox=newCullingBox;
+		__sync_synchronize();
+		cullingBoxVersion=version;
+		}
+	
+	return cullingBox;
+	}
+
+Box GroupNode::calcCullingBox(void) const
+	{
+	/* A plain group's coordinate system is the same as its parent's: */
+	return getLocalCullingBox();
+	}
+
 unsigned int GroupNode::addChild(GraphNode& child)
 	{
+	/* Invalidate all cached culling boxes: */
+	invalidateBoundingBoxes();
+	
 	/* Add the child to the children field: */
 	children.appendValue(&child);
 	
@@ -289,6 +382,9 @@ unsigned int GroupNode::addChild(GraphNode& child)
 
 unsigned int GroupNode::removeChild(GraphNode& child)
 	{
+	/* Invalidate all cached culling boxes: */
+	invalidateBoundingBoxes();
+	
 	/* Remove the first instance of the child from the children field: */
 	children.removeFirstValue(&child);
 	
@@ -308,6 +404,9 @@ unsigned int GroupNode::removeChild(GraphNode& child)
 
 unsigned int GroupNode::removeAllChildren(void)
 	{
+	/* Invalidate all cached culling boxes: */
+	invalidateBoundingBoxes();
+	
 	/* Clear the children field: */
 	children.clearValues();
 	
@@ -25,7 +25,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <vector>
 #include <Misc/Autopointer.h>
 #include <Geometry/ComponentArray.h>
+#include <Geometry/Box.h>
 #include <Geometry/Point.h>
+#include <Threads/Atomic.h>
+#include <Threads/Mutex.h>
 #include <SceneGraph/FieldTypes.h>
 #include <SceneGraph/GraphNode.h>
 
@@ -61,6 +64,11 @@ class GroupNode:public GraphNode
 	/* Derived state: */
 	protected:
 	Box* explicitBoundingBox; // Pointer to the explicit bounding box; null if there is no explicit bounding box
+	private:
+	static Threads::Atomic<unsigned int> boundingBoxVersion; // Global version number of cached bounding boxes; incremented whenever any group or geometry node is updated
+	mutable Threads::Mutex cullingBoxMutex; // Mutex serializing recalculation of the cached culling box by concurrent rendering threads
+	mutable volatile unsigned int cullingBoxVersion; // Global version number for which the cached culling box was calculated; zero while the cached culling box is being recalculated
+	mutable Box cullingBox; // Cached bounding box of the group's children in the group's own coordinate system; full if the children's extents are unknown
 	
 	/* Constructors and destructors: */
 	public:
@@ -87,6 +95,14 @@ class GroupNode:public GraphNode
 		{
 		return children.getValues();
 		}
+	static void invalidateBoundingBoxes(void) // Invalidates the cached culling boxes of all group nodes after changes that were not reported via update() or cascadingUpdate()
+		{
+		/* Skip the version number marking culling boxes that are being recalculated on wrap-around: */
+		if(boundingBoxVersion.preAdd(1)==0)
+			boundingBoxVersion.preAdd(1);
+		}
+	Box getLocalCullingBox(void) const; // Returns the bounding box of the group's children in the group's own coordinate system, used for view frustum culling; returns a full box if the children's extents are unknown
+	virtual Box calcCullingBox(void) const; // Returns the group's culling box in its parent's coordinate system; returns a full box if the box can change without the parent being updated
 	virtual unsigned int addChild(GraphNode& child); // Adds the given child to the group; returns result from update()
 	virtual unsigned int removeChild(GraphNode& child); // Removes the given child from the group; returns result from update()
 	virtual unsigned int removeAllChildren(void); // Removes all children from the group; returns result from update()
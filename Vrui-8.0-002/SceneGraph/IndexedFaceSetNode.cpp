@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <Math/Math.h>
+#include <Math/Interval.h>
 #include <Geometry/PrimaryPlaneProjector.h>
 #include <GL/gl.h>
 #include <GL/GLVertexArrayParts.h>
@@ -33,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/VRMLFile.h>
 #include <SceneGraph/SphereCollisionQuery.h>
 #include <SceneGraph/GLRenderState.h>
+#include <SceneGraph/Internal/FaceBVH.h>
 
 namespace SceneGraph {
 
@@ -122,91 +124,286 @@ bool pointInFace(const Geometry::PrimaryPlaneProjector<Scalar>& ppp,const Geomet
 	return inside;
 	}
 
-}
+void testFaceSolidCcw(SphereCollisionQuery& collisionQuery,const MFPoint::ValueList& coords,MFInt::ValueList::const_iterator faceBegin,MFInt::ValueList::const_iterator faceEnd)
+	{
+	/* Retrieve query parameters: */
+	const Point& c0=collisionQuery.getC0();
+	const Vector& c0c1=collisionQuery.getC0c1();
+	Scalar radius=collisionQuery.getRadius();
+	
+	/* Calculate the plane equation defined by the first three vertices: */
+	Point center=coords[*faceBegin];
+	Vector normal=triangleNormal(center,coords[*(faceBegin+1)],coords[*(faceBegin+2)]);
+	
+	/* Test the sphere against the face's plane: */
+	Scalar denominator=c0c1*normal;
+	Scalar offset=(c0-center)*normal;
+	if(denominator<Scalar(0)&&offset>=Scalar(0))
+		{
+		/* Calculate the intersection of the sphere's path with the face's plane: */
+		Scalar normalSqr=normal.sqr();
+		Scalar normalMag=Math::sqrt(normalSqr);
+		Scalar counter=radius*normalMag-offset;
+		Scalar lambda=counter<Scalar(0)?counter/denominator:Scalar(0); // Take care of the case where the sphere is already penetrating the face
+		if(lambda<collisionQuery.getHitLambda())
+			{
+			/* Calculate the point where the sphere hits the face's plane and project it to 2D: */
+			Point hit3=c0;
+			if(lambda>Scalar(0))
+				hit3.addScaled(c0c1,lambda).subtractScaled(normal,radius/normalMag);
+			else
+				hit3.subtractScaled(normal,offset/normalSqr);
+			Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
+			Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
+			
+			/* Check if the intersection point is inside the face: */
+			bool inside=pointInFace(ppp,hit,coords,faceBegin,faceEnd);
+			if(inside)
+				{
+				/* This is the actual collision: */
+				collisionQuery.update(lambda,normal);
+				}
+			else
+				{
+				/* Test the face's vertices and edges: */
+				MFInt::ValueList::const_iterator it0=faceEnd-2;
+				Geometry::PrimaryPlaneProjector<Scalar>::Point2 v0=ppp.project(coords[*it0]);
+				MFInt::ValueList::const_iterator it1=faceEnd-1;
+				Geometry::PrimaryPlaneProjector<Scalar>::Point2 v1=ppp.project(coords[*it1]);
+				bool testE0=(hit[0]-v0[0])*(v1[1]-v0[1])>(hit[1]-v0[1])*(v1[0]-v0[0]);
+				for(MFInt::ValueList::const_iterator it2=faceBegin;it2!=faceEnd;it0=it1,it1=it2,++it2)
+					{
+					Geometry::PrimaryPlaneProjector<Scalar>::Point2 v2=ppp.project(coords[*it2]);
+					bool testE1=(hit[0]-v1[0])*(v2[1]-v1[1])>(hit[1]-v1[1])*(v2[0]-v1[0]);
+					
+					/* Test the edge and the vertex if the hit point is outside of it: */
+					if(testE1)
+						{
+						collisionQuery.testEdgeAndUpdate(coords[*it1],coords[*it2]);
+						collisionQuery.testVertexAndUpdate(coords[*it1]);
+						}
+					else if(testE0)
+						collisionQuery.testVertexAndUpdate(coords[*it1]);
+					
+					v1=v2;
+					testE0=testE1;
+					}
+				}
+			}
+		}
+	}
 
-void IndexedFaceSetNode::testCollisionSolidCcw(SphereCollisionQuery& collisionQuery) const
+void testFaceSolidCw(SphereCollisionQuery& collisionQuery,const MFPoint::ValueList& coords,MFInt::ValueList::const_iterator faceBegin,MFInt::ValueList::const_iterator faceEnd)
 	{
 	/* Retrieve query parameters: */
 	const Point& c0=collisionQuery.getC0();
 	const Vector& c0c1=collisionQuery.getC0c1();
 	Scalar radius=collisionQuery.getRadius();
 	
-	/* Get a handle to the face set's vertex coordinates and vertex indices: */
-	const MFPoint::ValueList& coords=coord.getValue()->point.getValues();
-	const MFInt::ValueList& coordIndices=coordIndex.getValues();
+	/* Calculate the plane equation defined by the first three vertices: */
+	Point center=coords[*faceBegin];
+	Vector normal=triangleNormal(center,coords[*(faceBegin+2)],coords[*(faceBegin+1)]);
 	
-	/* Test the sphere against all faces: */
-	for(MFInt::ValueList::const_iterator ciIt=coordIndices.begin();ciIt!=coordIndices.end();)
+	/* Test the sphere against the face's plane: */
+	Scalar denominator=c0c1*normal;
+	Scalar offset=(c0-center)*normal;
+	if(denominator<Scalar(0)&&offset>=Scalar(0))
 		{
-		/* Find the end of the current face's vertex list: */
-		MFInt::ValueList::const_iterator faceEnd;
-		for(faceEnd=ciIt;faceEnd!=coordIndices.end()&&*faceEnd>=0;++faceEnd)
-			;
-		
-		/* Check if the face has at least three vertices: */
-		if(faceEnd-ciIt>=3)
+		/* Calculate the intersection of the sphere's path with the face's plane: */
+		Scalar normalSqr=normal.sqr();
+		Scalar normalMag=Math::sqrt(normalSqr);
+		Scalar counter=radius*normalMag-offset;
+		Scalar lambda=counter<Scalar(0)?counter/denominator:Scalar(0); // Take care of the case where the sphere is already penetrating the face
+		if(lambda<collisionQuery.getHitLambda())
 			{
-			/* Calculate the plane equation defined by the first three vertices: */
-			Point center=coords[*ciIt];
-			Vector normal=triangleNormal(center,coords[*(ciIt+1)],coords[*(ciIt+2)]);
+			/* Calculate the point where the sphere hits the face's plane and project it to 2D: */
+			Point hit3=c0;
+			if(lambda>Scalar(0))
+				hit3.addScaled(c0c1,lambda).subtractScaled(normal,radius/normalMag);
+			else
+				hit3.subtractScaled(normal,offset/normalSqr);
+			Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
+			Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
 			
-			/* Test the sphere against the face's plane: */
-			Scalar denominator=c0c1*normal;
-			Scalar offset=(c0-center)*normal;
-			if(denominator<Scalar(0)&&offset>=Scalar(0))
+			/* Check if the intersection point is inside the face: */
+			bool inside=pointInFace(ppp,hit,coords,faceBegin,faceEnd);
+			if(inside)
 				{
-				/* Calculate the intersection of the sphere's path with the face's plane: */
-				Scalar normalSqr=normal.sqr();
-				Scalar normalMag=Math::sqrt(normalSqr);
-				Scalar counter=radius*normalMag-offset;
-				Scalar lambda=counter<Scalar(0)?counter/denominator:Scalar(0); // Take care of the case where the sphere is already penetrating the face
-				if(lambda<collisionQuery.getHitLambda())
+				/* This is the actual collision: */
+				collisionQuery.update(lambda,normal);
+				}
+			else
+				{
+				/* Test the face's vertices and edges: */
+				MFInt::ValueList::const_iterator it0=faceEnd-2;
+				Geometry::PrimaryPlaneProjector<Scalar>::Point2 v0=ppp.project(coords[*it0]);
+				MFInt::ValueList::const_iterator it1=faceEnd-1;
+				Geometry::PrimaryPlaneProjector<Scalar>::Point2 v1=ppp.project(coords[*it1]);
+				bool testE0=(hit[0]-v0[0])*(v1[1]-v0[1])<(hit[1]-v0[1])*(v1[0]-v0[0]);
+				for(MFInt::ValueList::const_iterator it2=faceBegin;it2!=faceEnd;it0=it1,it1=it2,++it2)
 					{
-					/* Calculate the point where the sphere hits the face's plane and project it to 2D: */
-					Point hit3=c0;
-					if(lambda>Scalar(0))
-						hit3.addScaled(c0c1,lambda).subtractScaled(normal,radius/normalMag);
-					else
-						hit3.subtractScaled(normal,offset/normalSqr);
-					Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
-					Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
+					Geometry::PrimaryPlaneProjector<Scalar>::Point2 v2=ppp.project(coords[*it2]);
+					bool testE1=(hit[0]-v1[0])*(v2[1]-v1[1])<(hit[1]-v1[1])*(v2[0]-v1[0]);
 					
-					/* Check if the intersection point is inside the face: */
-					bool inside=pointInFace(ppp,hit,coords,ciIt,faceEnd);
-					if(inside)
+					/* Test the edge and the vertex if the hit point is outside of it: */
+					if(testE1)
 						{
-						/* This is the actual collision: */
-						collisionQuery.update(lambda,normal);
+						collisionQuery.testEdgeAndUpdate(coords[*it1],coords[*it2]);
+						collisionQuery.testVertexAndUpdate(coords[*it1]);
 						}
-					else
+					else if(testE0)
+						collisionQuery.testVertexAndUpdate(coords[*it1]);
+					
+					v1=v2;
+					testE0=testE1;
+					}
+				}
+			}
+		}
+	}
+
+void testFaceNonSolid(SphereCollisionQuery& collisionQuery,const MFPoint::ValueList& coords,MFInt::ValueList::const_iterator faceBegin,MFInt::ValueList::const_iterator faceEnd)
+	{
+	/* Retrieve query parameters: */
+	const Point& c0=collisionQuery.getC0();
+	const Vector& c0c1=collisionQuery.getC0c1();
+	Scalar radius=collisionQuery.getRadius();
+	
+	/* Calculate the plane equation defined by the first three vertices: */
+	Point center=coords[*faceBegin];
+	Vector normal=triangleNormal(center,coords[*(faceBegin+1)],coords[*(faceBegin+2)]);
+	
+	/* Test the sphere against the slab containing the face's plane: */
+	Scalar normalSqr=normal.sqr();
+	Scalar normalMag=Math::sqrt(normalSqr);
+	Scalar offset=(c0-center)*normal;
+	Scalar radiusNormal=radius*normalMag;
+	if(Math::abs(offset)>radiusNormal) // Sphere's starting point is outside the slab
+		{
+		Scalar denominator=c0c1*normal;
+		Scalar slabOffset=Math::copysign(radiusNormal,offset);
+		Scalar lambda=(slabOffset-offset)/denominator;
+		if(lambda>=Scalar(0)&&lambda<collisionQuery.getHitLambda())
+			{
+			/* Calculate the point where the sphere hits the face's plane and project it to 2D: */
+			Point hit3=Geometry::addScaled(c0,c0c1,lambda).subtractScaled(normal,Math::copysign(radius,offset)/normalMag);
+			Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
+			Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
+			
+			/* Check if the intersection point is inside the face: */
+			bool inside=pointInFace(ppp,hit,coords,faceBegin,faceEnd);
+			if(inside)
+				{
+				/* This is the actual collision: */
+				collisionQuery.update(lambda,offset>Scalar(0)?normal:-normal);
+				}
+			else
+				{
+				/* Test the face's vertices and edges: */
+				MFInt::ValueList::const_iterator it0=faceEnd-2;
+				Geometry::PrimaryPlaneProjector<Scalar>::Point2 v0=ppp.project(coords[*it0]);
+				MFInt::ValueList::const_iterator it1=faceEnd-1;
+				Geometry::PrimaryPlaneProjector<Scalar>::Point2 v1=ppp.project(coords[*it1]);
+				bool testE0=(hit[0]-v0[0])*(v1[1]-v0[1])>(hit[1]-v0[1])*(v1[0]-v0[0]);
+				for(MFInt::ValueList::const_iterator it2=faceBegin;it2!=faceEnd;it0=it1,it1=it2,++it2)
+					{
+					Geometry::PrimaryPlaneProjector<Scalar>::Point2 v2=ppp.project(coords[*it2]);
+					bool testE1=(hit[0]-v1[0])*(v2[1]-v1[1])>(hit[1]-v1[1])*(v2[0]-v1[0]);
+					
+					/* Test the edge and the vertex if the hit point is outside of it: */
+					if(testE1)
 						{
-						/* Test the face's vertices and edges: */
-						MFInt::ValueList::const_iterator it0=faceEnd-2;
-						Geometry::PrimaryPlaneProjector<Scalar>::Point2 v0=ppp.project(coords[*it0]);
-						MFInt::ValueList::const_iterator it1=faceEnd-1;
-						Geometry::PrimaryPlaneProjector<Scalar>::Point2 v1=ppp.project(coords[*it1]);
-						bool testE0=(hit[0]-v0[0])*(v1[1]-v0[1])>(hit[1]-v0[1])*(v1[0]-v0[0]);
-						for(MFInt::ValueList::const_iterator it2=ciIt;it2!=faceEnd;it0=it1,it1=it2,++it2)
-							{
-							Geometry::PrimaryPlaneProjector<Scalar>::Point2 v2=ppp.project(coords[*it2]);
-							bool testE1=(hit[0]-v1[0])*(v2[1]-v1[1])>(hit[1]-v1[1])*(v2[0]-v1[0]);
-							
-							/* Test the edge and the vertex if the hit point is outside of it: */
-							if(testE1)
-								{
-								collisionQuery.testEdgeAndUpdate(coords[*it1],coords[*it2]);
-								collisionQuery.testVertexAndUpdate(coords[*it1]);
-								}
-							else if(testE0)
-								collisionQuery.testVertexAndUpdate(coords[*it1]);
-							
-							v1=v2;
-							testE0=testE1;
-							}
+						collisionQuery.testEdgeAndUpdate(coords[*it1],coords[*it2]);
+						collisionQuery.testVertexAndUpdate(coords[*it1]);
 						}
+					else if(testE0)
+						collisionQuery.testVertexAndUpdate(coords[*it1]);
+					
+					v1=v2;
+					testE0=testE1;
 					}
 				}
 			}
+		}
+	else // Sphere's starting point is inside the slab
+		{
+		/* Check if the sphere's starting point is inside the face: */
+		Point hit3=Geometry::subtractScaled(c0,normal,offset/normalSqr);
+		Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
+		Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
+		bool inside=pointInFace(ppp,hit,coords,faceBegin,faceEnd);
+		if(inside)
+			{
+			/* Check if the sphere is attempting to penetrate deeper into the face: */
+			if(collisionQuery.getHitLambda()>Scalar(0)&&(c0c1*normal)*offset<Scalar(0))
+				{
+				/* Prevent further movement: */
+				collisionQuery.update(Scalar(0),offset>Scalar(0)?normal:-normal);
+				}
+			}
+		else
+			{
+			/* Test the face's vertices and edges: */
+			MFInt::ValueList::const_iterator it0=faceEnd-1;
+			for(MFInt::ValueList::const_iterator it1=faceBegin;it1!=faceEnd;it0=it1,++it1)
+				{
+				collisionQuery.testVertexAndUpdate(coords[*it1]);
+				collisionQuery.testEdgeAndUpdate(coords[*it0],coords[*it1]);
+				}
+			}
+		}
+	}
+
+typedef void (*FaceTestFunction)(SphereCollisionQuery& collisionQuery,const MFPoint::ValueList& coords,MFInt::ValueList::const_iterator faceBegin,MFInt::ValueList::const_iterator faceEnd); // Type for per-face collision test functions
+
+class FaceCollisionVisitor // Class to test a collision query against the faces found during a bounding volume hierarchy traversal
+	{
+	/* Elements: */
+	private:
+	SphereCollisionQuery& collisionQuery; // The collision query
+	const MFPoint::ValueList& coords; // The face set's vertex coordinates
+	FaceTestFunction testFace; // Function to test the collision query against a single face
+	
+	/* Constructors and destructors: */
+	public:
+	FaceCollisionVisitor(SphereCollisionQuery& sCollisionQuery,const MFPoint::ValueList& sCoords,FaceTestFunction sTestFace)
+		:collisionQuery(sCollisionQuery),coords(sCoords),testFace(sTestFace)
+		{
+		}
+	
+	/* Methods: */
+	bool intersectBox(const Box& box,Scalar& entry)
+		{
+		/* Sort boxes by the parameter at which the sphere's path enters them: */
+		Math::Interval<Scalar> interval=collisionQuery.calcBoxInterval(box);
+		entry=interval.getMin();
+		return interval.getMin()<interval.getMax();
+		}
+	void visitFace(MFInt::ValueList::const_iterator faceBegin,MFInt::ValueList::const_iterator faceEnd)
+		{
+		testFace(collisionQuery,coords,faceBegin,faceEnd);
+		}
+	};
+
+}
+
+void IndexedFaceSetNode::testCollisionSolidCcw(SphereCollisionQuery& collisionQuery) const
+	{
+	/* Get a handle to the face set's vertex coordinates and vertex indices: */
+	const MFPoint::ValueList& coords=coord.getValue()->point.getValues();
+	const MFInt::ValueList& coordIndices=coordIndex.getValues();
+	
+	/* Test the sphere against all faces: */
+	for(MFInt::ValueList::const_iterator ciIt=coordIndices.begin();ciIt!=coordIndices.end();)
+		{
+		/* Find the end of the current face's vertex list: */
+		MFInt::ValueList::const_iterator faceEnd;
+		for(faceEnd=ciIt;faceEnd!=coordIndices.end()&&*faceEnd>=0;++faceEnd)
+			;
+		
+		/* Check if the face has at least three vertices: */
+		if(faceEnd-ciIt>=3)
+			testFaceSolidCcw(collisionQuery,coords,ciIt,faceEnd);
 		
 		/* Go to the next face: */
 		if(faceEnd!=coordIndices.end())
@@ -217,11 +414,6 @@ void IndexedFaceSetNode::testCollisionSolidCcw(SphereCollisionQuery& collisionQu
 
 void IndexedFaceSetNode::testCollisionSolidCw(SphereCollisionQuery& collisionQuery) const
 	{
-	/* Retrieve query parameters: */
-	const Point& c0=collisionQuery.getC0();
-	const Vector& c0c1=collisionQuery.getC0c1();
-	Scalar radius=collisionQuery.getRadius();
-	
 	/* Get a handle to the face set's vertex coordinates and vertex indices: */
 	const MFPoint::ValueList& coords=coord.getValue()->point.getValues();
 	const MFInt::ValueList& coordIndices=coordIndex.getValues();
@@ -236,68 +428,7 @@ void IndexedFaceSetNode::testCollisionSolidCw(SphereCollisionQuery& collisionQue
 		
 		/* Check if the face has at least three vertices: */
 		if(faceEnd-ciIt>=3)
-			{
-			/* Calculate the plane equation defined by the first three vertices: */
-			Point center=coords[*ciIt];
-			Vector normal=triangleNormal(center,coords[*(ciIt+2)],coords[*(ciIt+1)]);
-			
-			/* Test the sphere against the face's plane: */
-			Scalar denominator=c0c1*normal;
-			Scalar offset=(c0-center)*normal;
-			if(denominator<Scalar(0)&&offset>=Scalar(0))
-				{
-				/* Calculate the intersection of the sphere's path with the face's plane: */
-				Scalar normalSqr=normal.sqr();
-				Scalar normalMag=Math::sqrt(normalSqr);
-				Scalar counter=radius*normalMag-offset;
-				Scalar lambda=counter<Scalar(0)?counter/denominator:Scalar(0); // Take care of the case where the sphere is already penetrating the face
-				if(lambda<collisionQuery.getHitLambda())
-					{
-					/* Calculate the point where the sphere hits the face's plane and project it to 2D: */
-					Point hit3=c0;
-					if(lambda>Scalar(0))
-						hit3.addScaled(c0c1,lambda).subtractScaled(normal,radius/normalMag);
-					else
-						hit3.subtractScaled(normal,offset/normalSqr);
-					Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
-					Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
-					
-					/* Check if the intersection point is inside the face: */
-					bool inside=pointInFace(ppp,hit,coords,ciIt,faceEnd);
-					if(inside)
-						{
-						/* This is the actual collision: */
-						collisionQuery.update(lambda,normal);
-						}
-					else
-						{
-						/* Test the face's vertices and edges: */
-						MFInt::ValueList::const_iterator it0=faceEnd-2;
-						Geometry::PrimaryPlaneProjector<Scalar>::Point2 v0=ppp.project(coords[*it0]);
-						MFInt::ValueList::const_iterator it1=faceEnd-1;
-						Geometry::PrimaryPlaneProjector<Scalar>::Point2 v1=ppp.project(coords[*it1]);
-						bool testE0=(hit[0]-v0[0])*(v1[1]-v0[1])<(hit[1]-v0[1])*(v1[0]-v0[0]);
-						for(MFInt::ValueList::const_iterator it2=ciIt;it2!=faceEnd;it0=it1,it1=it2,++it2)
-							{
-							Geometry::PrimaryPlaneProjector<Scalar>::Point2 v2=ppp.project(coords[*it2]);
-							bool testE1=(hit[0]-v1[0])*(v2[1]-v1[1])<(hit[1]-v1[1])*(v2[0]-v1[0]);
-							
-							/* Test the edge and the vertex if the hit point is outside of it: */
-							if(testE1)
-								{
-								collisionQuery.testEdgeAndUpdate(coords[*it1],coords[*it2]);
-								collisionQuery.testVertexAndUpdate(coords[*it1]);
-								}
-							else if(testE0)
-								collisionQuery.testVertexAndUpdate(coords[*it1]);
-							
-							v1=v2;
-							testE0=testE1;
-							}
-						}
-					}
-				}
-			}
+			testFaceSolidCw(collisionQuery,coords,ciIt,faceEnd);
 		
 		/* Go to the next face: */
 		if(faceEnd!=coordIndices.end())
@@ -308,11 +439,6 @@ void IndexedFaceSetNode::testCollisionSolidCw(SphereCollisionQuery& collisionQue
 
 void IndexedFaceSetNode::testCollisionNonSolid(SphereCollisionQuery& collisionQuery) const
 	{
-	/* Retrieve query parameters: */
-	const Point& c0=collisionQuery.getC0();
-	const Vector& c0c1=collisionQuery.getC0c1();
-	Scalar radius=collisionQuery.getRadius();
-	
 	/* Get a handle to the face set's vertex coordinates and vertex indices: */
 	const MFPoint::ValueList& coords=coord.getValue()->point.getValues();
 	const MFInt::ValueList& coordIndices=coordIndex.getValues();
@@ -327,91 +453,7 @@ void IndexedFaceSetNode::testCollisionNonSolid(SphereCollisionQuery& collisionQu
 		
 		/* Check if the face has at least three vertices: */
 		if(faceEnd-ciIt>=3)
-			{
-			/* Calculate the plane equation defined by the first three vertices: */
-			Point center=coords[*ciIt];
-			Vector normal=triangleNormal(center,coords[*(ciIt+1)],coords[*(ciIt+2)]);
-			
-			/* Test the sphere against the slab containing the face's plane: */
-			Scalar normalSqr=normal.sqr();
-			Scalar normalMag=Math::sqrt(normalSqr);
-			Scalar offset=(c0-center)*normal;
-			Scalar radiusNormal=radius*normalMag;
-			if(Math::abs(offset)>radiusNormal) // Sphere's starting point is outside the slab
-				{
-				Scalar denominator=c0c1*normal;
-				Scalar slabOffset=Math::copysign(radiusNormal,offset);
-				Scalar lambda=(slabOffset-offset)/denominator;
-				if(lambda>=Scalar(0)&&lambda<collisionQuery.getHitLambda())
-					{
-					/* Calculate the point where the sphere hits the face's plane and project it to 2D: */
-					Point hit3=Geometry::addScaled(c0,c0c1,lambda).subtractScaled(normal,Math::copysign(radius,offset)/normalMag);
-					Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
-					Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
-					
-					/* Check if the intersection point is inside the face: */
-					bool inside=pointInFace(ppp,hit,coords,ciIt,faceEnd);
-					if(inside)
-						{
-						/* This is the actual collision: */
-						collisionQuery.update(lambda,offset>Scalar(0)?normal:-normal);
-						}
-					else
-						{
-						/* Test the face's vertices and edges: */
-						MFInt::ValueList::const_iterator it0=faceEnd-2;
-						Geometry::PrimaryPlaneProjector<Scalar>::Point2 v0=ppp.project(coords[*it0]);
-						MFInt::ValueList::const_iterator it1=faceEnd-1;
-						Geometry::PrimaryPlaneProjector<Scalar>::Point2 v1=ppp.project(coords[*it1]);
-						bool testE0=(hit[0]-v0[0])*(v1[1]-v0[1])>(hit[1]-v0[1])*(v1[0]-v0[0]);
-						for(MFInt::ValueList::const_iterator it2=ciIt;it2!=faceEnd;it0=it1,it1=it2,++it2)
-							{
-							Geometry::PrimaryPlaneProjector<Scalar>::Point2 v2=ppp.project(coords[*it2]);
-							bool testE1=(hit[0]-v1[0])*(v2[1]-v1[1])>(hit[1]-v1[1])*(v2[0]-v1[0]);
-							
-							/* Test the edge and the vertex if the hit point is outside of it: */
-							if(testE1)
-								{
-								collisionQuery.testEdgeAndUpdate(coords[*it1],coords[*it2]);
-								collisionQuery.testVertexAndUpdate(coords[*it1]);
-								}
-							else if(testE0)
-								collisionQuery.testVertexAndUpdate(coords[*it1]);
-							
-							v1=v2;
-							testE0=testE1;
-							}
-						}
-					}
-				}
-			else // Sphere's starting point is inside the slab
-				{
-				/* Check if the sphere's starting point is inside the face: */
-				Point hit3=Geometry::subtractScaled(c0,normal,offset/normalSqr);
-				Geometry::PrimaryPlaneProjector<Scalar> ppp(normal);
-				Geometry::PrimaryPlaneProjector<Scalar>::Point2 hit=ppp.project(hit3);
-				bool inside=pointInFace(ppp,hit,coords,ciIt,faceEnd);
-				if(inside)
-					{
-					/* Check if the sphere is attempting to penetrate deeper into the face: */
-					if(collisionQuery.getHitLambda()>Scalar(0)&&(c0c1*normal)*offset<Scalar(0))
-						{
-						/* Prevent further movement: */
-						collisionQuery.update(Scalar(0),offset>Scalar(0)?normal:-normal);
-						}
-					}
-				else
-					{
-					/* Test the face's vertices and edges: */
-					MFInt::ValueList::const_iterator it0=faceEnd-1;
-					for(MFInt::ValueList::const_iterator it1=ciIt;it1!=faceEnd;it0=it1,++it1)
-						{
-						collisionQuery.testVertexAndUpdate(coords[*it1]);
-						collisionQuery.testEdgeAndUpdate(coords[*it0],coords[*it1]);
-						}
-					}
-				}
-			}
+			testFaceNonSolid(collisionQuery,coords,ciIt,faceEnd);
 		
 		/* Go to the next face: */
 		if(faceEnd!=coordIndices.end())
@@ -1508,8 +1550,13 @@ IndexedFaceSetNode::IndexedFaceSetNode(void)
 	:colorPerVertex(true),normalPerVertex(true),
 	 ccw(true),convex(true),solid(true),
 	 haveColors(false),bbox(Box::empty),numTriangles(0),
-	 version(0)
+	 version(0),bvh(0)
+	{
+	}
+
+IndexedFaceSetNode::~IndexedFaceSetNode(void)
 	{
+	delete bvh;
 	}
 
 const char* IndexedFaceSetNode::getClassName(void) const
@@ -1581,6 +1628,9 @@ void IndexedFaceSetNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int IndexedFaceSetNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Check if there are per-vertex colors: */
 	haveColors=color.getValue()!=0;
 	
@@ -1624,6 +1674,10 @@ unsigned int IndexedFaceSetNode::update(void)
 			}
 		}
 	
+	/* Invalidate the bounding volume hierarchy: */
+	delete bvh;
+	bvh=0;
+	
 	/* Bump up the indexed face set's version number: */
 	++version;
 	
@@ -1642,6 +1696,22 @@ void IndexedFaceSetNode::testCollision(SphereCollisionQuery& collisionQuery) con
 	if(!collisionQuery.doesHitBox(bbox))
 		return;
 	
+	/* Use a bounding volume hierarchy for large face sets: */
+	if(numTriangles>=64)
+		{
+		/* Create the bounding volume hierarchy if it does not exist yet: */
+		const MFPoint::ValueList& coords=coord.getValue()->point.getValues();
+		if(bvh==0)
+			bvh=new FaceBVH(coords,coordIndex.getValues());
+		
+		/* Traverse the bounding volume hierarchy with the appropriate per-face test for the face set's mode: */
+		FaceTestFunction testFace=solid.getValue()?(ccw.getValue()?testFaceSolidCcw:testFaceSolidCw):testFaceNonSolid;
+		FaceCollisionVisitor visitor(collisionQuery,coords,testFace);
+		bvh->traverse(coordIndex.getValues(),visitor);
+		
+		return;
+		}
+	
 	/* Call the appropriate method for the face set's mode: */
 	if(solid.getValue())
 		{
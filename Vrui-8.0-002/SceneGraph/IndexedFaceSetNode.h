@@ -33,6 +33,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/NormalNode.h>
 #include <SceneGraph/TextureCoordinateNode.h>
 
+/* Forward declarations: */
+namespace SceneGraph {
+class FaceBVH;
+}
+
 namespace SceneGraph {
 
 class IndexedFaceSetNode:public GeometryNode,public GLObject
@@ -91,6 +96,7 @@ class IndexedFaceSetNode:public GeometryNode,public GLObject
 	Box bbox; // Bounding box containing all vertices referenced by the face set
 	size_t numTriangles; // Total number of triangles defined by the indexed face set
 	unsigned int version; // Version number of face set
+	mutable FaceBVH* bvh; // Bounding volume hierarchy over the face set's faces to accelerate collision queries; created on the first collision query after an update
 	
 	/* Private methods: */
 	private:
@@ -108,6 +114,7 @@ class IndexedFaceSetNode:public GeometryNode,public GLObject
 	/* Constructors and destructors: */
 	public:
 	IndexedFaceSetNode(void); // Creates a default face set
+	virtual ~IndexedFaceSetNode(void);
 	
 	/* Methods from class Node: */
 	virtual const char* getClassName(void) const;
@@ -239,6 +239,9 @@ void IndexedLineSetNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int IndexedLineSetNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Iterate over the coordinate index array to count the number of vertices for each line and the total number of vertices: */
 	const MFInt::ValueList& coordIndices=coordIndex.getValues();
 	numVertices.clear();
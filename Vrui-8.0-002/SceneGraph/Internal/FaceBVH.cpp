@@ -0,0 +1,163 @@
+/***********************************************************************
+FaceBVH - Class for bounding volume hierarchies over the faces of
+indexed face sets to accelerate collision queries.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Simple Scene Graph Renderer (SceneGraph).
+
+The Simple Scene Graph Renderer is free software; you can redistribute
+it and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Simple Scene Graph Renderer is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Simple Scene Graph Renderer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <SceneGraph/Internal/FaceBVH.h>
+
+#include <algorithm>
+#include <Math/Math.h>
+
+namespace SceneGraph {
+
+/****************************************
+Declaration of struct FaceBVH::BuildFace:
+****************************************/
+
+struct FaceBVH::BuildFace
+	{
+	/* Elements: */
+	public:
+	size_t faceStart; // Offset of the face's first vertex index in the vertex index list
+	Box box; // Bounding box of the face
+	Point center; // Center of the face's bounding box
+	};
+
+namespace {
+
+/**************
+Helper classes:
+**************/
+
+class BuildFaceCenterComparator // Class to compare faces by the position of their centers along one axis
+	{
+	/* Elements: */
+	private:
+	int axis; // Axis along which to compare
+	
+	/* Constructors and destructors: */
+	public:
+	BuildFaceCenterComparator(int sAxis)
+		:axis(sAxis)
+		{
+		}
+	
+	/* Methods: */
+	template <class BuildFaceParam>
+	bool operator()(const BuildFaceParam& f1,const BuildFaceParam& f2) const
+		{
+		return f1.center[axis]<f2.center[axis];
+		}
+	};
+
+}
+
+/************************
+Methods of class FaceBVH:
+************************/
+
+unsigned int FaceBVH::buildSubtree(FaceBVH::BuildFace* begin,FaceBVH::BuildFace* end,unsigned int nodeIndex,unsigned int maxLeafSize)
+	{
+	/* Calculate the bounding box of all faces and of all face centers: */
+	Box box=Box::empty;
+	Box centerBox=Box::empty;
+	for(BuildFace* fPtr=begin;fPtr!=end;++fPtr)
+		{
+		box.addBox(fPtr->box);
+		centerBox.addPoint(fPtr->center);
+		}
+	nodes[nodeIndex].box=box;
+	
+	/* Find the axis along which the face centers are spread out the most: */
+	int splitAxis=0;
+	for(int i=1;i<3;++i)
+		if(centerBox.getSize(splitAxis)<centerBox.getSize(i))
+			splitAxis=i;
+	
+	/* Create a leaf node if there are few enough faces, or if the faces cannot be separated: */
+	unsigned int numFaces=(unsigned int)(end-begin);
+	if(numFaces<=maxLeafSize||centerBox.getSize(splitAxis)<=Scalar(0))
+		{
+		nodes[nodeIndex].index=(unsigned int)(faces.size());
+		nodes[nodeIndex].numFaces=numFaces;
+		for(BuildFace* fPtr=begin;fPtr!=end;++fPtr)
+			faces.push_back(fPtr->faceStart);
+		return 1;
+		}
+	
+	/* Split the faces at the median of their centers along the split axis: */
+	BuildFace* mid=begin+numFaces/2;
+	std::nth_element(begin,mid,end,BuildFaceCenterComparator(splitAxis));
+	
+	/* Create the interior node's two children: */
+	unsigned int childIndex=(unsigned int)(nodes.size());
+	nodes[nodeIndex].index=childIndex;
+	nodes[nodeIndex].numFaces=0;
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+	
+	/* Build the children's subtrees: */
+	unsigned int depth0=buildSubtree(begin,mid,childIndex,maxLeafSize);
+	unsigned int depth1=buildSubtree(mid,end,childIndex+1,maxLeafSize);
+	return Math::max(depth0,depth1)+1;
+	}
+
+FaceBVH::FaceBVH(const FaceBVH::CoordList& coords,const FaceBVH::IndexList& coordIndices,unsigned int maxLeafSize)
+	:depth(0)
+	{
+	/* Collect all faces with at least three vertices: */
+	std::vector<BuildFace> buildFaces;
+	for(IndexList::const_iterator ciIt=coordIndices.begin();ciIt!=coordIndices.end();)
+		{
+		/* Calculate the face's bounding box while finding the end of its vertex list: */
+		BuildFace bf;
+		bf.faceStart=size_t(ciIt-coordIndices.begin());
+		bf.box=Box::empty;
+		IndexList::const_iterator faceEnd;
+		for(faceEnd=ciIt;faceEnd!=coordIndices.end()&&*faceEnd>=0;++faceEnd)
+			bf.box.addPoint(coords[*faceEnd]);
+		
+		if(faceEnd-ciIt>=3)
+			{
+			/* Store the face: */
+			for(int i=0;i<3;++i)
+				bf.center[i]=Math::mid(bf.box.min[i],bf.box.max[i]);
+			buildFaces.push_back(bf);
+			}
+		
+		/* Go to the next face: */
+		if(faceEnd!=coordIndices.end())
+			++faceEnd;
+		ciIt=faceEnd;
+		}
+	
+	if(!buildFaces.empty())
+		{
+		/* Build the hierarchy recursively: */
+		if(maxLeafSize<1)
+			maxLeafSize=1;
+		nodes.reserve(((buildFaces.size()+maxLeafSize-1)/maxLeafSize)*2);
+		faces.reserve(buildFaces.size());
+		nodes.push_back(Node());
+		depth=buildSubtree(&buildFaces.front(),&buildFaces.front()+buildFaces.size(),0,maxLeafSize);
+		}
+	}
+
+}
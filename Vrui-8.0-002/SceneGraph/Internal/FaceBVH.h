@@ -0,0 +1,156 @@
+/***********************************************************************
+FaceBVH - Class for bounding volume hierarchies over the faces of
+indexed face sets to accelerate collision queries.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Simple Scene Graph Renderer (SceneGraph).
+
+The Simple Scene Graph Renderer is free software; you can redistribute
+it and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Simple Scene Graph Renderer is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Simple Scene Graph Renderer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef SCENEGRAPH_INTERNAL_FACEBVH_INCLUDED
+#define SCENEGRAPH_INTERNAL_FACEBVH_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+#include <Geometry/Box.h>
+#include <SceneGraph/Geometry.h>
+#include <SceneGraph/FieldTypes.h>
+
+namespace SceneGraph {
+
+class FaceBVH
+	{
+	/* Embedded classes: */
+	public:
+	typedef MFPoint::ValueList CoordList; // Type for lists of vertex positions
+	typedef MFInt::ValueList IndexList; // Type for lists of vertex indices, with faces separated by negative indices
+	
+	private:
+	struct Node // Structure for hierarchy nodes
+		{
+		/* Elements: */
+		public:
+		Box box; // Bounding box of all faces below the node
+		unsigned int index; // Index of first face in the face list for leaf nodes, or index of first child node for interior nodes
+		unsigned int numFaces; // Number of faces in leaf nodes; zero for interior nodes
+		};
+	
+	struct BuildFace; // Structure holding a face during hierarchy construction
+	
+	/* Elements: */
+	std::vector<Node> nodes; // List of hierarchy nodes; the root node is the first node, and an interior node's two children are adjacent
+	std::vector<size_t> faces; // Offsets of the first vertex index of each face in the vertex index list, in leaf order
+	unsigned int depth; // Maximum depth of the hierarchy
+	
+	/* Private methods: */
+	unsigned int buildSubtree(BuildFace* begin,BuildFace* end,unsigned int nodeIndex,unsigned int maxLeafSize); // Builds the subtree for the given range of faces rooted at the given node; returns the subtree's depth
+	
+	/* Constructors and destructors: */
+	public:
+	FaceBVH(const CoordList& coords,const IndexList& coordIndices,unsigned int maxLeafSize =4); // Builds a hierarchy over all faces with at least three vertices
+	
+	/* Methods: */
+	size_t getNumFaces(void) const // Returns the number of faces in the hierarchy
+		{
+		return faces.size();
+		}
+	template <class VisitorParam>
+	void traverse(const IndexList& coordIndices,VisitorParam& visitor) const; // Traverses the hierarchy in front-to-back order using the given visitor
+	};
+
+/************************
+Methods of class FaceBVH:
+************************/
+
+/**********************************************************************
+A visitor must provide two methods:
+bool intersectBox(const Box& box,Scalar& entry) returns false if the
+given box can be skipped, or stores a sort key in entry such that boxes
+with smaller keys are visited first.
+void visitFace(IndexList::const_iterator faceBegin,
+IndexList::const_iterator faceEnd) tests a single face.
+Boxes are re-tested when they are popped off the traversal stack, so
+visitors can tighten their queries while the traversal is running.
+**********************************************************************/
+
+template <class VisitorParam>
+inline
+void
+FaceBVH::traverse(
+	const FaceBVH::IndexList& coordIndices,
+	VisitorParam& visitor) const
+	{
+	/* Bail out if the hierarchy is empty: */
+	if(nodes.empty())
+		return;
+	
+	/* Traverse the hierarchy using a stack of node indices: */
+	std::vector<unsigned int> stack;
+	stack.reserve(depth+1);
+	stack.push_back(0);
+	while(!stack.empty())
+		{
+		/* Pop the next node and check it against the visitor's current query: */
+		const Node& node=nodes[stack.back()];
+		stack.pop_back();
+		Scalar entry;
+		if(!visitor.intersectBox(node.box,entry))
+			continue;
+		
+		if(node.numFaces!=0)
+			{
+			/* Visit all faces in the leaf node: */
+			std::vector<size_t>::const_iterator fEnd=faces.begin()+(node.index+node.numFaces);
+			for(std::vector<size_t>::const_iterator fIt=faces.begin()+node.index;fIt!=fEnd;++fIt)
+				{
+				/* Find the end of the face's vertex list: */
+				IndexList::const_iterator faceBegin=coordIndices.begin()+*fIt;
+				IndexList::const_iterator faceEnd;
+				for(faceEnd=faceBegin;faceEnd!=coordIndices.end()&&*faceEnd>=0;++faceEnd)
+					;
+				visitor.visitFace(faceBegin,faceEnd);
+				}
+			}
+		else
+			{
+			/* Push the node's children such that the closer child is visited first: */
+			Scalar entry0,entry1;
+			bool hit0=visitor.intersectBox(nodes[node.index].box,entry0);
+			bool hit1=visitor.intersectBox(nodes[node.index+1].box,entry1);
+			if(hit0&&hit1)
+				{
+				if(entry0<=entry1)
+					{
+					stack.push_back(node.index+1);
+					stack.push_back(node.index);
+					}
+				else
+					{
+					stack.push_back(node.index);
+					stack.push_back(node.index+1);
+					}
+				}
+			else if(hit0)
+				stack.push_back(node.index);
+			else if(hit1)
+				stack.push_back(node.index+1);
+			}
+		}
+	}
+
+}
+
+#endif
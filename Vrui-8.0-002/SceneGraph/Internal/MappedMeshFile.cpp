@@ -0,0 +1,53 @@
+/***********************************************************************
+MappedMeshFile - Helper functions to load mesh files from memory-mapped
+files using multiple threads.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Simple Scene Graph Renderer (SceneGraph).
+
+The Simple Scene Graph Renderer is free software; you can redistribute
+it and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Simple Scene Graph Renderer is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Simple Scene Graph Renderer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <SceneGraph/Internal/MappedMeshFile.h>
+
+#include <stdexcept>
+#include <Misc/FileNameExtensions.h>
+#include <IO/Directory.h>
+#include <IO/StandardDirectory.h>
+
+namespace SceneGraph {
+
+MemMappedFilePtr openMappedMeshFile(const IO::Directory& directory,const std::string& fileName)
+	{
+	MemMappedFilePtr result;
+	
+	/* Only map files that are stored uncompressed in the local file system: */
+	if(dynamic_cast<const IO::StandardDirectory*>(&directory)!=0&&!Misc::hasCaseExtension(fileName.c_str(),".gz"))
+		{
+		try
+			{
+			/* Memory-map the file: */
+			result=new IO::MemMappedFile(directory.getPath(fileName.c_str()).c_str());
+			}
+		catch(const std::runtime_error&)
+			{
+			/* Let the caller fall back to reading the file sequentially: */
+			}
+		}
+	
+	return result;
+	}
+
+}
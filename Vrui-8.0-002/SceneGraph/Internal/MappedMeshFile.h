@@ -0,0 +1,78 @@
+/***********************************************************************
+MappedMeshFile - Helper functions to load mesh files from memory-mapped
+files using multiple threads.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Simple Scene Graph Renderer (SceneGraph).
+
+The Simple Scene Graph Renderer is free software; you can redistribute
+it and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The Simple Scene Graph Renderer is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Simple Scene Graph Renderer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef SCENEGRAPH_INTERNAL_MAPPEDMESHFILE_INCLUDED
+#define SCENEGRAPH_INTERNAL_MAPPEDMESHFILE_INCLUDED
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <Misc/Autopointer.h>
+#include <Threads/Thread.h>
+#include <IO/MemMappedFile.h>
+
+/* Forward declarations: */
+namespace IO {
+class Directory;
+}
+
+namespace SceneGraph {
+
+typedef Misc::Autopointer<IO::MemMappedFile> MemMappedFilePtr; // Type for pointers to memory-mapped files
+
+MemMappedFilePtr openMappedMeshFile(const IO::Directory& directory,const std::string& fileName); // Memory-maps the mesh file of the given name if it is an uncompressed file in the local file system; returns null pointer otherwise
+
+inline size_t getNumMeshLoaderChunks(size_t numItems,size_t minChunkSize,unsigned int numThreads) // Returns the number of chunks into which to split the given number of items for parallel processing
+	{
+	/* Don't split off chunks of fewer than the given number of items: */
+	size_t result=numItems/minChunkSize;
+	if(result>size_t(numThreads))
+		result=numThreads;
+	if(result<1)
+		result=1;
+	return result;
+	}
+
+template <class WorkerParam>
+inline
+void
+runMeshLoaderWorkers(
+	std::vector<WorkerParam>& workers) // Calls the run methods of all workers in the given list in parallel, using the calling thread for the first worker
+	{
+	/* Start background threads for all but the first worker: */
+	Threads::Thread* threads=new Threads::Thread[workers.size()];
+	for(size_t i=1;i<workers.size();++i)
+		threads[i].start(&workers[i],&WorkerParam::run);
+	
+	/* Run the first worker on the calling thread: */
+	if(!workers.empty())
+		workers[0].run();
+	
+	/* Wait for all background threads to finish: */
+	for(size_t i=1;i<workers.size();++i)
+		threads[i].join();
+	delete[] threads;
+	}
+
+}
+
+#endif
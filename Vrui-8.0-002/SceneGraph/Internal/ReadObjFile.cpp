@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/Internal/ReadObjFile.h>
 
 #include <ctype.h>
+#include <string.h>
+#include <vector>
 #include <Misc/StringPrintf.h>
 #include <Misc/FileNameExtensions.h>
 #include <Misc/ThrowStdErr.h>
@@ -30,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Misc/HashTable.h>
 #include <IO/Directory.h>
 #include <IO/ValueSource.h>
+#include <IO/NumberParser.h>
 #include <Math/Math.h>
 #include <SceneGraph/TextureCoordinateNode.h>
 #include <SceneGraph/ColorNode.h>
@@ -43,12 +46,264 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/ShapeNode.h>
 #include <SceneGraph/MeshFileNode.h>
 #include <SceneGraph/Internal/OBJValueSource.h>
+#include <SceneGraph/Internal/MappedMeshFile.h>
 #include <SceneGraph/Internal/ReadMtlFile.h>
 
 namespace SceneGraph {
 
 namespace {
 
+/************************************************************
+Helper classes to parse memory-mapped OBJ files in parallel:
+************************************************************/
+
+inline bool isObjWs(char c) // Returns true if the given character is whitespace for OBJValueSource
+	{
+	return c=='\0'||(c!='\n'&&isspace((unsigned char)c));
+	}
+
+inline bool isObjPunctuation(char c) // Returns true if the given character is punctuation for OBJValueSource
+	{
+	return c=='/'||c=='#'||c=='\\'||c=='\n';
+	}
+
+inline const char* skipObjWs(const char* cPtr) // Skips whitespace up to the end of the current line
+	{
+	while(isObjWs(*cPtr))
+		++cPtr;
+	return cPtr;
+	}
+
+inline const char* readObjNumber(const char* cPtr,const char* end,Scalar& value) // Reads a number and skips whitespace like OBJValueSource::readNumber; returns null pointer on error
+	{
+	double number;
+	cPtr=IO::NumberParser::parseNumber(cPtr,end,number);
+	if(cPtr==0)
+		return 0;
+	value=Scalar(number);
+	return skipObjWs(cPtr);
+	}
+
+inline const char* readObjInteger(const char* cPtr,const char* end,int& value) // Reads an integer and skips whitespace like OBJValueSource::readInteger; returns null pointer on error
+	{
+	cPtr=IO::NumberParser::parseInteger(cPtr,end,value);
+	if(cPtr==0)
+		return 0;
+	return skipObjWs(cPtr);
+	}
+
+struct OBJFaceVertex // Structure for face vertex definitions parsed from an OBJ file
+	{
+	/* Embedded classes: */
+	public:
+	enum Flags // Enumerated type for face vertex flags
+		{
+		HasTexCoord=0x1,HasNormal=0x2,EndOfFace=0x4
+		};
+	
+	/* Elements: */
+	int coordIndex,texCoordIndex,normalIndex; // Vertex property indices as defined in the file
+	int flags; // Flags which indices were defined, or whether this is a face terminator
+	};
+
+struct OBJCommand // Structure for OBJ file commands that must be executed in order
+	{
+	/* Embedded classes: */
+	public:
+	enum Type // Enumerated type for command types
+		{
+		Faces,Group,MtlLib,UseMtl
+		};
+	
+	/* Elements: */
+	Type type; // Command type
+	size_t numTexCoords,numColors,numNormals,numCoords; // Number of vertex properties defined in the command's chunk before the command
+	size_t firstVertex,lastVertex; // Range of face vertices defining a sequence of faces
+	std::string name; // Material library or material name
+	};
+
+struct OBJChunkParser // Structure to parse a range of complete lines from an OBJ file in a background thread
+	{
+	/* Elements: */
+	public:
+	const char* begin; // Beginning of the first line in the chunk
+	const char* end; // End of the last line in the chunk, right after its line break
+	const char* fileEnd; // End of the OBJ file
+	MFTexCoord::ValueList texCoords; // Vertex properties defined in the chunk
+	MFColor::ValueList colors;
+	MFVector::ValueList normals;
+	MFPoint::ValueList coords;
+	std::vector<OBJFaceVertex> faceVertices; // Face vertices defined in the chunk
+	std::vector<OBJCommand> commands; // Commands in the chunk
+	bool ok; // Flag whether the chunk could be parsed
+	
+	/* Private methods: */
+	private:
+	void addCommand(OBJCommand::Type type) // Adds a command of the given type
+		{
+		commands.push_back(OBJCommand());
+		OBJCommand& command=commands.back();
+		command.type=type;
+		command.numTexCoords=texCoords.size();
+		command.numColors=colors.size();
+		command.numNormals=normals.size();
+		command.numCoords=coords.size();
+		command.firstVertex=command.lastVertex=faceVertices.size();
+		}
+	const char* parseFace(const char* cPtr) // Parses the vertices of a face; returns null pointer on error
+		{
+		/* Leave empty faces to the sequential parser: */
+		if(*cPtr=='\n')
+			return 0;
+		
+		/* Start a new sequence of faces if any vertex properties were defined since the last face: */
+		if(commands.empty()||commands.back().type!=OBJCommand::Faces||commands.back().numCoords!=coords.size()||commands.back().numTexCoords!=texCoords.size()||commands.back().numNormals!=normals.size()||commands.back().numColors!=colors.size())
+			addCommand(OBJCommand::Faces);
+		
+		/* Read face vertex definitions until the end of the line: */
+		while(*cPtr!='\n')
+			{
+			OBJFaceVertex fv;
+			fv.flags=0x0;
+			
+			/* Read a vertex position index: */
+			if((cPtr=readObjInteger(cPtr,fileEnd,fv.coordIndex))==0)
+				return 0;
+			
+			/* Check for a texture coordinate index: */
+			if(*cPtr=='/'&&*(++cPtr)!='/')
+				{
+				if((cPtr=readObjInteger(cPtr,fileEnd,fv.texCoordIndex))==0)
+					return 0;
+				fv.flags|=OBJFaceVertex::HasTexCoord;
+				}
+			
+			/* Check for a normal vector index: */
+			if(*cPtr=='/'&&!isObjWs(*(++cPtr)))
+				{
+				if((cPtr=readObjInteger(cPtr,fileEnd,fv.normalIndex))==0)
+					return 0;
+				fv.flags|=OBJFaceVertex::HasNormal;
+				}
+			cPtr=skipObjWs(cPtr);
+			
+			faceVertices.push_back(fv);
+			}
+		
+		/* Finish the face: */
+		OBJFaceVertex terminator;
+		terminator.flags=OBJFaceVertex::EndOfFace;
+		faceVertices.push_back(terminator);
+		commands.back().lastVertex=faceVertices.size();
+		
+		return cPtr;
+		}
+	const char* parseName(const char* cPtr,const char* tag,OBJCommand::Type type) // Parses a tag and a name following the given first tag character; returns null pointer on error
+		{
+		/* Leave tags starting with punctuation to the sequential parser: */
+		if(isObjPunctuation(*cPtr))
+			return 0;
+		
+		/* Read the rest of the tag: */
+		const char* tagBegin=cPtr;
+		while(!isObjWs(*cPtr)&&!isObjPunctuation(*cPtr))
+			++cPtr;
+		if(size_t(cPtr-tagBegin)!=strlen(tag)||memcmp(tagBegin,tag,cPtr-tagBegin)!=0)
+			return cPtr;
+		
+		/* Read the name until the end of the line and trim trailing whitespace: */
+		cPtr=skipObjWs(cPtr);
+		const char* nameEnd=static_cast<const char*>(memchr(cPtr,'\n',end-cPtr));
+		while(nameEnd!=cPtr&&isspace(nameEnd[-1]))
+			--nameEnd;
+		if(nameEnd==cPtr)
+			return 0;
+		addCommand(type);
+		commands.back().name=std::string(cPtr,nameEnd);
+		
+		return nameEnd;
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	OBJChunkParser(void)
+		:begin(0),end(0),fileEnd(0),ok(false)
+		{
+		}
+	
+	/* Methods: */
+	void* run(void)
+		{
+		const char* cPtr=begin;
+		while(cPtr!=end)
+			{
+			/* Skip whitespace at the beginning of the line and parse the next tag: */
+			cPtr=skipObjWs(cPtr);
+			if(*cPtr=='v') // It's some type of vertex property
+				{
+				++cPtr;
+				if(*cPtr=='t') // Texture coordinate
+					{
+					/* Read texture coordinate components: */
+					TexCoord tc=TexCoord::origin;
+					cPtr=skipObjWs(cPtr+1);
+					for(int i=0;i<2&&cPtr!=0&&*cPtr!='\n';++i)
+						cPtr=readObjNumber(cPtr,fileEnd,tc[i]);
+					texCoords.push_back(tc);
+					}
+				else if(*cPtr=='n') // Normal vector
+					{
+					/* Read normal vector components: */
+					Vector n=Vector::zero;
+					cPtr=skipObjWs(cPtr+1);
+					for(int i=0;i<3&&cPtr!=0&&*cPtr!='\n';++i)
+						cPtr=readObjNumber(cPtr,fileEnd,n[i]);
+					normals.push_back(n);
+					}
+				else if(*cPtr==' ') // Vertex position
+					{
+					/* Read vertex position components and optional vertex colors: */
+					Scalar vc[6];
+					vc[2]=vc[1]=vc[0]=Scalar(0);
+					int numComponents;
+					cPtr=skipObjWs(cPtr);
+					for(numComponents=0;numComponents<6&&cPtr!=0&&*cPtr!='\n';++numComponents)
+						cPtr=readObjNumber(cPtr,fileEnd,vc[numComponents]);
+					coords.push_back(Point(vc[0],vc[1],vc[2]));
+					if(numComponents==6)
+						colors.push_back(Color(vc[3],vc[4],vc[5]));
+					}
+				}
+			else if(*cPtr=='f')
+				{
+				++cPtr;
+				if(*cPtr==' ') // Face definition
+					cPtr=parseFace(skipObjWs(cPtr));
+				}
+			else if(*cPtr=='g')
+				{
+				++cPtr;
+				if(*cPtr==' ') // Group definition
+					addCommand(OBJCommand::Group);
+				}
+			else if(*cPtr=='m')
+				cPtr=parseName(cPtr+1,"tllib",OBJCommand::MtlLib);
+			else if(*cPtr=='u')
+				cPtr=parseName(cPtr+1,"semtl",OBJCommand::UseMtl);
+			
+			/* Bail out on errors: */
+			if(cPtr==0)
+				return 0;
+			
+			/* Skip the rest of the line: */
+			cPtr=static_cast<const char*>(memchr(cPtr,'\n',end-cPtr))+1;
+			}
+		
+		ok=true;
+		return 0;
+		}
+	};
+
 class OBJFileReader // Helper class to maintain state while parsing an OBJ file
 	{
 	/* Embedded classes: */
@@ -144,6 +399,110 @@ class OBJFileReader // Helper class to maintain state while parsing an OBJ file
 		currentFaceSet=0;
 		}
 	
+	void selectFaceSet(void) // Selects an existing face set compatible with the current appearance, or starts a new face set
+		{
+		/* Check whether there is already a face set node compatible with the current appearance: */
+		newFaceSet=true;
+		if(currentAppearance!=0)
+			{
+			FaceSetMap::Iterator fsIt=faceSetMap.findEntry(currentAppearance.getPointer());
+			if(!fsIt.isFinished())
+				{
+				/* Append this group's faces to the existing face set: */
+				currentFaceSet=fsIt->getDest();
+				newFaceSet=false;
+				
+				/* Check whether the existing face set uses texture coordinates and/or normal vectors: */
+				haveTexCoords=currentFaceSet->texCoord.getValue()!=0;
+				haveNormals=currentFaceSet->normal.getValue()!=0;
+				}
+			}
+		
+		if(newFaceSet)
+			{
+			/* Start a new face set: */
+			currentFaceSet=new IndexedFaceSetNode;
+			}
+		}
+	void loadMaterialLibrary(const std::string& materialLibraryFileName) // Reads a material library file unless the mesh file node defines a material library
+		{
+		/* Check if the mesh file node does not have a defined material library node: */
+		if(node.materialLibrary.getValue()==0)
+			{
+			/* Read the material library file into the temporary node: */
+			readMtlFile(directory,materialLibraryFileName,*materialLibrary,node.disableTextures.getValue());
+			}
+		}
+	void useMaterial(const std::string& materialName) // Starts using the given material from the active material library
+		{
+		/* Add the current face set to the mesh file node: */
+		storeFaceSet();
+		
+		/* Get the new material's appearance node from the active material library: */
+		if(node.materialLibrary.getValue()!=0)
+			currentAppearance=node.materialLibrary.getValue()->getMaterial(materialName);
+		else
+			currentAppearance=materialLibrary->getMaterial(materialName);
+		}
+	template <class ValueListParam>
+	static void appendChunkValues(ValueListParam& values,size_t base,const ValueListParam& chunkValues,size_t numChunkValues) // Appends values parsed from a chunk, where the chunk's first value has the given index, up to the given number of chunk values
+		{
+		values.insert(values.end(),chunkValues.begin()+(values.size()-base),chunkValues.begin()+numChunkValues);
+		}
+	void appendChunkVertices(const OBJChunkParser& chunk,const size_t bases[4],size_t chunkNumTexCoords,size_t chunkNumColors,size_t chunkNumNormals,size_t chunkNumCoords) // Appends vertex properties parsed from a chunk up to the given numbers of chunk vertex properties
+		{
+		appendChunkValues(texCoords,bases[0],chunk.texCoords,chunkNumTexCoords);
+		numTexCoords=int(texCoords.size());
+		appendChunkValues(colors,bases[1],chunk.colors,chunkNumColors);
+		numColors=int(colors.size());
+		appendChunkValues(normals,bases[2],chunk.normals,chunkNumNormals);
+		numNormals=int(normals.size());
+		appendChunkValues(coords,bases[3],chunk.coords,chunkNumCoords);
+		numCoords=int(coords.size());
+		}
+	void appendChunkFaces(const OBJChunkParser& chunk,const OBJCommand& command) // Appends a sequence of faces parsed from a chunk to the current face set
+		{
+		for(size_t i=command.firstVertex;i<command.lastVertex;++i)
+			{
+			const OBJFaceVertex& fv=chunk.faceVertices[i];
+			if(fv.flags&OBJFaceVertex::EndOfFace)
+				{
+				/* Finish the face: */
+				if(haveTexCoords)
+					currentFaceSet->texCoordIndex.appendValue(-1);
+				if(haveNormals)
+					currentFaceSet->normalIndex.appendValue(-1);
+				currentFaceSet->coordIndex.appendValue(-1);
+				continue;
+				}
+			
+			/* Check whether this is the first face in a new face set: */
+			if(currentFaceSet==0)
+				{
+				/* Continue a compatible face set or start a new one: */
+				selectFaceSet();
+				
+				if(newFaceSet)
+					{
+					/* Use the first vertex of the first face to determine whether the new face set will have texture coordinates and/or normal vectors: */
+					haveTexCoords=(fv.flags&OBJFaceVertex::HasTexCoord)!=0;
+					haveNormals=(fv.flags&OBJFaceVertex::HasNormal)!=0;
+					}
+				}
+			
+			/* Store the vertex position index and the most recent texture coordinate and/or normal vector indices if the face set requires them: */
+			currentFaceSet->coordIndex.appendValue(fv.coordIndex>0?fv.coordIndex-1:numCoords+fv.coordIndex); // Negative indices count back from most recent
+			if(fv.flags&OBJFaceVertex::HasTexCoord)
+				lastTexCoordIndex=fv.texCoordIndex>0?fv.texCoordIndex-1:numTexCoords+fv.texCoordIndex;
+			if(fv.flags&OBJFaceVertex::HasNormal)
+				lastNormalIndex=fv.normalIndex>0?fv.normalIndex-1:numNormals+fv.normalIndex;
+			if(haveTexCoords)
+				currentFaceSet->texCoordIndex.appendValue(lastTexCoordIndex);
+			if(haveNormals)
+				currentFaceSet->normalIndex.appendValue(lastNormalIndex);
+			}
+		}
+	
 	/* Constructors and destructors: */
 	public:
 	OBJFileReader(IO::Directory& sDirectory,const std::string& fileName,MeshFileNode& sNode)
@@ -232,28 +591,11 @@ class OBJFileReader // Helper class to maintain state while parsing an OBJ file
 					/* Check whether this is the first face in a new face set: */
 					if(currentFaceSet==0)
 						{
-						/* Check whether there is already a face set node compatible with the current appearance: */
-						newFaceSet=true;
-						if(currentAppearance!=0)
-							{
-							FaceSetMap::Iterator fsIt=faceSetMap.findEntry(currentAppearance.getPointer());
-							if(!fsIt.isFinished())
-								{
-								/* Append this group's faces to the existing face set: */
-								currentFaceSet=fsIt->getDest();
-								newFaceSet=false;
-								
-								/* Check whether the existing face set uses texture coordinates and/or normal vectors: */
-								haveTexCoords=currentFaceSet->texCoord.getValue()!=0;
-								haveNormals=currentFaceSet->normal.getValue()!=0;
-								}
-							}
+						/* Continue a compatible face set or start a new one: */
+						selectFaceSet();
 						
 						if(newFaceSet)
 							{
-							/* Start a new face set: */
-							currentFaceSet=new IndexedFaceSetNode;
-							
 							/***********************************************************
 							Read the first vertex of the first face to determine whether
 							the new face set will have texture coordinates and/or normal
@@ -343,15 +685,8 @@ class OBJFileReader // Helper class to maintain state while parsing an OBJ file
 				std::string tag=objFile.readString();
 				if(tag=="tllib") // Material library file name
 					{
-					/* Read the material library file name: */
-					std::string materialLibraryFileName=objFile.readLine();
-					
-					/* Check if the mesh file node does not have a defined material library node: */
-					if(node.materialLibrary.getValue()==0)
-						{
-						/* Read the material library file into the temporary node: */
-						readMtlFile(directory,materialLibraryFileName,*materialLibrary,node.disableTextures.getValue());
-						}
+					/* Read the material library file name and the material library: */
+					loadMaterialLibrary(objFile.readLine());
 					}
 				}
 			else if(objFile.peekc()=='u')
@@ -362,15 +697,8 @@ class OBJFileReader // Helper class to maintain state while parsing an OBJ file
 				std::string tag=objFile.readString();
 				if(tag=="semtl") // Use named material from the material library
 					{
-					/* Add the current face set to the mesh file node: */
-					storeFaceSet();
-					
-					/* Read the name of the new material and get its appearance node from the active material library: */
-					std::string materialName=objFile.readLine();
-					if(node.materialLibrary.getValue()!=0)
-						currentAppearance=node.materialLibrary.getValue()->getMaterial(materialName);
-					else
-						currentAppearance=materialLibrary->getMaterial(materialName);
+					/* Read the name of the new material and start using it: */
+					useMaterial(objFile.readLine());
 					}
 				}
 			
@@ -381,6 +709,81 @@ class OBJFileReader // Helper class to maintain state while parsing an OBJ file
 		/* Add the current face set to the mesh file node: */
 		storeFaceSet();
 		}
+	bool parseParallel(const char* fileBegin,const char* fileEnd,unsigned int numThreads) // Parses the memory-mapped OBJ file of the given extents in parallel and creates shapes; returns false without creating any shapes if the file must be parsed sequentially instead
+		{
+		/* Leave empty files, files with line continuations, and files not ending in a line break to the sequential parser: */
+		if(fileBegin==fileEnd||fileEnd[-1]!='\n'||memchr(fileBegin,'\\',fileEnd-fileBegin)!=0)
+			return false;
+		
+		/* Split the file into chunks of complete lines: */
+		size_t fileSize=fileEnd-fileBegin;
+		size_t numChunks=getNumMeshLoaderChunks(fileSize,65536,numThreads);
+		std::vector<OBJChunkParser> chunks(numChunks);
+		const char* chunkBegin=fileBegin;
+		for(size_t i=0;i<numChunks;++i)
+			{
+			const char* chunkEnd=fileEnd;
+			if(i<numChunks-1)
+				{
+				/* Move the chunk end to the end of the line containing the chunk's nominal end: */
+				chunkEnd=fileBegin+(fileSize*(i+1))/numChunks;
+				if(chunkEnd<chunkBegin)
+					chunkEnd=chunkBegin;
+				if(chunkEnd!=fileEnd)
+					chunkEnd=static_cast<const char*>(memchr(chunkEnd,'\n',fileEnd-chunkEnd))+1;
+				}
+			chunks[i].begin=chunkBegin;
+			chunks[i].end=chunkEnd;
+			chunks[i].fileEnd=fileEnd;
+			chunkBegin=chunkEnd;
+			}
+		
+		/* Parse all chunks in parallel: */
+		runMeshLoaderWorkers(chunks);
+		for(size_t i=0;i<numChunks;++i)
+			if(!chunks[i].ok)
+				return false;
+		
+		/* Execute the commands from all chunks in order: */
+		for(std::vector<OBJChunkParser>::iterator cIt=chunks.begin();cIt!=chunks.end();++cIt)
+			{
+			/* Remember the numbers of vertex properties defined before the chunk: */
+			size_t bases[4]={texCoords.size(),colors.size(),normals.size(),coords.size()};
+			
+			for(std::vector<OBJCommand>::const_iterator comIt=cIt->commands.begin();comIt!=cIt->commands.end();++comIt)
+				{
+				/* Append the vertex properties defined before the command: */
+				appendChunkVertices(*cIt,bases,comIt->numTexCoords,comIt->numColors,comIt->numNormals,comIt->numCoords);
+				
+				switch(comIt->type)
+					{
+					case OBJCommand::Faces:
+						appendChunkFaces(*cIt,*comIt);
+						break;
+					
+					case OBJCommand::Group:
+						storeFaceSet();
+						break;
+					
+					case OBJCommand::MtlLib:
+						loadMaterialLibrary(comIt->name);
+						break;
+					
+					case OBJCommand::UseMtl:
+						useMaterial(comIt->name);
+						break;
+					}
+				}
+			
+			/* Append the remaining vertex properties defined in the chunk: */
+			appendChunkVertices(*cIt,bases,cIt->texCoords.size(),cIt->colors.size(),cIt->normals.size(),cIt->coords.size());
+			}
+		
+		/* Add the current face set to the mesh file node: */
+		storeFaceSet();
+		
+		return true;
+		}
 	};
 
 }
@@ -396,8 +799,21 @@ void readObjFile(const IO::Directory& directory,const std::string& fileName,Mesh
 	/* Create a reader for the OBJ file: */
 	OBJFileReader objFileReader(*objDirectory,objFileName,node);
 	
-	/* Parse the OBJ file: */
-	objFileReader.parse();
+	/* Try parsing the OBJ file in parallel if requested: */
+	bool parsed=false;
+	if(node.numLoaderThreads.getValue()>1)
+		{
+		MemMappedFilePtr mappedFile=openMappedMeshFile(*objDirectory,objFileName);
+		if(mappedFile!=0)
+			{
+			const char* fileBegin=static_cast<const char*>(mappedFile->getMemory());
+			parsed=objFileReader.parseParallel(fileBegin,fileBegin+mappedFile->getSize(),(unsigned int)(node.numLoaderThreads.getValue()));
+			}
+		}
+	
+	/* Parse the OBJ file sequentially: */
+	if(!parsed)
+		objFileReader.parse();
 	}
 
 }
@@ -22,12 +22,19 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <SceneGraph/Internal/ReadPlyFile.h>
 
+#include <ctype.h>
+#include <string.h>
 #include <stdexcept>
+#include <vector>
+#include <Misc/SizedTypes.h>
+#include <Misc/Endianness.h>
 #include <Misc/Autopointer.h>
 #include <Misc/ThrowStdErr.h>
 #include <IO/File.h>
+#include <IO/SeekableFile.h>
 #include <IO/Directory.h>
 #include <IO/ValueSource.h>
+#include <IO/NumberParser.h>
 #include <SceneGraph/ColorNode.h>
 #include <SceneGraph/NormalNode.h>
 #include <SceneGraph/CoordinateNode.h>
@@ -36,6 +43,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/ShapeNode.h>
 #include <SceneGraph/MeshFileNode.h>
 #include <SceneGraph/Internal/PlyFileStructures.h>
+#include <SceneGraph/Internal/MappedMeshFile.h>
 
 namespace SceneGraph {
 
@@ -45,6 +53,138 @@ namespace {
 Helper functions:
 ****************/
 
+struct PLYVertexLayout // Structure describing which vertex element properties define vertex colors, normal vectors, and positions
+	{
+	/* Elements: */
+	public:
+	unsigned int colorIndex[3]; // Property indices of red, green, and blue color components
+	int colorMask; // Bit mask of found color components
+	bool colorIsUInt; // Flag if color components are stored as unsigned integers
+	Color::Scalar colorScale; // Scale factor from unsigned integer color components to [0, 1]
+	unsigned int normalIndex[3]; // Property indices of normal vector components
+	int normalMask; // Bit mask of found normal vector components
+	unsigned int coordIndex[3]; // Property indices of position components
+	int coordMask; // Bit mask of found position components
+	
+	/* Constructors and destructors: */
+	PLYVertexLayout(const PLYElement& element); // Extracts the vertex layout from the given vertex element
+	};
+
+PLYVertexLayout::PLYVertexLayout(const PLYElement& element)
+	:colorMask(0x0),colorIsUInt(false),colorScale(1),
+	 normalMask(0x0),
+	 coordMask(0x0)
+	{
+	/* Get the indices of all supported vertex properties: */
+	const char* colorNames[3]={"red","green","blue"};
+	const char* normalNames[3]={"nx","ny","nz"};
+	const char* coordNames[3]={"x","y","z"};
+	unsigned int propertyIndex=0;
+	for(PLYElement::PropertyList::const_iterator pIt=element.propertiesBegin();pIt!=element.propertiesEnd();++pIt,++propertyIndex)
+		if(pIt->getPropertyType()==PLYProperty::SCALAR)
+			{
+			/* Check for any of the supported properties: */
+			for(int i=0;i<3;++i)
+				if(pIt->getName()==colorNames[i])
+					{
+					colorIndex[i]=propertyIndex;
+					colorMask|=0x1<<i;
+					if(colorMask==0x7)
+						{
+						/* Determine the color component scalar type: */
+						switch(pIt->getScalarType())
+							{
+							case PLY_UINT8:
+								colorIsUInt=true;
+								colorScale=Color::Scalar(1)/Color::Scalar(255);
+								break;
+							
+							case PLY_UINT16:
+								colorIsUInt=true;
+								colorScale=Color::Scalar(1)/Color::Scalar(65535);
+								break;
+							
+							case PLY_FLOAT32:
+							case PLY_FLOAT64:
+								colorIsUInt=false;
+								break;
+							
+							default:
+								/* Ignore color values due to unsupported scalar type: */
+								colorMask=0x0;
+							}
+						}
+					}
+			for(int i=0;i<3;++i)
+				if(pIt->getName()==normalNames[i])
+					{
+					normalIndex[i]=propertyIndex;
+					normalMask|=0x1<<i;
+					}
+			for(int i=0;i<3;++i)
+				if(pIt->getName()==coordNames[i])
+					{
+					coordIndex[i]=propertyIndex;
+					coordMask|=0x1<<i;
+					}
+			}
+	}
+
+void addPlyShape(ColorNodePointer color,NormalNodePointer normal,CoordinateNodePointer coord,Misc::Autopointer<IndexedFaceSetNode> faceSet,MeshFileNode& node) // Adds a shape node for the given property and geometry nodes to the given mesh file node
+	{
+	/* Check if the PLY file defined vertex coordinates: */
+	if(coord!=0)
+		{
+		/* Create a new shape node: */
+		ShapeNodePointer shape=new ShapeNode;
+		
+		/* Set the shape node's appearance to the mesh file node's appearance: */
+		shape->appearance.setValue(node.appearance.getValue());
+		
+		/* Check if the PLY file defined faces: */
+		if(faceSet!=0)
+			{
+			/* Attach the property nodes to the face set node: */
+			faceSet->color.setValue(color);
+			faceSet->normal.setValue(normal);
+			faceSet->coord.setValue(coord);
+			
+			/* Set up face set parameters: */
+			faceSet->colorPerVertex.setValue(true);
+			faceSet->normalPerVertex.setValue(true);
+			
+			/* Copy face set parameters from the mesh file node: */
+			faceSet->ccw.setValue(node.ccw.getValue());
+			faceSet->solid.setValue(node.solid.getValue());
+			faceSet->creaseAngle.setValue(node.creaseAngle.getValue());
+			
+			/* Finalize the face set and set it as the shape's geometry node: */
+			faceSet->update();
+			shape->geometry.setValue(faceSet);
+			}
+		else
+			{
+			/* Create a point set node to render the vertices read from the PLY file: */
+			Misc::Autopointer<PointSetNode> pointSet=new PointSetNode;
+			
+			/* Attach the property nodes to the point set node: */
+			pointSet->color.setValue(color);
+			pointSet->coord.setValue(coord);
+			
+			/* Copy point set parameters from the mesh file node: */
+			pointSet->pointSize.setValue(node.pointSize.getValue());
+			
+			/* Finalize the point set and set it as the shape's geometry node: */
+			pointSet->update();
+			shape->geometry.setValue(pointSet);
+			}
+		
+		/* Finalize the shape node and add it to the mesh file node's shape list: */
+		shape->update();
+		node.addShape(*shape);
+		}
+	}
+
 template <class PLYFileParam>
 void readPlyFileElements(const PLYFileHeader& header,PLYFileParam& ply,MeshFileNode& node)
 	{
@@ -64,66 +204,15 @@ void readPlyFileElements(const PLYFileHeader& header,PLYFileParam& ply,MeshFileN
 		if(element.isElement("vertex")&&element.getNumValues()>0)
 			{
 			/* Get the indices of all supported vertex properties: */
-			const char* colorNames[3]={"red","green","blue"};
-			unsigned int colorIndex[3];
-			int colorMask=0x0;
-			bool colorIsUInt=false;
-			Color::Scalar colorScale(1);
-			const char* normalNames[3]={"nx","ny","nz"};
-			unsigned int normalIndex[3];
-			int normalMask=0x0;
-			const char* coordNames[3]={"x","y","z"};
-			unsigned int coordIndex[3];
-			int coordMask=0x0;
-			unsigned int propertyIndex=0;
-			for(PLYElement::PropertyList::const_iterator pIt=element.propertiesBegin();pIt!=element.propertiesEnd();++pIt,++propertyIndex)
-				if(pIt->getPropertyType()==PLYProperty::SCALAR)
-					{
-					/* Check for any of the supported properties: */
-					for(int i=0;i<3;++i)
-						if(pIt->getName()==colorNames[i])
-							{
-							colorIndex[i]=propertyIndex;
-							colorMask|=0x1<<i;
-							if(colorMask==0x7)
-								{
-								/* Determine the color component scalar type: */
-								switch(pIt->getScalarType())
-									{
-									case PLY_UINT8:
-										colorIsUInt=true;
-										colorScale=Color::Scalar(1)/Color::Scalar(255);
-										break;
-									
-									case PLY_UINT16:
-										colorIsUInt=true;
-										colorScale=Color::Scalar(1)/Color::Scalar(65535);
-										break;
-									
-									case PLY_FLOAT32:
-									case PLY_FLOAT64:
-										colorIsUInt=false;
-										break;
-									
-									default:
-										/* Ignore color values due to unsupported scalar type: */
-										colorMask=0x0;
-									}
-								}
-							}
-					for(int i=0;i<3;++i)
-						if(pIt->getName()==normalNames[i])
-							{
-							normalIndex[i]=propertyIndex;
-							normalMask|=0x1<<i;
-							}
-					for(int i=0;i<3;++i)
-						if(pIt->getName()==coordNames[i])
-							{
-							coordIndex[i]=propertyIndex;
-							coordMask|=0x1<<i;
-							}
-					}
+			PLYVertexLayout layout(element);
+			const unsigned int* colorIndex=layout.colorIndex;
+			int colorMask=layout.colorMask;
+			bool colorIsUInt=layout.colorIsUInt;
+			Color::Scalar colorScale=layout.colorScale;
+			const unsigned int* normalIndex=layout.normalIndex;
+			int normalMask=layout.normalMask;
+			const unsigned int* coordIndex=layout.coordIndex;
+			int coordMask=layout.coordMask;
 			
 			/* Check that the PLY file at least defines vertex positions: */
 			if(coordMask!=0x7)
@@ -353,56 +442,528 @@ void readPlyFileElements(const PLYFileHeader& header,PLYFileParam& ply,MeshFileN
 			}
 		}
 	
-	/* Check if the PLY file defined vertex coordinates: */
-	if(coord!=0)
+	/* Create a shape node from the property and geometry nodes: */
+	addPlyShape(color,normal,coord,faceSet,node);
+	}
+
+/***********************************************************
+Helper classes to read memory-mapped PLY files in parallel:
+***********************************************************/
+
+class PLYMappedValue // Class for scalar values read from memory-mapped PLY files, converting like PLYDataValue
+	{
+	/* Embedded classes: */
+	public:
+	enum MemoryType // Enumerated type for in-memory representations of PLY data types
 		{
-		/* Create a new shape node: */
-		ShapeNodePointer shape=new ShapeNode;
-		
-		/* Set the shape node's appearance to the mesh file node's appearance: */
-		shape->appearance.setValue(node.appearance.getValue());
-		
-		/* Check if the PLY file defined faces: */
-		if(faceSet!=0)
+		INT,UINT,DOUBLE
+		};
+	
+	/* Elements: */
+	MemoryType memoryType; // Memory type of the current value
+	union
+		{
+		int i;
+		unsigned int ui;
+		double d;
+		} value; // The current value
+	
+	/* Methods: */
+	static MemoryType getMemoryType(PLYDataType dataType) // Returns the memory type used for the given data type
+		{
+		switch(dataType)
 			{
-			/* Attach the property nodes to the face set node: */
-			faceSet->color.setValue(color);
-			faceSet->normal.setValue(normal);
-			faceSet->coord.setValue(coord);
+			case PLY_SINT8:
+			case PLY_SINT16:
+			case PLY_SINT32:
+				return INT;
 			
-			/* Set up face set parameters: */
-			faceSet->colorPerVertex.setValue(true);
-			faceSet->normalPerVertex.setValue(true);
+			case PLY_UINT8:
+			case PLY_UINT16:
+			case PLY_UINT32:
+				return UINT;
 			
-			/* Copy face set parameters from the mesh file node: */
-			faceSet->ccw.setValue(node.ccw.getValue());
-			faceSet->solid.setValue(node.solid.getValue());
-			faceSet->creaseAngle.setValue(node.creaseAngle.getValue());
+			default:
+				return DOUBLE;
+			}
+		}
+	unsigned int getUnsignedInt(void) const
+		{
+		switch(memoryType)
+			{
+			case INT:
+				return (unsigned int)(value.i);
 			
-			/* Finalize the face set and set it as the shape's geometry node: */
-			faceSet->update();
-			shape->geometry.setValue(faceSet);
+			case UINT:
+				return value.ui;
+			
+			default:
+				return (unsigned int)(value.d);
+			}
+		}
+	double getDouble(void) const
+		{
+		switch(memoryType)
+			{
+			case INT:
+				return double(value.i);
+			
+			case UINT:
+				return double(value.ui);
+			
+			default:
+				return value.d;
+			}
+		}
+	};
+
+size_t getFileSize(PLYDataType dataType) // Returns the size of a value of the given data type in binary PLY files
+	{
+	static const size_t fileSizes[]={1,1,2,2,4,4,4,8};
+	return fileSizes[dataType];
+	}
+
+class PLYBinaryReader // Class to read values from a memory-mapped binary PLY file
+	{
+	/* Elements: */
+	public:
+	const char* ptr; // Current read position
+	const char* end; // End of the file
+	bool swapEndianness; // Flag whether multi-byte values must be endianness-swapped
+	
+	/* Private methods: */
+	private:
+	template <class FileTypeParam>
+	FileTypeParam readRaw(void) // Reads a raw value of the given file type; assumes that the value is entirely inside the file
+		{
+		FileTypeParam result;
+		memcpy(&result,ptr,sizeof(FileTypeParam));
+		ptr+=sizeof(FileTypeParam);
+		if(swapEndianness)
+			Misc::swapEndianness(result);
+		return result;
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	PLYBinaryReader(const char* sPtr,const char* sEnd,bool sSwapEndianness)
+		:ptr(sPtr),end(sEnd),swapEndianness(sSwapEndianness)
+		{
+		}
+	
+	/* Methods: */
+	bool read(PLYDataType dataType,PLYMappedValue& value) // Reads a value of the given data type; returns false on error
+		{
+		if(size_t(end-ptr)<getFileSize(dataType))
+			return false;
+		value.memoryType=PLYMappedValue::getMemoryType(dataType);
+		switch(dataType)
+			{
+			case PLY_SINT8:
+				value.value.i=int(readRaw<Misc::SInt8>());
+				break;
+			
+			case PLY_UINT8:
+				value.value.ui=(unsigned int)(readRaw<Misc::UInt8>());
+				break;
+			
+			case PLY_SINT16:
+				value.value.i=int(readRaw<Misc::SInt16>());
+				break;
+			
+			case PLY_UINT16:
+				value.value.ui=(unsigned int)(readRaw<Misc::UInt16>());
+				break;
+			
+			case PLY_SINT32:
+				value.value.i=int(readRaw<Misc::SInt32>());
+				break;
+			
+			case PLY_UINT32:
+				value.value.ui=(unsigned int)(readRaw<Misc::UInt32>());
+				break;
+			
+			case PLY_FLOAT32:
+				value.value.d=double(readRaw<Misc::Float32>());
+				break;
+			
+			case PLY_FLOAT64:
+				value.value.d=double(readRaw<Misc::Float64>());
+				break;
+			}
+		return true;
+		}
+	bool finishValue(void) // Finishes reading an element value
+		{
+		return true;
+		}
+	bool skipValues(const PLYElement& element,size_t numValues) // Skips the given number of values of the given element
+		{
+		if(!element.hasListProperty())
+			{
+			/* Skip all values at once: */
+			size_t valueSize=0;
+			for(PLYElement::PropertyList::const_iterator pIt=element.propertiesBegin();pIt!=element.propertiesEnd();++pIt)
+				valueSize+=getFileSize(pIt->getScalarType());
+			if(valueSize!=0&&size_t(end-ptr)/valueSize<numValues)
+				return false;
+			ptr+=valueSize*numValues;
 			}
 		else
 			{
-			/* Create a point set node to render the vertices read from the PLY file: */
-			Misc::Autopointer<PointSetNode> pointSet=new PointSetNode;
+			/* Skip each value separately: */
+			for(size_t i=0;i<numValues;++i)
+				for(PLYElement::PropertyList::const_iterator pIt=element.propertiesBegin();pIt!=element.propertiesEnd();++pIt)
+					{
+					size_t skipSize;
+					if(pIt->getPropertyType()==PLYProperty::SCALAR)
+						skipSize=getFileSize(pIt->getScalarType());
+					else
+						{
+						PLYMappedValue listSize;
+						if(!read(pIt->getListSizeType(),listSize))
+							return false;
+						skipSize=getFileSize(pIt->getListElementType())*size_t(listSize.getUnsignedInt());
+						}
+					if(size_t(end-ptr)<skipSize)
+						return false;
+					ptr+=skipSize;
+					}
+			}
+		return true;
+		}
+	bool skipElement(const PLYElement& element) // Skips all values of the given element like skipElement(const PLYElement&,IO::File&)
+		{
+		return skipValues(element,element.getNumValues());
+		}
+	};
+
+class PLYAsciiReader // Class to read values from a memory-mapped ASCII PLY file that stores each element value on its own line
+	{
+	/* Elements: */
+	public:
+	const char* ptr; // Current read position
+	const char* end; // End of the file
+	
+	/* Private methods: */
+	private:
+	static bool isWhitespace(char c) // Returns true if the given character is whitespace for IO::ValueSource
+		{
+		return c=='\0'||isspace((unsigned char)c);
+		}
+	void skipWs(void) // Skips whitespace including line breaks
+		{
+		while(ptr!=end&&isWhitespace(*ptr))
+			++ptr;
+		}
+	void skipLine(void) // Skips the rest of the current line including the line break
+		{
+		const char* lineEnd=static_cast<const char*>(memchr(ptr,'\n',end-ptr));
+		ptr=lineEnd!=0?lineEnd+1:end;
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	PLYAsciiReader(const char* sPtr,const char* sEnd)
+		:ptr(sPtr),end(sEnd)
+		{
+		}
+	
+	/* Methods: */
+	bool read(PLYDataType dataType,PLYMappedValue& value) // Reads a value of the given data type; returns false on error or if the value is not followed by whitespace
+		{
+		/* Parse the value according to its memory type like IO::ValueSource: */
+		value.memoryType=PLYMappedValue::getMemoryType(dataType);
+		const char* valueEnd;
+		switch(value.memoryType)
+			{
+			case PLYMappedValue::INT:
+				valueEnd=IO::NumberParser::parseInteger(ptr,end,value.value.i);
+				break;
 			
-			/* Attach the property nodes to the point set node: */
-			pointSet->color.setValue(color);
-			pointSet->coord.setValue(coord);
+			case PLYMappedValue::UINT:
+				valueEnd=IO::NumberParser::parseUnsignedInteger(ptr,end,value.value.ui);
+				break;
 			
-			/* Copy point set parameters from the mesh file node: */
-			pointSet->pointSize.setValue(node.pointSize.getValue());
+			default:
+				valueEnd=IO::NumberParser::parseNumber(ptr,end,value.value.d);
+			}
+		if(valueEnd==0||!isWhitespace(*valueEnd))
+			return false;
+		
+		/* Skip whitespace up to the end of the line: */
+		for(ptr=valueEnd;ptr!=end&&*ptr!='\n'&&isWhitespace(*ptr);++ptr)
+			;
+		return true;
+		}
+	bool finishValue(void) // Finishes reading an element value; returns false if the value did not end at a line break
+		{
+		if(ptr==end||*ptr!='\n')
+			return false;
+		skipWs();
+		return true;
+		}
+	bool skipValues(const PLYElement& element,size_t numValues) // Skips the given number of values of the given element
+		{
+		for(size_t i=0;i<numValues;++i)
+			{
+			if(ptr==end)
+				return false;
+			skipLine();
+			skipWs();
+			}
+		return true;
+		}
+	bool skipElement(const PLYElement& element) // Skips all values of the given element like skipElement(const PLYElement&,IO::ValueSource&)
+		{
+		for(size_t i=0;i<element.getNumValues();++i)
+			skipLine();
+		skipWs();
+		return true;
+		}
+	};
+
+template <class PLYReaderParam>
+inline bool readPlyValue(PLYReaderParam& reader,const PLYElement& element,PLYMappedValue* scalars,unsigned int indexListIndex,std::vector<int>& indices) // Reads one element value; stores scalar properties in the given array and the elements of the given list property in the given index list
+	{
+	unsigned int propertyIndex=0;
+	for(PLYElement::PropertyList::const_iterator pIt=element.propertiesBegin();pIt!=element.propertiesEnd();++pIt,++propertyIndex)
+		{
+		if(pIt->getPropertyType()==PLYProperty::SCALAR)
+			{
+			if(!reader.read(pIt->getScalarType(),scalars[propertyIndex]))
+				return false;
+			}
+		else
+			{
+			/* Read the list size and all list elements: */
+			PLYMappedValue listSize;
+			if(!reader.read(pIt->getListSizeType(),listSize))
+				return false;
+			unsigned int numListElements=listSize.getUnsignedInt();
+			PLYMappedValue listElement;
+			for(unsigned int i=0;i<numListElements;++i)
+				{
+				if(!reader.read(pIt->getListElementType(),listElement))
+					return false;
+				if(propertyIndex==indexListIndex)
+					indices.push_back(int(listElement.getUnsignedInt()));
+				}
+			if(propertyIndex==indexListIndex)
+				indices.push_back(-1);
+			}
+		}
+	
+	return reader.finishValue();
+	}
+
+template <class PLYReaderParam>
+struct PLYChunkWorker // Structure to read a contiguous range of element values in a background thread
+	{
+	/* Elements: */
+	public:
+	const PLYElement* element; // The element whose values to read
+	const PLYVertexLayout* layout; // Vertex layout if the element is the vertex element
+	unsigned int indexListIndex; // Index of the vertex_indices property if the element is the face element
+	PLYReaderParam reader; // Reader positioned at the first value of the chunk
+	const char* chunkEnd; // Position at which the last value of the chunk must end
+	size_t firstValue,numValues; // Range of element values in the chunk
+	Color* colors; // Array of vertex colors or null
+	Vector* normals; // Array of vertex normal vectors or null
+	Point* coords; // Array of vertex positions or null
+	std::vector<int> indices; // List of face vertex indices read from the chunk
+	bool ok; // Flag whether the chunk was read successfully
+	
+	/* Constructors and destructors: */
+	PLYChunkWorker(const PLYReaderParam& sReader)
+		:element(0),layout(0),indexListIndex(~0U),reader(sReader),chunkEnd(0),
+		 firstValue(0),numValues(0),colors(0),normals(0),coords(0),
+		 ok(false)
+		{
+		}
+	
+	/* Methods: */
+	void* run(void)
+		{
+		std::vector<PLYMappedValue> scalars(element->getNumProperties()+1);
+		size_t i;
+		for(i=0;i<numValues&&readPlyValue(reader,*element,&scalars[0],indexListIndex,indices);++i)
+			{
+			if(layout==0)
+				continue;
 			
-			/* Finalize the point set and set it as the shape's geometry node: */
-			pointSet->update();
-			shape->geometry.setValue(pointSet);
+			/* Extract vertex color, normal vector, and position: */
+			size_t vi=firstValue+i;
+			if(colors!=0)
+				{
+				for(int j=0;j<3;++j)
+					{
+					const PLYMappedValue& c=scalars[layout->colorIndex[j]];
+					colors[vi][j]=layout->colorIsUInt?Color::Scalar(c.getUnsignedInt())*layout->colorScale:Color::Scalar(c.getDouble());
+					}
+				}
+			if(normals!=0)
+				for(int j=0;j<3;++j)
+					normals[vi][j]=Scalar(scalars[layout->normalIndex[j]].getDouble());
+			for(int j=0;j<3;++j)
+				coords[vi][j]=Scalar(scalars[layout->coordIndex[j]].getDouble());
 			}
 		
-		/* Finalize the shape node and add it to the mesh file node's shape list: */
-		shape->update();
-		node.addShape(*shape);
+		/* Check that all values were read and that the chunk ended where expected: */
+		ok=i==numValues&&reader.ptr==chunkEnd;
+		
+		return 0;
+		}
+	};
+
+template <class PLYReaderParam>
+bool readPlyElementParallel(PLYReaderParam& reader,const PLYElement& element,const PLYVertexLayout* layout,unsigned int indexListIndex,unsigned int numThreads,Color* colors,Vector* normals,Point* coords,std::vector<int>* indices) // Reads all values of the given element in parallel; returns false on error
+	{
+	/* Find the beginning of each chunk of element values: */
+	size_t numChunks=getNumMeshLoaderChunks(element.getNumValues(),4096,numThreads);
+	std::vector<PLYChunkWorker<PLYReaderParam> > workers;
+	workers.reserve(numChunks);
+	for(size_t chunk=0;chunk<numChunks;++chunk)
+		{
+		workers.push_back(PLYChunkWorker<PLYReaderParam>(reader));
+		PLYChunkWorker<PLYReaderParam>& w=workers.back();
+		w.element=&element;
+		w.layout=layout;
+		w.indexListIndex=indexListIndex;
+		w.firstValue=(element.getNumValues()*chunk)/numChunks;
+		w.numValues=(element.getNumValues()*(chunk+1))/numChunks-w.firstValue;
+		w.colors=colors;
+		w.normals=normals;
+		w.coords=coords;
+		if(!reader.skipValues(element,w.numValues))
+			return false;
+		w.chunkEnd=reader.ptr;
+		}
+	
+	/* Read all chunks in parallel: */
+	runMeshLoaderWorkers(workers);
+	
+	/* Check for errors and collect face vertex indices: */
+	size_t numIndices=0;
+	for(size_t chunk=0;chunk<numChunks;++chunk)
+		{
+		if(!workers[chunk].ok)
+			return false;
+		numIndices+=workers[chunk].indices.size();
+		}
+	if(indices!=0)
+		{
+		indices->reserve(numIndices);
+		for(size_t chunk=0;chunk<numChunks;++chunk)
+			indices->insert(indices->end(),workers[chunk].indices.begin(),workers[chunk].indices.end());
+		}
+	
+	return true;
+	}
+
+template <class PLYReaderParam>
+bool readPlyFileElementsParallel(const PLYFileHeader& header,PLYReaderParam& reader,unsigned int numThreads,MeshFileNode& node) // Reads a memory-mapped PLY file in parallel; returns false if the file must be read sequentially instead
+	{
+	/* Collect attribute and geometry nodes extracted from the PLY file: */
+	ColorNodePointer color;
+	NormalNodePointer normal;
+	CoordinateNodePointer coord;
+	Misc::Autopointer<IndexedFaceSetNode> faceSet;
+	
+	/* Process all PLY file elements in order: */
+	for(size_t elementIndex=0;elementIndex<header.getNumElements();++elementIndex)
+		{
+		/* Get the next element: */
+		const PLYElement& element=header.getElement(elementIndex);
+		
+		/* Check if it's the vertex or face element: */
+		if(element.isElement("vertex")&&element.getNumValues()>0)
+			{
+			/* Get the indices of all supported vertex properties and leave error handling to the sequential reader: */
+			PLYVertexLayout layout(element);
+			if(layout.coordMask!=0x7)
+				return false;
+			
+			/* Create property nodes for defined properties and read all vertices in parallel: */
+			if(layout.colorMask==0x7)
+				{
+				color=new ColorNode;
+				color->color.getValues().resize(element.getNumValues());
+				}
+			if(layout.normalMask==0x7)
+				{
+				normal=new NormalNode;
+				normal->vector.getValues().resize(element.getNumValues());
+				}
+			coord=new CoordinateNode;
+			coord->point.getValues().resize(element.getNumValues());
+			Color* colors=layout.colorMask==0x7?&color->color.getValues()[0]:0;
+			Vector* normals=layout.normalMask==0x7?&normal->vector.getValues()[0]:0;
+			if(!readPlyElementParallel(reader,element,&layout,~0U,numThreads,colors,normals,&coord->point.getValues()[0],0))
+				return false;
+			
+			/* Finalize the property nodes: */
+			if(layout.colorMask==0x7)
+				color->update();
+			if(layout.normalMask==0x7)
+				normal->update();
+			coord->update();
+			}
+		else if(element.isElement("face")&&element.getNumValues()>0)
+			{
+			/* Read all face vertex indices in parallel: */
+			unsigned int vertexIndicesIndex=element.getPropertyIndex("vertex_indices");
+			if(vertexIndicesIndex>=element.getNumProperties())
+				return false;
+			faceSet=new IndexedFaceSetNode;
+			if(!readPlyElementParallel(reader,element,0,vertexIndicesIndex,numThreads,0,0,0,&faceSet->coordIndex.getValues()))
+				return false;
+			}
+		else
+			{
+			/* Skip the entire element: */
+			if(!reader.skipElement(element))
+				return false;
+			}
+		}
+	
+	/* Create a shape node from the property and geometry nodes: */
+	addPlyShape(color,normal,coord,faceSet,node);
+	
+	return true;
+	}
+
+bool readPlyFileParallel(const IO::Directory& directory,const std::string& fileName,MeshFileNode& node) // Reads a PLY file by memory-mapping it and converting elements in parallel; returns false if the file must be read sequentially instead
+	{
+	/* Memory-map the PLY file: */
+	MemMappedFilePtr mappedFile=openMappedMeshFile(directory,fileName);
+	if(mappedFile==0)
+		return false;
+	
+	/* Read the PLY file's header from a separate file to find the beginning of the element data: */
+	IO::SeekableFilePtr headerFile(directory.openSeekableFile(fileName.c_str()));
+	PLYFileHeader header(*headerFile);
+	if(!header.isValid())
+		return false;
+	IO::SeekableFile::Offset dataOffset=headerFile->getReadPos();
+	IO::SeekableFile::Offset fileSize=mappedFile->getSize();
+	if(dataOffset>fileSize)
+		return false;
+	const char* data=static_cast<const char*>(mappedFile->getMemory());
+	
+	/* Read the PLY file in ASCII or binary mode: */
+	unsigned int numThreads=(unsigned int)(node.numLoaderThreads.getValue());
+	if(header.getFileType()==PLYFileHeader::Ascii)
+		{
+		PLYAsciiReader reader(data+dataOffset,data+fileSize);
+		return readPlyFileElementsParallel(header,reader,numThreads,node);
+		}
+	else
+		{
+		/* Let the memory-mapped file decide whether values must be endianness-swapped: */
+		mappedFile->setEndianness(header.getFileEndianness());
+		PLYBinaryReader reader(data+dataOffset,data+fileSize,mappedFile->mustSwapOnRead());
+		return readPlyFileElementsParallel(header,reader,numThreads,node);
 		}
 	}
 
@@ -410,6 +971,20 @@ void readPlyFileElements(const PLYFileHeader& header,PLYFileParam& ply,MeshFileN
 
 void readPlyFile(const IO::Directory& directory,const std::string& fileName,MeshFileNode& node)
 	{
+	/* Try reading the PLY file in parallel if requested: */
+	if(node.numLoaderThreads.getValue()>1)
+		{
+		try
+			{
+			if(readPlyFileParallel(directory,fileName,node))
+				return;
+			}
+		catch(const std::runtime_error&)
+			{
+			/* Fall back to reading the PLY file sequentially, which will report the error: */
+			}
+		}
+	
 	/* Open the input file: */
 	IO::FilePtr plyFile(directory.openFile(fileName.c_str()));
 	
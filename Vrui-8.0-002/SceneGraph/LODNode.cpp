@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <AL/ALContextData.h>
+#include <SceneGraph/GroupNode.h>
 #include <SceneGraph/EventTypes.h>
 #include <SceneGraph/VRMLFile.h>
 #include <SceneGraph/SphereCollisionQuery.h>
@@ -96,6 +97,9 @@ void LODNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int LODNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the node's extents might have changed: */
+	GroupNode::invalidateBoundingBoxes();
+	
 	/* Calculate the new pass mask as the union of all levels' pass masks, for lack of a better approach: */
 	PassMask newPassMask=0x0U;
 	for(MFGraphNode::ValueList::const_iterator lIt=level.getValues().begin();lIt!=level.getValues().end();++lIt)
@@ -106,6 +106,9 @@ void LabelSetNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int LabelSetNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Create a default font style node if none was provided: */
 	if(fontStyle.getValue()==0)
 		{
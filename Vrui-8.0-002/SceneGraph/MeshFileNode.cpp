@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <Misc/ThrowStdErr.h>
+#include <SceneGraph/GroupNode.h>
 #include <SceneGraph/VRMLFile.h>
 #include <SceneGraph/Internal/ReadPlyFile.h>
 #include <SceneGraph/Internal/ReadObjFile.h>
@@ -41,7 +42,7 @@ Methods of class MeshFileNode:
 *****************************/
 
 MeshFileNode::MeshFileNode(void)
-	:disableTextures(false),ccw(true),solid(true),pointSize(1)
+	:disableTextures(false),ccw(true),solid(true),pointSize(1),numLoaderThreads(1)
 	{
 	}
 
@@ -75,12 +76,17 @@ void MeshFileNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 		vrmlFile.parseField(creaseAngle);
 	else if(strcmp(fieldName,"pointSize")==0)
 		vrmlFile.parseField(pointSize);
+	else if(strcmp(fieldName,"numLoaderThreads")==0)
+		vrmlFile.parseField(numLoaderThreads);
 	else
 		GraphNode::parseField(fieldName,vrmlFile);
 	}
 
 unsigned int MeshFileNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the node's extents might have changed: */
+	GroupNode::invalidateBoundingBoxes();
+	
 	/* Delete the current mesh file representation: */
 	shapes.clear();
 	
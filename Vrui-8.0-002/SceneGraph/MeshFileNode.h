@@ -56,6 +56,7 @@ class MeshFileNode:public GraphNode
 	SFBool solid; // Flag whether the mesh file defines a solid surfaces whose backfaces are not rendered
 	SFFloat pointSize; // Cosmetic point size for rendering points
 	SFFloat creaseAngle; // Maximum angle between adjacent faces to create a sharp edge
+	SFInt numLoaderThreads; // Number of threads to use when loading uncompressed local mesh files; 1 reads mesh files sequentially
 	
 	/* Derived elements: */
 	protected:
@@ -109,4 +109,10 @@ void OGTransformNode::alRenderAction(ALRenderState& renderState) const
 	renderState.popTransform(previousTransform);
 	}
 
+Box OGTransformNode::calcCullingBox(void) const
+	{
+	/* The transformation can be changed via setTransform without notifying the parent, so the group's extents are unknown: */
+	return Box::full;
+	}
+
 }
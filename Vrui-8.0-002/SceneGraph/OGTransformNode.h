@@ -55,6 +55,9 @@ class OGTransformNode:public GroupNode
 	virtual void glRenderAction(GLRenderState& renderState) const;
 	virtual void alRenderAction(ALRenderState& renderState) const;
 	
+	/* Methods from class GroupNode: */
+	virtual Box calcCullingBox(void) const;
+	
 	/* New methods: */
 	void setTransform(const OGTransform& newTransform) // Sets the transformation and performs necessary updates
 		{
@@ -110,4 +110,10 @@ void ONTransformNode::alRenderAction(ALRenderState& renderState) const
 	renderState.popTransform(previousTransform);
 	}
 
+Box ONTransformNode::calcCullingBox(void) const
+	{
+	/* The transformation can be changed via setTransform without notifying the parent, so the group's extents are unknown: */
+	return Box::full;
+	}
+
 }
@@ -55,6 +55,9 @@ class ONTransformNode:public GroupNode
 	virtual void glRenderAction(GLRenderState& renderState) const;
 	virtual void alRenderAction(ALRenderState& renderState) const;
 	
+	/* Methods from class GroupNode: */
+	virtual Box calcCullingBox(void) const;
+	
 	/* New methods: */
 	void setTransform(const ONTransform& newTransform) // Sets the transformation and performs necessary updates
 		{
@@ -115,6 +115,9 @@ void PointSetNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int PointSetNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Bump up the point set's version number: */
 	++version;
 	
@@ -262,6 +262,9 @@ void QuadSetNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int QuadSetNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Determine the number of full quads: */
 	numQuads=coord.getValue()!=0?coord.getValue()->point.getNumValues()/4:0;
 	
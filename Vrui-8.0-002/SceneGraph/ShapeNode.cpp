@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <SceneGraph/ShapeNode.h>
 
 #include <string.h>
+#include <SceneGraph/GroupNode.h>
 #include <SceneGraph/VRMLFile.h>
 #include <SceneGraph/GLRenderState.h>
 
@@ -63,6 +64,9 @@ void ShapeNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int ShapeNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the node's extents might have changed: */
+	GroupNode::invalidateBoundingBoxes();
+	
 	/* Check if there are both an appearance node and a geometry node: */
 	if(appearance.getValue()!=0&&geometry.getValue()!=0)
 		{
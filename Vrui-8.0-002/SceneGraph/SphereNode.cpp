@@ -304,6 +304,9 @@ void SphereNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int SphereNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Invalidate the display list: */
 	DisplayList::update();
 	
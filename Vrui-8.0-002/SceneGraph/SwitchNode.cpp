@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <Geometry/Box.h>
+#include <SceneGraph/GroupNode.h>
 #include <SceneGraph/EventTypes.h>
 #include <SceneGraph/VRMLFile.h>
 
@@ -85,6 +86,9 @@ void SwitchNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int SwitchNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the node's extents might have changed: */
+	GroupNode::invalidateBoundingBoxes();
+	
 	/* Set this node's pass mask to the current choice's pass mask or nothing if the choice is invalid : */
 	PassMask newPassMask=0x0U;
 	int wc=whichChoice.getValue();
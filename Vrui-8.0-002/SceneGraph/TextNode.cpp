@@ -95,6 +95,9 @@ void TextNode::parseField(const char* fieldName,VRMLFile& vrmlFile)
 
 unsigned int TextNode::update(void)
 	{
+	/* Invalidate cached culling boxes, as the geometry's extents might have changed: */
+	GeometryNode::update();
+	
 	/* Create a default font style node if none was provided: */
 	if(fontStyle.getValue()==0)
 		{
@@ -202,4 +202,13 @@ void TransformNode::alRenderAction(ALRenderState& renderState) const
 	renderState.popTransform(previousTransform);
 	}
 
+Box TransformNode::calcCullingBox(void) const
+	{
+	/* Transform the group's culling box to the parent's coordinate system: */
+	Box result=getLocalCullingBox();
+	if(!result.isNull()&&!result.isFull())
+		result.transform(transform);
+	return result;
+	}
+
 }
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #define THREADS_CONFIG_HAVE_BUILTIN_ATOMICS 1
 #define THREADS_CONFIG_HAVE_SPINLOCKS 1
 #define THREADS_CONFIG_CAN_CANCEL 1
+#define THREADS_CONFIG_HAVE_EPOLL 1
 
 #define THREADS_CONFIG_DEBUG 0
 
@@ -29,6 +29,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <unistd.h>
 #include <fcntl.h>
 #include <signal.h>
+#if THREADS_CONFIG_HAVE_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
 #include <stdexcept>
 #include <Misc/ThrowStdErr.h>
 #include <Misc/MessageLogger.h>
@@ -245,6 +250,40 @@ EventDispatcher::ListenerKey EventDispatcher::getNextKey(void)
 	return nextKey;
 	}
 
+#if THREADS_CONFIG_HAVE_EPOLL
+
+size_t EventDispatcher::readPipeMessages(void)
+	{
+	/* Reset the event file descriptor's counter: */
+	eventfd_t counter;
+	if(eventfd_read(eventFd,&counter)<0&&errno!=EAGAIN&&errno!=EWOULDBLOCK&&errno!=EINTR)
+		Misc::throwStdErr("Threads::EventDispatcher::readPipeMessages: Fatal error %d (%s) while reading event counter",errno,strerror(errno));
+	
+	/* Take all queued messages, and recycle the previous message list's storage for the queue: */
+	messages.clear();
+	{
+	Threads::Spinlock::Lock pipeLock(pipeMutex);
+	std::swap(messages,newMessages);
+	}
+	
+	return messages.size();
+	}
+
+void EventDispatcher::writePipeMessage(const EventDispatcher::PipeMessage& pm,const char* methodName)
+	{
+	/* Append the message to the queue: */
+	{
+	Threads::Spinlock::Lock pipeLock(pipeMutex);
+	newMessages.push_back(pm);
+	}
+	
+	/* Wake up the dispatcher: */
+	if(eventfd_write(eventFd,1)<0)
+		Misc::throwStdErr("Threads::EventDispatcher::%s: Fatal error %d (%s) while writing command",methodName,errno,strerror(errno));
+	}
+
+#else
+
 size_t EventDispatcher::readPipeMessages(void)
 	{
 	/* Check if there was a partial message during the previous call: */
@@ -306,6 +345,67 @@ void EventDispatcher::writePipeMessage(const EventDispatcher::PipeMessage& pm,co
 		}
 	}
 
+#endif
+
+#if THREADS_CONFIG_HAVE_EPOLL
+
+void EventDispatcher::updateFdSets(int fd,int,int)
+	{
+	/* Combine the interest masks of all listeners on the given file descriptor: */
+	int typeMask=0x0;
+	for(std::vector<IOEventListener>::iterator elIt=ioEventListeners.begin();elIt!=ioEventListeners.end();++elIt)
+		if(elIt->fd==fd)
+			typeMask|=elIt->typeMask;
+	unsigned int newEvents=0x0U;
+	if(typeMask&Read)
+		newEvents|=EPOLLIN;
+	if(typeMask&Write)
+		newEvents|=EPOLLOUT;
+	if(typeMask&Exception)
+		newEvents|=EPOLLPRI;
+	
+	/* Retrieve the epoll event mask with which the file descriptor is currently registered: */
+	EpollMaskMap::Iterator emIt=epollMasks.findEntry(fd);
+	unsigned int oldEvents=emIt.isFinished()?0x0U:emIt->getDest();
+	if(newEvents==oldEvents)
+		return;
+	
+	if(newEvents==0x0U)
+		{
+		/* Remove the file descriptor from the epoll set; ignore errors as the file descriptor might already be closed: */
+		epoll_ctl(epollFd,EPOLL_CTL_DEL,fd,0);
+		epollMasks.removeEntry(emIt);
+		}
+	else
+		{
+		/* Add the file descriptor to the epoll set or modify its registration: */
+		struct epoll_event event;
+		memset(&event,0,sizeof(struct epoll_event));
+		event.events=newEvents;
+		event.data.fd=fd;
+		int result;
+		if(oldEvents==0x0U)
+			{
+			result=epoll_ctl(epollFd,EPOLL_CTL_ADD,fd,&event);
+			if(result<0&&errno==EEXIST)
+				result=epoll_ctl(epollFd,EPOLL_CTL_MOD,fd,&event);
+			}
+		else
+			{
+			/* Re-add the file descriptor if it was closed and re-opened in the meantime: */
+			result=epoll_ctl(epollFd,EPOLL_CTL_MOD,fd,&event);
+			if(result<0&&errno==ENOENT)
+				result=epoll_ctl(epollFd,EPOLL_CTL_ADD,fd,&event);
+			}
+		if(result<0)
+			Misc::formattedLogWarning("Threads::EventDispatcher::updateFdSets: Error %d (%s) while watching file descriptor %d",errno,strerror(errno),fd);
+		
+		epollMasks[fd]=newEvents;
+		}
+	}
+
+#else
+
 void EventDispatcher::updateFdSets(int fd,int oldEventMask,int newEventMask)
 	{
 	/* Check if the read set needs to be updated: */
@@ -375,6 +475,57 @@ void EventDispatcher::updateFdSets(int fd,int oldEventMask,int newEventMask)
 		}
 	}
 
+#endif
+
+#if THREADS_CONFIG_HAVE_EPOLL
+
+EventDispatcher::EventDispatcher(void)
+	:epollFd(-1),eventFd(-1),timerFd(-1),
+	 stopRequested(false),timerArmed(false),
+	 epollMasks(17),
+	 nextKey(0),
+	 signalListeners(17)
+	{
+	/* Create the epoll instance and the event and timer file descriptors: */
+	epollFd=epoll_create1(EPOLL_CLOEXEC);
+	if(epollFd>=0)
+		eventFd=eventfd(0,EFD_NONBLOCK|EFD_CLOEXEC);
+	if(eventFd>=0)
+		timerFd=timerfd_create(CLOCK_REALTIME,TFD_NONBLOCK|TFD_CLOEXEC);
+	if(timerFd<0)
+		{
+		int error=errno;
+		if(eventFd>=0)
+			close(eventFd);
+		if(epollFd>=0)
+			close(epollFd);
+		Misc::throwStdErr("Misc::EventDispatcher: Cannot create event descriptors due to error %d (%s)",error,strerror(error));
+		}
+	
+	/* Watch the event and timer file descriptors: */
+	struct epoll_event event;
+	memset(&event,0,sizeof(struct epoll_event));
+	event.events=EPOLLIN;
+	event.data.fd=eventFd;
+	epoll_ctl(epollFd,EPOLL_CTL_ADD,eventFd,&event);
+	event.data.fd=timerFd;
+	epoll_ctl(epollFd,EPOLL_CTL_ADD,timerFd,&event);
+	}
+
+EventDispatcher::~EventDispatcher(void)
+	{
+	/* Close the epoll instance and the event and timer file descriptors: */
+	close(timerFd);
+	close(eventFd);
+	close(epollFd);
+	
+	/* Delete all timer event listeners: */
+	for(TimerEventListenerHeap::Iterator telIt=timerEventListeners.begin();telIt!=timerEventListeners.end();++telIt)
+		delete *telIt;
+	}
+
+#else
+
 EventDispatcher::EventDispatcher(void)
 	:numMessages(4096/sizeof(PipeMessage)),messages(new PipeMessage[numMessages]),messageReadSize(0),
 	 nextKey(0),
@@ -410,6 +561,172 @@ EventDispatcher::~EventDispatcher(void)
 		delete *telIt;
 	}
 
+#endif
+
+bool EventDispatcher::handlePipeMessages(void)
+	{
+	/* Read and handle pipe messages: */
+	size_t numMessages=readPipeMessages();
+	#if THREADS_CONFIG_HAVE_EPOLL
+	PipeMessage* pmPtr=numMessages>0?&messages.front():0;
+	#else
+	PipeMessage* pmPtr=messages;
+	#endif
+	for(size_t i=0;i<numMessages;++i,++pmPtr)
+		{
+		switch(pmPtr->messageType)
+			{
+			case PipeMessage::INTERRUPT: // Interrupt wait
+				
+				/* Do nothing */
+				
+				break;
+			
+			case PipeMessage::STOP: // Stop dispatching events
+				return false;
+				break;
+			
+			case PipeMessage::ADD_IO_LISTENER: // Add input/output event listener
+				
+				/* Add the new input/output event listener to the list: */
+				ioEventListeners.push_back(IOEventListener(pmPtr->addIOListener.key,pmPtr->addIOListener.fd,pmPtr->addIOListener.typeMask,pmPtr->addIOListener.callback,pmPtr->addIOListener.callbackUserData));
+				
+				/* Update the file descriptor sets: */
+				updateFdSets(pmPtr->addIOListener.fd,0x0,pmPtr->addIOListener.typeMask);
+				
+				break;
+			
+			case PipeMessage::SET_IO_LISTENER_TYPEMASK: // Change the event type mask of an input/output event listener
+				
+				/* Find the input/output event listener with the given key: */
+				for(std::vector<IOEventListener>::iterator elIt=ioEventListeners.begin();elIt!=ioEventListeners.end();++elIt)
+					if(elIt->key==pmPtr->setIOListenerEventTypeMask.key)
+						{
+						/* Update the input/output event listener: */
+						int typeMask=elIt->typeMask;
+						elIt->typeMask=pmPtr->setIOListenerEventTypeMask.newTypeMask;
+						
+						/* Update the file descriptor sets: */
+						updateFdSets(elIt->fd,typeMask,elIt->typeMask);
+						
+						/* Stop looking: */
+						break;
+						}
+				
+				break;
+			
+			case PipeMessage::REMOVE_IO_LISTENER: // Remove input/output event listener
+				
+				/* Find the input/output event listener with the given key: */
+				for(std::vector<IOEventListener>::iterator elIt=ioEventListeners.begin();elIt!=ioEventListeners.end();++elIt)
+					if(elIt->key==pmPtr->removeIOListener)
+						{
+						/* Remove the input/output event listener from the list: */
+						int fd=elIt->fd;
+						int typeMask=elIt->typeMask;
+						*elIt=ioEventListeners.back();
+						ioEventListeners.pop_back();
+						
+						/* Update the file descriptor sets: */
+						updateFdSets(fd,typeMask,0x0);
+						
+						/* Stop looking: */
+						break;
+						}
+				
+				break;
+			
+			case PipeMessage::ADD_TIMER_LISTENER: // Add timer event listener
+				
+				/* Add the new timer event listener to the heap: */
+				timerEventListeners.insert(new TimerEventListener(pmPtr->addTimerListener.key,pmPtr->addTimerListener.time,pmPtr->addTimerListener.interval,pmPtr->addTimerListener.callback,pmPtr->addTimerListener.callbackUserData));
+				
+				break;
+			
+			case PipeMessage::REMOVE_TIMER_LISTENER: // Remove timer event listener
+				
+				/* Find the timer event listener with the given key: */
+				for(TimerEventListenerHeap::Iterator elIt=timerEventListeners.begin();elIt!=timerEventListeners.end();++elIt)
+					if((*elIt)->key==pmPtr->removeTimerListener)
+						{
+						/* Remove the timer event listener from the heap: */
+						delete *elIt;
+						timerEventListeners.remove(elIt);
+						
+						/* Stop looking: */
+						break;
+						}
+				
+				break;
+			
+			case PipeMessage::ADD_PROCESS_LISTENER:
+				
+				/* Add the new process listener to the list: */
+				processListeners.push_back(ProcessListener(pmPtr->addProcessListener.key,pmPtr->addProcessListener.callback,pmPtr->addProcessListener.callbackUserData));
+				
+				break;
+			
+			case PipeMessage::REMOVE_PROCESS_LISTENER:
+				
+				/* Find the process listener with the given key: */
+				for(std::vector<ProcessListener>::iterator plIt=processListeners.begin();plIt!=processListeners.end();++plIt)
+					if(plIt->key==pmPtr->removeProcessListener)
+						{
+						/* Remove the process listener from the list: */
+						*plIt=processListeners.back();
+						processListeners.pop_back();
+						
+						/* Stop looking: */
+						break;
+						}
+				
+				break;
+			
+			case PipeMessage::ADD_SIGNAL_LISTENER:
+				
+				/* Add the new signal listener to the map: */
+				signalListeners.setEntry(SignalListenerMap::Entry(pmPtr->addSignalListener.key,SignalListener(pmPtr->addSignalListener.key,pmPtr->addSignalListener.callback,pmPtr->addSignalListener.callbackUserData)));
+				
+				break;
+			
+			case PipeMessage::REMOVE_SIGNAL_LISTENER:
+				
+				/* Remove the signal listener with the given key from the map: */
+				signalListeners.removeEntry(pmPtr->removeSignalListener);
+				
+				break;
+			
+			case PipeMessage::SIGNAL:
+				{
+				/* Find the signal listener with the given key in the map: */
+				SignalListener& sl=signalListeners.getEntry(pmPtr->signal.key).getDest();
+				
+				/* Call the callback: */
+				sl.callback(sl.key,pmPtr->signal.signalData,sl.callbackUserData);
+				
+				break;
+				}
+			
+			default:
+				/* Do nothing: */
+				
+				// DEBUGGING
+				Misc::formattedLogWarning("Threads::EventDispatcher::handlePipeMessages: Unknown pipe message %d",pmPtr->messageType);
+			}
+		}
+	
+	#if THREADS_CONFIG_HAVE_EPOLL
+	/* Check if the stop() method was called: */
+	if(stopRequested)
+		{
+		stopRequested=false;
+		return false;
+		}
+	#endif
+	
+	return true;
+	}
+
 bool EventDispatcher::dispatchNextEvent(void)
 	{
 	/* Update the dispatch time point: */
@@ -451,6 +768,112 @@ bool EventDispatcher::dispatchNextEvent(void)
 			}
 		}
 	
+	#if THREADS_CONFIG_HAVE_EPOLL
+	
+	/* Arm the timer file descriptor for the next timer event if it changed: */
+	if(!timerEventListeners.isEmpty())
+		{
+		const Time& nextTime=timerEventListeners.getSmallest()->time;
+		if(!timerArmed||timerTime!=nextTime)
+			{
+			struct itimerspec timerSpec;
+			memset(&timerSpec,0,sizeof(struct itimerspec));
+			timerSpec.it_value.tv_sec=nextTime.tv_sec;
+			timerSpec.it_value.tv_nsec=nextTime.tv_usec*1000L;
+			if(timerSpec.it_value.tv_sec==0&&timerSpec.it_value.tv_nsec==0)
+				timerSpec.it_value.tv_nsec=1; // A zero time would disarm the timer
+			timerfd_settime(timerFd,TFD_TIMER_ABSTIME,&timerSpec,0);
+			timerArmed=true;
+			timerTime=nextTime;
+			}
+		}
+	else if(timerArmed)
+		{
+		/* Disarm the timer file descriptor: */
+		struct itimerspec timerSpec;
+		memset(&timerSpec,0,sizeof(struct itimerspec));
+		timerfd_settime(timerFd,TFD_TIMER_ABSTIME,&timerSpec,0);
+		timerArmed=false;
+		}
+	
+	/* Wait for the next event on any watched file descriptor, the event file descriptor, or the timer file descriptor: */
+	const int maxNumEvents=64;
+	struct epoll_event events[maxNumEvents];
+	int numEvents=epoll_wait(epollFd,events,maxNumEvents,-1);
+	
+	/* Update the dispatch time point: */
+	dispatchTime=Time::now();
+	
+	if(numEvents<0)
+		{
+		if(errno!=EINTR)
+			{
+			int error=errno;
+			Misc::throwStdErr("Threads::EventDispatcher::dispatchNextEvent: Error %d (%s) during epoll_wait",error,strerror(error));
+			}
+		numEvents=0;
+		}
+	
+	/* Handle pipe messages and timer expirations first: */
+	for(int i=0;i<numEvents;++i)
+		{
+		if(events[i].data.fd==eventFd)
+			{
+			/* Read and handle pipe messages: */
+			if(!handlePipeMessages())
+				return false;
+			}
+		else if(events[i].data.fd==timerFd)
+			{
+			/* Reset the timer file descriptor; elapsed timer events will be handled on the next iteration: */
+			uint64_t numExpirations;
+			if(read(timerFd,&numExpirations,sizeof(uint64_t))<0&&errno!=EAGAIN&&errno!=EWOULDBLOCK&&errno!=EINTR)
+				Misc::formattedLogWarning("Threads::EventDispatcher::dispatchNextEvent: Error %d (%s) while reading timer",errno,strerror(errno));
+			timerArmed=false;
+			}
+		}
+	
+	/* Handle all input/output events: */
+	for(int i=0;i<numEvents;++i)
+		{
+		int fd=events[i].data.fd;
+		if(fd==eventFd||fd==timerFd)
+			continue;
+		
+		/* Determine all event types on the file descriptor; errors and hang-ups count as reads and writes like in select(): */
+		int eventTypeMask=0x0;
+		if(events[i].events&(EPOLLIN|EPOLLHUP|EPOLLERR))
+			eventTypeMask|=Read;
+		if(events[i].events&(EPOLLOUT|EPOLLHUP|EPOLLERR))
+			eventTypeMask|=Write;
+		if(events[i].events&EPOLLPRI)
+			eventTypeMask|=Exception;
+		
+		/* Dispatch the events to all listeners on the file descriptor: */
+		for(size_t elIndex=0;elIndex<ioEventListeners.size();++elIndex)
+			{
+			IOEventListener& el=ioEventListeners[elIndex];
+			if(el.fd!=fd)
+				continue;
+			
+			/* Call the listener's event callback if it is interested, and check whether the listener wants to be removed: */
+			int interestEventTypeMask=eventTypeMask&el.typeMask;
+			if(interestEventTypeMask!=0x0&&el.callback(el.key,interestEventTypeMask,el.callbackUserData))
+				{
+				/* Remove the event listener from the list: */
+				int typeMask=el.typeMask;
+				ioEventListeners[elIndex]=ioEventListeners.back();
+				ioEventListeners.pop_back();
+				--elIndex;
+				
+				/* Update the epoll set: */
+				updateFdSets(fd,typeMask,0x0);
+				}
+			}
+		}
+	
+	#else
+	
 	/* Create lists of watched file descriptors: */
 	fd_set rds,wds,eds;
 	int numRfds,numWfds,numEfds,numFds;
@@ -503,150 +926,8 @@ bool EventDispatcher::dispatchNextEvent(void)
 		if(FD_ISSET(pipeFds[0],&rds))
 			{
 			/* Read and handle pipe messages: */
-			size_t numMessages=readPipeMessages();
-			PipeMessage* pmPtr=messages;
-			for(size_t i=0;i<numMessages;++i,++pmPtr)
-				{
-				switch(pmPtr->messageType)
-					{
-					case PipeMessage::INTERRUPT: // Interrupt wait
-						
-						/* Do nothing */
-						
-						break;
-					
-					case PipeMessage::STOP: // Stop dispatching events
-						return false;
-						break;
-					
-					case PipeMessage::ADD_IO_LISTENER: // Add input/output event listener
-						
-						/* Add the new input/output event listener to the list: */
-						ioEventListeners.push_back(IOEventListener(pmPtr->addIOListener.key,pmPtr->addIOListener.fd,pmPtr->addIOListener.typeMask,pmPtr->addIOListener.callback,pmPtr->addIOListener.callbackUserData));
-						
-						/* Update the file descriptor sets: */
-						updateFdSets(pmPtr->addIOListener.fd,0x0,pmPtr->addIOListener.typeMask);
-						
-						break;
-					
-					case PipeMessage::SET_IO_LISTENER_TYPEMASK: // Change the event type mask of an input/output event listener
-						
-						/* Find the input/output event listener with the given key: */
-						for(std::vector<IOEventListener>::iterator elIt=ioEventListeners.begin();elIt!=ioEventListeners.end();++elIt)
-							if(elIt->key==pmPtr->setIOListenerEventTypeMask.key)
-								{
-								/* Update the input/output event listener: */
-								int typeMask=elIt->typeMask;
-								elIt->typeMask=pmPtr->setIOListenerEventTypeMask.newTypeMask;
-								
-								/* Update the file descriptor sets: */
-								updateFdSets(elIt->fd,typeMask,elIt->typeMask);
-								
-								/* Stop looking: */
-								break;
-								}
-						
-						break;
-					
-					case PipeMessage::REMOVE_IO_LISTENER: // Remove input/output event listener
-						
-						/* Find the input/output event listener with the given key: */
-						for(std::vector<IOEventListener>::iterator elIt=ioEventListeners.begin();elIt!=ioEventListeners.end();++elIt)
-							if(elIt->key==pmPtr->removeIOListener)
-								{
-								/* Remove the input/output event listener from the list: */
-								int fd=elIt->fd;
-								int typeMask=elIt->typeMask;
-								*elIt=ioEventListeners.back();
-								ioEventListeners.pop_back();
-								
-								/* Update the file descriptor sets: */
-								updateFdSets(fd,typeMask,0x0);
-								
-								/* Stop looking: */
-								break;
-								}
-						
-						break;
-					
-					case PipeMessage::ADD_TIMER_LISTENER: // Add timer event listener
-						
-						/* Add the new timer event listener to the heap: */
-						timerEventListeners.insert(new TimerEventListener(pmPtr->addTimerListener.key,pmPtr->addTimerListener.time,pmPtr->addTimerListener.interval,pmPtr->addTimerListener.callback,pmPtr->addTimerListener.callbackUserData));
-						
-						break;
-					
-					case PipeMessage::REMOVE_TIMER_LISTENER: // Remove timer event listener
-						
-						/* Find the timer event listener with the given key: */
-						for(TimerEventListenerHeap::Iterator elIt=timerEventListeners.begin();elIt!=timerEventListeners.end();++elIt)
-							if((*elIt)->key==pmPtr->removeTimerListener)
-								{
-								/* Remove the timer event listener from the heap: */
-								delete *elIt;
-								timerEventListeners.remove(elIt);
-								
-								/* Stop looking: */
-								break;
-								}
-						
-						break;
-					
-					case PipeMessage::ADD_PROCESS_LISTENER:
-						
-						/* Add the new process listener to the list: */
-						processListeners.push_back(ProcessListener(pmPtr->addProcessListener.key,pmPtr->addProcessListener.callback,pmPtr->addProcessListener.callbackUserData));
-						
-						break;
-					
-					case PipeMessage::REMOVE_PROCESS_LISTENER:
-						
-						/* Find the process listener with the given key: */
-						for(std::vector<ProcessListener>::iterator plIt=processListeners.begin();plIt!=processListeners.end();++plIt)
-							if(plIt->key==pmPtr->removeProcessListener)
-								{
-								/* Remove the process listener from the list: */
-								*plIt=processListeners.back();
-								processListeners.pop_back();
-								
-								/* Stop looking: */
-								break;
-								}
-						
-						break;
-					
-					case PipeMessage::ADD_SIGNAL_LISTENER:
-						
-						/* Add the new signal listener to the map: */
-						signalListeners.setEntry(SignalListenerMap::Entry(pmPtr->addSignalListener.key,SignalListener(pmPtr->addSignalListener.key,pmPtr->addSignalListener.callback,pmPtr->addSignalListener.callbackUserData)));
-						
-						break;
-					
-					case PipeMessage::REMOVE_SIGNAL_LISTENER:
-						
-						/* Remove the signal listener with the given key from the map: */
-						signalListeners.removeEntry(pmPtr->removeSignalListener);
-						
-						break;
-					
-					case PipeMessage::SIGNAL:
-						{
-						/* Find the signal listener with the given key in the map: */
-						SignalListener& sl=signalListeners.getEntry(pmPtr->signal.key).getDest();
-						
-						/* Call the callback: */
-						sl.callback(sl.key,pmPtr->signal.signalData,sl.callbackUserData);
-						
-						break;
-						}
-						
-					default:
-						/* Do nothing: */
-						
-						// DEBUGGING
-						Misc::formattedLogWarning("Threads::EventDispatcher::dispatchNextEvent: Unknown pipe message %d",pmPtr->messageType);
-					}
-				}
+			if(!handlePipeMessages())
+				return false;
 			
 			--numSetFds;
 			}
@@ -685,13 +966,15 @@ bool EventDispatcher::dispatchNextEvent(void)
 			/* Call the listener's event callback and check whether the listener wants to be removed: */
 			if(interestEventTypeMask!=0x0&&elIt->callback(elIt->key,interestEventTypeMask,elIt->callbackUserData))
 				{
-				/* Update the file descriptor sets: */
-				updateFdSets(elIt->fd,elIt->typeMask,0x0);
-				
 				/* Remove the event listener from the list: */
+				int fd=elIt->fd;
+				int typeMask=elIt->typeMask;
 				*elIt=ioEventListeners.back();
 				ioEventListeners.pop_back();
 				--elIt;
+				
+				/* Update the file descriptor sets: */
+				updateFdSets(fd,typeMask,0x0);
 				}
 			}
 		}
@@ -712,6 +995,8 @@ bool EventDispatcher::dispatchNextEvent(void)
 			}
 		}
 	
+	#endif
+	
 	/* Call all process listeners: */
 	for(std::vector<ProcessListener>::iterator plIt=processListeners.begin();plIt!=processListeners.end();++plIt)
 		{
@@ -735,6 +1020,24 @@ void EventDispatcher::dispatchEvents(void)
 		;
 	}
 
+#if THREADS_CONFIG_HAVE_EPOLL
+
+void EventDispatcher::interrupt(void)
+	{
+	/* Wake up the dispatcher: */
+	if(eventfd_write(eventFd,1)<0)
+		Misc::throwStdErr("Threads::EventDispatcher::interrupt: Fatal error %d (%s) while writing command",errno,strerror(errno));
+	}
+
+void EventDispatcher::stop(void)
+	{
+	/* Set the stop flag and wake up the dispatcher without locking, as this method can be called from signal handlers: */
+	stopRequested=true;
+	eventfd_write(eventFd,1);
+	}
+
+#else
+
 void EventDispatcher::interrupt(void)
 	{
 	/* Write a pipe message to the self pipe: */
@@ -753,6 +1056,8 @@ void EventDispatcher::stop(void)
 	writePipeMessage(pm,"stop");
 	}
 
+#endif
+
 void EventDispatcher::stopOnSignals(void)
 	{
 	/* Check if there is already a signal-stopped event dispatcher: */
@@ -808,12 +1113,13 @@ void EventDispatcher::setIOEventListenerEventTypeMaskFromCallback(EventDispatche
 	for(std::vector<IOEventListener>::iterator elIt=ioEventListeners.begin();elIt!=ioEventListeners.end();++elIt)
 		if(elIt->key==listenerKey)
 			{
-			/* Update the file descriptor sets: */
-			updateFdSets(elIt->fd,elIt->typeMask,newEventTypeMask);
-			
 			/* Update the input/output event listener: */
+			int typeMask=elIt->typeMask;
 			elIt->typeMask=newEventTypeMask;
 			
+			/* Update the file descriptor sets: */
+			updateFdSets(elIt->fd,typeMask,newEventTypeMask);
+			
 			/* Stop looking: */
 			break;
 			}
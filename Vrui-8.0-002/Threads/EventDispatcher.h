@@ -32,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Misc/PriorityHeap.h>
 #include <Misc/StandardHashFunction.h>
 #include <Misc/HashTable.h>
+#include <Threads/Config.h>
 #include <Threads/Spinlock.h>
 
 namespace Threads {
@@ -141,30 +142,49 @@ class EventDispatcher
 	struct SignalListener; // Structure representing listeners that react to user-defined signals
 	typedef Misc::HashTable<ListenerKey,SignalListener> SignalListenerMap; // Hash table mapping listener keys to signal listeners
 	struct PipeMessage;
+	#if THREADS_CONFIG_HAVE_EPOLL
+	typedef Misc::HashTable<int,unsigned int> EpollMaskMap; // Hash table mapping file descriptors to the epoll event masks with which they are registered
+	#endif
 	
 	/* Elements: */
 	private:
+	#if THREADS_CONFIG_HAVE_EPOLL
+	Spinlock pipeMutex; // Mutex protecting the message queue used to change the dispatcher's internal state or raise signals
+	int epollFd; // File descriptor of the epoll instance watching all file descriptors
+	int eventFd; // Event file descriptor to wake up the dispatcher when messages are queued, or it is interrupted or stopped
+	int timerFd; // Timer file descriptor to wake up the dispatcher when the next timer event is due
+	std::vector<PipeMessage> newMessages; // Queue of messages sent to the dispatcher since it last read messages
+	std::vector<PipeMessage> messages; // List of messages read by the dispatcher
+	volatile bool stopRequested; // Flag whether the stop() method was called since the dispatcher last read messages
+	bool timerArmed; // Flag whether the timer file descriptor is armed
+	Time timerTime; // Time point for which the timer file descriptor is armed
+	EpollMaskMap epollMasks; // Map of file descriptors currently registered with the epoll instance
+	#else
 	Spinlock pipeMutex; // Mutex protecting the self-pipe used to change the dispatcher's internal state or raise signals
 	int pipeFds[2]; // A uni-directional unnamed pipe to trigger events internal to the dispatcher
 	size_t numMessages; // Number of messages in the self-pipe read buffer
 	PipeMessage* messages; // A buffer to read pipe messages from the self-pipe
 	size_t messageReadSize; // Number of bytes read during previous call to readPipeMessages
+	#endif
 	ListenerKey nextKey; // Next key to be assigned to an event listener
 	std::vector<IOEventListener> ioEventListeners; // List of currently registered input/output event listeners
 	TimerEventListenerHeap timerEventListeners; // Heap of currently registered timer event listeners, sorted by next event time
 	std::vector<ProcessListener> processListeners; // List of currently registered process event listeners
 	SignalListenerMap signalListeners; // Map of currently registered signal event listeners
+	#if !THREADS_CONFIG_HAVE_EPOLL
 	fd_set readFds,writeFds,exceptionFds; // Three sets of file descriptors waiting for reads, writes, and exceptions, respectively
 	int numReadFds,numWriteFds,numExceptionFds; // Number of file descriptors in the three descriptor sets
 	int maxFd; // Largest file descriptor set in any of the three descriptor sets
 	bool hadBadFd; // Flag if the last invocation of dispatchNextEvent() tripped on a bad file descriptor
+	#endif
 	Time dispatchTime; // Time point of current iteration of dispatchNextEvent() method
 	
 	/* Private methods: */
 	ListenerKey getNextKey(void); // Returns a new listener key
 	size_t readPipeMessages(void); // Reads messages from the self-pipe; returns number of complete messages read
 	void writePipeMessage(const PipeMessage& pm,const char* methodName); // Writes a message to the self-pipe
-	void updateFdSets(int fd,int oldEventMask,int newEventMask); // Updates the three descriptor sets based on the given file descriptor changing its interest mask
+	bool handlePipeMessages(void); // Reads and handles messages from the self-pipe; returns false if the stop() method was called
+	void updateFdSets(int fd,int oldEventMask,int newEventMask); // Updates the watched file descriptors after a listener on the given file descriptor changed its interest mask; must be called after the listener list has been updated
 	
 	/* Constructors and destructors: */
 	public:
@@ -44,12 +44,33 @@ Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 Methods of class VRDeviceManager:
 ********************************/
 
+void VRDeviceManager::reportTracker(int trackerIndex)
+	{
+	/* Notify streamer of single tracker update: */
+	streamer->trackerUpdated(trackerIndex);
+	
+	/* Check if this is the tracker's first report in the current report generation: */
+	if(trackerReportGenerations[trackerIndex]!=trackerReportGeneration)
+		{
+		trackerReportGenerations[trackerIndex]=trackerReportGeneration;
+		if(++numReportedTrackers==int(trackerReportGenerations.size()))
+			{
+			/* Notify streamer that device state has completed update: */
+			streamer->updateCompleted();
+			
+			/* Start a new report generation: */
+			++trackerReportGeneration;
+			numReportedTrackers=0;
+			}
+		}
+	}
+
 VRDeviceManager::VRDeviceManager(Misc::ConfigurationFile& configFile)
 	:deviceFactories(configFile.retrieveString("./deviceDirectory",VRDEVICEDAEMON_CONFIG_VRDEVICESDIR),this),
 	 calibratorFactories(configFile.retrieveString("./calibratorDirectory",VRDEVICEDAEMON_CONFIG_VRCALIBRATORSDIR)),
 	 numDevices(0),
 	 devices(0),trackerIndexBases(0),buttonIndexBases(0),valuatorIndexBases(0),
-	 fullTrackerReportMask(0x0),trackerReportMask(0x0),streamer(0)
+	 trackerReportGeneration(1U),numReportedTrackers(0),streamer(0)
 	{
 	/* Allocate device and base index arrays: */
 	typedef std::vector<std::string> StringList;
@@ -190,8 +211,8 @@ int VRDeviceManager::addTracker(const char* name)
 	else
 		trackerNames.push_back(name);
 	
-	/* Update the tracker report mask: */
-	fullTrackerReportMask=(0x1U<<(result+1))-1U;
+	/* Add the new tracker to the report generation tracker: */
+	trackerReportGenerations.push_back(0U);
 	
 	return result;
 	}
@@ -294,21 +315,7 @@ void VRDeviceManager::disableTracker(int trackerIndex)
 	
 	/* Check if update notifications are requested: */
 	if(streamer!=0)
-		{
-		/* Notify streamer of single tracker update: */
-		streamer->trackerUpdated(trackerIndex);
-		
-		/* Update tracker report mask: */
-		trackerReportMask|=1<<trackerIndex;
-		if(trackerReportMask==fullTrackerReportMask)
-			{
-			/* Notify streamer that device state has completed update: */
-			streamer->updateCompleted();
-			
-			/* Reset the tracker report mask: */
-			trackerReportMask=0x0;
-			}
-		}
+		reportTracker(trackerIndex);
 	}
 
 void VRDeviceManager::setTrackerState(int trackerIndex,const Vrui::VRDeviceState::TrackerState& newTrackerState,Vrui::VRDeviceState::TimeStamp newTimeStamp)
@@ -322,21 +329,7 @@ void VRDeviceManager::setTrackerState(int trackerIndex,const Vrui::VRDeviceState
 	
 	/* Check if update notifications are requested: */
 	if(streamer!=0)
-		{
-		/* Notify streamer of single tracker update: */
-		streamer->trackerUpdated(trackerIndex);
-		
-		/* Update tracker report mask: */
-		trackerReportMask|=1<<trackerIndex;
-		if(trackerReportMask==fullTrackerReportMask)
-			{
-			/* Notify streamer that device state has completed update: */
-			streamer->updateCompleted();
-			
-			/* Reset the tracker report mask: */
-			trackerReportMask=0x0;
-			}
-		}
+		reportTracker(trackerIndex);
 	}
 
 void VRDeviceManager::setButtonState(int buttonIndex,Vrui::VRDeviceState::ButtonState newButtonState)
@@ -370,13 +363,14 @@ void VRDeviceManager::updateState(void)
 	Threads::Mutex::Lock stateLock(stateMutex);
 	
 	/* Check if update notifications are requested and an update is necessary: */
-	if(streamer!=0&&(trackerReportMask!=0x0||fullTrackerReportMask==0x0))
+	if(streamer!=0&&(numReportedTrackers!=0||trackerReportGenerations.empty()))
 		{
 		/* Notify streamer that device state has completed update: */
 		streamer->updateCompleted();
 		
-		/* Reset the tracker report mask: */
-		trackerReportMask=0x0;
+		/* Start a new report generation: */
+		++trackerReportGeneration;
+		numReportedTrackers=0;
 		}
 	}
 
@@ -137,10 +137,14 @@ class VRDeviceManager
 	std::vector<Vrui::HMDConfiguration*> hmdConfigurations; // List of HMD configurations
 	std::vector<Feature> powerFeatures; // List of device parts that can be powered off on request
 	std::vector<Feature> hapticFeatures; // List of haptic feedback devices
-	unsigned int fullTrackerReportMask; // Bitmask containing 1-bits for all used logical tracker indices
-	unsigned int trackerReportMask; // Bitmask of logical tracker indices that have reported state
+	std::vector<unsigned int> trackerReportGenerations; // Report generation in which each logical tracker most recently reported state
+	unsigned int trackerReportGeneration; // Current report generation, which ends when all logical trackers have reported state
+	int numReportedTrackers; // Number of logical trackers that have reported state in the current report generation
 	VRStreamer* streamer; // Pointer to VR streamer receiving state update notifications
 	
+	/* Private methods: */
+	void reportTracker(int trackerIndex); // Notifies the streamer that the given tracker has been updated, and that the device state is complete if all trackers have reported state
+	
 	/* Constructors and destructors: */
 	public:
 	VRDeviceManager(Misc::ConfigurationFile& configFile); // Creates device manager by reading current section of configuration file
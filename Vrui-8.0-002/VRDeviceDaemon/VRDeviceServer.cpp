@@ -27,10 +27,12 @@ Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <stdexcept>
 #include <Misc/SizedTypes.h>
 #include <Misc/PrintInteger.h>
+#include <Misc/StandardMarshallers.h>
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
 #include <Vrui/Internal/VRDeviceDescriptor.h>
 #include <Vrui/Internal/HMDConfiguration.h>
+#include <Vrui/Internal/VRDeviceSharedState.h>
 
 #define VRDEVICEDAEMON_DEBUG_PROTOCOL 0
 
@@ -55,7 +57,8 @@ VRDeviceServer::ClientState::ClientState(VRDeviceServer* sServer,Comm::Listening
 	:server(sServer),
 	 pipe(listenSocket),
 	 state(START),protocolVersion(Vrui::VRDevicePipe::protocolVersionNumber),clientExpectsTimeStamps(true),
-	 active(false),streaming(false)
+	 active(false),streaming(false),
+	 sharedStateSlot(-1)
 	{
 	#ifdef VERBOSE
 	/* Assemble the client name: */
@@ -118,6 +121,10 @@ void VRDeviceServer::disconnectClient(VRDeviceServer::ClientState* client,bool r
 		dispatcher.removeIOEventListener(client->listenerKey);
 		}
 	
+	/* Release the client's update notification slot in the shared device state: */
+	if(client->sharedStateSlot>=0)
+		sharedStateSlotMask&=~(1U<<client->sharedStateSlot);
+	
 	/* Check if the client is still streaming or active: */
 	if(client->streaming)
 		--numStreamingClients;
@@ -249,6 +256,16 @@ bool VRDeviceServer::clientMessageCallback(Threads::EventDispatcher::ListenerKey
 							client->pipe.write<Misc::UInt32>(thisPtr->deviceManager->getNumHapticFeatures());
 							}
 						
+						/* Check if the client knows about shared device states: */
+						if(client->protocolVersion>=10U)
+							{
+							/* Offer the shared device state to clients running on the same host: */
+							std::string sharedStateName;
+							if(thisPtr->sharedState!=0&&client->pipe.getAddress()==client->pipe.getPeerAddress())
+								sharedStateName=thisPtr->sharedState->getName();
+							Misc::write(sharedStateName,client->pipe);
+							}
+						
 						/* Finish the reply message: */
 						client->pipe.flush();
 						
@@ -285,6 +302,35 @@ bool VRDeviceServer::clientMessageCallback(Threads::EventDispatcher::ListenerKey
 						thisPtr->disconnectClient(client,false,true);
 						result=true;
 						}
+					else if(message==Vrui::VRDevicePipe::SHAREDSTATE_REQUEST)
+						{
+						/* Allocate an update notification slot in the shared device state for the client: */
+						if(thisPtr->sharedState!=0&&client->sharedStateSlot<0)
+							{
+							int slot;
+							for(slot=0;slot<int(Vrui::VRDeviceSharedState::maxNumClients)&&(thisPtr->sharedStateSlotMask&(1U<<slot))!=0U;++slot)
+								;
+							if(slot<int(Vrui::VRDeviceSharedState::maxNumClients))
+								{
+								thisPtr->sharedStateSlotMask|=1U<<slot;
+								thisPtr->sharedState->resetNotification(slot);
+								client->sharedStateSlot=slot;
+								}
+							}
+						
+						#ifdef VERBOSE
+						if(client->sharedStateSlot>=0)
+							{
+							printf("VRDeviceServer: Client %s receives state updates through shared memory\n",client->clientName.c_str());
+							fflush(stdout);
+							}
+						#endif
+						
+						/* Send the client's notification slot index, or -1 if the request was denied: */
+						client->pipe.writeMessage(Vrui::VRDevicePipe::SHAREDSTATE_REPLY);
+						client->pipe.write<Misc::SInt32>(client->sharedStateSlot);
+						client->pipe.flush();
+						}
 					else
 						throw std::runtime_error("Protocol error in CONNECTED state");
 					break;
@@ -449,6 +495,19 @@ bool VRDeviceServer::writeStateUpdates(VRDeviceServer::ClientStateList::iterator
 	/* Send state updates to client: */
 	try
 		{
+		/* Check if the client receives state updates through the shared device state: */
+		if(client->sharedStateSlot>=0)
+			{
+			/* Notify the client of the update unless it has not yet acknowledged the previous notification: */
+			if(sharedState->raiseNotification(client->sharedStateSlot))
+				{
+				client->pipe.writeMessage(Vrui::VRDevicePipe::SHAREDSTATE_UPDATE);
+				client->pipe.flush();
+				}
+			
+			return true;
+			}
+		
 		/* Send tracker state updates: */
 		for(std::vector<int>::iterator utIt=updatedTrackers.begin();utIt!=updatedTrackers.end();++utIt)
 			{
@@ -574,6 +633,7 @@ bool VRDeviceServer::writeHmdConfiguration(VRDeviceServer::ClientStateList::iter
 VRDeviceServer::VRDeviceServer(VRDeviceManager* sDeviceManager,const Misc::ConfigurationFile& configFile)
 	:VRDeviceManager::VRStreamer(sDeviceManager),
 	 listenSocket(configFile.retrieveValue<int>("./serverPort",-1),5),
+	 sharedState(0),sharedStateSlotMask(0x0U),
 	 numActiveClients(0),numStreamingClients(0),
 	 haveUpdates(false),
 	 managerTrackerStateVersion(0U),streamingTrackerStateVersion(0U),
@@ -584,6 +644,11 @@ VRDeviceServer::VRDeviceServer(VRDeviceManager* sDeviceManager,const Misc::Confi
 	/* Add an event listener for incoming connections on the listening socket: */
 	dispatcher.addIOEventListener(listenSocket.getFd(),Threads::EventDispatcher::Read,newConnectionCallback,this);
 	
+	/* Initialize the update flags of all trackers, buttons, and valuators: */
+	trackerUpdateFlags.resize(state.getNumTrackers(),false);
+	buttonUpdateFlags.resize(state.getNumButtons(),false);
+	valuatorUpdateFlags.resize(state.getNumValuators(),false);
+	
 	/* Initialize the array of battery state version numbers: */
 	batteryStateVersions=new BatteryStateVersions[deviceManager->getNumVirtualDevices()];
 	
@@ -591,6 +656,26 @@ VRDeviceServer::VRDeviceServer(VRDeviceManager* sDeviceManager,const Misc::Confi
 	hmdConfigurationVersions=new HMDConfigurationVersions[numHmdConfigurations];
 	for(unsigned int i=0;i<hmdConfigurations.size();++i)
 		hmdConfigurationVersions[i].hmdConfiguration=hmdConfigurations[i];
+	
+	/* Check if the device state should be shared with local clients: */
+	if(configFile.retrieveValue<bool>("./useSharedMemory",true))
+		{
+		/* Create a shared memory segment named after the server's port: */
+		char sharedStateName[64];
+		snprintf(sharedStateName,sizeof(sharedStateName),"/VRDeviceDaemon-%d",listenSocket.getPortId());
+		std::string sharedMemoryGroup=configFile.retrieveString("./sharedMemoryGroup","");
+		try
+			{
+			Threads::Mutex::Lock stateLock(stateMutex);
+			sharedState=new Vrui::VRDeviceSharedState(sharedStateName,state,sharedMemoryGroup.c_str());
+			}
+		catch(const std::runtime_error& err)
+			{
+			/* Print an error message and send all state updates through pipes: */
+			fprintf(stderr,"VRDeviceServer: Unable to share device state with local clients due to exception %s\n",err.what());
+			fflush(stderr);
+			}
+		}
 	}
 
 VRDeviceServer::~VRDeviceServer(void)
@@ -606,37 +691,74 @@ VRDeviceServer::~VRDeviceServer(void)
 	/* Clean up: */
 	delete[] batteryStateVersions;
 	delete[] hmdConfigurationVersions;
+	delete sharedState;
 	}
 
 void VRDeviceServer::trackerUpdated(int trackerIndex)
 	{
-	/* Remember the updated tracker's index and wake up the run loop: */
+	/* Copy the updated tracker's state into the shared device state: */
+	if(sharedState!=0)
+		sharedState->writeTracker(trackerIndex,state);
+	
+	/* Wake up the run loop unless it already has pending updates: */
+	if(!isStateUpdatePending())
+		dispatcher.interrupt();
+	
+	/* Remember the updated tracker's index unless it is already in the list: */
 	haveUpdates=true;
-	updatedTrackers.push_back(trackerIndex);
-	dispatcher.interrupt();
+	if(!trackerUpdateFlags[trackerIndex])
+		{
+		trackerUpdateFlags[trackerIndex]=true;
+		updatedTrackers.push_back(trackerIndex);
+		}
 	}
 
 void VRDeviceServer::buttonUpdated(int buttonIndex)
 	{
-	/* Remember the updated button's index and wake up the run loop: */
+	/* Copy the updated button's state into the shared device state: */
+	if(sharedState!=0)
+		sharedState->writeButton(buttonIndex,state);
+	
+	/* Wake up the run loop unless it already has pending updates: */
+	if(!isStateUpdatePending())
+		dispatcher.interrupt();
+	
+	/* Remember the updated button's index unless it is already in the list: */
 	haveUpdates=true;
-	updatedButtons.push_back(buttonIndex);
-	dispatcher.interrupt();
+	if(!buttonUpdateFlags[buttonIndex])
+		{
+		buttonUpdateFlags[buttonIndex]=true;
+		updatedButtons.push_back(buttonIndex);
+		}
 	}
 
 void VRDeviceServer::valuatorUpdated(int valuatorIndex)
 	{
-	/* Remember the updated valuator's index and wake up the run loop: */
+	/* Copy the updated valuator's state into the shared device state: */
+	if(sharedState!=0)
+		sharedState->writeValuator(valuatorIndex,state);
+	
+	/* Wake up the run loop unless it already has pending updates: */
+	if(!isStateUpdatePending())
+		dispatcher.interrupt();
+	
+	/* Remember the updated valuator's index unless it is already in the list: */
 	haveUpdates=true;
-	updatedValuators.push_back(valuatorIndex);
-	dispatcher.interrupt();
+	if(!valuatorUpdateFlags[valuatorIndex])
+		{
+		valuatorUpdateFlags[valuatorIndex]=true;
+		updatedValuators.push_back(valuatorIndex);
+		}
 	}
 
 void VRDeviceServer::updateCompleted(void)
 	{
-	/* Update the version number of the device manager's tracking state and wake up the run loop: */
+	/* Wake up the run loop unless it already has pending updates: */
+	if(!isStateUpdatePending())
+		dispatcher.interrupt();
+	
+	/* Update the version number of the device manager's tracking state: */
 	++managerTrackerStateVersion;
-	dispatcher.interrupt();
 	}
 
 void VRDeviceServer::batteryStateUpdated(unsigned int deviceIndex)
@@ -682,8 +804,14 @@ void VRDeviceServer::run(void)
 				
 				/* Reset the update arrays: */
 				haveUpdates=false;
+				for(std::vector<int>::iterator utIt=updatedTrackers.begin();utIt!=updatedTrackers.end();++utIt)
+					trackerUpdateFlags[*utIt]=false;
 				updatedTrackers.clear();
+				for(std::vector<int>::iterator ubIt=updatedButtons.begin();ubIt!=updatedButtons.end();++ubIt)
+					buttonUpdateFlags[*ubIt]=false;
 				updatedButtons.clear();
+				for(std::vector<int>::iterator uvIt=updatedValuators.begin();uvIt!=updatedValuators.end();++uvIt)
+					valuatorUpdateFlags[*uvIt]=false;
 				updatedValuators.clear();
 				}
 			
@@ -36,6 +36,7 @@ class ConfigurationFile;
 namespace Vrui {
 class BatteryState;
 class HMDConfiguration;
+class VRDeviceSharedState;
 }
 
 class VRDeviceServer:public VRDeviceManager::VRStreamer
@@ -58,6 +59,7 @@ class VRDeviceServer:public VRDeviceManager::VRStreamer
 		bool clientExpectsValidFlags; // Flag whether the connected client expects to receive tracker valid flags
 		bool active; // Flag whether the client is currently active
 		bool streaming; // Flag whether client is currently in streaming mode
+		int sharedStateSlot; // Index of the client's update notification slot in the shared device state, or -1 if the client receives state updates through its pipe
 		
 		/* Constructors and destructors: */
 		ClientState(VRDeviceServer* sServer,Comm::ListeningTCPSocket& listenSocket); // Accepts next incoming connection on given listening socket and establishes VR device connection
@@ -99,12 +101,17 @@ class VRDeviceServer:public VRDeviceManager::VRStreamer
 	Threads::EventDispatcher dispatcher; // Event dispatcher to handle communication with multiple clients in parallel
 	Comm::ListeningTCPSocket listenSocket; // Main socket the server listens on for incoming connections
 	ClientStateList clientStates; // List of currently connected clients
+	Vrui::VRDeviceSharedState* sharedState; // Device state shared with local clients via shared memory, or null
+	unsigned int sharedStateSlotMask; // Bit mask of allocated client update notification slots in the shared device state
 	int numActiveClients; // Number of clients that are currently active
 	int numStreamingClients; // Number of clients that are currently streaming
 	bool haveUpdates; // Flag if any device state components have been updated since last status update was sent
 	std::vector<int> updatedTrackers; // List of trackers that have been updated since last status update was sent
 	std::vector<int> updatedButtons; // List of buttons that have been updated since last status update was sent
 	std::vector<int> updatedValuators; // List of valuators that have been updated since last status update was sent
+	std::vector<bool> trackerUpdateFlags; // Flags whether each tracker is in the list of updated trackers
+	std::vector<bool> buttonUpdateFlags; // Flags whether each button is in the list of updated buttons
+	std::vector<bool> valuatorUpdateFlags; // Flags whether each valuator is in the list of updated valuators
 	unsigned int managerTrackerStateVersion; // Version number of tracker states in device manager
 	unsigned int streamingTrackerStateVersion; // Version number of tracker states most recently sent to streaming clients
 	unsigned int managerBatteryStateVersion; // Version number of device battery states in device manager
@@ -116,6 +123,10 @@ class VRDeviceServer:public VRDeviceManager::VRStreamer
 	HMDConfigurationVersions* hmdConfigurationVersions; // Array of HMD configuration version numbers
 	
 	/* Private methods: */
+	bool isStateUpdatePending(void) const // Returns true if the run loop has already been woken up to send device state updates that have not been sent yet
+		{
+		return haveUpdates||streamingTrackerStateVersion!=managerTrackerStateVersion;
+		}
 	static bool newConnectionCallback(Threads::EventDispatcher::ListenerKey eventKey,int eventType,void* userData); // Callback called when a connection attempt is made at the listening socket
 	void disconnectClient(ClientState* client,bool removeListener,bool removeFromList); // Disconnects the given client due to a communication error; removes listener and/or dead client from list if respective flags are true
 	static bool clientMessageCallback(Threads::EventDispatcher::ListenerKey eventKey,int eventType,void* userData); // Callback called when a message from a client arrives
@@ -23,8 +23,10 @@ Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <VRDeviceDaemon/VRDevices/DummyDevice.h>
 
 #include <unistd.h>
+#include <stdio.h>
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
+#include <Realtime/Time.h>
 #include <Geometry/GeometryValueCoders.h>
 
 #include <VRDeviceDaemon/VRDeviceManager.h>
@@ -35,24 +37,52 @@ Methods of class DummyDevice:
 
 void DummyDevice::deviceThreadMethod(void)
 	{
+	/* Initialize load statistics: */
+	Realtime::TimePointMonotonic statisticsStart;
+	unsigned int numUpdates=0;
+	double updateTime=0.0;
+	
 	while(true)
 		{
 		/* Wait for the next status update: */
 		usleep(sleepTime);
 		
 		/* 'Update' the device manager's state: */
+		Realtime::TimePointMonotonic updateStart;
 		for(int i=0;i<state.getNumButtons();++i)
 			setButtonState(i,state.getButtonState(i));
 		for(int i=0;i<state.getNumValuators();++i)
 			setValuatorState(i,state.getValuatorState(i));
 		for(int i=0;i<state.getNumTrackers();++i)
 			setTrackerState(i,state.getTrackerState(i));
+		
+		if(statisticsInterval>0.0)
+			{
+			/* Accumulate the time spent handing the state to the device manager: */
+			updateTime+=double(updateStart.setAndDiff());
+			++numUpdates;
+			
+			/* Check if it is time to print load statistics: */
+			double elapsed=double(updateStart-statisticsStart);
+			if(elapsed>=statisticsInterval)
+				{
+				double numSamples=double(numUpdates)*double(state.getNumTrackers()+state.getNumButtons()+state.getNumValuators());
+				printf("DummyDevice: %.1f updates/s, %.0f samples/s, %.3f us per sample in device manager\n",double(numUpdates)/elapsed,numSamples/elapsed,numSamples>0.0?updateTime*1.0e6/numSamples:0.0);
+				fflush(stdout);
+				
+				/* Reset the load statistics: */
+				statisticsStart=updateStart;
+				numUpdates=0;
+				updateTime=0.0;
+				}
+			}
 		}
 	}
 
 DummyDevice::DummyDevice(VRDevice::Factory* sFactory,VRDeviceManager* sDeviceManager,Misc::ConfigurationFile& configFile)
 	:VRDevice(sFactory,sDeviceManager,configFile),
-	 sleepTime(configFile.retrieveValue<int>("./sleepTime"))
+	 sleepTime(configFile.retrieveValue<int>("./sleepTime")),
+	 statisticsInterval(configFile.retrieveValue<double>("./statisticsInterval",0.0))
 	{
 	/* Read device layout: */
 	int numTrackers=configFile.retrieveValue<int>("./numTrackers",0);
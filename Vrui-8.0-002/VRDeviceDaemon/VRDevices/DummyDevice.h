@@ -33,6 +33,7 @@ class DummyDevice:public VRDevice
 	private:
 	Vrui::VRDeviceState state; // State of all simulated devices
 	unsigned long sleepTime; // Time between "state updates" in microseconds
+	double statisticsInterval; // Interval between printed load statistics in seconds, or 0 to disable load statistics
 	
 	/* Protected methods: */
 	virtual void deviceThreadMethod(void);
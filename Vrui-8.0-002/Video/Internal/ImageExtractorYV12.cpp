@@ -24,7 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <Video/FrameBuffer.h>
-#include <Video/Colorspaces.h>
+#include <Video/Internal/YpCbCrRowConverters.h>
 
 namespace Video {
 
@@ -54,60 +54,22 @@ void ImageExtractorYV12::extractGrey(const FrameBuffer* frame,void* image)
 	unsigned char* gRowPtr=static_cast<unsigned char*>(image);
 	gRowPtr+=(size[1]-1)*size[0];
 	for(unsigned int y=0;y<size[1];++y,rRowPtr+=planes[0].stride,gRowPtr-=size[0])
-		{
-		const unsigned char* rPtr=rRowPtr;
-		unsigned char* gPtr=gRowPtr;
-		for(unsigned int x=0;x<size[0];++x,++rPtr,++gPtr)
-			{
-			/* Convert from Y' to Y: */
-			if(*rPtr<=16)
-				*gPtr=0;
-			else if(*rPtr>=236)
-				*gPtr=255;
-			else
-				*gPtr=(unsigned char)(((int(rPtr[0])-16)*256)/220);
-			}
-		}
+		YpCbCrRowConverters::planarToY(rRowPtr,size[0],gRowPtr);
 	}
 
 void ImageExtractorYV12::extractRGB(const FrameBuffer* frame,void* image)
 	{
-	/* Convert the frame from Y'CbCr 4:2:0 to RGB by processing blocks of 2x2 pixels: */
+	/* Convert the frame from Y'CbCr 4:2:0 to RGB by processing pairs of pixel rows sharing the same Cb and Cr rows: */
 	unsigned char* resultRowPtr=static_cast<unsigned char*>(image)+(size[1]-1)*size[0]*3;
 	const unsigned char* ypRowPtr=frame->start+planes[0].offset;
 	const unsigned char* cbRowPtr=frame->start+planes[1].offset;
 	const unsigned char* crRowPtr=frame->start+planes[2].offset;
 	for(unsigned int y=0;y<size[1];y+=2)
 		{
-		unsigned char* resultPtr=resultRowPtr;
-		const unsigned char* ypPtr=ypRowPtr;
-		const unsigned char* cbPtr=cbRowPtr;
-		const unsigned char* crPtr=crRowPtr;
-		for(unsigned int x=0;x<size[0];x+=2)
-			{
-			/* Convert the four pixels in the 2x2 block from Y'CbCr to RGB: */
-			unsigned char ypcbcr[3];
-			ypcbcr[0]=ypPtr[0];
-			ypcbcr[1]=*cbPtr;
-			ypcbcr[2]=*crPtr;
-			ypcbcrToRgb(ypcbcr,resultPtr);
-			
-			ypcbcr[0]=ypPtr[1];
-			ypcbcrToRgb(ypcbcr,resultPtr+3);
-			
-			ypcbcr[0]=ypPtr[planes[0].stride];
-			ypcbcrToRgb(ypcbcr,resultPtr-size[0]*3);
-			
-			ypcbcr[0]=ypPtr[planes[0].stride+1];
-			ypcbcrToRgb(ypcbcr,resultPtr-size[0]*3+3);
-			
-			/* Go to the next pixel: */
-			resultPtr+=2*3;
-			ypPtr+=2;
-			++cbPtr;
-			++crPtr;
-			}
-
+		/* Convert the two pixel rows: */
+		YpCbCrRowConverters::planarToRGB(ypRowPtr,cbRowPtr,crRowPtr,size[0],resultRowPtr);
+		YpCbCrRowConverters::planarToRGB(ypRowPtr+planes[0].stride,cbRowPtr,crRowPtr,size[0],resultRowPtr-size[0]*3);
+		
 		/* Go to the next row: */
 		resultRowPtr-=2*size[0]*3;
 		ypRowPtr+=2*planes[0].stride;
@@ -118,52 +80,17 @@ void ImageExtractorYV12::extractRGB(const FrameBuffer* frame,void* image)
 
 void ImageExtractorYV12::extractYpCbCr(const FrameBuffer* frame,void* image)
 	{
-	/* Convert the frame from Y'CbCr 4:2:0 to Y'CbCr by processing blocks of 2x2 pixels: */
+	/* Convert the frame from Y'CbCr 4:2:0 to Y'CbCr by processing pairs of pixel rows sharing the same Cb and Cr rows: */
 	unsigned char* resultRowPtr=static_cast<unsigned char*>(image)+(size[1]-1)*size[0]*3;
 	const unsigned char* ypRowPtr=frame->start+planes[0].offset;
 	const unsigned char* cbRowPtr=frame->start+planes[1].offset;
 	const unsigned char* crRowPtr=frame->start+planes[2].offset;
 	for(unsigned int y=0;y<size[1];y+=2)
 		{
-		unsigned char* result0Ptr=resultRowPtr;
-		unsigned char* result1Ptr=resultRowPtr-size[0]*3;
-		const unsigned char* yp0Ptr=ypRowPtr;
-		const unsigned char* yp1Ptr=ypRowPtr+planes[0].stride;
-		const unsigned char* cbPtr=cbRowPtr;
-		const unsigned char* crPtr=crRowPtr;
-		for(unsigned int x=0;x<size[0];x+=2)
-			{
-			/* Get the cb and cr components shared by the 2x2 block: */
-			unsigned char ypcbcr[3];
-			ypcbcr[1]=*cbPtr;
-			ypcbcr[2]=*crPtr;
-			
-			/* Create the 2x2 block's 4 pixels: */
-			ypcbcr[0]=yp0Ptr[0];
-			for(int i=0;i<3;++i)
-				result0Ptr[i]=ypcbcr[i];
-			
-			ypcbcr[0]=yp0Ptr[1];
-			for(int i=0;i<3;++i)
-				result0Ptr[3+i]=ypcbcr[i];
-			
-			ypcbcr[0]=yp1Ptr[0];
-			for(int i=0;i<3;++i)
-				result1Ptr[i]=ypcbcr[i];
-			
-			ypcbcr[0]=yp1Ptr[1];
-			for(int i=0;i<3;++i)
-				result1Ptr[3+i]=ypcbcr[i];
-			
-			/* Go to the next pixel: */
-			result0Ptr+=2*3;
-			result1Ptr+=2*3;
-			yp0Ptr+=2;
-			yp1Ptr+=2;
-			++cbPtr;
-			++crPtr;
-			}
-
+		/* Convert the two pixel rows: */
+		YpCbCrRowConverters::planarToYpCbCr(ypRowPtr,cbRowPtr,crRowPtr,size[0],resultRowPtr);
+		YpCbCrRowConverters::planarToYpCbCr(ypRowPtr+planes[0].stride,cbRowPtr,crRowPtr,size[0],resultRowPtr-size[0]*3);
+		
 		/* Go to the next row: */
 		resultRowPtr-=2*size[0]*3;
 		ypRowPtr+=2*planes[0].stride;
@@ -0,0 +1,708 @@
+/***********************************************************************
+YpCbCrRowConverters - Functions to convert single pixel rows of
+subsampled Y'CbCr video frames to grey, RGB, or full Y'CbCr images,
+using vectorized implementations selected at run-time where available.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Basic Video Library (Video).
+
+The Basic Video Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The Basic Video Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Basic Video Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Video/Internal/YpCbCrRowConverters.h>
+
+#include <Video/Colorspaces.h>
+
+#if defined(__GNUC__)&&(defined(__x86_64__)||defined(__i386__))
+#define VIDEO_YPCBCRROWCONVERTERS_X86 1
+#include <immintrin.h>
+#define VIDEO_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define VIDEO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Video {
+
+namespace YpCbCrRowConverters {
+
+namespace {
+
+/**********************************************************************
+Scalar converters. Each converter processes the pixels from the given
+start index to the end of the row, and also handles the remaining pixels
+of rows processed by the vectorized converters.
+**********************************************************************/
+
+inline unsigned char ypToY(unsigned char yp) // Converts a single Y' value to Y
+	{
+	if(yp<=16)
+		return 0;
+	else if(yp>=236)
+		return 255;
+	else
+		return (unsigned char)(((int(yp)-16)*256)/220);
+	}
+
+void packedToYScalar(const unsigned char* row,PackedLayout layout,unsigned int x,unsigned int width,unsigned char* y)
+	{
+	const unsigned char* rPtr=row+x*2+(layout==YPCBYPCR?0:1);
+	for(;x<width;++x,rPtr+=2)
+		y[x]=ypToY(*rPtr);
+	}
+
+void packedToRGBScalar(const unsigned char* row,PackedLayout layout,unsigned int x,unsigned int width,unsigned char* rgb)
+	{
+	/* Get the byte offsets of the pixel pair components: */
+	int yp0=layout==YPCBYPCR?0:1;
+	int cb=layout==YPCBYPCR?1:0;
+	
+	const unsigned char* rPtr=row+x*2;
+	unsigned char* cPtr=rgb+x*3;
+	for(;x<width;x+=2,rPtr+=4,cPtr+=2*3)
+		{
+		/* Convert the pixel pair: */
+		unsigned char ypcbcr[3];
+		ypcbcr[0]=rPtr[yp0];
+		ypcbcr[1]=rPtr[cb];
+		ypcbcr[2]=rPtr[cb+2];
+		ypcbcrToRgb(ypcbcr,cPtr);
+		ypcbcr[0]=rPtr[yp0+2];
+		ypcbcrToRgb(ypcbcr,cPtr+3);
+		}
+	}
+
+void packedToYpCbCrScalar(const unsigned char* row,PackedLayout layout,unsigned int x,unsigned int width,unsigned char* ypcbcr)
+	{
+	/* Get the byte offsets of the pixel pair components: */
+	int yp0=layout==YPCBYPCR?0:1;
+	int cb=layout==YPCBYPCR?1:0;
+	
+	const unsigned char* rPtr=row+x*2;
+	unsigned char* cPtr=ypcbcr+x*3;
+	for(;x<width;x+=2,rPtr+=4,cPtr+=2*3)
+		{
+		/* Unpack the pixel pair: */
+		cPtr[0]=rPtr[yp0];
+		cPtr[1]=rPtr[cb];
+		cPtr[2]=rPtr[cb+2];
+		cPtr[3+0]=rPtr[yp0+2];
+		cPtr[3+1]=rPtr[cb];
+		cPtr[3+2]=rPtr[cb+2];
+		}
+	}
+
+void packedToPlanarScalar(const unsigned char* row,PackedLayout layout,unsigned int x,unsigned int width,unsigned char* yp,unsigned char* c,bool keepCr)
+	{
+	/* Get the byte offsets of the pixel pair components: */
+	int yp0=layout==YPCBYPCR?0:1;
+	int cc=(layout==YPCBYPCR?1:0)+(keepCr?2:0);
+	
+	const unsigned char* rPtr=row+x*2;
+	for(;x<width;x+=2,rPtr+=4)
+		{
+		/* Split the pixel pair: */
+		yp[x]=rPtr[yp0];
+		yp[x+1]=rPtr[yp0+2];
+		c[x/2]=rPtr[cc];
+		}
+	}
+
+void planarToYScalar(const unsigned char* yp,unsigned int x,unsigned int width,unsigned char* y)
+	{
+	for(;x<width;++x)
+		y[x]=ypToY(yp[x]);
+	}
+
+void planarToRGBScalar(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int x,unsigned int width,unsigned char* rgb)
+	{
+	unsigned char* cPtr=rgb+x*3;
+	for(;x<width;x+=2,cPtr+=2*3)
+		{
+		/* Convert the pixel pair: */
+		unsigned char ypcbcr[3];
+		ypcbcr[0]=yp[x];
+		ypcbcr[1]=cb[x/2];
+		ypcbcr[2]=cr[x/2];
+		ypcbcrToRgb(ypcbcr,cPtr);
+		ypcbcr[0]=yp[x+1];
+		ypcbcrToRgb(ypcbcr,cPtr+3);
+		}
+	}
+
+void planarToYpCbCrScalar(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int x,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned char* cPtr=ypcbcr+x*3;
+	for(;x<width;x+=2,cPtr+=2*3)
+		{
+		/* Unpack the pixel pair: */
+		cPtr[0]=yp[x];
+		cPtr[1]=cb[x/2];
+		cPtr[2]=cr[x/2];
+		cPtr[3+0]=yp[x+1];
+		cPtr[3+1]=cb[x/2];
+		cPtr[3+2]=cr[x/2];
+		}
+	}
+
+#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+
+/**********************************************************************
+Vectorized converters. The Y'CbCr to RGB conversion splits the 16-bit
+fixed-point coefficients of ypcbcrToRgb into an integer part, which is
+applied with 16-bit arithmetic, and a fractional part, which is applied
+with exact 32-bit multiply-adds, such that the rounded and clamped
+results match clampFixed16 for all inputs:
+  R=y+2v+((y*10773-v*26475+32768)>>16)
+  G=y-v+((y*10773-u*25675+v*12257+32768)>>16)
+  B=y+2u+((y*10773+u*1130+32768)>>16)
+The Y' to Y conversion ((y'-16)*256)/220 is calculated exactly as
+d+((d*10728)>>16) with d=y'-16 for all d in [0, 220), and saturates to
+255 for larger d.
+**********************************************************************/
+
+inline int coefficientPair(int c0,int c1) // Returns a 32-bit word containing two 16-bit multiply-add coefficients
+	{
+	return int((unsigned int)(c0&0xffff)|((unsigned int)(c1&0xffff)<<16));
+	}
+
+/* SSSE3 converters processing 16 pixels at a time: */
+
+VIDEO_TARGET_SSSE3 inline void unpackPacked(const unsigned char* src,PackedLayout layout,__m128i& yp,__m128i& cb,__m128i& cr) // Unpacks 16 packed pixels into Y' and horizontally duplicated Cb and Cr
+	{
+	__m128i in0=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+	__m128i in1=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+16));
+	__m128i lowMask=_mm_set1_epi16(0x00ff);
+	__m128i c;
+	if(layout==YPCBYPCR)
+		{
+		yp=_mm_packus_epi16(_mm_and_si128(in0,lowMask),_mm_and_si128(in1,lowMask));
+		c=_mm_packus_epi16(_mm_srli_epi16(in0,8),_mm_srli_epi16(in1,8));
+		}
+	else
+		{
+		yp=_mm_packus_epi16(_mm_srli_epi16(in0,8),_mm_srli_epi16(in1,8));
+		c=_mm_packus_epi16(_mm_and_si128(in0,lowMask),_mm_and_si128(in1,lowMask));
+		}
+	
+	/* Duplicate the interleaved chroma values into both bytes of each 16-bit word: */
+	cb=_mm_and_si128(c,lowMask);
+	cb=_mm_or_si128(cb,_mm_slli_epi16(cb,8));
+	cr=_mm_srli_epi16(c,8);
+	cr=_mm_or_si128(cr,_mm_slli_epi16(cr,8));
+	}
+
+VIDEO_TARGET_SSSE3 inline __m128i convertY(__m128i yp) // Converts 16 Y' values to Y
+	{
+	__m128i zero=_mm_setzero_si128();
+	__m128i scale=_mm_set1_epi16(10728);
+	__m128i d=_mm_subs_epu8(yp,_mm_set1_epi8(16));
+	__m128i d0=_mm_unpacklo_epi8(d,zero);
+	__m128i d1=_mm_unpackhi_epi8(d,zero);
+	d0=_mm_add_epi16(d0,_mm_mulhi_epu16(d0,scale));
+	d1=_mm_add_epi16(d1,_mm_mulhi_epu16(d1,scale));
+	return _mm_packus_epi16(d0,d1);
+	}
+
+VIDEO_TARGET_SSSE3 inline __m128i roundFraction(__m128i sum) // Rounds four 16.16 fixed-point fractions to integers
+	{
+	return _mm_srai_epi32(_mm_add_epi32(sum,_mm_set1_epi32(32768)),16);
+	}
+
+VIDEO_TARGET_SSSE3 inline void convertRGB(__m128i yp,__m128i cb,__m128i cr,__m128i& r,__m128i& g,__m128i& b) // Converts 16 Y'CbCr pixels to RGB
+	{
+	__m128i zero=_mm_setzero_si128();
+	__m128i cR=_mm_set1_epi32(coefficientPair(10773,-26475));
+	__m128i cGu=_mm_set1_epi32(coefficientPair(10773,-25675));
+	__m128i cGv=_mm_set1_epi32(coefficientPair(0,12257));
+	__m128i cB=_mm_set1_epi32(coefficientPair(10773,1130));
+	__m128i yOffset=_mm_set1_epi16(16);
+	__m128i cOffset=_mm_set1_epi16(128);
+	
+	__m128i rgb[3][2];
+	for(int half=0;half<2;++half)
+		{
+		/* Convert the half's components to signed 16-bit YUV: */
+		__m128i y,u,v;
+		if(half==0)
+			{
+			y=_mm_unpacklo_epi8(yp,zero);
+			u=_mm_unpacklo_epi8(cb,zero);
+			v=_mm_unpacklo_epi8(cr,zero);
+			}
+		else
+			{
+			y=_mm_unpackhi_epi8(yp,zero);
+			u=_mm_unpackhi_epi8(cb,zero);
+			v=_mm_unpackhi_epi8(cr,zero);
+			}
+		y=_mm_sub_epi16(y,yOffset);
+		u=_mm_sub_epi16(u,cOffset);
+		v=_mm_sub_epi16(v,cOffset);
+		
+		/* Calculate the fractional parts from (y, u) and (y, v) pairs: */
+		__m128i yu0=_mm_unpacklo_epi16(y,u);
+		__m128i yu1=_mm_unpackhi_epi16(y,u);
+		__m128i yv0=_mm_unpacklo_epi16(y,v);
+		__m128i yv1=_mm_unpackhi_epi16(y,v);
+		__m128i rf=_mm_packs_epi32(roundFraction(_mm_madd_epi16(yv0,cR)),roundFraction(_mm_madd_epi16(yv1,cR)));
+		__m128i gf=_mm_packs_epi32(roundFraction(_mm_add_epi32(_mm_madd_epi16(yu0,cGu),_mm_madd_epi16(yv0,cGv))),roundFraction(_mm_add_epi32(_mm_madd_epi16(yu1,cGu),_mm_madd_epi16(yv1,cGv))));
+		__m128i bf=_mm_packs_epi32(roundFraction(_mm_madd_epi16(yu0,cB)),roundFraction(_mm_madd_epi16(yu1,cB)));
+		
+		/* Add the integer parts: */
+		rgb[0][half]=_mm_add_epi16(_mm_add_epi16(y,_mm_add_epi16(v,v)),rf);
+		rgb[1][half]=_mm_add_epi16(_mm_sub_epi16(y,v),gf);
+		rgb[2][half]=_mm_add_epi16(_mm_add_epi16(y,_mm_add_epi16(u,u)),bf);
+		}
+	
+	/* Clamp the results to [0, 255]: */
+	r=_mm_packus_epi16(rgb[0][0],rgb[0][1]);
+	g=_mm_packus_epi16(rgb[1][0],rgb[1][1]);
+	b=_mm_packus_epi16(rgb[2][0],rgb[2][1]);
+	}
+
+VIDEO_TARGET_SSSE3 inline void storeInterleaved(unsigned char* dst,__m128i c0,__m128i c1,__m128i c2) // Stores 16 three-component pixels from three component vectors
+	{
+	__m128i out0=_mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(c0,_mm_setr_epi8(0,-1,-1,1,-1,-1,2,-1,-1,3,-1,-1,4,-1,-1,5)),
+		_mm_shuffle_epi8(c1,_mm_setr_epi8(-1,0,-1,-1,1,-1,-1,2,-1,-1,3,-1,-1,4,-1,-1))),
+		_mm_shuffle_epi8(c2,_mm_setr_epi8(-1,-1,0,-1,-1,1,-1,-1,2,-1,-1,3,-1,-1,4,-1)));
+	__m128i out1=_mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(c0,_mm_setr_epi8(-1,-1,6,-1,-1,7,-1,-1,8,-1,-1,9,-1,-1,10,-1)),
+		_mm_shuffle_epi8(c1,_mm_setr_epi8(5,-1,-1,6,-1,-1,7,-1,-1,8,-1,-1,9,-1,-1,10))),
+		_mm_shuffle_epi8(c2,_mm_setr_epi8(-1,5,-1,-1,6,-1,-1,7,-1,-1,8,-1,-1,9,-1,-1)));
+	__m128i out2=_mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(c0,_mm_setr_epi8(-1,11,-1,-1,12,-1,-1,13,-1,-1,14,-1,-1,15,-1,-1)),
+		_mm_shuffle_epi8(c1,_mm_setr_epi8(-1,-1,11,-1,-1,12,-1,-1,13,-1,-1,14,-1,-1,15,-1))),
+		_mm_shuffle_epi8(c2,_mm_setr_epi8(10,-1,-1,11,-1,-1,12,-1,-1,13,-1,-1,14,-1,-1,15)));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst),out0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+16),out1);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+32),out2);
+	}
+
+VIDEO_TARGET_SSSE3 inline void loadPlanar(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,__m128i& ypv,__m128i& cbv,__m128i& crv) // Loads 16 planar pixels into Y' and horizontally duplicated Cb and Cr
+	{
+	ypv=_mm_loadu_si128(reinterpret_cast<const __m128i*>(yp));
+	cbv=_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cb));
+	cbv=_mm_unpacklo_epi8(cbv,cbv);
+	crv=_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cr));
+	crv=_mm_unpacklo_epi8(crv,crv);
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int packedToYSSSE3(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* y)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		{
+		__m128i yp,cb,cr;
+		unpackPacked(row+x*2,layout,yp,cb,cr);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(y+x),convertY(yp));
+		}
+	return x;
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int packedToRGBSSSE3(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* rgb)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		{
+		__m128i yp,cb,cr,r,g,b;
+		unpackPacked(row+x*2,layout,yp,cb,cr);
+		convertRGB(yp,cb,cr,r,g,b);
+		storeInterleaved(rgb+x*3,r,g,b);
+		}
+	return x;
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int packedToYpCbCrSSSE3(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		{
+		__m128i yp,cb,cr;
+		unpackPacked(row+x*2,layout,yp,cb,cr);
+		storeInterleaved(ypcbcr+x*3,yp,cb,cr);
+		}
+	return x;
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int packedToPlanarSSSE3(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* yp,unsigned char* c,bool keepCr)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		{
+		__m128i ypv,cbv,crv;
+		unpackPacked(row+x*2,layout,ypv,cbv,crv);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(yp+x),ypv);
+		__m128i cv=_mm_and_si128(keepCr?crv:cbv,_mm_set1_epi16(0x00ff));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(c+x/2),_mm_packus_epi16(cv,cv));
+		}
+	return x;
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int planarToYSSSE3(const unsigned char* yp,unsigned int width,unsigned char* y)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(y+x),convertY(_mm_loadu_si128(reinterpret_cast<const __m128i*>(yp+x))));
+	return x;
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int planarToRGBSSSE3(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* rgb)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		{
+		__m128i ypv,cbv,crv,r,g,b;
+		loadPlanar(yp+x,cb+x/2,cr+x/2,ypv,cbv,crv);
+		convertRGB(ypv,cbv,crv,r,g,b);
+		storeInterleaved(rgb+x*3,r,g,b);
+		}
+	return x;
+	}
+
+VIDEO_TARGET_SSSE3 unsigned int planarToYpCbCrSSSE3(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned int x;
+	for(x=0;x+16<=width;x+=16)
+		{
+		__m128i ypv,cbv,crv;
+		loadPlanar(yp+x,cb+x/2,cr+x/2,ypv,cbv,crv);
+		storeInterleaved(ypcbcr+x*3,ypv,cbv,crv);
+		}
+	return x;
+	}
+
+/**********************************************************************
+AVX2 converters processing 32 pixels at a time. Most AVX2 instructions
+operate on the two 128-bit halves of their operands independently; the
+unpack and pack operations in the Y' and RGB conversions cancel out, but
+packing the de-interleaved packed pixels requires an explicit cross-lane
+permutation.
+**********************************************************************/
+
+VIDEO_TARGET_AVX2 inline void unpackPacked(const unsigned char* src,PackedLayout layout,__m256i& yp,__m256i& cb,__m256i& cr) // Unpacks 32 packed pixels into Y' and horizontally duplicated Cb and Cr
+	{
+	__m256i in0=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+	__m256i in1=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+32));
+	__m256i lowMask=_mm256_set1_epi16(0x00ff);
+	__m256i c;
+	if(layout==YPCBYPCR)
+		{
+		yp=_mm256_packus_epi16(_mm256_and_si256(in0,lowMask),_mm256_and_si256(in1,lowMask));
+		c=_mm256_packus_epi16(_mm256_srli_epi16(in0,8),_mm256_srli_epi16(in1,8));
+		}
+	else
+		{
+		yp=_mm256_packus_epi16(_mm256_srli_epi16(in0,8),_mm256_srli_epi16(in1,8));
+		c=_mm256_packus_epi16(_mm256_and_si256(in0,lowMask),_mm256_and_si256(in1,lowMask));
+		}
+	yp=_mm256_permute4x64_epi64(yp,0xd8);
+	c=_mm256_permute4x64_epi64(c,0xd8);
+	
+	/* Duplicate the interleaved chroma values into both bytes of each 16-bit word: */
+	cb=_mm256_and_si256(c,lowMask);
+	cb=_mm256_or_si256(cb,_mm256_slli_epi16(cb,8));
+	cr=_mm256_srli_epi16(c,8);
+	cr=_mm256_or_si256(cr,_mm256_slli_epi16(cr,8));
+	}
+
+VIDEO_TARGET_AVX2 inline __m256i convertY(__m256i yp) // Converts 32 Y' values to Y
+	{
+	__m256i zero=_mm256_setzero_si256();
+	__m256i scale=_mm256_set1_epi16(10728);
+	__m256i d=_mm256_subs_epu8(yp,_mm256_set1_epi8(16));
+	__m256i d0=_mm256_unpacklo_epi8(d,zero);
+	__m256i d1=_mm256_unpackhi_epi8(d,zero);
+	d0=_mm256_add_epi16(d0,_mm256_mulhi_epu16(d0,scale));
+	d1=_mm256_add_epi16(d1,_mm256_mulhi_epu16(d1,scale));
+	return _mm256_packus_epi16(d0,d1);
+	}
+
+VIDEO_TARGET_AVX2 inline __m256i roundFraction(__m256i sum) // Rounds eight 16.16 fixed-point fractions to integers
+	{
+	return _mm256_srai_epi32(_mm256_add_epi32(sum,_mm256_set1_epi32(32768)),16);
+	}
+
+VIDEO_TARGET_AVX2 inline void convertRGB(__m256i yp,__m256i cb,__m256i cr,__m256i& r,__m256i& g,__m256i& b) // Converts 32 Y'CbCr pixels to RGB
+	{
+	__m256i zero=_mm256_setzero_si256();
+	__m256i cR=_mm256_set1_epi32(coefficientPair(10773,-26475));
+	__m256i cGu=_mm256_set1_epi32(coefficientPair(10773,-25675));
+	__m256i cGv=_mm256_set1_epi32(coefficientPair(0,12257));
+	__m256i cB=_mm256_set1_epi32(coefficientPair(10773,1130));
+	__m256i yOffset=_mm256_set1_epi16(16);
+	__m256i cOffset=_mm256_set1_epi16(128);
+	
+	__m256i rgb[3][2];
+	for(int half=0;half<2;++half)
+		{
+		/* Convert the half's components to signed 16-bit YUV: */
+		__m256i y,u,v;
+		if(half==0)
+			{
+			y=_mm256_unpacklo_epi8(yp,zero);
+			u=_mm256_unpacklo_epi8(cb,zero);
+			v=_mm256_unpacklo_epi8(cr,zero);
+			}
+		else
+			{
+			y=_mm256_unpackhi_epi8(yp,zero);
+			u=_mm256_unpackhi_epi8(cb,zero);
+			v=_mm256_unpackhi_epi8(cr,zero);
+			}
+		y=_mm256_sub_epi16(y,yOffset);
+		u=_mm256_sub_epi16(u,cOffset);
+		v=_mm256_sub_epi16(v,cOffset);
+		
+		/* Calculate the fractional parts from (y, u) and (y, v) pairs: */
+		__m256i yu0=_mm256_unpacklo_epi16(y,u);
+		__m256i yu1=_mm256_unpackhi_epi16(y,u);
+		__m256i yv0=_mm256_unpacklo_epi16(y,v);
+		__m256i yv1=_mm256_unpackhi_epi16(y,v);
+		__m256i rf=_mm256_packs_epi32(roundFraction(_mm256_madd_epi16(yv0,cR)),roundFraction(_mm256_madd_epi16(yv1,cR)));
+		__m256i gf=_mm256_packs_epi32(roundFraction(_mm256_add_epi32(_mm256_madd_epi16(yu0,cGu),_mm256_madd_epi16(yv0,cGv))),roundFraction(_mm256_add_epi32(_mm256_madd_epi16(yu1,cGu),_mm256_madd_epi16(yv1,cGv))));
+		__m256i bf=_mm256_packs_epi32(roundFraction(_mm256_madd_epi16(yu0,cB)),roundFraction(_mm256_madd_epi16(yu1,cB)));
+		
+		/* Add the integer parts: */
+		rgb[0][half]=_mm256_add_epi16(_mm256_add_epi16(y,_mm256_add_epi16(v,v)),rf);
+		rgb[1][half]=_mm256_add_epi16(_mm256_sub_epi16(y,v),gf);
+		rgb[2][half]=_mm256_add_epi16(_mm256_add_epi16(y,_mm256_add_epi16(u,u)),bf);
+		}
+	
+	/* Clamp the results to [0, 255]: */
+	r=_mm256_packus_epi16(rgb[0][0],rgb[0][1]);
+	g=_mm256_packus_epi16(rgb[1][0],rgb[1][1]);
+	b=_mm256_packus_epi16(rgb[2][0],rgb[2][1]);
+	}
+
+VIDEO_TARGET_AVX2 inline void storeInterleaved(unsigned char* dst,__m256i c0,__m256i c1,__m256i c2) // Stores 32 three-component pixels from three component vectors
+	{
+	storeInterleaved(dst,_mm256_castsi256_si128(c0),_mm256_castsi256_si128(c1),_mm256_castsi256_si128(c2));
+	storeInterleaved(dst+48,_mm256_extracti128_si256(c0,1),_mm256_extracti128_si256(c1,1),_mm256_extracti128_si256(c2,1));
+	}
+
+VIDEO_TARGET_AVX2 inline void loadPlanar(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,__m256i& ypv,__m256i& cbv,__m256i& crv) // Loads 32 planar pixels into Y' and horizontally duplicated Cb and Cr
+	{
+	ypv=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(yp));
+	cbv=_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cb)));
+	cbv=_mm256_or_si256(cbv,_mm256_slli_epi16(cbv,8));
+	crv=_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cr)));
+	crv=_mm256_or_si256(crv,_mm256_slli_epi16(crv,8));
+	}
+
+VIDEO_TARGET_AVX2 unsigned int packedToYAVX2(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* y)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		{
+		__m256i yp,cb,cr;
+		unpackPacked(row+x*2,layout,yp,cb,cr);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(y+x),convertY(yp));
+		}
+	return x;
+	}
+
+VIDEO_TARGET_AVX2 unsigned int packedToRGBAVX2(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* rgb)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		{
+		__m256i yp,cb,cr,r,g,b;
+		unpackPacked(row+x*2,layout,yp,cb,cr);
+		convertRGB(yp,cb,cr,r,g,b);
+		storeInterleaved(rgb+x*3,r,g,b);
+		}
+	return x;
+	}
+
+VIDEO_TARGET_AVX2 unsigned int packedToYpCbCrAVX2(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		{
+		__m256i yp,cb,cr;
+		unpackPacked(row+x*2,layout,yp,cb,cr);
+		storeInterleaved(ypcbcr+x*3,yp,cb,cr);
+		}
+	return x;
+	}
+
+VIDEO_TARGET_AVX2 unsigned int packedToPlanarAVX2(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* yp,unsigned char* c,bool keepCr)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		{
+		__m256i ypv,cbv,crv;
+		unpackPacked(row+x*2,layout,ypv,cbv,crv);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(yp+x),ypv);
+		__m256i cv=_mm256_and_si256(keepCr?crv:cbv,_mm256_set1_epi16(0x00ff));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(c+x/2),_mm_packus_epi16(_mm256_castsi256_si128(cv),_mm256_extracti128_si256(cv,1)));
+		}
+	return x;
+	}
+
+VIDEO_TARGET_AVX2 unsigned int planarToYAVX2(const unsigned char* yp,unsigned int width,unsigned char* y)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(y+x),convertY(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(yp+x))));
+	return x;
+	}
+
+VIDEO_TARGET_AVX2 unsigned int planarToRGBAVX2(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* rgb)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		{
+		__m256i ypv,cbv,crv,r,g,b;
+		loadPlanar(yp+x,cb+x/2,cr+x/2,ypv,cbv,crv);
+		convertRGB(ypv,cbv,crv,r,g,b);
+		storeInterleaved(rgb+x*3,r,g,b);
+		}
+	return x;
+	}
+
+VIDEO_TARGET_AVX2 unsigned int planarToYpCbCrAVX2(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned int x;
+	for(x=0;x+32<=width;x+=32)
+		{
+		__m256i ypv,cbv,crv;
+		loadPlanar(yp+x,cb+x/2,cr+x/2,ypv,cbv,crv);
+		storeInterleaved(ypcbcr+x*3,ypv,cbv,crv);
+		}
+	return x;
+	}
+
+#endif
+
+/**********************************************************************
+Run-time selection of the converter implementation. Since the selected
+implementation is a statically-initialized constant, converters called
+before it is initialized use the scalar implementation.
+**********************************************************************/
+
+enum Implementation
+	{
+	SCALAR=0,SSSE3,AVX2
+	};
+
+Implementation selectImplementation(void)
+	{
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		return AVX2;
+	if(__builtin_cpu_supports("ssse3"))
+		return SSSE3;
+	#endif
+	
+	return SCALAR;
+	}
+
+const Implementation implementation=selectImplementation();
+
+}
+
+/*********************************************
+Namespace-global functions of YpCbCrRowConverters:
+*********************************************/
+
+void packedToY(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* y)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=packedToYAVX2(row,layout,width,y);
+	else if(implementation==SSSE3)
+		x=packedToYSSSE3(row,layout,width,y);
+	#endif
+	packedToYScalar(row,layout,x,width,y);
+	}
+
+void packedToRGB(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* rgb)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=packedToRGBAVX2(row,layout,width,rgb);
+	else if(implementation==SSSE3)
+		x=packedToRGBSSSE3(row,layout,width,rgb);
+	#endif
+	packedToRGBScalar(row,layout,x,width,rgb);
+	}
+
+void packedToYpCbCr(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=packedToYpCbCrAVX2(row,layout,width,ypcbcr);
+	else if(implementation==SSSE3)
+		x=packedToYpCbCrSSSE3(row,layout,width,ypcbcr);
+	#endif
+	packedToYpCbCrScalar(row,layout,x,width,ypcbcr);
+	}
+
+void packedToPlanar(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* yp,unsigned char* c,bool keepCr)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=packedToPlanarAVX2(row,layout,width,yp,c,keepCr);
+	else if(implementation==SSSE3)
+		x=packedToPlanarSSSE3(row,layout,width,yp,c,keepCr);
+	#endif
+	packedToPlanarScalar(row,layout,x,width,yp,c,keepCr);
+	}
+
+void planarToY(const unsigned char* yp,unsigned int width,unsigned char* y)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=planarToYAVX2(yp,width,y);
+	else if(implementation==SSSE3)
+		x=planarToYSSSE3(yp,width,y);
+	#endif
+	planarToYScalar(yp,x,width,y);
+	}
+
+void planarToRGB(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* rgb)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=planarToRGBAVX2(yp,cb,cr,width,rgb);
+	else if(implementation==SSSE3)
+		x=planarToRGBSSSE3(yp,cb,cr,width,rgb);
+	#endif
+	planarToRGBScalar(yp,cb,cr,x,width,rgb);
+	}
+
+void planarToYpCbCr(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* ypcbcr)
+	{
+	unsigned int x=0;
+	#ifdef VIDEO_YPCBCRROWCONVERTERS_X86
+	if(implementation==AVX2)
+		x=planarToYpCbCrAVX2(yp,cb,cr,width,ypcbcr);
+	else if(implementation==SSSE3)
+		x=planarToYpCbCrSSSE3(yp,cb,cr,width,ypcbcr);
+	#endif
+	planarToYpCbCrScalar(yp,cb,cr,x,width,ypcbcr);
+	}
+
+}
+
+}
@@ -0,0 +1,58 @@
+/***********************************************************************
+YpCbCrRowConverters - Functions to convert single pixel rows of
+subsampled Y'CbCr video frames to grey, RGB, or full Y'CbCr images,
+using vectorized implementations selected at run-time where available.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Basic Video Library (Video).
+
+The Basic Video Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The Basic Video Library is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Basic Video Library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VIDEO_INTERNAL_YPCBCRROWCONVERTERS_INCLUDED
+#define VIDEO_INTERNAL_YPCBCRROWCONVERTERS_INCLUDED
+
+/**********************************************************************
+All converters produce results that are bit-identical to the per-pixel
+conversions in Video/Colorspaces.h and the scalar loops formerly used by
+the image extractors. Row widths must be even.
+**********************************************************************/
+
+namespace Video {
+
+namespace YpCbCrRowConverters {
+
+enum PackedLayout // Enumerated type for byte orders of packed 4:2:2 pixel pairs
+	{
+	YPCBYPCR, // Y'0 Cb Y'1 Cr, as in YUYV
+	CBYPCRYP // Cb Y'0 Cr Y'1, as in UYVY
+	};
+
+/* Converters for packed 4:2:2 pixel rows: */
+void packedToY(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* y); // Converts the row's Y' channel to Y
+void packedToRGB(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* rgb); // Converts the row to interleaved RGB
+void packedToYpCbCr(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* ypcbcr); // Converts the row to interleaved 4:4:4 Y'CbCr
+void packedToPlanar(const unsigned char* row,PackedLayout layout,unsigned int width,unsigned char* yp,unsigned char* c,bool keepCr); // Splits the row into a Y' plane row and a half-width row of either the Cb or the Cr plane
+
+/* Converters for planar 4:2:0 pixel rows: */
+void planarToY(const unsigned char* yp,unsigned int width,unsigned char* y); // Converts a Y' plane row to Y
+void planarToRGB(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* rgb); // Converts a Y' plane row and its associated half-width Cb and Cr plane rows to interleaved RGB
+void planarToYpCbCr(const unsigned char* yp,const unsigned char* cb,const unsigned char* cr,unsigned int width,unsigned char* ypcbcr); // Converts a Y' plane row and its associated half-width Cb and Cr plane rows to interleaved 4:4:4 Y'CbCr
+
+}
+
+}
+
+#endif
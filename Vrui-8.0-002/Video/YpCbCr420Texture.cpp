@@ -22,9 +22,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <Video/YpCbCr420Texture.h>
 
+#include <string.h>
 #include <GL/gl.h>
 #include <GL/Extensions/GLARBMultitexture.h>
+#include <GL/Extensions/GLARBPixelBufferObject.h>
 #include <GL/Extensions/GLARBTextureNonPowerOfTwo.h>
+#include <GL/Extensions/GLARBVertexBufferObject.h>
 #include <GL/GLContextData.h>
 #include <Video/Colorspaces.h>
 
@@ -37,6 +40,8 @@ Methods of class YpCbCr420Texture::DataItem:
 YpCbCr420Texture::DataItem::DataItem(void)
 	:npotdtSupported(GLARBTextureNonPowerOfTwo::isSupported()),
 	 shaderSupported(GLARBMultitexture::isSupported()&&GLShader::isSupported()),
+	 pboSupported(GLARBPixelBufferObject::isSupported()),
+	 bufferId(0),
 	 chromaKey(false),frameNumber(0)
 	{
 	/* Initialize optional OpenGL extensions: */
@@ -44,6 +49,13 @@ YpCbCr420Texture::DataItem::DataItem(void)
 		GLARBTextureNonPowerOfTwo::initExtension();
 	if(shaderSupported)
 		GLARBMultitexture::initExtension();
+	if(pboSupported)
+		{
+		GLARBPixelBufferObject::initExtension();
+		
+		/* Create the pixel buffer object: */
+		glGenBuffersARB(1,&bufferId);
+		}
 	
 	/* Create the texture objects: */
 	if(shaderSupported)
@@ -69,6 +81,10 @@ YpCbCr420Texture::DataItem::~DataItem(void)
 		glDeleteTextures(3,planeTextureIds);
 	else
 		glDeleteTextures(1,planeTextureIds);
+	
+	/* Destroy the pixel buffer object: */
+	if(pboSupported)
+		glDeleteBuffersARB(1,&bufferId);
 	}
 
 namespace {
@@ -162,10 +178,102 @@ void YpCbCr420Texture::DataItem::buildShader(bool newChromaKey)
 	textureSamplerLocs[2]=ypcbcr420Shader.getUniformLocation("crTextureSampler");
 	}
 
+bool YpCbCr420Texture::DataItem::updateTextureSize(int textureIndex,const unsigned int frameSize[2])
+	{
+	bool mustResize=false;
+	for(int i=0;i<2;++i)
+		{
+		/* Calculate the texture size, rounded up to the next power of two if required: */
+		unsigned int newTextureSize=frameSize[i];
+		if(!npotdtSupported)
+			for(newTextureSize=1;newTextureSize<frameSize[i];newTextureSize<<=1)
+				;
+		
+		if(textureSizes[textureIndex][i]!=newTextureSize)
+			{
+			textureSizes[textureIndex][i]=newTextureSize;
+			mustResize=true;
+			}
+		}
+	
+	return mustResize;
+	}
+
+unsigned char* YpCbCr420Texture::DataItem::mapBuffer(size_t bufferSize)
+	{
+	if(!pboSupported)
+		return 0;
+	
+	/* Orphan the buffer's previous storage, which might still be read by pending texture uploads, and map new storage: */
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,bufferId);
+	glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB,GLsizeiptrARB(bufferSize),0,GL_STREAM_DRAW_ARB);
+	unsigned char* result=static_cast<unsigned char*>(glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,GL_WRITE_ONLY_ARB));
+	if(result==0)
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,0);
+	
+	return result;
+	}
+
+bool YpCbCr420Texture::DataItem::unmapBuffer(void)
+	{
+	/* Unmap the buffer, and check if its contents were corrupted while it was mapped: */
+	if(glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB))
+		return true;
+	
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,0);
+	return false;
+	}
+
 /*********************************
 Methods of class YpCbCr420Texture:
 *********************************/
 
+void YpCbCr420Texture::convertToRgb(unsigned char* rgb) const
+	{
+	const unsigned char* ypRowPtr=planes[0].base;
+	const unsigned char* cbRowPtr=planes[1].base;
+	const unsigned char* crRowPtr=planes[2].base;
+	unsigned char* rgbRowPtr=rgb;
+	for(unsigned int y=0;y<planes[0].size[1];y+=2)
+		{
+		/* Convert two rows: */
+		const unsigned char* ypPtr=ypRowPtr;
+		const unsigned char* cbPtr=cbRowPtr;
+		const unsigned char* crPtr=crRowPtr;
+		unsigned char* rgbPtr=rgbRowPtr;
+		for(unsigned int x=0;x<planes[0].size[0];x+=2)
+			{
+			/* Convert a 2x2 pixel block: */
+			unsigned char ypcbcr[3];
+			ypcbcr[0]=ypPtr[0];
+			ypcbcr[1]=*cbPtr;
+			ypcbcr[2]=*crPtr;
+			Video::ypcbcrToRgb(ypcbcr,rgbPtr);
+			
+			ypcbcr[0]=ypPtr[1];
+			Video::ypcbcrToRgb(ypcbcr,rgbPtr+3);
+			
+			ypcbcr[0]=ypPtr[planes[0].stride];
+			Video::ypcbcrToRgb(ypcbcr,rgbPtr+planes[0].size[0]*3);
+			
+			ypcbcr[0]=ypPtr[planes[0].stride+1];
+			Video::ypcbcrToRgb(ypcbcr,rgbPtr+planes[0].size[0]*3+3);
+			
+			/* Go to the next pixel block: */
+			ypPtr+=2;
+			++cbPtr;
+			++crPtr;
+			rgbPtr+=2*3;
+			}
+		
+		/* Go to the next two rows: */
+		ypRowPtr+=planes[0].stride*2;
+		cbRowPtr+=planes[1].stride;
+		crRowPtr+=planes[2].stride;
+		rgbRowPtr+=planes[0].size[0]*2*3;
+		}
+	}
+
 YpCbCr420Texture::YpCbCr420Texture(void)
 	:GLObject(false),
 	 chromaKey(false),frameNumber(0)
@@ -255,63 +363,82 @@ void YpCbCr420Texture::install(GLContextData& contextData,GLfloat texCoord[2]) c
 	
 	if(dataItem->shaderSupported)
 		{
-		/* Bind and, if necessary, update the image plane textures: */
-		for(int i=0;i<3;++i)
+		/* Check if the image plane textures are outdated: */
+		if(dataItem->frameNumber!=frameNumber)
 			{
-			/* Bind the plane texture: */
-			glActiveTextureARB(GL_TEXTURE0_ARB+i);
-			glBindTexture(GL_TEXTURE_2D,dataItem->planeTextureIds[i]);
+			/* Set up the pixel transfer pipeline: */
+			glPixelStorei(GL_UNPACK_SKIP_ROWS,0);
+			glPixelStorei(GL_UNPACK_SKIP_PIXELS,0);
+			glPixelStorei(GL_UNPACK_ALIGNMENT,1);
 			
-			/* Check if it's outdated: */
-			if(dataItem->frameNumber!=frameNumber)
-				{
-				/* Calculate the plane's texture size: */
-				if(dataItem->npotdtSupported)
+			/* Re-allocate the plane textures if the frame size changed, before a pixel buffer is bound: */
+			for(int i=0;i<3;++i)
+				if(dataItem->updateTextureSize(i,planes[i].size))
 					{
-					dataItem->textureSizes[i][0]=planes[i].size[0];
-					dataItem->textureSizes[i][1]=planes[i].size[1];
+					glBindTexture(GL_TEXTURE_2D,dataItem->planeTextureIds[i]);
+					glTexImage2D(GL_TEXTURE_2D,0,GL_LUMINANCE8,dataItem->textureSizes[i][0],dataItem->textureSizes[i][1],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
 					}
-				else
+			
+			/* Try copying the image planes into a new pixel buffer to upload them asynchronously: */
+			size_t planeOffsets[3];
+			size_t bufferSize=0;
+			for(int i=0;i<3;++i)
+				{
+				planeOffsets[i]=bufferSize;
+				bufferSize+=size_t(planes[i].size[0])*size_t(planes[i].size[1]);
+				}
+			unsigned char* buffer=dataItem->mapBuffer(bufferSize);
+			if(buffer!=0)
+				{
+				/* Copy the image planes row by row: */
+				for(int i=0;i<3;++i)
 					{
-					/* Calculate the next power-of-two texture size: */
-					bool mustResize=false;
-					for(int j=0;j<2;++j)
-						{
-						unsigned int newTextureSize;
-						for(newTextureSize=1;newTextureSize<planes[i].size[j];newTextureSize<<=1)
-							;
-						if(dataItem->textureSizes[i][j]!=newTextureSize)
-							{
-							dataItem->textureSizes[i][j]=newTextureSize;
-							mustResize=true;
-							}
-						}
-					
-					if(mustResize)
-						{
-						/* Re-upload the texture: */
-						glTexImage2D(GL_TEXTURE_2D,0,GL_LUMINANCE8,dataItem->textureSizes[i][0],dataItem->textureSizes[i][1],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
-						}
+					const unsigned char* rowPtr=planes[i].base;
+					unsigned char* bufferRowPtr=buffer+planeOffsets[i];
+					for(unsigned int y=0;y<planes[i].size[1];++y,rowPtr+=planes[i].stride,bufferRowPtr+=planes[i].size[0])
+						memcpy(bufferRowPtr,rowPtr,planes[i].size[0]);
 					}
 				
-				/* Set up the pixel transfer pipeline: */
-				glPixelStorei(GL_UNPACK_ROW_LENGTH,planes[i].stride);
-				glPixelStorei(GL_UNPACK_SKIP_ROWS,0);
-				glPixelStorei(GL_UNPACK_SKIP_PIXELS,0);
-				glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+				/* Upload directly from the image planes if the buffer's contents were lost: */
+				if(!dataItem->unmapBuffer())
+					buffer=0;
+				}
+			
+			for(int i=0;i<3;++i)
+				{
+				/* Bind the plane texture: */
+				glActiveTextureARB(GL_TEXTURE0_ARB+i);
+				glBindTexture(GL_TEXTURE_2D,dataItem->planeTextureIds[i]);
 				
-				/* Upload the plane texture: */
-				if(dataItem->npotdtSupported)
-					glTexImage2D(GL_TEXTURE_2D,0,GL_LUMINANCE8,planes[i].size[0],planes[i].size[1],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,planes[i].base);
+				/* Upload the plane texture from the pixel buffer or directly from the image plane: */
+				if(buffer!=0)
+					{
+					glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
+					glTexSubImage2D(GL_TEXTURE_2D,0,0,0,planes[i].size[0],planes[i].size[1],GL_LUMINANCE,GL_UNSIGNED_BYTE,static_cast<const GLubyte*>(0)+planeOffsets[i]);
+					}
 				else
+					{
+					glPixelStorei(GL_UNPACK_ROW_LENGTH,planes[i].stride);
 					glTexSubImage2D(GL_TEXTURE_2D,0,0,0,planes[i].size[0],planes[i].size[1],GL_LUMINANCE,GL_UNSIGNED_BYTE,planes[i].base);
+					}
+				}
+			if(buffer!=0)
+				glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,0);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
+			
+			/* Mark the image plane textures as valid: */
+			dataItem->frameNumber=frameNumber;
+			}
+		else
+			{
+			/* Bind the image plane textures: */
+			for(int i=0;i<3;++i)
+				{
+				glActiveTextureARB(GL_TEXTURE0_ARB+i);
+				glBindTexture(GL_TEXTURE_2D,dataItem->planeTextureIds[i]);
 				}
 			}
 		glActiveTextureARB(GL_TEXTURE0_ARB);
-		glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
-		
-		/* Mark the image plane textures as valid: */
-		dataItem->frameNumber=frameNumber;
 		
 		/* Check if the shader is valid: */
 		if(dataItem->chromaKey!=chromaKey)
@@ -334,78 +461,20 @@ void YpCbCr420Texture::install(GLContextData& contextData,GLfloat texCoord[2]) c
 		/* Check if it's outdated: */
 		if(dataItem->frameNumber!=frameNumber)
 			{
-			/* Calculate the texture's size: */
-			if(dataItem->npotdtSupported)
-				{
-				dataItem->textureSizes[0][0]=planes[0].size[0];
-				dataItem->textureSizes[0][1]=planes[0].size[1];
-				}
-			else
-				{
-				/* Calculate the next power-of-two texture size: */
-				bool mustResize=false;
-				for(int j=0;j<2;++j)
-					{
-					unsigned int newTextureSize;
-					for(newTextureSize=1;newTextureSize<planes[0].size[j];newTextureSize<<=1)
-						;
-					if(dataItem->textureSizes[0][j]!=newTextureSize)
-						{
-						dataItem->textureSizes[0][j]=newTextureSize;
-						mustResize=true;
-						}
-					}
-				
-				if(mustResize)
-					{
-					/* Re-upload the texture: */
-					glTexImage2D(GL_TEXTURE_2D,0,GL_RGB8,dataItem->textureSizes[0][0],dataItem->textureSizes[0][1],0,GL_RGB,GL_UNSIGNED_BYTE,0);
-					}
-				}
+			/* Re-allocate the texture if the frame size changed: */
+			if(dataItem->updateTextureSize(0,planes[0].size))
+				glTexImage2D(GL_TEXTURE_2D,0,GL_RGB8,dataItem->textureSizes[0][0],dataItem->textureSizes[0][1],0,GL_RGB,GL_UNSIGNED_BYTE,0);
 			
-			/* Convert the Y'CbCr 4:2:0 image to a temporary RGB image: */
-			unsigned char* rgb=new unsigned char[planes[0].size[0]*planes[0].size[1]*3];
-			const unsigned char* ypRowPtr=planes[0].base;
-			const unsigned char* cbRowPtr=planes[1].base;
-			const unsigned char* crRowPtr=planes[2].base;
-			unsigned char* rgbRowPtr=rgb;
-			for(unsigned int y=0;y<planes[0].size[1];y+=2)
+			/* Convert the Y'CbCr 4:2:0 image to RGB, directly into a new pixel buffer if possible: */
+			size_t rgbSize=size_t(planes[0].size[0])*size_t(planes[0].size[1])*3;
+			unsigned char* buffer=dataItem->mapBuffer(rgbSize);
+			if(buffer!=0)
 				{
-				/* Convert two rows: */
-				const unsigned char* ypPtr=ypRowPtr;
-				const unsigned char* cbPtr=cbRowPtr;
-				const unsigned char* crPtr=crRowPtr;
-				unsigned char* rgbPtr=rgbRowPtr;
-				for(unsigned int x=0;x<planes[0].size[0];x+=2)
-					{
-					/* Convert a 2x2 pixel block: */
-					unsigned char ypcbcr[3];
-					ypcbcr[0]=ypPtr[0];
-					ypcbcr[1]=*cbPtr;
-					ypcbcr[2]=*crPtr;
-					Video::ypcbcrToRgb(ypcbcr,rgbPtr);
-					
-					ypcbcr[0]=ypPtr[1];
-					Video::ypcbcrToRgb(ypcbcr,rgbPtr+3);
-					
-					ypcbcr[0]=ypPtr[planes[0].stride];
-					Video::ypcbcrToRgb(ypcbcr,rgbPtr+planes[0].size[0]*3);
-					
-					ypcbcr[0]=ypPtr[planes[0].stride+1];
-					Video::ypcbcrToRgb(ypcbcr,rgbPtr+planes[0].size[0]*3+3);
-					
-					/* Go to the next pixel block: */
-					ypPtr+=2;
-					++cbPtr;
-					++crPtr;
-					rgbPtr+=2*3;
-					}
+				convertToRgb(buffer);
 				
-				/* Go to the next two rows: */
-				ypRowPtr+=planes[0].stride*2;
-				cbRowPtr+=planes[1].stride;
-				crRowPtr+=planes[2].stride;
-				rgbRowPtr+=planes[0].size[0]*2*3;
+				/* Fall back to a temporary RGB image if the buffer's contents were lost: */
+				if(!dataItem->unmapBuffer())
+					buffer=0;
 				}
 			
 			/* Set up the pixel transfer pipeline: */
@@ -415,13 +484,23 @@ void YpCbCr420Texture::install(GLContextData& contextData,GLfloat texCoord[2]) c
 			glPixelStorei(GL_UNPACK_ALIGNMENT,1);
 			
 			/* Upload the RGB texture: */
-			if(dataItem->npotdtSupported)
-				glTexImage2D(GL_TEXTURE_2D,0,GL_RGB8,planes[0].size[0],planes[0].size[1],0,GL_RGB,GL_UNSIGNED_BYTE,rgb);
+			if(buffer!=0)
+				{
+				/* Upload the RGB texture from the pixel buffer: */
+				glTexSubImage2D(GL_TEXTURE_2D,0,0,0,planes[0].size[0],planes[0].size[1],GL_RGB,GL_UNSIGNED_BYTE,0);
+				glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,0);
+				}
 			else
+				{
+				/* Convert the image into a temporary RGB image, upload it, and destroy it: */
+				unsigned char* rgb=new unsigned char[rgbSize];
+				convertToRgb(rgb);
 				glTexSubImage2D(GL_TEXTURE_2D,0,0,0,planes[0].size[0],planes[0].size[1],GL_RGB,GL_UNSIGNED_BYTE,rgb);
+				delete[] rgb;
+				}
 			
-			/* Destroy the temporary RGB image: */
-			delete[] rgb;
+			/* Mark the texture as valid: */
+			dataItem->frameNumber=frameNumber;
 			}
 		
 		/* Enable texturing: */
@@ -48,6 +48,8 @@ class YpCbCr420Texture:public GLObject
 		public:
 		bool npotdtSupported; // Flag whether the OpenGL context supports non-power-of-two dimension textures
 		bool shaderSupported; // Flag whether GLSL shaders are supported by OpenGL
+		bool pboSupported; // Flag whether the OpenGL context supports pixel buffer objects
+		GLuint bufferId; // ID of pixel buffer object used to stream new video frames into the texture objects
 		GLuint planeTextureIds[3]; // Texture object IDs for the Y', Cb, and Cr image planes, respectively
 		bool chromaKey; // Flag whether the currently compiled shader has chroma keying enabled
 		GLShader ypcbcr420Shader; // GLSL shader to convert textures in Y'CbCr 4:2:0 pixel format to RGB on-the-fly
@@ -61,6 +63,9 @@ class YpCbCr420Texture:public GLObject
 		
 		/* Methods: */
 		void buildShader(bool newChromaKey); // Rebuilds the rendering shader (assuming that shaders are supported) with the given chroma key setting
+		bool updateTextureSize(int textureIndex,const unsigned int frameSize[2]); // Updates the size of the given texture object to hold an image of the given size; returns true if the texture object needs to be re-allocated
+		unsigned char* mapBuffer(size_t bufferSize); // Binds the pixel buffer object and maps a new buffer of the given size for writing; returns null and unbinds if no buffer could be mapped
+		bool unmapBuffer(void); // Unmaps the bound pixel buffer object; returns false and unbinds it if the buffer's contents were lost
 		};
 	
 	/* Elements: */
@@ -69,6 +74,9 @@ class YpCbCr420Texture:public GLObject
 	ImagePlane planes[3]; // The Yp, Cb, and Cr image planes, respectively
 	unsigned int frameNumber; // Version number of the current video frame
 	
+	/* Private methods: */
+	void convertToRgb(unsigned char* rgb) const; // Converts the current video frame to packed 8-bit RGB in the given buffer
+	
 	/* Constructors and destructors: */
 	public:
 	YpCbCr420Texture(void);
@@ -0,0 +1,197 @@
+/***********************************************************************
+FrameProfiler - Class to record per-phase timestamps of Vrui's main loop
+into a lock-free ring buffer for run-time performance analysis.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#include <Vrui/FrameProfiler.h>
+
+#include <iomanip>
+#include <Misc/SizedTypes.h>
+#include <IO/File.h>
+#include <IO/OpenFile.h>
+#include <IO/OStream.h>
+
+namespace Vrui {
+
+/******************************
+Methods of class FrameProfiler:
+******************************/
+
+double FrameProfiler::elapsed(const Realtime::TimePointMonotonic& since)
+	{
+	Realtime::TimePointMonotonic now;
+	return double(now.tv_sec-since.tv_sec)+double(now.tv_nsec-since.tv_nsec)*1.0e-9;
+	}
+
+FrameProfiler::FrameProfiler(size_t sBufferSize)
+	:enabled(false),active(false),
+	 bufferSize(sBufferSize>0?sBufferSize:1),buffer(new Slot[bufferSize]),
+	 numFrames(0)
+	{
+	/* Initialize the ring buffer: */
+	for(size_t i=0;i<bufferSize;++i)
+		buffer[i].sequence=0;
+	}
+
+FrameProfiler::~FrameProfiler(void)
+	{
+	delete[] buffer;
+	}
+
+const char* FrameProfiler::getPhaseName(int phase)
+	{
+	static const char* phaseNames[NumPhases]=
+		{
+		"Events","InputDevices","InputGraph","ToolManager","Application","Render","RenderWait","SwapBuffers"
+		};
+	
+	return phase>=0&&phase<NumPhases?phaseNames[phase]:"";
+	}
+
+void FrameProfiler::startFrame(void)
+	{
+	/* Check if profiling was just enabled: */
+	if(enabled&&!active)
+		{
+		/* Reset the ring buffer and the profiling epoch: */
+		numFrames=0;
+		epoch=Realtime::TimePointMonotonic();
+		}
+	active=enabled;
+	
+	if(active)
+		{
+		/* Reset the current frame: */
+		frameStartTime=Realtime::TimePointMonotonic();
+		current.frameIndex=numFrames;
+		current.frameStart=double(frameStartTime.tv_sec-epoch.tv_sec)+double(frameStartTime.tv_nsec-epoch.tv_nsec)*1.0e-9;
+		current.frameTime=0.0;
+		for(int i=0;i<NumPhases;++i)
+			current.phaseTimes[i]=0.0;
+		current.numWindows=0;
+		for(unsigned int i=0;i<maxNumWindows;++i)
+			current.windowDrawTimes[i]=0.0;
+		current.numCulledNodes=0;
+		current.numDrawnNodes=0;
+		}
+	}
+
+void FrameProfiler::finishFrame(void)
+	{
+	if(active)
+		{
+		/* Finalize the current frame: */
+		current.frameTime=elapsed(frameStartTime);
+		current.numWindows=0;
+		for(unsigned int i=0;i<maxNumWindows;++i)
+			if(current.windowDrawTimes[i]>0.0)
+				current.numWindows=i+1;
+		
+		/* Write the current frame into its ring buffer slot under the slot's sequence lock: */
+		Slot& slot=buffer[numFrames%bufferSize];
+		slot.sequence=slot.sequence+1;
+		__sync_synchronize();
+		slot.frame=current;
+		__sync_synchronize();
+		slot.sequence=slot.sequence+1;
+		
+		/* Publish the frame: */
+		__sync_synchronize();
+		numFrames=numFrames+1;
+		}
+	}
+
+bool FrameProfiler::getFrame(unsigned int frameIndex,FrameProfiler::Frame& frame) const
+	{
+	/* Bail out if the frame has not been published yet, or has already been overwritten: */
+	unsigned int nf=numFrames;
+	if(frameIndex>=nf||nf-frameIndex>bufferSize)
+		return false;
+	
+	/* Copy the frame from its slot and check that it was not concurrently overwritten: */
+	const Slot& slot=buffer[frameIndex%bufferSize];
+	unsigned int sequence=slot.sequence;
+	__sync_synchronize();
+	if(sequence&0x1U)
+		return false;
+	frame=slot.frame;
+	__sync_synchronize();
+	return slot.sequence==sequence&&frame.frameIndex==frameIndex;
+	}
+
+void FrameProfiler::saveCSV(const char* fileName) const
+	{
+	IO::OStream csv(IO::openFile(fileName,IO::File::WriteOnly));
+	
+	/* Write the header line: */
+	csv<<"Frame,Start,FrameTime";
+	for(int phase=0;phase<NumPhases;++phase)
+		csv<<','<<getPhaseName(phase);
+	for(unsigned int i=0;i<maxNumWindows;++i)
+		csv<<",Window"<<i;
+	csv<<",CulledNodes,DrawnNodes"<<std::endl;
+	
+	/* Write all frames currently in the ring buffer, in milliseconds: */
+	csv<<std::fixed<<std::setprecision(4);
+	unsigned int nf=numFrames;
+	Frame frame;
+	for(unsigned int frameIndex=nf>bufferSize?nf-bufferSize:0;frameIndex<nf;++frameIndex)
+		if(getFrame(frameIndex,frame))
+			{
+			csv<<frame.frameIndex<<','<<frame.frameStart*1000.0<<','<<frame.frameTime*1000.0;
+			for(int phase=0;phase<NumPhases;++phase)
+				csv<<','<<frame.phaseTimes[phase]*1000.0;
+			for(unsigned int i=0;i<maxNumWindows;++i)
+				csv<<','<<frame.windowDrawTimes[i]*1000.0;
+			csv<<','<<frame.numCulledNodes<<','<<frame.numDrawnNodes<<std::endl;
+			}
+	}
+
+void FrameProfiler::saveBinary(const char* fileName) const
+	{
+	IO::FilePtr file=IO::openFile(fileName,IO::File::WriteOnly);
+	file->setEndianness(Misc::LittleEndian);
+	
+	/* Write the file header: */
+	static const char header[16]="Vrui FrameProf ";
+	file->write(header,16);
+	file->write<Misc::UInt32>(2U); // File format version
+	file->write<Misc::UInt32>(NumPhases);
+	file->write<Misc::UInt32>(maxNumWindows);
+	
+	/* Write all frames currently in the ring buffer: */
+	unsigned int nf=numFrames;
+	Frame frame;
+	for(unsigned int frameIndex=nf>bufferSize?nf-bufferSize:0;frameIndex<nf;++frameIndex)
+		if(getFrame(frameIndex,frame))
+			{
+			file->write<Misc::UInt32>(frame.frameIndex);
+			file->write<Misc::Float64>(frame.frameStart);
+			file->write<Misc::Float64>(frame.frameTime);
+			file->write<Misc::Float64>(frame.phaseTimes,NumPhases);
+			file->write<Misc::UInt32>(frame.numWindows);
+			file->write<Misc::Float64>(frame.windowDrawTimes,maxNumWindows);
+			file->write<Misc::UInt32>(frame.numCulledNodes);
+			file->write<Misc::UInt32>(frame.numDrawnNodes);
+			}
+	}
+
+}
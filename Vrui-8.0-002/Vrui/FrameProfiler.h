@@ -0,0 +1,145 @@
+/***********************************************************************
+FrameProfiler - Class to record per-phase timestamps of Vrui's main loop
+into a lock-free ring buffer for run-time performance analysis.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef VRUI_FRAMEPROFILER_INCLUDED
+#define VRUI_FRAMEPROFILER_INCLUDED
+
+#include <stddef.h>
+#include <Realtime/Time.h>
+
+namespace Vrui {
+
+class FrameProfiler
+	{
+	/* Embedded classes: */
+	public:
+	enum Phase // Enumerated type for profiled phases of a Vrui frame
+		{
+		EventHandling=0, // Handling of window, pipe, and synchronous I/O events
+		InputDevices, // Updating all input devices via the input device manager
+		InputGraph, // Updating the input graph
+		ToolManager, // Updating the tool manager
+		Application, // Calling the application's frame function
+		Render, // Drawing all windows
+		RenderWait, // Waiting for rendering to finish via glFinish or barriers
+		SwapBuffers, // Swapping all windows' buffers
+		NumPhases
+		};
+	
+	static const unsigned int maxNumWindows=16; // Maximum number of windows whose draw times are recorded individually
+	
+	struct Frame // Structure holding timing information for a single Vrui frame
+		{
+		/* Elements: */
+		public:
+		unsigned int frameIndex; // Running index of the frame since profiling was enabled
+		double frameStart; // Start time of the frame in seconds since profiling was enabled
+		double frameTime; // Total duration of the frame in seconds
+		double phaseTimes[NumPhases]; // Time spent in each frame phase in seconds
+		unsigned int numWindows; // Number of windows whose draw times were recorded
+		double windowDrawTimes[maxNumWindows]; // Time spent in each window's draw method in seconds
+		unsigned int numCulledNodes; // Number of central scene graph group nodes culled against the view frustum, summed over all windows
+		unsigned int numDrawnNodes; // Number of central scene graph nodes whose OpenGL render actions were called, summed over all windows
+		};
+	
+	private:
+	struct Slot // Structure for a ring buffer slot protected by a sequence lock
+		{
+		/* Elements: */
+		public:
+		volatile unsigned int sequence; // Sequence number; odd while the slot is being written
+		Frame frame; // The frame stored in the slot
+		};
+	
+	/* Elements: */
+	volatile bool enabled; // Flag whether profiling is requested; takes effect at the start of the next frame
+	bool active; // Flag whether the current frame is being recorded
+	size_t bufferSize; // Number of frames in the ring buffer
+	Slot* buffer; // Ring buffer of recorded frames
+	volatile unsigned int numFrames; // Total number of frames published since profiling was enabled
+	Realtime::TimePointMonotonic epoch; // Time point at which profiling was enabled
+	Realtime::TimePointMonotonic frameStartTime; // Time point at which the current frame started
+	Frame current; // The frame currently being recorded
+	
+	/* Private methods: */
+	static double elapsed(const Realtime::TimePointMonotonic& since); // Returns the time elapsed since the given time point in seconds
+	
+	/* Constructors and destructors: */
+	public:
+	FrameProfiler(size_t sBufferSize); // Creates an inactive profiler with a ring buffer of the given size
+	private:
+	FrameProfiler(const FrameProfiler& source); // Prohibit copy constructor
+	FrameProfiler& operator=(const FrameProfiler& source); // Prohibit assignment operator
+	public:
+	~FrameProfiler(void);
+	
+	/* Methods: */
+	static const char* getPhaseName(int phase); // Returns a short name for the given frame phase
+	bool isActive(void) const // Returns true if the profiler is currently recording frames
+		{
+		return enabled;
+		}
+	void setActive(bool newActive) // Enables or disables recording starting with the next frame; enabling resets the ring buffer
+		{
+		enabled=newActive;
+		}
+	size_t getBufferSize(void) const // Returns the size of the ring buffer
+		{
+		return bufferSize;
+		}
+	
+	/* Recording methods, called by the Vrui kernel; all methods except addWindowDrawTime must be called from the main thread: */
+	void startFrame(void); // Starts recording a new frame
+	void addPhaseTime(int phase,const Realtime::TimePointMonotonic& phaseStart) // Adds the time elapsed since the given time point to the given phase of the current frame
+		{
+		if(active)
+			current.phaseTimes[phase]+=elapsed(phaseStart);
+		}
+	void addWindowDrawTime(int windowIndex,const Realtime::TimePointMonotonic& drawStart) // Adds the time elapsed since the given time point to the given window's draw time; can be called from rendering threads
+		{
+		if(active&&(unsigned int)(windowIndex)<maxNumWindows)
+			current.windowDrawTimes[windowIndex]+=elapsed(drawStart);
+		}
+	void addSceneGraphCounts(unsigned int culledNodes,unsigned int drawnNodes) // Adds the given numbers of culled and drawn central scene graph nodes to the current frame; can be called from rendering threads
+		{
+		if(active)
+			{
+			__sync_add_and_fetch(&current.numCulledNodes,culledNodes);
+			__sync_add_and_fetch(&current.numDrawnNodes,drawnNodes);
+			}
+		}
+	void finishFrame(void); // Publishes the current frame into the ring buffer
+	
+	/* Query methods; can be called from any thread: */
+	unsigned int getNumFrames(void) const // Returns the total number of frames published since profiling was enabled
+		{
+		return numFrames;
+		}
+	bool getFrame(unsigned int frameIndex,Frame& frame) const; // Copies the frame of the given index into the given structure; returns false if the frame is not or no longer in the ring buffer
+	void saveCSV(const char* fileName) const; // Writes all frames currently in the ring buffer to a comma-separated text file
+	void saveBinary(const char* fileName) const; // Writes all frames currently in the ring buffer to a little-endian binary file
+	};
+
+}
+
+#endif
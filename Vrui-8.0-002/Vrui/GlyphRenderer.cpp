@@ -23,9 +23,13 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Vrui/GlyphRenderer.h>
 
 #include <string.h>
+#include <stdexcept>
+#include <Misc/PrintInteger.h>
+#include <Misc/MessageLogger.h>
 #include <Misc/ThrowStdErr.h>
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
+#include <Math/Math.h>
 #include <Geometry/Point.h>
 #include <Geometry/Ray.h>
 #include <Geometry/OrthonormalTransformation.h>
@@ -33,6 +37,14 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <GL/GLGeometryWrappers.h>
 #include <GL/GLTransformationWrappers.h>
 #include <GL/GLModels.h>
+#include <GL/GLVertexArrayParts.h>
+#include <GL/GLLightTracker.h>
+#include <GL/GLClipPlaneTracker.h>
+#include <GL/Extensions/GLARBDrawInstanced.h>
+#include <GL/Extensions/GLARBFragmentShader.h>
+#include <GL/Extensions/GLARBInstancedArrays.h>
+#include <GL/Extensions/GLARBVertexBufferObject.h>
+#include <GL/Extensions/GLARBVertexShader.h>
 #include <Images/ReadImageFile.h>
 #include <Vrui/Vrui.h>
 #include <Vrui/Viewer.h>
@@ -41,6 +53,72 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 
 namespace Vrui {
 
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+typedef Geometry::OrthonormalTransformation<GLfloat,3> GlyphTransform; // Type for transformations applied to glyph model vertices
+
+const GLuint instanceAttributeBase=8; // Index of the first of seven generic vertex attributes holding per-instance glyph data; lower indices alias fixed-function vertex attributes on some OpenGL implementations
+
+void transformVertices(std::vector<GLModelVertex>& vertices,size_t first,const GlyphTransform& transform) // Transforms all vertices in the given list starting from the given index
+	{
+	for(std::vector<GLModelVertex>::iterator vIt=vertices.begin()+first;vIt!=vertices.end();++vIt)
+		{
+		GlyphTransform::Vector normal=transform.transform(GlyphTransform::Vector(vIt->normal.getXyzw()));
+		GlyphTransform::Point position=transform.transform(GlyphTransform::Point(vIt->position.getXyzw()));
+		vIt->normal=GLModelVertex::Normal(normal.getComponents());
+		vIt->position=GLModelVertex::Position(position.getComponents());
+		}
+	}
+
+void generateGlyph(int glyphType,GLfloat glyphSize,std::vector<GLModelVertex>& vertices,std::vector<GLuint>& triangles) // Appends the vertices and triangles of a 3D glyph of given type and size to the given lists; mirrors Glyph::render
+	{
+	size_t first=vertices.size();
+	switch(glyphType)
+		{
+		case Glyph::CONE:
+			{
+			glGenerateCone(0.25f*glyphSize,glyphSize,16,vertices,triangles);
+			GlyphTransform transform=GlyphTransform::rotate(GlyphTransform::Rotation::rotateX(Math::rad(-90.0f)));
+			transform*=GlyphTransform::translate(GlyphTransform::Vector(0.0f,0.0f,-0.75f*glyphSize));
+			transformVertices(vertices,first,transform);
+			break;
+			}
+		
+		case Glyph::CUBE:
+			glGenerateCube(glyphSize,vertices,triangles);
+			break;
+		
+		case Glyph::SPHERE:
+			glGenerateSphereIcosahedron(0.5f*glyphSize,8,vertices,triangles);
+			break;
+		
+		case Glyph::CROSSBALL:
+			{
+			glGenerateSphereIcosahedron(0.4f*glyphSize,8,vertices,triangles);
+			glGenerateCylinder(0.125f*glyphSize,1.1f*glyphSize,16,vertices,triangles);
+			GlyphTransform::Rotation rotation=GlyphTransform::Rotation::rotateX(Math::rad(90.0f));
+			first=vertices.size();
+			glGenerateCylinder(0.125f*glyphSize,1.1f*glyphSize,16,vertices,triangles);
+			transformVertices(vertices,first,GlyphTransform::rotate(rotation));
+			rotation*=GlyphTransform::Rotation::rotateY(Math::rad(90.0f));
+			first=vertices.size();
+			glGenerateCylinder(0.125f*glyphSize,1.1f*glyphSize,16,vertices,triangles);
+			transformVertices(vertices,first,GlyphTransform::rotate(rotation));
+			break;
+			}
+		
+		case Glyph::BOX:
+			glGenerateWireframeCube(glyphSize,glyphSize*0.075f,glyphSize*0.15f,vertices,triangles);
+			break;
+		}
+	}
+
+}
+
 /**********************
 Methods of class Glyph:
 **********************/
@@ -197,21 +275,147 @@ Methods of class GlyphRenderer::DataItem:
 GlyphRenderer::DataItem::DataItem(GLContextData& sContextData)
 	:contextData(sContextData),
 	 glyphDisplayLists(glGenLists(Glyph::GLYPHS_END)),
-	 cursorTextureObjectId(0)
+	 cursorTextureObjectId(0),
+	 haveInstancing(GLARBDrawInstanced::isSupported()&&GLARBInstancedArrays::isSupported()&&GLARBVertexBufferObject::isSupported()&&GLARBShaderObjects::isSupported()&&GLARBVertexShader::isSupported()&&GLARBFragmentShader::isSupported()),
+	 glyphVertexBufferId(0),glyphIndexBufferId(0),instanceBufferId(0),instanceBufferSize(0),
+	 vertexShader(0),fragmentShader(0),shaderProgram(0),
+	 lightStateVersion(0),clipPlaneStateVersion(0)
 	{
 	glGenTextures(1,&cursorTextureObjectId);
+	
+	if(haveInstancing)
+		{
+		/* Initialize required OpenGL extensions: */
+		GLARBDrawInstanced::initExtension();
+		GLARBInstancedArrays::initExtension();
+		GLARBVertexBufferObject::initExtension();
+		GLARBShaderObjects::initExtension();
+		GLARBVertexShader::initExtension();
+		GLARBFragmentShader::initExtension();
+		
+		/* Create the glyph vertex and index buffers and the instance buffer: */
+		glGenBuffersARB(1,&glyphVertexBufferId);
+		glGenBuffersARB(1,&glyphIndexBufferId);
+		glGenBuffersARB(1,&instanceBufferId);
+		
+		/* Create the shader objects and attach them to the shader program: */
+		vertexShader=glCreateShaderObjectARB(GL_VERTEX_SHADER_ARB);
+		fragmentShader=glCreateShaderObjectARB(GL_FRAGMENT_SHADER_ARB);
+		shaderProgram=glCreateProgramObjectARB();
+		glAttachObjectARB(shaderProgram,vertexShader);
+		glAttachObjectARB(shaderProgram,fragmentShader);
+		}
 	}
 
 GlyphRenderer::DataItem::~DataItem(void)
 	{
 	glDeleteLists(glyphDisplayLists,Glyph::GLYPHS_END);
 	glDeleteTextures(1,&cursorTextureObjectId);
+	
+	if(glyphVertexBufferId!=0)
+		{
+		/* Destroy the buffers and shader objects: */
+		glDeleteBuffersARB(1,&glyphVertexBufferId);
+		glDeleteBuffersARB(1,&glyphIndexBufferId);
+		glDeleteBuffersARB(1,&instanceBufferId);
+		glDeleteObjectARB(vertexShader);
+		glDeleteObjectARB(fragmentShader);
+		glDeleteObjectARB(shaderProgram);
+		}
 	}
 
 /******************************
 Methods of class GlyphRenderer:
 ******************************/
 
+void GlyphRenderer::compileShader(GlyphRenderer::DataItem* dataItem) const
+	{
+	const GLLightTracker& lightTracker=*dataItem->contextData.getLightTracker();
+	const GLClipPlaneTracker& clipPlaneTracker=*dataItem->contextData.getClipPlaneTracker();
+	
+	/* Create the glyph instance vertex shader source code: */
+	std::string vertexShaderFunctions;
+	std::string vertexShaderMain="\
+	attribute vec4 instanceTransform0;\n\
+	attribute vec4 instanceTransform1;\n\
+	attribute vec4 instanceTransform2;\n\
+	attribute vec4 instanceAmbient;\n\
+	attribute vec4 instanceDiffuse;\n\
+	attribute vec4 instanceSpecular;\n\
+	attribute vec4 instanceEmission;\n\
+	\n\
+	void main()\n\
+		{\n\
+		/* Transform the vertex and its normal vector by the instance's transformation: */\n\
+		vec4 vertex=vec4(dot(instanceTransform0,gl_Vertex),dot(instanceTransform1,gl_Vertex),dot(instanceTransform2,gl_Vertex),1.0);\n\
+		vec3 normal=vec3(dot(instanceTransform0.xyz,gl_Normal),dot(instanceTransform1.xyz,gl_Normal),dot(instanceTransform2.xyz,gl_Normal));\n\
+		\n\
+		/* Transform the vertex and its normal vector to eye space: */\n\
+		vec4 vertexEc=gl_ModelViewMatrix*vertex;\n\
+		vec3 normalEc=normalize(gl_NormalMatrix*normal);\n\
+		\n\
+		/* Calculate total illumination and initialize with global ambient term: */\n\
+		vec4 ambientDiffuseAccum=gl_LightModel.ambient*instanceAmbient+instanceEmission;\n\
+		vec4 specularAccum=vec4(0.0,0.0,0.0,0.0);\n\
+		vec4 specular=vec4(instanceSpecular.rgb,0.0);\n\
+		\n\
+		/* Accumulate all enabled light sources: */\n";
+	
+	/* Create light application functions for all enabled light sources: */
+	for(int lightIndex=0;lightIndex<lightTracker.getMaxNumLights();++lightIndex)
+		if(lightTracker.getLightState(lightIndex).isEnabled())
+			{
+			/* Create the light accumulation function: */
+			vertexShaderFunctions+=lightTracker.createAccumulateLightFunction(lightIndex);
+			
+			/* Call the light application function from the vertex shader's main function: */
+			vertexShaderMain+="\
+			accumulateLight";
+			char liBuffer[12];
+			vertexShaderMain.append(Misc::print(lightIndex,liBuffer+11));
+			vertexShaderMain+="(vertexEc,normalEc,instanceAmbient,instanceDiffuse,specular,instanceSpecular.a,ambientDiffuseAccum,specularAccum);\n";
+			}
+	
+	/* Assign the final vertex color and calculate clip distances: */
+	vertexShaderMain+="\
+		\n\
+		/* Compute the final vertex color with the diffuse material's opacity: */\n\
+		gl_FrontColor=vec4((ambientDiffuseAccum+specularAccum).rgb,instanceDiffuse.a);\n\
+		\n";
+	vertexShaderMain+=clipPlaneTracker.createCalcClipDistances("vertexEc");
+	
+	/* Finalize the vertex shader's main function: */
+	vertexShaderMain+="\
+		\n\
+		/* Transform the vertex to clip space: */\n\
+		gl_Position=gl_ProjectionMatrix*vertexEc;\n\
+		}\n";
+	
+	/* Compile the vertex shader: */
+	glCompileShaderFromStrings(dataItem->vertexShader,2,vertexShaderFunctions.c_str(),vertexShaderMain.c_str());
+	
+	/* Compile the fragment shader: */
+	glCompileShaderFromStrings(dataItem->fragmentShader,1,"\
+	void main()\n\
+		{\n\
+		gl_FragColor=gl_Color;\n\
+		}\n");
+	
+	/* Bind the per-instance attributes to fixed indices and link the shader program: */
+	static const char* instanceAttributeNames[7]=
+		{
+		"instanceTransform0","instanceTransform1","instanceTransform2",
+		"instanceAmbient","instanceDiffuse","instanceSpecular","instanceEmission"
+		};
+	for(int i=0;i<7;++i)
+		glBindAttribLocationARB(dataItem->shaderProgram,instanceAttributeBase+i,instanceAttributeNames[i]);
+	glLinkAndTestShader(dataItem->shaderProgram);
+	
+	/* Mark the shader program as up-to-date: */
+	dataItem->lightStateVersion=lightTracker.getVersion();
+	dataItem->clipPlaneStateVersion=clipPlaneTracker.getVersion();
+	}
+
 GlyphRenderer::GlyphRenderer(GLfloat sGlyphSize,const std::string& cursorImageFileName,unsigned int sCursorNominalSize)
 	:GLObject(false),
 	 glyphSize(sGlyphSize),
@@ -293,6 +497,39 @@ void GlyphRenderer::initContext(GLContextData& contextData) const
 			glEndList();
 			}
 		}
+	
+	if(dataItem->haveInstancing)
+		{
+		try
+			{
+			/* Create the initial glyph instance shader program: */
+			compileShader(dataItem);
+			
+			/* Generate the vertices and triangles of all 3D glyph types: */
+			std::vector<GLModelVertex> vertices;
+			std::vector<GLuint> triangles;
+			for(int glyphType=Glyph::CONE;glyphType<=Glyph::GLYPHS_END;++glyphType)
+				{
+				dataItem->glyphIndexOffsets[glyphType]=GLsizei(triangles.size());
+				if(glyphType<Glyph::GLYPHS_END)
+					generateGlyph(glyphType,glyphSize,vertices,triangles);
+				}
+			
+			/* Upload the vertices and triangles into the glyph vertex and index buffers: */
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB,dataItem->glyphVertexBufferId);
+			glBufferDataARB(GL_ARRAY_BUFFER_ARB,vertices.size()*sizeof(GLModelVertex),&vertices[0],GL_STATIC_DRAW_ARB);
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB,0);
+			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,dataItem->glyphIndexBufferId);
+			glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB,triangles.size()*sizeof(GLuint),&triangles[0],GL_STATIC_DRAW_ARB);
+			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,0);
+			}
+		catch(const std::runtime_error& err)
+			{
+			/* Fall back to rendering glyphs individually: */
+			Misc::formattedLogWarning("Vrui::GlyphRenderer: Rendering glyphs individually due to exception %s",err.what());
+			dataItem->haveInstancing=false;
+			}
+		}
 	}
 
 void GlyphRenderer::renderGlyph(const Glyph& glyph,const OGTransform& transformation,const GlyphRenderer::DataItem* contextDataItem) const
@@ -329,4 +566,172 @@ void GlyphRenderer::renderGlyph(const Glyph& glyph,const OGTransform& transforma
 		}
 	}
 
+void GlyphRenderer::addGlyph(const Glyph& glyph,const OGTransform& transformation,GlyphRenderer::DataItem* contextDataItem) const
+	{
+	/* Check if the glyph is enabled: */
+	if(glyph.enabled)
+		{
+		/* Render cursor glyphs, or all glyphs if instancing is not available or lighting is disabled, immediately: */
+		if(glyph.glyphType==Glyph::CURSOR||!contextDataItem->haveInstancing||!contextDataItem->contextData.getLightTracker()->isLightingEnabled())
+			{
+			renderGlyph(glyph,transformation,contextDataItem);
+			return;
+			}
+		
+		/* Add a new instance to the glyph type's batch: */
+		std::vector<GlyphInstance>& batch=contextDataItem->glyphBatches[glyph.glyphType];
+		batch.push_back(GlyphInstance());
+		GlyphInstance& gi=batch.back();
+		
+		/* Store the upper three rows of the glyph's transformation matrix: */
+		for(int j=0;j<3;++j)
+			{
+			Vector axis=transformation.getRotation().getDirection(j)*transformation.getScaling();
+			for(int i=0;i<3;++i)
+				gi.transform[i][j]=GLfloat(axis[i]);
+			}
+		for(int i=0;i<3;++i)
+			gi.transform[i][3]=GLfloat(transformation.getTranslation()[i]);
+		
+		/* Store the glyph's material properties: */
+		const GLMaterial& m=glyph.glyphMaterial;
+		for(int i=0;i<4;++i)
+			{
+			gi.ambient[i]=m.ambient[i];
+			gi.diffuse[i]=m.diffuse[i];
+			gi.specular[i]=m.specular[i];
+			gi.emission[i]=m.emission[i];
+			}
+		gi.specular[3]=m.shininess;
+		}
+	}
+
+void GlyphRenderer::renderGlyphs(GlyphRenderer::DataItem* contextDataItem) const
+	{
+	/* Count the number of batched glyphs: */
+	size_t numInstances=0;
+	for(int glyphType=Glyph::CONE;glyphType<Glyph::GLYPHS_END;++glyphType)
+		numInstances+=contextDataItem->glyphBatches[glyphType].size();
+	if(numInstances==0)
+		return;
+	
+	/* Check if the shader program is up-to-date: */
+	if(contextDataItem->lightStateVersion!=contextDataItem->contextData.getLightTracker()->getVersion()||contextDataItem->clipPlaneStateVersion!=contextDataItem->contextData.getClipPlaneTracker()->getVersion())
+		{
+		try
+			{
+			/* Recompile the shader program: */
+			compileShader(contextDataItem);
+			}
+		catch(const std::runtime_error& err)
+			{
+			/* Fall back to rendering glyphs individually from now on: */
+			Misc::formattedLogWarning("Vrui::GlyphRenderer: Rendering glyphs individually due to exception %s",err.what());
+			contextDataItem->haveInstancing=false;
+			
+			/* Render the already batched glyphs individually: */
+			for(int glyphType=Glyph::CONE;glyphType<Glyph::GLYPHS_END;++glyphType)
+				{
+				std::vector<GlyphInstance>& batch=contextDataItem->glyphBatches[glyphType];
+				for(std::vector<GlyphInstance>::const_iterator giIt=batch.begin();giIt!=batch.end();++giIt)
+					{
+					/* Assemble the instance's transformation matrix in column-major order: */
+					GLfloat matrix[16];
+					for(int j=0;j<4;++j)
+						{
+						for(int i=0;i<3;++i)
+							matrix[j*4+i]=giIt->transform[i][j];
+						matrix[j*4+3]=j==3?1.0f:0.0f;
+						}
+					
+					/* Render the glyph with the instance's material properties: */
+					glPushMatrix();
+					glMultMatrixf(matrix);
+					GLfloat specular[4]={giIt->specular[0],giIt->specular[1],giIt->specular[2],1.0f};
+					glMaterialfv(GL_FRONT,GL_AMBIENT,giIt->ambient);
+					glMaterialfv(GL_FRONT,GL_DIFFUSE,giIt->diffuse);
+					glMaterialfv(GL_FRONT,GL_SPECULAR,specular);
+					glMaterialf(GL_FRONT,GL_SHININESS,giIt->specular[3]);
+					glMaterialfv(GL_FRONT,GL_EMISSION,giIt->emission);
+					glCallList(contextDataItem->glyphDisplayLists+glyphType);
+					glPopMatrix();
+					}
+				batch.clear();
+				}
+			
+			return;
+			}
+		}
+	
+	/* Upload all batched glyphs into the instance buffer, re-allocating it to avoid synchronizing with previous draw calls: */
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,contextDataItem->instanceBufferId);
+	while(contextDataItem->instanceBufferSize<numInstances)
+		contextDataItem->instanceBufferSize=contextDataItem->instanceBufferSize!=0?contextDataItem->instanceBufferSize*2:64;
+	glBufferDataARB(GL_ARRAY_BUFFER_ARB,contextDataItem->instanceBufferSize*sizeof(GlyphInstance),0,GL_STREAM_DRAW_ARB);
+	size_t firstInstance=0;
+	for(int glyphType=Glyph::CONE;glyphType<Glyph::GLYPHS_END;++glyphType)
+		{
+		const std::vector<GlyphInstance>& batch=contextDataItem->glyphBatches[glyphType];
+		if(!batch.empty())
+			{
+			glBufferSubDataARB(GL_ARRAY_BUFFER_ARB,firstInstance*sizeof(GlyphInstance),batch.size()*sizeof(GlyphInstance),&batch[0]);
+			firstInstance+=batch.size();
+			}
+		}
+	
+	/* Enable the per-instance vertex attribute arrays: */
+	for(GLuint i=instanceAttributeBase;i<instanceAttributeBase+7;++i)
+		{
+		glEnableVertexAttribArrayARB(i);
+		glVertexAttribDivisorARB(i,1);
+		}
+	
+	/* Bind the glyph vertex and index buffers: */
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,contextDataItem->glyphVertexBufferId);
+	GLVertexArrayParts::enable(GLModelVertex::getPartsMask());
+	glVertexPointer(static_cast<const GLModelVertex*>(0));
+	glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,contextDataItem->glyphIndexBufferId);
+	
+	/* Activate the shader program: */
+	glUseProgramObjectARB(contextDataItem->shaderProgram);
+	
+	/* Render each glyph type's batch with a single draw call: */
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,contextDataItem->instanceBufferId);
+	firstInstance=0;
+	for(int glyphType=Glyph::CONE;glyphType<Glyph::GLYPHS_END;++glyphType)
+		{
+		std::vector<GlyphInstance>& batch=contextDataItem->glyphBatches[glyphType];
+		if(!batch.empty())
+			{
+			/* Point the per-instance vertex attributes to the batch's range in the instance buffer: */
+			const GlyphInstance* gi=static_cast<const GlyphInstance*>(0)+firstInstance;
+			for(int i=0;i<3;++i)
+				glVertexAttribPointerARB(instanceAttributeBase+i,4,GL_FLOAT,GL_FALSE,sizeof(GlyphInstance),gi->transform[i]);
+			glVertexAttribPointerARB(instanceAttributeBase+3,4,GL_FLOAT,GL_FALSE,sizeof(GlyphInstance),gi->ambient);
+			glVertexAttribPointerARB(instanceAttributeBase+4,4,GL_FLOAT,GL_FALSE,sizeof(GlyphInstance),gi->diffuse);
+			glVertexAttribPointerARB(instanceAttributeBase+5,4,GL_FLOAT,GL_FALSE,sizeof(GlyphInstance),gi->specular);
+			glVertexAttribPointerARB(instanceAttributeBase+6,4,GL_FLOAT,GL_FALSE,sizeof(GlyphInstance),gi->emission);
+			
+			/* Draw all instances of the glyph type: */
+			const GLuint* firstIndex=static_cast<const GLuint*>(0)+contextDataItem->glyphIndexOffsets[glyphType];
+			glDrawElementsInstancedARB(GL_TRIANGLES,contextDataItem->glyphIndexOffsets[glyphType+1]-contextDataItem->glyphIndexOffsets[glyphType],GL_UNSIGNED_INT,firstIndex,GLsizei(batch.size()));
+			
+			/* Clear the batch: */
+			firstInstance+=batch.size();
+			batch.clear();
+			}
+		}
+	
+	/* Reset OpenGL state: */
+	glUseProgramObjectARB(0);
+	GLVertexArrayParts::disable(GLModelVertex::getPartsMask());
+	for(GLuint i=instanceAttributeBase;i<instanceAttributeBase+7;++i)
+		{
+		glVertexAttribDivisorARB(i,0);
+		glDisableVertexAttribArrayARB(i);
+		}
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,0);
+	glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,0);
+	}
+
 }
@@ -24,10 +24,12 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #define VRUI_GLYPHRENDERER_INCLUDED
 
 #include <string>
+#include <vector>
 #include <GL/gl.h>
 #include <GL/GLMaterial.h>
 #include <GL/GLObject.h>
 #include <GL/GLContextData.h>
+#include <GL/Extensions/GLARBShaderObjects.h>
 #include <Images/RGBAImage.h>
 #include <Vrui/Geometry.h>
 
@@ -91,6 +93,18 @@ class Glyph // Class for reusable visualizations of positions and orientations
 class GlyphRenderer:public GLObject
 	{
 	/* Embedded classes: */
+	private:
+	struct GlyphInstance // Structure holding the per-instance data of a batched 3D glyph
+		{
+		/* Elements: */
+		public:
+		GLfloat transform[3][4]; // Upper three rows of the glyph's transformation matrix
+		GLfloat ambient[4]; // Ambient color of the glyph's material
+		GLfloat diffuse[4]; // Diffuse color of the glyph's material
+		GLfloat specular[4]; // Specular color of the glyph's material, with the specular exponent in the fourth component
+		GLfloat emission[4]; // Emissive color of the glyph's material
+		};
+	
 	public:
 	struct DataItem:public GLObject::DataItem // Structure for OpenGL per-context data
 		{
@@ -101,6 +115,18 @@ class GlyphRenderer:public GLObject
 		GLContextData& contextData; // Reference to context data structure containing this data item
 		GLuint glyphDisplayLists; // Base ID for consecutive display lists to render glyphs
 		GLuint cursorTextureObjectId; // ID of texture object containing cursor glyph texture
+		bool haveInstancing; // Flag whether 3D glyphs are rendered in batches using instanced rendering
+		GLuint glyphVertexBufferId; // ID of vertex buffer containing the vertices of all 3D glyph types
+		GLuint glyphIndexBufferId; // ID of index buffer containing the triangles of all 3D glyph types
+		GLsizei glyphIndexOffsets[Glyph::GLYPHS_END+1]; // Position of the first triangle vertex index of each glyph type in the glyph index buffer
+		GLuint instanceBufferId; // ID of vertex buffer streaming per-instance glyph data
+		size_t instanceBufferSize; // Number of instances for which space is allocated in the instance buffer
+		GLhandleARB vertexShader; // Vertex shader to transform and illuminate glyph instances
+		GLhandleARB fragmentShader; // Fragment shader to render glyph instances
+		GLhandleARB shaderProgram; // Shader program to render glyph instances
+		unsigned int lightStateVersion; // Version number of the lighting state reflected in the shader program
+		unsigned int clipPlaneStateVersion; // Version number of the clipping plane state reflected in the shader program
+		std::vector<GlyphInstance> glyphBatches[Glyph::GLYPHS_END]; // Lists of batched glyph instances for each glyph type
 		
 		/* Constructors and destructors: */
 		DataItem(GLContextData& sContextData);
@@ -115,6 +141,9 @@ class GlyphRenderer:public GLObject
 	unsigned int cursorNominalSize; // Nominal size of cursor image
 	unsigned int cursorHotspot[2]; // Position of cursor image's hot spot
 	
+	/* Private methods: */
+	void compileShader(DataItem* dataItem) const; // Compiles the glyph instance shader program based on current lighting and clipping state
+	
 	/* Constructors and destructors: */
 	public:
 	GlyphRenderer(GLfloat sGlyphSize,const std::string& cursorImageFileName,unsigned int sCursorNominalSize); // Initializes glyph renderer for given glyph size
@@ -125,12 +154,14 @@ class GlyphRenderer:public GLObject
 		{
 		return glyphSize;
 		}
-	const DataItem* getContextDataItem(GLContextData& contextData) const // Returns pointer to the context data item for quicker rendering of many glyphs
+	DataItem* getContextDataItem(GLContextData& contextData) const // Returns pointer to the context data item for quicker rendering of many glyphs
 		{
 		/* Return pointer to context data item: */
 		return contextData.retrieveDataItem<DataItem>(this);
 		}
 	void renderGlyph(const Glyph& glyph,const OGTransform& transformation,const DataItem* contextDataItem) const; // Renders glyph into current OpenGL context
+	void addGlyph(const Glyph& glyph,const OGTransform& transformation,DataItem* contextDataItem) const; // Adds glyph to the current OpenGL context's batch of glyphs, or renders it immediately if it can not be batched
+	void renderGlyphs(DataItem* contextDataItem) const; // Renders all batched glyphs into current OpenGL context using one draw call per glyph type, and clears the batch
 	};
 
 }
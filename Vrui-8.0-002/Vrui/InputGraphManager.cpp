@@ -1750,9 +1750,9 @@ void InputGraphManager::update(void)
 void InputGraphManager::glRenderDevices(GLContextData& contextData) const
 	{
 	/* Get the glyph renderer's context data item: */
-	const GlyphRenderer::DataItem* glyphRendererContextDataItem=glyphRenderer->getContextDataItem(contextData);
+	GlyphRenderer::DataItem* glyphRendererContextDataItem=glyphRenderer->getContextDataItem(contextData);
 	
-	/* Render all input devices in the first input graph level: */
+	/* Batch glyphs for all input devices in the first input graph level: */
 	for(const GraphInputDevice* gid=deviceLevels[0];gid!=0;gid=gid->levelSucc)
 		if(gid->enabled)
 			{
@@ -1767,14 +1767,14 @@ void InputGraphManager::glRenderDevices(GLContextData& contextData) const
 					/* Rotate the glyph so that its Y axis aligns to the device's ray direction: */
 					transform*=OGTransform::rotate(Rotation::rotateFromTo(Vector(0,1,0),gid->device->getDeviceRayDirection()));
 					}
-				glyphRenderer->renderGlyph(gid->deviceGlyph,transform,glyphRendererContextDataItem);
+				glyphRenderer->addGlyph(gid->deviceGlyph,transform,glyphRendererContextDataItem);
 				}
 			}
 	
 	/* Iterate through all higher input graph levels: */
 	for(int level=1;level<=maxGraphLevel;++level)
 		{
-		/* Render all input devices in this level: */
+		/* Batch glyphs for all input devices in this level: */
 		for(const GraphInputDevice* gid=deviceLevels[level];gid!=0;gid=gid->levelSucc)
 			if(gid->enabled)
 				{
@@ -1784,9 +1784,12 @@ void InputGraphManager::glRenderDevices(GLContextData& contextData) const
 					/* Rotate the glyph so that its Y axis aligns to the device's ray direction: */
 					transform*=OGTransform::rotate(Rotation::rotateFromTo(Vector(0,1,0),gid->device->getDeviceRayDirection()));
 					}
-				glyphRenderer->renderGlyph(gid->deviceGlyph,transform,glyphRendererContextDataItem);
+				glyphRenderer->addGlyph(gid->deviceGlyph,transform,glyphRendererContextDataItem);
 				}
 		}
+	
+	/* Render all batched glyphs: */
+	glyphRenderer->renderGlyphs(glyphRendererContextDataItem);
 	}
 
 void InputGraphManager::glRenderTools(GLContextData& contextData) const
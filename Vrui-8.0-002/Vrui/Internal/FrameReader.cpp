@@ -0,0 +1,208 @@
+/***********************************************************************
+FrameReader - Helper class to read the contents of a window into movie
+frames asynchronously, using a ring of pixel buffer objects whose
+contents are mapped only once their sync fences have been signaled.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#include <Vrui/Internal/FrameReader.h>
+
+#include <string.h>
+#include <GL/gl.h>
+#include <GL/Extensions/GLARBVertexBufferObject.h>
+#include <GL/Extensions/GLARBPixelBufferObject.h>
+#include <GL/Extensions/GLARBSync.h>
+#include <Vrui/Internal/MovieSaver.h>
+
+namespace Vrui {
+
+/****************************
+Methods of class FrameReader:
+****************************/
+
+bool FrameReader::isComplete(const FrameReader::Slot& slot) const
+	{
+	/* Without sync objects, a read is only considered complete once its slot has to be reused: */
+	if(slot.fence==0)
+		return false;
+	
+	/* Poll the slot's sync object without waiting: */
+	GLenum result=glClientWaitSync(slot.fence,0,0);
+	return result==GL_ALREADY_SIGNALED||result==GL_CONDITION_SATISFIED;
+	}
+
+void FrameReader::deliver(FrameReader::Slot& slot,MovieSaver* movieSaver)
+	{
+	if(slot.fence!=0)
+		{
+		/* Wait for the read to complete, which should not block if the slot was polled before: */
+		glClientWaitSync(slot.fence,GL_SYNC_FLUSH_COMMANDS_BIT,GL_TIMEOUT_IGNORED);
+		glDeleteSync(slot.fence);
+		slot.fence=0;
+		}
+	
+	/* Map the slot's buffer and copy its contents into a fresh movie frame: */
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB,slot.bufferId);
+	const unsigned char* pixels=static_cast<const unsigned char*>(glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB,GL_READ_ONLY_ARB));
+	if(pixels!=0)
+		{
+		MovieSaver::FrameBuffer& frameBuffer=movieSaver->startNewFrame();
+		frameBuffer.setFrameSize(slot.frameSize[0],slot.frameSize[1]);
+		frameBuffer.prepareWrite();
+		memcpy(frameBuffer.getBuffer(),pixels,size_t(slot.frameSize[1])*size_t(slot.frameSize[0])*3);
+		movieSaver->postNewFrame();
+		
+		glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+		}
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB,0);
+	
+	slot.pending=false;
+	}
+
+FrameReader::FrameReader(unsigned int sNumSlots)
+	:haveBuffers(GLARBPixelBufferObject::isSupported()),
+	 haveFences(haveBuffers&&GLARBSync::isSupported()),
+	 numSlots(sNumSlots>=2?sNumSlots:2),slots(0),
+	 nextSlot(0),numPending(0)
+	{
+	if(haveBuffers)
+		{
+		/* Initialize the required extensions: */
+		GLARBPixelBufferObject::initExtension();
+		if(haveFences)
+			GLARBSync::initExtension();
+		
+		/* Create the ring of pixel buffer objects: */
+		slots=new Slot[numSlots];
+		for(unsigned int i=0;i<numSlots;++i)
+			{
+			glGenBuffersARB(1,&slots[i].bufferId);
+			slots[i].frameSize[0]=slots[i].frameSize[1]=0;
+			slots[i].fence=0;
+			slots[i].pending=false;
+			}
+		}
+	}
+
+FrameReader::~FrameReader(void)
+	{
+	if(haveBuffers)
+		{
+		/* Destroy the ring of pixel buffer objects: */
+		for(unsigned int i=0;i<numSlots;++i)
+			{
+			if(slots[i].fence!=0)
+				glDeleteSync(slots[i].fence);
+			glDeleteBuffersARB(1,&slots[i].bufferId);
+			}
+		delete[] slots;
+		}
+	}
+
+void FrameReader::readFrame(int width,int height,MovieSaver* movieSaver)
+	{
+	/* Set up pixel pipeline to pack tightly: */
+	glPixelStorei(GL_PACK_ALIGNMENT,1);
+	glPixelStorei(GL_PACK_SKIP_PIXELS,0);
+	glPixelStorei(GL_PACK_ROW_LENGTH,0);
+	glPixelStorei(GL_PACK_SKIP_ROWS,0);
+	
+	if(!haveBuffers)
+		{
+		/* Read the frame directly into the movie saver's next frame buffer: */
+		MovieSaver::FrameBuffer& frameBuffer=movieSaver->startNewFrame();
+		frameBuffer.setFrameSize(width,height);
+		frameBuffer.prepareWrite();
+		glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,frameBuffer.getBuffer());
+		movieSaver->postNewFrame();
+		
+		return;
+		}
+	
+	/* If the ring is full, deliver the oldest frame to make room: */
+	Slot& slot=slots[nextSlot];
+	if(slot.pending)
+		{
+		deliver(slot,movieSaver);
+		--numPending;
+		}
+	
+	/* Start reading the frame into the next slot's buffer: */
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB,slot.bufferId);
+	if(slot.frameSize[0]!=width||slot.frameSize[1]!=height)
+		{
+		/* Resize the buffer: */
+		glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB,GLsizeiptrARB(height)*GLsizeiptrARB(width)*3,0,GL_STREAM_READ_ARB);
+		slot.frameSize[0]=width;
+		slot.frameSize[1]=height;
+		}
+	glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,0);
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB,0);
+	if(haveFences)
+		slot.fence=glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+	slot.pending=true;
+	nextSlot=(nextSlot+1)%numSlots;
+	++numPending;
+	
+	/* Find the most recent pending frame that has already arrived; reads complete in order: */
+	unsigned int first=(nextSlot+numSlots-numPending)%numSlots;
+	unsigned int numComplete=0;
+	while(numComplete<numPending&&isComplete(slots[(first+numComplete)%numSlots]))
+		++numComplete;
+	
+	if(numComplete>0)
+		{
+		/* Drop all older arrived frames, as the movie saver would only overwrite them: */
+		for(unsigned int i=0;i<numComplete-1;++i)
+			{
+			Slot& s=slots[(first+i)%numSlots];
+			glDeleteSync(s.fence);
+			s.fence=0;
+			s.pending=false;
+			}
+		
+		/* Deliver the most recent arrived frame: */
+		deliver(slots[(first+numComplete-1)%numSlots],movieSaver);
+		numPending-=numComplete;
+		}
+	}
+
+void FrameReader::flush(MovieSaver* movieSaver)
+	{
+	if(numPending>0)
+		{
+		/* Drop all pending frames except the most recent one: */
+		unsigned int first=(nextSlot+numSlots-numPending)%numSlots;
+		for(unsigned int i=0;i<numPending-1;++i)
+			{
+			Slot& s=slots[(first+i)%numSlots];
+			if(s.fence!=0)
+				glDeleteSync(s.fence);
+			s.fence=0;
+			s.pending=false;
+			}
+		
+		/* Wait for and deliver the most recent frame: */
+		deliver(slots[(nextSlot+numSlots-1)%numSlots],movieSaver);
+		numPending=0;
+		}
+	}
+
+}
@@ -0,0 +1,84 @@
+/***********************************************************************
+FrameReader - Helper class to read the contents of a window into movie
+frames asynchronously, using a ring of pixel buffer objects whose
+contents are mapped only once their sync fences have been signaled.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef VRUI_INTERNAL_FRAMEREADER_INCLUDED
+#define VRUI_INTERNAL_FRAMEREADER_INCLUDED
+
+#include <GL/gl.h>
+#include <GL/Extensions/GLARBSync.h>
+
+/* Forward declarations: */
+namespace Vrui {
+class MovieSaver;
+}
+
+namespace Vrui {
+
+class FrameReader
+	{
+	/* Embedded classes: */
+	private:
+	struct Slot // Structure for a pixel buffer object in the readback ring
+		{
+		/* Elements: */
+		public:
+		GLuint bufferId; // ID of the pixel buffer object
+		int frameSize[2]; // Size of the frame read into the buffer
+		GLsync fence; // Sync object signaled when the read into the buffer has completed, or null
+		bool pending; // Flag whether the buffer holds a frame that has not been delivered yet
+		};
+	
+	/* Elements: */
+	bool haveBuffers; // Flag whether the OpenGL context supports pixel buffer objects
+	bool haveFences; // Flag whether the OpenGL context supports sync objects
+	unsigned int numSlots; // Number of pixel buffer objects in the readback ring
+	Slot* slots; // Ring of pixel buffer objects
+	unsigned int nextSlot; // Index of the slot into which the next frame will be read
+	unsigned int numPending; // Number of slots holding frames that have not been delivered yet
+	
+	/* Private methods: */
+	bool isComplete(const Slot& slot) const; // Returns true if the read into the given slot has completed
+	void deliver(Slot& slot,MovieSaver* movieSaver); // Copies the frame in the given slot into a new frame of the given movie saver
+	
+	/* Constructors and destructors: */
+	public:
+	FrameReader(unsigned int sNumSlots); // Creates a frame reader with the given number of pixel buffer objects for the current OpenGL context
+	private:
+	FrameReader(const FrameReader& source); // Prohibit copy constructor
+	FrameReader& operator=(const FrameReader& source); // Prohibit assignment operator
+	public:
+	~FrameReader(void); // Destroys the frame reader; must be called with the same OpenGL context current
+	
+	/* Methods: */
+	bool isAsynchronous(void) const // Returns true if frames are read asynchronously
+		{
+		return haveBuffers;
+		}
+	void readFrame(int width,int height,MovieSaver* movieSaver); // Starts reading the lower-left part of the given size of the current read buffer, and delivers the most recent previously read frame that has arrived to the given movie saver
+	void flush(MovieSaver* movieSaver); // Waits for all pending reads to complete and delivers the most recent frame to the given movie saver
+	};
+
+}
+
+#endif
@@ -28,6 +28,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <algorithm>
 #include <Misc/PrintfTemplateTests.h>
 #include <Misc/Time.h>
 #include <Misc/ThrowStdErr.h>
@@ -36,9 +37,13 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
 #include <Misc/StringMarshaller.h>
+#include <Misc/CommandDispatcher.h>
+#include <Misc/SizedTypes.h>
 #include <IO/File.h>
 #include <IO/Directory.h>
 #include <IO/OpenFile.h>
+#include <IO/IFFChunk.h>
+#include <IO/GzipFilter.h>
 #include <Math/Constants.h>
 #include <Geometry/OrthonormalTransformation.h>
 #include <Geometry/GeometryValueCoders.h>
@@ -51,6 +56,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Vrui/TextEventDispatcher.h>
 #include <Vrui/InputGraphManager.h>
 #include <Vrui/Internal/MouseCursorFaker.h>
+#include <Vrui/Internal/InputDeviceStateCoder.h>
 #include <Vrui/VRWindow.h>
 #include <Vrui/Internal/Vrui.h>
 #include <Vrui/Internal/Config.h>
@@ -61,8 +67,116 @@ namespace Vrui {
 Methods of class InputDeviceAdapterPlayback:
 *******************************************/
 
+void InputDeviceAdapterPlayback::readChunkIndex(void)
+	{
+	IO::SeekableFile& file=*seekableInputDeviceDataFile;
+	IO::SeekableFile::Offset dataStart=file.getReadPos();
+	IO::SeekableFile::Offset fileSize=file.getSize();
+	
+	/* Try reading the chunk index, whose position is stored at the end of the file: */
+	bool haveIndex=false;
+	if(fileSize>=dataStart+20)
+		{
+		file.setReadPosAbs(fileSize-8);
+		IO::SeekableFile::Offset indexOffset=file.read<Misc::UInt64>();
+		if(indexOffset>=dataStart&&indexOffset+20<=fileSize)
+			{
+			/* Check that the index chunk is intact: */
+			file.setReadPosAbs(indexOffset);
+			char chunkId[4];
+			file.read<char>(chunkId,4);
+			Misc::UInt32 chunkSize=file.read<Misc::UInt32>();
+			Misc::UInt32 numChunks=file.read<Misc::UInt32>();
+			if(strncmp(chunkId,"INDX",4)==0&&indexOffset+8+chunkSize==fileSize&&IO::SeekableFile::Offset(chunkSize)==4+IO::SeekableFile::Offset(numChunks)*16+8)
+				{
+				/* Read the chunk index: */
+				chunkIndex.reserve(numChunks);
+				for(Misc::UInt32 i=0;i<numChunks;++i)
+					{
+					ChunkIndexEntry cie;
+					cie.timeStamp=file.read<double>();
+					cie.offset=file.read<Misc::UInt64>();
+					chunkIndex.push_back(cie);
+					}
+				haveIndex=true;
+				}
+			}
+		}
+	
+	if(!haveIndex)
+		{
+		/* Reconstruct the chunk index from all complete chunks, e.g., after an interrupted recording: */
+		IO::SeekableFile::Offset chunkPos=dataStart;
+		while(chunkPos+16<=fileSize)
+			{
+			/* Read the chunk header and bail out at the first incomplete or unknown chunk: */
+			file.setReadPosAbs(chunkPos);
+			char chunkId[4];
+			file.read<char>(chunkId,4);
+			Misc::UInt32 chunkSize=file.read<Misc::UInt32>();
+			if(strncmp(chunkId,"FRMS",4)!=0||chunkPos+8+chunkSize>fileSize)
+				break;
+			
+			/* Enter the chunk into the index: */
+			ChunkIndexEntry cie;
+			cie.timeStamp=file.read<double>();
+			cie.offset=chunkPos;
+			chunkIndex.push_back(cie);
+			
+			/* Go to the next chunk: */
+			chunkPos+=8+chunkSize+(chunkSize&0x1U);
+			}
+		
+		Misc::formattedLogWarning("Vrui::InputDeviceAdapterPlayback: Input device data file has no chunk index; recovered %u chunks",(unsigned int)(chunkIndex.size()));
+		}
+	
+	/* Go back to the beginning of the first chunk: */
+	file.setReadPosAbs(dataStart);
+	}
+
+bool InputDeviceAdapterPlayback::readChunk(void)
+	{
+	/* Release the current chunk: */
+	chunkFile=0;
+	
+	/* Bail out if all chunks have been read: */
+	if(nextChunkIndex>=chunkIndex.size())
+		return false;
+	
+	/* Open the next chunk: */
+	seekableInputDeviceDataFile->setReadPosAbs(chunkIndex[nextChunkIndex].offset);
+	++nextChunkIndex;
+	IO::IFFChunkPtr chunk=new IO::IFFChunk(inputDeviceDataFile);
+	
+	/* Read the chunk header: */
+	chunk->skip<double>(2); // Time stamps of the chunk's first and last data frames
+	numChunkFramesLeft=chunk->read<Misc::UInt32>();
+	bool compressed=chunk->read<Misc::UInt8>()!=0U;
+	
+	/* Read data frames directly from the chunk or through a decompressor: */
+	if(compressed)
+		{
+		chunkFile=new IO::GzipFilter(chunk);
+		chunkFile->setEndianness(Misc::LittleEndian);
+		}
+	else
+		chunkFile=chunk;
+	
+	/* Each chunk starts with a key frame: */
+	stateCoder->reset();
+	
+	return true;
+	}
+
 void InputDeviceAdapterPlayback::readDeviceStates(void)
 	{
+	/* Data file version 6 and later store device states in chunks of data frames: */
+	if(fileVersion>=6)
+		{
+		readChunkedDeviceStates();
+		return;
+		}
+	
 	/* Update all input devices: */
 	for(int deviceIndex=0;deviceIndex<numInputDevices;++deviceIndex)
 		{
@@ -173,11 +287,163 @@ void InputDeviceAdapterPlayback::readDeviceStates(void)
 		}
 	}
 
+void InputDeviceAdapterPlayback::readChunkedDeviceStates(void)
+	{
+	/* Update all input devices: */
+	for(int deviceIndex=0;deviceIndex<numInputDevices;++deviceIndex)
+		{
+		/* Get a handle on the device: */
+		InputDevice* device=inputDevices[deviceIndex];
+		
+		/* Read those parts of the device's state that changed since the previous data frame: */
+		unsigned int parts=stateCoder->readDeviceState(deviceIndex,*chunkFile);
+		if(applyAllStates)
+			parts=~0x0U;
+		bool deviceValid=stateCoder->isValid(deviceIndex);
+		
+		if(deviceValid)
+			{
+			/* Update tracker state: */
+			if((parts&InputDeviceStateCoder::TRACKER)&&device->getTrackType()!=InputDevice::TRACK_NONE)
+				{
+				Vector deviceRayDir;
+				Scalar deviceRayStart;
+				TrackerState trackerState;
+				Vector linearVelocity,angularVelocity;
+				stateCoder->getTrackerState(deviceIndex,deviceRayDir,deviceRayStart,trackerState,linearVelocity,angularVelocity);
+				device->setDeviceRay(deviceRayDir,deviceRayStart);
+				if(applyPreTransform)
+					{
+					/* Apply the pre-transformation to the 6-DOF tracker state: */
+					TrackerState::Vector translation=preTransform.getTranslation()+preTransform.getRotation().transform(trackerState.getTranslation()*preTransform.getScaling());
+					TrackerState::Rotation rotation=trackerState.getRotation();
+					rotation.leftMultiply(preTransform.getRotation());
+					trackerState=TrackerState(translation,rotation);
+					}
+				device->setTrackingState(trackerState,linearVelocity,angularVelocity);
+				}
+			
+			/* Update button states: */
+			if(parts&InputDeviceStateCoder::BUTTONS)
+				for(int i=0;i<device->getNumButtons();++i)
+					device->setButtonState(i,stateCoder->getButtonState(deviceIndex,i));
+			
+			/* Update valuator states: */
+			if(parts&InputDeviceStateCoder::VALUATORS)
+				for(int i=0;i<device->getNumValuators();++i)
+					device->setValuator(i,stateCoder->getValuator(deviceIndex,i));
+			}
+		
+		/* Check if the device's valid flag changed: */
+		if(validFlags[deviceIndex]!=deviceValid)
+			{
+			/* Enable or disable the device in the input graph manager: */
+			inputDeviceManager->getInputGraphManager()->setEnabled(device,deviceValid);
+			
+			/* Update the device's valid flag: */
+			validFlags[deviceIndex]=deviceValid;
+			}
+		}
+	
+	/* Read and enqueue all text and text control events: */
+	inputDeviceManager->getTextEventDispatcher()->readEventQueues(*chunkFile);
+	
+	--numChunkFramesLeft;
+	applyAllStates=false;
+	}
+
+void InputDeviceAdapterPlayback::skipDeviceStates(void)
+	{
+	/* Update the coded states of all input devices: */
+	for(int deviceIndex=0;deviceIndex<numInputDevices;++deviceIndex)
+		stateCoder->readDeviceState(deviceIndex,*chunkFile);
+	
+	/* Skip all text and text control events: */
+	TextEventDispatcher::skipEventQueues(*chunkFile);
+	
+	--numChunkFramesLeft;
+	}
+
+bool InputDeviceAdapterPlayback::readNextTimeStamp(void)
+	{
+	try
+		{
+		if(fileVersion>=6)
+			{
+			/* Go to the next chunk if the current one is exhausted: */
+			while(numChunkFramesLeft==0)
+				if(!readChunk())
+					return false;
+			
+			nextTimeStamp=chunkFile->read<double>();
+			}
+		else
+			nextTimeStamp=inputDeviceDataFile->read<double>();
+		}
+	catch(const IO::File::ReadError&)
+		{
+		return false;
+		}
+	
+	return nextTimeStamp<=stopTime;
+	}
+
+bool InputDeviceAdapterPlayback::seekChunkedFile(double newTimeStamp)
+	{
+	if(chunkIndex.empty())
+		return false;
+	
+	/* Find the last chunk starting at or before the given time stamp: */
+	std::vector<ChunkIndexEntry>::iterator ciIt=std::lower_bound(chunkIndex.begin(),chunkIndex.end(),newTimeStamp);
+	if(ciIt==chunkIndex.end()||(ciIt->timeStamp>newTimeStamp&&ciIt!=chunkIndex.begin()))
+		--ciIt;
+	
+	/* Start reading from the found chunk: */
+	nextChunkIndex=ciIt-chunkIndex.begin();
+	numChunkFramesLeft=0;
+	applyAllStates=true;
+	
+	/* Decode data frames until reaching the given time stamp: */
+	while(true)
+		{
+		if(!readNextTimeStamp())
+			return false;
+		if(nextTimeStamp>=newTimeStamp)
+			break;
+		skipDeviceStates();
+		}
+	
+	return true;
+	}
+
+void InputDeviceAdapterPlayback::finishPlayback(void)
+	{
+	done=true;
+	nextTimeStamp=Math::Constants<double>::max;
+	
+	if(numPlayedFrames>0)
+		{
+		/* Log the playback time as a convenience for benchmarking: */
+		Misc::Time rt=Misc::Time::now();
+		double realTime=double(rt.tv_sec)+double(rt.tv_nsec)/1000000000.0;
+		Misc::formattedLogNote("Vrui::InputDeviceAdapterPlayback: Played back %u data frames in %fs",numPlayedFrames,realTime-playbackStartTime);
+		}
+	
+	if(quitWhenDone)
+		{
+		/* Request exiting the program: */
+		shutdown();
+		}
+	}
+
 InputDeviceAdapterPlayback::InputDeviceAdapterPlayback(InputDeviceManager* sInputDeviceManager,const Misc::ConfigurationFileSection& configFileSection)
 	:InputDeviceAdapter(sInputDeviceManager),
+	 stateCoder(0),nextChunkIndex(0),numChunkFramesLeft(0),applyAllStates(false),
 	 applyPreTransform(false),
 	 mouseCursorFaker(0),
 	 synchronizePlayback(configFileSection.retrieveValue<bool>("./synchronizePlayback",false)),
+	 playbackSpeed(configFileSection.retrieveValue<double>("./playbackSpeed",1.0)),
+	 stopTime(configFileSection.retrieveValue<double>("./stopTime",Math::Constants<double>::max)),
 	 quitWhenDone(configFileSection.retrieveValue<bool>("./quitWhenDone",false)),
 	 soundPlayer(0),
 	 saveMovie(configFileSection.retrieveValue<bool>("./saveMovie",false)),
@@ -185,6 +451,7 @@ InputDeviceAdapterPlayback::InputDeviceAdapterPlayback(InputDeviceManager* sInpu
 	 movieFrameStart(0),movieFrameOffset(0),
 	 timeStamp(0.0),timeStampOffset(0.0),
 	 nextTimeStamp(0.0),
+	 numPlayedFrames(0),playbackStartTime(0.0),
 	 validFlags(0),
 	 nextMovieFrameTime(0.0),nextMovieFrameCounter(0),
 	 done(false)
@@ -230,12 +497,30 @@ InputDeviceAdapterPlayback::InputDeviceAdapterPlayback(InputDeviceManager* sInpu
 		/* File version with valid flags: */
 		fileVersion=5;
 		}
+	else if(strcmp(header+29,"6.0\n")==0)
+		{
+		/* File version with indexed chunks of quantized and optionally compressed data frames: */
+		fileVersion=6;
+		}
 	else
 		{
 		header[32]='\0';
 		Misc::throwStdErr("Vrui::InputDeviceAdapterPlayback: Unsupported input device data file version %s",header+29);
 		}
 	
+	if(fileVersion>=6)
+		{
+		/* Chunked files are read through a seekable file; reopen the file through a seekable filter if necessary: */
+		seekableInputDeviceDataFile=inputDeviceDataFile;
+		if(seekableInputDeviceDataFile==0)
+			{
+			seekableInputDeviceDataFile=baseDirectory->openSeekableFile(configFileSection.retrieveString("./inputDeviceDataFileName").c_str());
+			seekableInputDeviceDataFile->setEndianness(Misc::LittleEndian);
+			seekableInputDeviceDataFile->skip<char>(34);
+			inputDeviceDataFile=seekableInputDeviceDataFile;
+			}
+		}
+	
 	/* Read random seed value: */
 	unsigned int randomSeed=inputDeviceDataFile->read<unsigned int>();
 	setRandomSeed(randomSeed);
@@ -305,6 +590,17 @@ InputDeviceAdapterPlayback::InputDeviceAdapterPlayback(InputDeviceManager* sInpu
 		validFlags[i]=true;
 		}
 	
+	if(fileVersion>=6)
+		{
+		/* Create a coder for input device states using the file's quantization steps: */
+		double positionQuantum=inputDeviceDataFile->read<double>();
+		double orientationQuantum=inputDeviceDataFile->read<double>();
+		stateCoder=new InputDeviceStateCoder(numInputDevices,inputDevices,positionQuantum,orientationQuantum);
+		
+		/* Read the index of all chunks in the file: */
+		readChunkIndex();
+		}
+	
 	/* Check if the user wants to pre-transform stored device data: */
 	if(configFileSection.hasTag("./preTransform"))
 		{
@@ -329,23 +625,23 @@ InputDeviceAdapterPlayback::InputDeviceAdapterPlayback(InputDeviceManager* sInpu
 		mouseCursorFaker->setCursorHotspot(configFileSection.retrieveValue<Vector>("./mouseCursorHotspot",mouseCursorFaker->getCursorHotspot()));
 		}
 	
-	/* Read the initial application time stamp: */
-	try
+	/* Read the initial application time stamp, optionally skipping ahead to a start time: */
+	bool haveFrame;
+	if(configFileSection.hasTag("./startTime"))
 		{
-		timeStamp=inputDeviceDataFile->read<double>();
-		synchronize(timeStamp);
+		if(fileVersion<6)
+			Misc::throwStdErr("Vrui::InputDeviceAdapterPlayback: Starting playback at a given time requires input device data file version 6.0");
+		haveFrame=seekChunkedFile(configFileSection.retrieveValue<double>("./startTime"));
 		}
-	catch(const IO::File::ReadError&)
+	else
+		haveFrame=readNextTimeStamp();
+	if(haveFrame)
 		{
-		done=true;
-		nextTimeStamp=Math::Constants<double>::max;
-		
-		if(quitWhenDone)
-			{
-			/* Request exiting the program: */
-			shutdown();
-			}
+		timeStamp=nextTimeStamp;
+		synchronize(timeStamp);
 		}
+	else
+		finishPlayback();
 	
 	/* Check if the user wants to play back a commentary sound track: */
 	std::string soundFileName=configFileSection.retrieveString("./soundFileName","");
@@ -385,10 +681,16 @@ InputDeviceAdapterPlayback::InputDeviceAdapterPlayback(InputDeviceManager* sInpu
 		/* Get the index of the first movie frame: */
 		movieFrameOffset=configFileSection.retrieveValue<int>("./movieFirstFrameIndex",movieFrameOffset);
 		}
+	
+	/* Let the user jump to other time stamps in seekable input device data files: */
+	if(fileVersion>=6)
+		getCommandDispatcher().addCommandCallback("InputDeviceAdapterPlayback.seekTime",&InputDeviceAdapterPlayback::seekTimeCallback,this,"<time stamp>","Continues input device data playback at the first data frame at or after the given time stamp");
 	}
 
 InputDeviceAdapterPlayback::~InputDeviceAdapterPlayback(void)
 	{
+	chunkFile=0;
+	delete stateCoder;
 	delete mouseCursorFaker;
 	delete soundPlayer;
 	delete[] deviceFeatureBaseIndices;
@@ -439,13 +741,10 @@ int InputDeviceAdapterPlayback::getFeatureIndex(InputDevice* device,const char*
 
 void InputDeviceAdapterPlayback::prepareMainLoop(void)
 	{
-	if(synchronizePlayback)
-		{
-		/* Calculate the offset between the saved timestamps and the system's wall clock time: */
-		Misc::Time rt=Misc::Time::now();
-		double realTime=double(rt.tv_sec)+double(rt.tv_nsec)/1000000000.0;
-		timeStampOffset=nextTimeStamp-realTime;
-		}
+	/* Calculate the offset between the saved timestamps and the system's wall clock time, sped up by the playback speed factor: */
+	Misc::Time rt=Misc::Time::now();
+	playbackStartTime=double(rt.tv_sec)+double(rt.tv_nsec)/1000000000.0;
+	timeStampOffset=nextTimeStamp-playbackStartTime*playbackSpeed;
 	
 	/* Start the sound player, if there is one: */
 	if(soundPlayer!=0)
@@ -477,37 +776,27 @@ void InputDeviceAdapterPlayback::updateInputDevices(void)
 		/* Check if there is positive drift between the system's offset wall clock time and the next time stamp: */
 		Misc::Time rt=Misc::Time::now();
 		double realTime=double(rt.tv_sec)+double(rt.tv_nsec)/1000000000.0;
-		double delta=nextTimeStamp-(realTime+timeStampOffset);
+		double delta=nextTimeStamp-(realTime*playbackSpeed+timeStampOffset);
 		if(delta>0.0)
 			{
 			/* Block to correct the drift: */
-			vruiDelay(delta);
+			vruiDelay(delta/playbackSpeed);
 			}
 		}
 	
 	/* Read new device states: */
 	readDeviceStates();
+	++numPlayedFrames;
 	
 	/* Read time stamp of next data frame: */
-	try
+	if(readNextTimeStamp())
 		{
-		nextTimeStamp=inputDeviceDataFile->read<double>();
-		
 		/* Request a synchronized update for the next frame: */
 		synchronize(nextTimeStamp,false);
 		requestUpdate();
 		}
-	catch(const IO::File::ReadError&)
-		{
-		done=true;
-		nextTimeStamp=Math::Constants<double>::max;
-		
-		if(quitWhenDone)
-			{
-			/* Request exiting the program: */
-			shutdown();
-			}
-		}
+	else
+		finishPlayback();
 	
 	if(saveMovie&&movieWindow!=0)
 		{
@@ -561,4 +850,41 @@ void InputDeviceAdapterPlayback::updateInputDevices(void)
 		}
 	}
 
+void InputDeviceAdapterPlayback::seekTimeCallback(const char* argumentsBegin,const char* argumentsEnd,void* userData)
+	{
+	InputDeviceAdapterPlayback* thisPtr=static_cast<InputDeviceAdapterPlayback*>(userData);
+	
+	/* Parse the new time stamp: */
+	double newTimeStamp=Misc::ValueCoder<double>::decode(argumentsBegin,argumentsEnd);
+	
+	/* Continue playback at the new time stamp: */
+	thisPtr->seekTime(newTimeStamp);
+	}
+
+void InputDeviceAdapterPlayback::seekTime(double newTimeStamp)
+	{
+	if(fileVersion<6)
+		{
+		Misc::formattedUserWarning("Vrui::InputDeviceAdapterPlayback: Seeking requires input device data file version 6.0");
+		return;
+		}
+	
+	/* Position the input device data file at the first data frame at or after the given time stamp: */
+	done=false;
+	if(seekChunkedFile(newTimeStamp))
+		{
+		/* Continue synchronized playback from the new time stamp: */
+		Misc::Time rt=Misc::Time::now();
+		double realTime=double(rt.tv_sec)+double(rt.tv_nsec)/1000000000.0;
+		timeStampOffset=nextTimeStamp-realTime*playbackSpeed;
+		nextMovieFrameTime=nextTimeStamp+movieFrameTimeInterval*0.5;
+		
+		/* Request a synchronized update for the next frame: */
+		synchronize(nextTimeStamp,false);
+		requestUpdate();
+		}
+	else
+		finishPlayback();
+	}
+
 }
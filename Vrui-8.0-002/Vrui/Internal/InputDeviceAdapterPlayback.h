@@ -27,6 +27,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <string>
 #include <vector>
 #include <IO/File.h>
+#include <IO/SeekableFile.h>
 #include <Geometry/Vector.h>
 #include <Geometry/OrthogonalTransformation.h>
 #include <Vrui/Geometry.h>
@@ -44,22 +45,47 @@ class SoundPlayer;
 namespace Vrui {
 class MouseCursorFaker;
 class VRWindow;
+class InputDeviceStateCoder;
 }
 
 namespace Vrui {
 
 class InputDeviceAdapterPlayback:public InputDeviceAdapter
 	{
-	/* Elements: */
+	/* Embedded classes: */
 	private:
+	struct ChunkIndexEntry // Structure to locate a chunk of data frames in a chunked input device data file
+		{
+		/* Elements: */
+		public:
+		double timeStamp; // Time stamp of the chunk's first data frame
+		IO::SeekableFile::Offset offset; // Position of the chunk's header in the input device data file
+		
+		/* Methods: */
+		bool operator<(double otherTimeStamp) const // Comparison operator for binary search by time stamp
+			{
+			return timeStamp<otherTimeStamp;
+			}
+		};
+	
+	/* Elements: */
 	IO::FilePtr inputDeviceDataFile; // File containing the input device data
 	unsigned int fileVersion; // Version of the input device data file
+	IO::SeekableFilePtr seekableInputDeviceDataFile; // Seekable version of the input device data file, or null if the file is not seekable
+	InputDeviceStateCoder* stateCoder; // Coder reading input device states from data frames of chunked input device data files
+	std::vector<ChunkIndexEntry> chunkIndex; // Index of all chunks in a seekable chunked input device data file
+	size_t nextChunkIndex; // Index of the next chunk to read in the chunk index
+	IO::FilePtr chunkFile; // File from which the data frames of the current chunk are read
+	unsigned int numChunkFramesLeft; // Number of unread data frames in the current chunk
+	bool applyAllStates; // Flag to apply the complete coded states of all input devices on the next data frame, after seeking
 	bool applyPreTransform; // Flag whether to transform input device data read from the file
 	OGTransform preTransform; // Upright transformation to apply to input device data read from the file
 	int* deviceFeatureBaseIndices; // Array of base indices in feature name array for each input device
 	std::vector<std::string> deviceFeatureNames; // Array of input device feature names
 	MouseCursorFaker* mouseCursorFaker; // Pointer to object used to render a fake mouse cursor
 	bool synchronizePlayback; // Flag whether to force the Vrui mainloop to run at the speed of the recording; by default, mainloop runs as fast as it can
+	double playbackSpeed; // Factor by which synchronized playback runs faster than the recording
+	double stopTime; // Time stamp after which playback stops
 	bool quitWhenDone; // Flag whether to quit the Vrui application when all saved data has been played back
 	Sound::SoundPlayer* soundPlayer; // Pointer to a sound player object used to play back synchronized commentary tracks
 	bool saveMovie; // Flag whether to create a movie by writing screenshots at regular intervals
@@ -72,13 +98,23 @@ class InputDeviceAdapterPlayback:public InputDeviceAdapter
 	double timeStamp; // Current time stamp of input device data
 	double timeStampOffset; // Offset from system's wall clock time to input data's time stamp sequence
 	double nextTimeStamp; // Time stamp of next frame of input device data
+	unsigned int numPlayedFrames; // Number of data frames played back so far
+	double playbackStartTime; // Wall clock time at which playback started
 	bool* validFlags; // Array of valid flags for all loaded input devices
 	double nextMovieFrameTime; // Time at which to save the next movie frame
 	int nextMovieFrameCounter; // Frame index for the next movie frame
 	bool done; // Flag if input file is at end
 	
 	/* Private methods: */
+	void readChunkIndex(void); // Reads or reconstructs the chunk index of a seekable chunked input device data file
+	bool readChunk(void); // Starts reading the next chunk of data frames from a chunked input device data file; returns false at end of file
 	void readDeviceStates(void); // Reads a set of input device states from the input device data file
+	void readChunkedDeviceStates(void); // Reads a set of input device states from a data frame of a chunked input device data file
+	void skipDeviceStates(void); // Decodes a data frame of a chunked input device data file without applying it to the input devices
+	bool readNextTimeStamp(void); // Reads the time stamp of the next data frame; returns false if playback is finished
+	bool seekChunkedFile(double newTimeStamp); // Positions a chunked input device data file at the first data frame at or after the given time stamp; returns false if there is no such frame
+	void finishPlayback(void); // Marks playback as finished
+	static void seekTimeCallback(const char* argumentsBegin,const char* argumentsEnd,void* userData); // Handles a "seekTime" command on the command pipe
 	
 	/* Constructors and destructors: */
 	public:
@@ -104,6 +140,7 @@ class InputDeviceAdapterPlayback:public InputDeviceAdapter
 		{
 		return nextTimeStamp;
 		}
+	void seekTime(double newTimeStamp); // Continues playback at the first data frame at or after the given time stamp; only supported for chunked input device data files
 	};
 
 }
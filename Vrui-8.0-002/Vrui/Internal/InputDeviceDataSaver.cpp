@@ -31,6 +31,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Misc/ConfigurationFile.h>
 #include <IO/File.h>
 #include <IO/OpenFile.h>
+#include <IO/GzipFilter.h>
 #include <Geometry/Point.h>
 #include <Geometry/Vector.h>
 #include <Geometry/Rotation.h>
@@ -43,6 +44,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Vrui/InputDeviceFeature.h>
 #include <Vrui/InputDeviceManager.h>
 #include <Vrui/TextEventDispatcher.h>
+#include <Vrui/Internal/InputDeviceStateCoder.h>
 #ifdef VRUI_INPUTDEVICEDATASAVER_USE_KINECT
 #include <Vrui/Internal/KinectRecorder.h>
 #endif
@@ -64,9 +66,78 @@ void InputDeviceDataSaver::inputDeviceStateChangeCallback(InputGraphManager::Inp
 			}
 	}
 
+void InputDeviceDataSaver::writeChunk(void)
+	{
+	/* Enter the chunk into the chunk index: */
+	ChunkIndexEntry cie;
+	cie.timeStamp=chunkFirstTimeStamp;
+	cie.offset=dataFileSize;
+	chunkIndex.push_back(cie);
+	
+	/* Compress the chunk's data frames if requested: */
+	IO::VariableMemoryFile* compressedBuffer=0;
+	IO::FilePtr compressedBufferPtr;
+	if(compressChunks)
+		{
+		compressedBufferPtr=compressedBuffer=new IO::VariableMemoryFile;
+		IO::GzipFilter compressor(compressedBufferPtr);
+		chunkBuffer.writeToSink(compressor);
+		}
+	size_t frameDataSize=compressedBuffer!=0?compressedBuffer->getDataSize():chunkBuffer.getDataSize();
+	
+	/* Write the chunk header: */
+	Misc::UInt32 chunkSize=Misc::UInt32(2*sizeof(double)+sizeof(Misc::UInt32)+sizeof(Misc::UInt8)+frameDataSize);
+	inputDeviceDataFile->write<char>("FRMS",4);
+	inputDeviceDataFile->write<Misc::UInt32>(chunkSize);
+	inputDeviceDataFile->write<double>(chunkFirstTimeStamp);
+	inputDeviceDataFile->write<double>(chunkLastTimeStamp);
+	inputDeviceDataFile->write<Misc::UInt32>(numChunkFrames);
+	inputDeviceDataFile->write<Misc::UInt8>(compressedBuffer!=0?1U:0U);
+	
+	/* Write the chunk's data frames: */
+	if(compressedBuffer!=0)
+		compressedBuffer->writeToSink(*inputDeviceDataFile);
+	else
+		chunkBuffer.writeToSink(*inputDeviceDataFile);
+	
+	/* Pad the chunk to an even size like other IFF chunks: */
+	if(chunkSize&0x1U)
+		inputDeviceDataFile->write<Misc::UInt8>(0U);
+	dataFileSize+=8+chunkSize+(chunkSize&0x1U);
+	
+	/* Start a new chunk: */
+	chunkBuffer.clear();
+	numChunkFrames=0;
+	}
+
+void InputDeviceDataSaver::writeChunkIndex(void)
+	{
+	/* Write the index chunk header: */
+	Misc::UInt32 chunkSize=Misc::UInt32(sizeof(Misc::UInt32)+chunkIndex.size()*(sizeof(double)+sizeof(Misc::UInt64))+sizeof(Misc::UInt64));
+	inputDeviceDataFile->write<char>("INDX",4);
+	inputDeviceDataFile->write<Misc::UInt32>(chunkSize);
+	
+	/* Write the chunk index: */
+	inputDeviceDataFile->write<Misc::UInt32>(Misc::UInt32(chunkIndex.size()));
+	for(std::vector<ChunkIndexEntry>::iterator ciIt=chunkIndex.begin();ciIt!=chunkIndex.end();++ciIt)
+		{
+		inputDeviceDataFile->write<double>(ciIt->timeStamp);
+		inputDeviceDataFile->write<Misc::UInt64>(ciIt->offset);
+		}
+	
+	/* Finish the file with the position of the index chunk so that readers can find it from the end of the file: */
+	inputDeviceDataFile->write<Misc::UInt64>(dataFileSize);
+	dataFileSize+=8+chunkSize;
+	}
+
 InputDeviceDataSaver::InputDeviceDataSaver(const Misc::ConfigurationFileSection& configFileSection,InputDeviceManager& inputDeviceManager,TextEventDispatcher* sTextEventDispatcher,unsigned int randomSeed)
-	:numInputDevices(inputDeviceManager.getNumInputDevices()),
+	:dataFileSize(0),
+	 numInputDevices(inputDeviceManager.getNumInputDevices()),
 	 inputDevices(new InputDevice*[numInputDevices]),validFlags(new bool[numInputDevices]),
+	 stateCoder(0),
+	 chunkDuration(configFileSection.retrieveValue<double>("./chunkDuration",1.0)),
+	 compressChunks(configFileSection.retrieveValue<bool>("./compressChunks",true)),
+	 numChunkFrames(0),chunkFirstTimeStamp(0.0),chunkLastTimeStamp(0.0),
 	 textEventDispatcher(sTextEventDispatcher),
 	 soundRecorder(0)
 	 #ifdef VRUI_INPUTDEVICEDATASAVER_USE_KINECT
@@ -79,16 +150,21 @@ InputDeviceDataSaver::InputDeviceDataSaver(const Misc::ConfigurationFileSection&
 	/* Open the input device data file relative to the base directory: */
 	inputDeviceDataFile=baseDirectory->openFile(baseDirectory->createNumberedFileName(configFileSection.retrieveString("./inputDeviceDataFileName").c_str(),4).c_str(),IO::File::WriteOnly);
 	
-	/* Write a file identification header: */
 	inputDeviceDataFile->setEndianness(Misc::LittleEndian);
-	static const char* fileHeader="Vrui Input Device Data File v5.0\n";
-	inputDeviceDataFile->write<char>(fileHeader,34);
+	chunkBuffer.setEndianness(Misc::LittleEndian);
+	
+	/* Assemble the file header in the chunk buffer to keep track of the data file's size: */
+	IO::File& header=chunkBuffer;
+	
+	/* Write a file identification header: */
+	static const char* fileHeader="Vrui Input Device Data File v6.0\n";
+	header.write<char>(fileHeader,34);
 	
 	/* Save the random number seed: */
-	inputDeviceDataFile->write<unsigned int>(randomSeed);
+	header.write<unsigned int>(randomSeed);
 	
 	/* Save number of input devices: */
-	inputDeviceDataFile->write<int>(numInputDevices);
+	header.write<int>(numInputDevices);
 	
 	/* Save layout and feature names of all input devices in the input device manager: */
 	for(int i=0;i<numInputDevices;++i)
@@ -97,22 +173,34 @@ InputDeviceDataSaver::InputDeviceDataSaver(const Misc::ConfigurationFileSection&
 		inputDevices[i]=inputDeviceManager.getInputDevice(i);
 		
 		/* Save input device's name and layout: */
-		Misc::writeCString(inputDevices[i]->getDeviceName(),*inputDeviceDataFile);
-		inputDeviceDataFile->write<int>(inputDevices[i]->getTrackType());
-		inputDeviceDataFile->write<int>(inputDevices[i]->getNumButtons());
-		inputDeviceDataFile->write<int>(inputDevices[i]->getNumValuators());
+		Misc::writeCString(inputDevices[i]->getDeviceName(),header);
+		header.write<int>(inputDevices[i]->getTrackType());
+		header.write<int>(inputDevices[i]->getNumButtons());
+		header.write<int>(inputDevices[i]->getNumValuators());
 		
 		/* Save input device's feature names: */
 		for(int j=0;j<inputDevices[i]->getNumFeatures();++j)
 			{
 			std::string featureName=inputDeviceManager.getFeatureName(InputDeviceFeature(inputDevices[i],j));
-			Misc::writeCppString(featureName,*inputDeviceDataFile);
+			Misc::writeCppString(featureName,header);
 			}
 		
 		/* Initialize device as valid: */
 		validFlags[i]=true;
 		}
 	
+	/* Create a coder for input device states and save its quantization steps: */
+	double positionQuantum=configFileSection.retrieveValue<double>("./positionQuantum",1.0e-5);
+	double orientationQuantum=configFileSection.retrieveValue<double>("./orientationQuantum",1.0e-6);
+	stateCoder=new InputDeviceStateCoder(numInputDevices,inputDevices,positionQuantum,orientationQuantum);
+	header.write<double>(positionQuantum);
+	header.write<double>(orientationQuantum);
+	
+	/* Write the file header to the input device data file: */
+	dataFileSize=chunkBuffer.getDataSize();
+	chunkBuffer.writeToSink(*inputDeviceDataFile);
+	chunkBuffer.clear();
+	
 	/* Register a callback with the input graph manager: */
 	getInputGraphManager()->getInputDeviceStateChangeCallbacks().add(this,&InputDeviceDataSaver::inputDeviceStateChangeCallback);
 	
@@ -157,9 +245,15 @@ InputDeviceDataSaver::~InputDeviceDataSaver(void)
 	/* Log the total recording time as a convenience: */
 	Misc::formattedLogNote("Vrui::InputDeviceDataSaver: Total recording time: %fs",getApplicationTime());
 	
+	/* Write the last partial chunk of data frames and the chunk index: */
+	if(numChunkFrames>0)
+		writeChunk();
+	writeChunkIndex();
+	
 	/* Shut down recording: */
 	delete[] inputDevices;
 	delete[] validFlags;
+	delete stateCoder;
 	delete soundRecorder;
 	#ifdef VRUI_INPUTDEVICEDATASAVER_USE_KINECT
 	delete kinectRecorder;
@@ -187,68 +281,30 @@ void InputDeviceDataSaver::prepareMainLoop(void)
 
 void InputDeviceDataSaver::saveCurrentState(double currentTimeStamp)
 	{
-	/* Write current time stamp: */
-	inputDeviceDataFile->write(currentTimeStamp);
+	/* Write the current chunk if it covers the maximum time span: */
+	if(numChunkFrames>0&&currentTimeStamp-chunkFirstTimeStamp>=chunkDuration)
+		writeChunk();
 	
-	/* Write state of all input devices: */
-	for(int i=0;i<numInputDevices;++i)
+	/* Start each chunk with a key frame to allow starting playback at any chunk: */
+	bool keyFrame=numChunkFrames==0;
+	if(keyFrame)
 		{
-		/* Check if the input device is valid: */
-		if(validFlags[i])
-			{
-			/* Write valid flag: */
-			inputDeviceDataFile->write<unsigned char>(1);
-			
-			/* Write input device's tracker state: */
-			if(inputDevices[i]->getTrackType()!=InputDevice::TRACK_NONE)
-				{
-				inputDeviceDataFile->write(inputDevices[i]->getDeviceRayDirection().getComponents(),3);
-				inputDeviceDataFile->write(inputDevices[i]->getDeviceRayStart());
-				const TrackerState& t=inputDevices[i]->getTransformation();
-				inputDeviceDataFile->write(t.getTranslation().getComponents(),3);
-				inputDeviceDataFile->write(t.getRotation().getQuaternion(),4);
-				inputDeviceDataFile->write(inputDevices[i]->getLinearVelocity().getComponents(),3);
-				inputDeviceDataFile->write(inputDevices[i]->getAngularVelocity().getComponents(),3);
-				}
-			
-			/* Write input device's button states: */
-			unsigned char buttonBits=0x00U;
-			int numBits=0;
-			for(int j=0;j<inputDevices[i]->getNumButtons();++j)
-				{
-				buttonBits<<=1;
-				if(inputDevices[i]->getButtonState(j))
-					buttonBits|=0x01U;
-				if(++numBits==8)
-					{
-					inputDeviceDataFile->write(buttonBits);
-					buttonBits=0x00U;
-					numBits=0;
-					}
-				}
-			if(numBits!=0)
-				{
-				buttonBits<<=8-numBits;
-				inputDeviceDataFile->write(buttonBits);
-				}
-			
-			/* Write input device's valuator states: */
-			for(int j=0;j<inputDevices[i]->getNumValuators();++j)
-				{
-				double valuatorState=inputDevices[i]->getValuator(j);
-				inputDeviceDataFile->write(valuatorState);
-				}
-			}
-		else
-			{
-			/* Write valid flag: */
-			inputDeviceDataFile->write<unsigned char>(0);
-			}
-		
+		stateCoder->reset();
+		chunkFirstTimeStamp=currentTimeStamp;
 		}
 	
+	/* Write current time stamp: */
+	chunkBuffer.write(currentTimeStamp);
+	
+	/* Write the changed parts of the states of all input devices: */
+	for(int i=0;i<numInputDevices;++i)
+		stateCoder->writeDeviceState(i,*inputDevices[i],validFlags[i],keyFrame,chunkBuffer);
+	
 	/* Write all enqueued text and text control events: */
-	textEventDispatcher->writeEventQueues(*inputDeviceDataFile);
+	textEventDispatcher->writeEventQueues(chunkBuffer);
+	
+	chunkLastTimeStamp=currentTimeStamp;
+	++numChunkFrames;
 	}
 
 }
@@ -25,7 +25,10 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #define VRUI_INTERNAL_INPUTDEVICEDATASAVER_INCLUDED
 
 #include <string>
+#include <vector>
+#include <Misc/SizedTypes.h>
 #include <IO/File.h>
+#include <IO/VariableMemoryFile.h>
 #include <Vrui/InputGraphManager.h>
 
 /* Forward declarations: */
@@ -38,6 +41,7 @@ class SoundRecorder;
 namespace Vrui {
 class InputDevice;
 class InputDeviceManager;
+class InputDeviceStateCoder;
 class TextEventDispatcher;
 #ifdef VRUI_INPUTDEVICEDATASAVER_USE_KINECT
 class KinectRecorder;
@@ -48,12 +52,29 @@ namespace Vrui {
 
 class InputDeviceDataSaver
 	{
-	/* Elements: */
+	/* Embedded classes: */
 	private:
+	struct ChunkIndexEntry // Structure to locate a chunk of data frames in the input device data file
+		{
+		/* Elements: */
+		public:
+		double timeStamp; // Time stamp of the chunk's first data frame
+		Misc::UInt64 offset; // Position of the chunk's header in the input device data file
+		};
+	
+	/* Elements: */
 	IO::FilePtr inputDeviceDataFile; // File input device data is saved to
+	Misc::UInt64 dataFileSize; // Number of bytes written to the input device data file so far
 	int numInputDevices; // Number of saved (physical) input devices
 	InputDevice** inputDevices; // Array of pointers to saved input devices
 	bool* validFlags; // Array of flags indicating whether a saved input device is enabled
+	InputDeviceStateCoder* stateCoder; // Coder writing input device states as quantized differences to the previous data frame
+	double chunkDuration; // Maximum time span covered by a chunk of data frames
+	bool compressChunks; // Flag whether to compress chunks of data frames
+	IO::VariableMemoryFile chunkBuffer; // Buffer collecting the data frames of the current chunk
+	unsigned int numChunkFrames; // Number of data frames in the current chunk
+	double chunkFirstTimeStamp,chunkLastTimeStamp; // Time stamps of the first and last data frames in the current chunk
+	std::vector<ChunkIndexEntry> chunkIndex; // Index of all chunks written to the input device data file so far
 	TextEventDispatcher* textEventDispatcher; // Pointer to the dispatcher for GLMotif text and text control events
 	Sound::SoundRecorder* soundRecorder; // Pointer to sound recorder object to record commentary tracks
 	#ifdef VRUI_INPUTDEVICEDATASAVER_USE_KINECT
@@ -62,6 +83,8 @@ class InputDeviceDataSaver
 	
 	/* Private methods: */
 	void inputDeviceStateChangeCallback(InputGraphManager::InputDeviceStateChangeCallbackData* cbData); // Callback called when an input device changes state
+	void writeChunk(void); // Writes the current chunk of data frames to the input device data file
+	void writeChunkIndex(void); // Writes the chunk index to the end of the input device data file
 	
 	/* Constructors and destructors: */
 	public:
@@ -0,0 +1,276 @@
+/***********************************************************************
+InputDeviceStateCoder - Class to encode and decode the states of a set
+of input devices as quantized differences to the previously coded states
+for chunked input device data files.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#include <Vrui/Internal/InputDeviceStateCoder.h>
+
+#include <string.h>
+#include <Misc/VarIntMarshaller.h>
+#include <IO/File.h>
+#include <Math/Math.h>
+#include <Vrui/InputDevice.h>
+
+namespace Vrui {
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+inline Misc::SInt32 quantize(double value,double quantum) // Quantizes the given value, clamping it to the range of 32-bit signed integers
+	{
+	double q=Math::floor(value/quantum+0.5);
+	if(q>=2147483647.0)
+		return Misc::SInt32(2147483647);
+	else if(q>-2147483647.0)
+		return Misc::SInt32(q);
+	else
+		return Misc::SInt32(-2147483647); // Also catches NaN values
+	}
+
+inline void writeDelta(Misc::SInt32 oldValue,Misc::SInt32 newValue,IO::File& file) // Writes the difference between the given quantized values as a zig-zag encoded variable-length integer
+	{
+	/* Calculate the difference in modular arithmetic, which can always be reversed exactly: */
+	Misc::SInt32 delta=Misc::SInt32(Misc::UInt32(newValue)-Misc::UInt32(oldValue));
+	Misc::writeVarInt32((Misc::UInt32(delta)<<1)^Misc::UInt32(delta>>31),file);
+	}
+
+inline Misc::SInt32 readDelta(Misc::SInt32 oldValue,IO::File& file) // Reads a zig-zag encoded difference and applies it to the given quantized value
+	{
+	Misc::UInt32 zigZag=Misc::readVarInt32(file);
+	Misc::UInt32 delta=(zigZag>>1)^(0U-(zigZag&0x1U));
+	return Misc::SInt32(Misc::UInt32(oldValue)+delta);
+	}
+
+}
+
+/**************************************
+Methods of class InputDeviceStateCoder:
+**************************************/
+
+InputDeviceStateCoder::InputDeviceStateCoder(int sNumDevices,InputDevice* const* devices,double sPositionQuantum,double sOrientationQuantum)
+	:positionQuantum(sPositionQuantum),orientationQuantum(sOrientationQuantum),
+	 numDevices(sNumDevices),states(new DeviceState[numDevices])
+	{
+	/* Assign quantization steps to the tracker state components: */
+	double* qPtr=quanta;
+	for(int i=0;i<3;++i) // Device ray direction
+		*(qPtr++)=orientationQuantum;
+	*(qPtr++)=positionQuantum; // Device ray start
+	for(int i=0;i<3;++i) // Translation
+		*(qPtr++)=positionQuantum;
+	for(int i=0;i<4;++i) // Quaternion
+		*(qPtr++)=orientationQuantum;
+	for(int i=0;i<3;++i) // Linear velocity
+		*(qPtr++)=positionQuantum;
+	for(int i=0;i<3;++i) // Angular velocity
+		*(qPtr++)=orientationQuantum;
+	
+	/* Initialize the device states from the given device layouts: */
+	for(int deviceIndex=0;deviceIndex<numDevices;++deviceIndex)
+		{
+		DeviceState& ds=states[deviceIndex];
+		ds.tracked=devices[deviceIndex]->getTrackType()!=InputDevice::TRACK_NONE;
+		ds.numButtons=devices[deviceIndex]->getNumButtons();
+		ds.numButtonBytes=(ds.numButtons+7)/8;
+		ds.numValuators=devices[deviceIndex]->getNumValuators();
+		ds.buttonBits=new Misc::UInt8[ds.numButtonBytes];
+		ds.valuators=new double[ds.numValuators];
+		}
+	reset();
+	}
+
+InputDeviceStateCoder::~InputDeviceStateCoder(void)
+	{
+	for(int deviceIndex=0;deviceIndex<numDevices;++deviceIndex)
+		{
+		delete[] states[deviceIndex].buttonBits;
+		delete[] states[deviceIndex].valuators;
+		}
+	delete[] states;
+	}
+
+void InputDeviceStateCoder::reset(void)
+	{
+	for(int deviceIndex=0;deviceIndex<numDevices;++deviceIndex)
+		{
+		DeviceState& ds=states[deviceIndex];
+		ds.valid=true;
+		for(int i=0;i<numTrackerComponents;++i)
+			ds.tracker[i]=0;
+		memset(ds.buttonBits,0,ds.numButtonBytes);
+		for(int i=0;i<ds.numValuators;++i)
+			ds.valuators[i]=0.0;
+		}
+	}
+
+void InputDeviceStateCoder::writeDeviceState(int deviceIndex,const InputDevice& device,bool valid,bool keyFrame,IO::File& file)
+	{
+	DeviceState& ds=states[deviceIndex];
+	ds.valid=valid;
+	if(!valid)
+		{
+		/* Write an empty state: */
+		file.write<Misc::UInt8>(0x00U);
+		return;
+		}
+	
+	unsigned int parts=VALID;
+	
+	/* Quantize the device's tracker state and compare it to the previous state: */
+	Misc::SInt32 tracker[numTrackerComponents];
+	if(ds.tracked)
+		{
+		double components[numTrackerComponents];
+		double* cPtr=components;
+		for(int i=0;i<3;++i)
+			*(cPtr++)=device.getDeviceRayDirection()[i];
+		*(cPtr++)=device.getDeviceRayStart();
+		const TrackerState& t=device.getTransformation();
+		for(int i=0;i<3;++i)
+			*(cPtr++)=t.getTranslation()[i];
+		for(int i=0;i<4;++i)
+			*(cPtr++)=t.getRotation().getQuaternion()[i];
+		for(int i=0;i<3;++i)
+			*(cPtr++)=device.getLinearVelocity()[i];
+		for(int i=0;i<3;++i)
+			*(cPtr++)=device.getAngularVelocity()[i];
+		
+		for(int i=0;i<numTrackerComponents;++i)
+			{
+			tracker[i]=quantize(components[i],quanta[i]);
+			if(tracker[i]!=ds.tracker[i])
+				parts|=TRACKER;
+			}
+		if(keyFrame)
+			parts|=TRACKER;
+		}
+	
+	/* Pack the device's button states and compare them to the previous states: */
+	Misc::UInt8 buttonBits[32];
+	Misc::UInt8* bbPtr=ds.numButtonBytes<=int(sizeof(buttonBits))?buttonBits:new Misc::UInt8[ds.numButtonBytes];
+	memset(bbPtr,0,ds.numButtonBytes);
+	for(int i=0;i<ds.numButtons;++i)
+		if(device.getButtonState(i))
+			bbPtr[i>>3]|=Misc::UInt8(0x80U>>(i&0x7));
+	if(ds.numButtons>0&&(keyFrame||memcmp(bbPtr,ds.buttonBits,ds.numButtonBytes)!=0))
+		parts|=BUTTONS;
+	
+	/* Compare the device's valuator states to the previous states: */
+	if(ds.numValuators>0)
+		{
+		if(keyFrame)
+			parts|=VALUATORS;
+		for(int i=0;i<ds.numValuators&&(parts&VALUATORS)==0x0U;++i)
+			if(device.getValuator(i)!=ds.valuators[i])
+				parts|=VALUATORS;
+		}
+	
+	/* Write the flags indicating which state parts follow: */
+	file.write<Misc::UInt8>(Misc::UInt8(parts));
+	
+	if(parts&TRACKER)
+		{
+		/* Write the tracker state as differences to the previous state: */
+		for(int i=0;i<numTrackerComponents;++i)
+			{
+			writeDelta(ds.tracker[i],tracker[i],file);
+			ds.tracker[i]=tracker[i];
+			}
+		}
+	
+	if(parts&BUTTONS)
+		{
+		/* Write the packed button states: */
+		file.write(bbPtr,ds.numButtonBytes);
+		memcpy(ds.buttonBits,bbPtr,ds.numButtonBytes);
+		}
+	if(bbPtr!=buttonBits)
+		delete[] bbPtr;
+	
+	if(parts&VALUATORS)
+		{
+		/* Write the valuator states unquantized, as they are often discrete: */
+		for(int i=0;i<ds.numValuators;++i)
+			{
+			ds.valuators[i]=device.getValuator(i);
+			file.write<double>(ds.valuators[i]);
+			}
+		}
+	}
+
+unsigned int InputDeviceStateCoder::readDeviceState(int deviceIndex,IO::File& file)
+	{
+	DeviceState& ds=states[deviceIndex];
+	
+	/* Read the flags indicating which state parts follow: */
+	unsigned int parts=file.read<Misc::UInt8>();
+	ds.valid=(parts&VALID)!=0x0U;
+	
+	if(parts&TRACKER)
+		{
+		/* Read the tracker state as differences to the previous state: */
+		for(int i=0;i<numTrackerComponents;++i)
+			ds.tracker[i]=readDelta(ds.tracker[i],file);
+		}
+	
+	if(parts&BUTTONS)
+		{
+		/* Read the packed button states: */
+		file.read(ds.buttonBits,ds.numButtonBytes);
+		}
+	
+	if(parts&VALUATORS)
+		{
+		/* Read the valuator states: */
+		file.read(ds.valuators,ds.numValuators);
+		}
+	
+	return parts;
+	}
+
+void InputDeviceStateCoder::getTrackerState(int deviceIndex,Vector& deviceRayDirection,Scalar& deviceRayStart,TrackerState& transformation,Vector& linearVelocity,Vector& angularVelocity) const
+	{
+	/* Dequantize the tracker state components: */
+	const DeviceState& ds=states[deviceIndex];
+	Scalar components[numTrackerComponents];
+	for(int i=0;i<numTrackerComponents;++i)
+		components[i]=Scalar(ds.tracker[i])*Scalar(quanta[i]);
+	
+	const Scalar* cPtr=components;
+	deviceRayDirection=Vector(cPtr);
+	cPtr+=3;
+	deviceRayStart=*(cPtr++);
+	TrackerState::Vector translation(cPtr);
+	cPtr+=3;
+	TrackerState::Rotation rotation(cPtr);
+	rotation.renormalize(); // Quantization leaves the quaternion slightly denormalized
+	cPtr+=4;
+	transformation=TrackerState(translation,rotation);
+	linearVelocity=Vector(cPtr);
+	cPtr+=3;
+	angularVelocity=Vector(cPtr);
+	}
+
+}
@@ -0,0 +1,108 @@
+/***********************************************************************
+InputDeviceStateCoder - Class to encode and decode the states of a set
+of input devices as quantized differences to the previously coded states
+for chunked input device data files.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef VRUI_INTERNAL_INPUTDEVICESTATECODER_INCLUDED
+#define VRUI_INTERNAL_INPUTDEVICESTATECODER_INCLUDED
+
+#include <Misc/SizedTypes.h>
+#include <Vrui/Geometry.h>
+
+/* Forward declarations: */
+namespace IO {
+class File;
+}
+namespace Vrui {
+class InputDevice;
+}
+
+namespace Vrui {
+
+class InputDeviceStateCoder
+	{
+	/* Embedded classes: */
+	public:
+	enum StateParts // Enumerated type for flags denoting which parts of a device state are stored in a data frame
+		{
+		VALID=0x01U,TRACKER=0x02U,BUTTONS=0x04U,VALUATORS=0x08U
+		};
+	
+	private:
+	static const int numTrackerComponents=17; // Number of quantized components in a tracker state: ray direction and start, translation, quaternion, linear and angular velocity
+	
+	struct DeviceState // Structure holding the most recently coded state of an input device
+		{
+		/* Elements: */
+		public:
+		bool tracked; // Flag whether the device has a tracker state
+		int numButtons; // Number of buttons on the device
+		int numButtonBytes; // Number of bytes to store the device's packed button states
+		int numValuators; // Number of valuators on the device
+		bool valid; // Flag whether the device was valid in the last coded data frame
+		Misc::SInt32 tracker[numTrackerComponents]; // Quantized tracker state components
+		Misc::UInt8* buttonBits; // Packed button states, most significant bit first
+		double* valuators; // Valuator states
+		};
+	
+	/* Elements: */
+	double positionQuantum; // Quantization step for positions and linear velocities in physical coordinate units
+	double orientationQuantum; // Quantization step for ray directions, quaternion components, and angular velocities
+	double quanta[numTrackerComponents]; // Quantization step for each tracker state component
+	int numDevices; // Number of coded input devices
+	DeviceState* states; // Array of most recently coded states of all input devices
+	
+	/* Constructors and destructors: */
+	public:
+	InputDeviceStateCoder(int sNumDevices,InputDevice* const* devices,double sPositionQuantum,double sOrientationQuantum); // Creates a coder for input devices of the same layouts as the given devices, using the given quantization steps
+	~InputDeviceStateCoder(void);
+	
+	/* Methods: */
+	double getPositionQuantum(void) const // Returns the position quantization step
+		{
+		return positionQuantum;
+		}
+	double getOrientationQuantum(void) const // Returns the orientation quantization step
+		{
+		return orientationQuantum;
+		}
+	void reset(void); // Resets all coded device states to zero at the beginning of a chunk of data frames
+	void writeDeviceState(int deviceIndex,const InputDevice& device,bool valid,bool keyFrame,IO::File& file); // Writes the parts of the given device's current state that changed since the last written state, or all parts if keyFrame is true
+	unsigned int readDeviceState(int deviceIndex,IO::File& file); // Reads the state of the given device from the given file; returns a combination of StateParts flags for the parts that were read
+	bool isValid(int deviceIndex) const // Returns true if the given device was valid in the most recently read data frame
+		{
+		return states[deviceIndex].valid;
+		}
+	void getTrackerState(int deviceIndex,Vector& deviceRayDirection,Scalar& deviceRayStart,TrackerState& transformation,Vector& linearVelocity,Vector& angularVelocity) const; // Returns the given device's most recently read tracker state
+	bool getButtonState(int deviceIndex,int buttonIndex) const // Returns the given device's most recently read state of the given button
+		{
+		return (states[deviceIndex].buttonBits[buttonIndex>>3]&(0x80U>>(buttonIndex&0x7)))!=0x00U;
+		}
+	double getValuator(int deviceIndex,int valuatorIndex) const // Returns the given device's most recently read state of the given valuator
+		{
+		return states[deviceIndex].valuators[valuatorIndex];
+		}
+	};
+
+}
+
+#endif
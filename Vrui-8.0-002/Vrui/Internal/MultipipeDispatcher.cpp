@@ -23,6 +23,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 
 #include <Vrui/Internal/MultipipeDispatcher.h>
 
+#include <string.h>
 #include <Misc/ThrowStdErr.h>
 #include <Misc/Marshaller.h>
 #include <Misc/StringMarshaller.h>
@@ -40,19 +41,124 @@ namespace Vrui {
 Methods of class MultipipeDispatcher:
 ************************************/
 
-MultipipeDispatcher::MultipipeDispatcher(InputDeviceManager* sInputDeviceManager,Cluster::MulticastPipe* sPipe)
+void MultipipeDispatcher::sendStateDeltas(void)
+	{
+	/* Clear the change masks: */
+	for(int i=0;i<numDeviceMaskWords;++i)
+		deviceMask[i]=0x0U;
+	for(int i=0;i<numValuatorMaskWords;++i)
+		valuatorMask[i]=0x0U;
+	
+	/* Gather the current state of all input devices and compare it bit-wise against the state sent in the last update: */
+	bool buttonsChanged=sendKeyframe;
+	bool* bsPtr=buttonStates;
+	int valuatorIndex=0;
+	for(int i=0;i<numInputDevices;++i)
+		{
+		InputDeviceTrackingState ts;
+		ts.deviceRayDirection=inputDevices[i]->getDeviceRayDirection();
+		ts.deviceRayStart=inputDevices[i]->getDeviceRayStart();
+		ts.transformation=inputDevices[i]->getTransformation();
+		ts.linearVelocity=inputDevices[i]->getLinearVelocity();
+		ts.angularVelocity=inputDevices[i]->getAngularVelocity();
+		if(sendKeyframe||memcmp(&ts,&trackingStates[i],sizeof(InputDeviceTrackingState))!=0)
+			{
+			trackingStates[i]=ts;
+			deviceMask[i>>5]|=0x1U<<(i&0x1f);
+			}
+		
+		for(int j=0;j<inputDevices[i]->getNumButtons();++j,++bsPtr)
+			{
+			bool buttonState=inputDevices[i]->getButtonState(j);
+			if(sendKeyframe||*bsPtr!=buttonState)
+				{
+				*bsPtr=buttonState;
+				buttonsChanged=true;
+				}
+			}
+		
+		for(int j=0;j<inputDevices[i]->getNumValuators();++j,++valuatorIndex)
+			{
+			double valuatorState=inputDevices[i]->getValuator(j);
+			if(sendKeyframe||memcmp(&valuatorState,&valuatorStates[valuatorIndex],sizeof(double))!=0)
+				{
+				valuatorStates[valuatorIndex]=valuatorState;
+				valuatorMask[valuatorIndex>>5]|=0x1U<<(valuatorIndex&0x1f);
+				}
+			}
+		}
+	
+	/* Send the tracking states of all changed input devices: */
+	pipe->write<Misc::UInt32>(deviceMask,numDeviceMaskWords);
+	for(int i=0;i<numInputDevices;++i)
+		if(deviceMask[i>>5]&(0x1U<<(i&0x1f)))
+			pipe->write<InputDeviceTrackingState>(trackingStates[i]);
+	
+	/* Send the bit-packed states of all buttons if any of them changed: */
+	pipe->write<Misc::UInt8>(buttonsChanged?1:0);
+	if(buttonsChanged)
+		{
+		for(int i=0;i<numPackedButtonBytes;++i)
+			packedButtonStates[i]=0x0U;
+		for(int i=0;i<totalNumButtons;++i)
+			if(buttonStates[i])
+				packedButtonStates[i>>3]|=Misc::UInt8(0x1U<<(i&0x7));
+		pipe->write<Misc::UInt8>(packedButtonStates,numPackedButtonBytes);
+		}
+	
+	/* Send the values of all changed valuators: */
+	pipe->write<Misc::UInt32>(valuatorMask,numValuatorMaskWords);
+	for(int i=0;i<totalNumValuators;++i)
+		if(valuatorMask[i>>5]&(0x1U<<(i&0x1f)))
+			pipe->write<double>(valuatorStates[i]);
+	
+	sendKeyframe=false;
+	}
+
+void MultipipeDispatcher::receiveStateDeltas(void)
+	{
+	/* Receive the tracking states of all changed input devices: */
+	pipe->read<Misc::UInt32>(deviceMask,numDeviceMaskWords);
+	for(int i=0;i<numInputDevices;++i)
+		if(deviceMask[i>>5]&(0x1U<<(i&0x1f)))
+			pipe->read<InputDeviceTrackingState>(trackingStates[i]);
+	
+	/* Receive the bit-packed states of all buttons if any of them changed: */
+	if(pipe->read<Misc::UInt8>()!=0)
+		{
+		pipe->read<Misc::UInt8>(packedButtonStates,numPackedButtonBytes);
+		for(int i=0;i<totalNumButtons;++i)
+			buttonStates[i]=(packedButtonStates[i>>3]&(0x1U<<(i&0x7)))!=0x0U;
+		}
+	
+	/* Receive the values of all changed valuators: */
+	pipe->read<Misc::UInt32>(valuatorMask,numValuatorMaskWords);
+	for(int i=0;i<totalNumValuators;++i)
+		if(valuatorMask[i>>5]&(0x1U<<(i&0x1f)))
+			pipe->read<double>(valuatorStates[i]);
+	}
+
+MultipipeDispatcher::MultipipeDispatcher(InputDeviceManager* sInputDeviceManager,Cluster::MulticastPipe* sPipe,bool sSendDeltas)
 	:InputDeviceAdapter(sInputDeviceManager),
 	 pipe(sPipe),
 	 totalNumButtons(0),
 	 totalNumValuators(0),
+	 sendDeltas(sSendDeltas),
 	 trackingStates(0),
 	 buttonStates(0),
-	 valuatorStates(0)
+	 valuatorStates(0),
+	 sendKeyframe(true),
+	 numDeviceMaskWords(0),deviceMask(0),
+	 numPackedButtonBytes(0),packedButtonStates(0),
+	 numValuatorMaskWords(0),valuatorMask(0)
 	{
 	if(pipe->isMaster())
 		{
 		/* Distribute the input device configuration from the input device manager to all slave nodes: */
 		
+		/* Send the state distribution mode: */
+		pipe->write<char>(sendDeltas?1:0);
+		
 		/* Send number of input devices: */
 		numInputDevices=inputDeviceManager->getNumInputDevices();
 		pipe->write<int>(numInputDevices);
@@ -102,6 +208,9 @@ MultipipeDispatcher::MultipipeDispatcher(InputDeviceManager* sInputDeviceManager
 		
 		/* Receive the input device configuration from the master node: */
 		
+		/* Read the state distribution mode: */
+		sendDeltas=pipe->read<char>()!=0;
+		
 		/* Read number of input devices: */
 		numInputDevices=pipe->read<int>();
 		inputDevices=new InputDevice*[numInputDevices];
@@ -152,6 +261,16 @@ MultipipeDispatcher::MultipipeDispatcher(InputDeviceManager* sInputDeviceManager
 	trackingStates=new InputDeviceTrackingState[numInputDevices];
 	buttonStates=new bool[totalNumButtons];
 	valuatorStates=new double[totalNumValuators];
+	if(sendDeltas)
+		{
+		/* Create the input device state change marshalling structures: */
+		numDeviceMaskWords=(numInputDevices+31)/32;
+		deviceMask=new Misc::UInt32[numDeviceMaskWords];
+		numPackedButtonBytes=(totalNumButtons+7)/8;
+		packedButtonStates=new Misc::UInt8[numPackedButtonBytes];
+		numValuatorMaskWords=(totalNumValuators+31)/32;
+		valuatorMask=new Misc::UInt32[numValuatorMaskWords];
+		}
 	}
 
 MultipipeDispatcher::~MultipipeDispatcher(void)
@@ -166,6 +285,9 @@ MultipipeDispatcher::~MultipipeDispatcher(void)
 	delete[] trackingStates;
 	delete[] buttonStates;
 	delete[] valuatorStates;
+	delete[] deviceMask;
+	delete[] packedButtonStates;
+	delete[] valuatorMask;
 	}
 
 std::string MultipipeDispatcher::getFeatureName(const InputDeviceFeature& feature) const
@@ -241,6 +363,13 @@ void MultipipeDispatcher::updateInputDevices(void)
 	{
 	if(pipe->isMaster())
 		{
+		if(sendDeltas)
+			{
+			/* Send only the input device states that changed since the last update to the slave nodes: */
+			sendStateDeltas();
+			return;
+			}
+		
 		/* Gather the current state of all input devices: */
 		bool* bsPtr=buttonStates;
 		double* vsPtr=valuatorStates;
@@ -265,9 +394,14 @@ void MultipipeDispatcher::updateInputDevices(void)
 	else
 		{
 		/* Receive the input device states from the master node: */
-		pipe->read<InputDeviceTrackingState>(trackingStates,numInputDevices);
-		pipe->read<bool>(buttonStates,totalNumButtons);
-		pipe->read<double>(valuatorStates,totalNumValuators);
+		if(sendDeltas)
+			receiveStateDeltas();
+		else
+			{
+			pipe->read<InputDeviceTrackingState>(trackingStates,numInputDevices);
+			pipe->read<bool>(buttonStates,totalNumButtons);
+			pipe->read<double>(valuatorStates,totalNumValuators);
+			}
 		
 		/* Set the state of all input devices: */
 		bool* bsPtr=buttonStates;
@@ -26,6 +26,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 
 #include <string>
 #include <vector>
+#include <Misc/SizedTypes.h>
 #include <Geometry/Vector.h>
 #include <Geometry/OrthonormalTransformation.h>
 #include <Vrui/Geometry.h>
@@ -61,6 +62,7 @@ class MultipipeDispatcher:public InputDeviceAdapter
 	Cluster::MulticastPipe* pipe; // Multicast pipe connecting the master node to all slave nodes
 	int totalNumButtons; // Total number of buttons on all dispatched input devices
 	int totalNumValuators; // Total number of valuators on all dispatched input devices
+	bool sendDeltas; // Flag whether only the states of input devices, buttons, and valuators that changed since the last frame are sent to the slave nodes
 	
 	/* Slave state: */
 	std::vector<std::string> buttonNames; // Array of button names for all dispatched input devices
@@ -71,9 +73,22 @@ class MultipipeDispatcher:public InputDeviceAdapter
 	bool* buttonStates; // Array of input device button states
 	double* valuatorStates; // Array of input device valuator states
 	
+	/* Transient state to marshall input device state changes over a multicast pipe: */
+	bool sendKeyframe; // Flag whether the next update sends the complete state of all input devices
+	int numDeviceMaskWords; // Number of words in the bit mask of changed input devices
+	Misc::UInt32* deviceMask; // Bit mask of input devices whose tracking states changed since the last update
+	int numPackedButtonBytes; // Number of bytes in the array of bit-packed button states
+	Misc::UInt8* packedButtonStates; // Array of bit-packed button states
+	int numValuatorMaskWords; // Number of words in the bit mask of changed valuators
+	Misc::UInt32* valuatorMask; // Bit mask of valuators whose values changed since the last update
+	
+	/* Private methods: */
+	void sendStateDeltas(void); // Sends the changes in input device states since the last update to the slave nodes
+	void receiveStateDeltas(void); // Receives changes in input device states from the master node
+	
 	/* Constructors and destructors: */
 	public:
-	MultipipeDispatcher(InputDeviceManager* sInputDeviceManager,Cluster::MulticastPipe* sPipe);
+	MultipipeDispatcher(InputDeviceManager* sInputDeviceManager,Cluster::MulticastPipe* sPipe,bool sSendDeltas =false); // Creates a dispatcher; the delta mode flag is only used on the master node, and forwarded to the slave nodes
 	virtual ~MultipipeDispatcher(void);
 	
 	/* Methods from InputDeviceAdapter: */
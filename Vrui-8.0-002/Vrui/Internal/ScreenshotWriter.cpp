@@ -0,0 +1,95 @@
+/***********************************************************************
+ScreenshotWriter - Helper class to encode and write screenshot images
+to files in a background thread.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#include <Vrui/Internal/ScreenshotWriter.h>
+
+#include <stdexcept>
+#include <Misc/MessageLogger.h>
+#include <Images/WriteImageFile.h>
+
+namespace Vrui {
+
+/*********************************
+Methods of class ScreenshotWriter:
+*********************************/
+
+void* ScreenshotWriter::screenshotWritingThreadMethod(void)
+	{
+	while(true)
+		{
+		/* Wait for the next screenshot: */
+		Screenshot screenshot;
+		{
+		Threads::MutexCond::Lock screenshotsLock(screenshotsCond);
+		while(!done&&screenshots.empty())
+			screenshotsCond.wait(screenshotsLock);
+		if(screenshots.empty()) // Bail out if there will be no more screenshots
+			break;
+		screenshot=screenshots.front();
+		screenshots.pop_front();
+		}
+		
+		/* Write the screenshot to its image file: */
+		try
+			{
+			Images::writeImageFile(screenshot.image,screenshot.imageFileName.c_str());
+			}
+		catch(const std::runtime_error& err)
+			{
+			Misc::formattedUserError("Save Screenshot: Unable to write screenshot to file %s due to exception %s",screenshot.imageFileName.c_str(),err.what());
+			}
+		}
+	
+	return 0;
+	}
+
+ScreenshotWriter::ScreenshotWriter(void)
+	:done(false)
+	{
+	/* Start the screenshot writing thread: */
+	screenshotWritingThread.start(this,&ScreenshotWriter::screenshotWritingThreadMethod);
+	}
+
+ScreenshotWriter::~ScreenshotWriter(void)
+	{
+	/* Tell the screenshot writing thread to shut down once all pending screenshots are written: */
+	{
+	Threads::MutexCond::Lock screenshotsLock(screenshotsCond);
+	done=true;
+	screenshotsCond.signal();
+	}
+	screenshotWritingThread.join();
+	}
+
+void ScreenshotWriter::writeScreenshot(const Images::RGBImage& image,const std::string& imageFileName)
+	{
+	/* Append the screenshot to the queue and wake up the screenshot writing thread: */
+	Threads::MutexCond::Lock screenshotsLock(screenshotsCond);
+	Screenshot screenshot;
+	screenshot.image=image;
+	screenshot.imageFileName=imageFileName;
+	screenshots.push_back(screenshot);
+	screenshotsCond.signal();
+	}
+
+}
@@ -0,0 +1,67 @@
+/***********************************************************************
+ScreenshotWriter - Helper class to encode and write screenshot images
+to files in a background thread.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef VRUI_INTERNAL_SCREENSHOTWRITER_INCLUDED
+#define VRUI_INTERNAL_SCREENSHOTWRITER_INCLUDED
+
+#include <string>
+#include <deque>
+#include <Threads/MutexCond.h>
+#include <Threads/Thread.h>
+#include <Images/RGBImage.h>
+
+namespace Vrui {
+
+class ScreenshotWriter
+	{
+	/* Embedded classes: */
+	private:
+	struct Screenshot // Structure for a screenshot waiting to be written
+		{
+		/* Elements: */
+		public:
+		Images::RGBImage image; // The screenshot image
+		std::string imageFileName; // Name of the image file to which to write the screenshot
+		};
+	
+	/* Elements: */
+	Threads::MutexCond screenshotsCond; // Condition variable to signal arrival of new screenshots or shutdown
+	std::deque<Screenshot> screenshots; // Queue of screenshots waiting to be written
+	bool done; // Flag to shut down the screenshot writing thread once the queue is empty
+	Threads::Thread screenshotWritingThread; // Thread writing screenshots in the background
+	
+	/* Private methods: */
+	void* screenshotWritingThreadMethod(void);
+	
+	/* Constructors and destructors: */
+	public:
+	ScreenshotWriter(void); // Creates a screenshot writer and starts its background thread
+	~ScreenshotWriter(void); // Writes all pending screenshots and shuts down the background thread
+	
+	/* Methods: */
+	void writeScreenshot(const Images::RGBImage& image,const std::string& imageFileName); // Queues the given image for writing to the given image file
+	};
+
+}
+
+#endif
@@ -27,11 +27,13 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 
 #include <Misc/SizedTypes.h>
 #include <Misc/Time.h>
+#include <Misc/StandardMarshallers.h>
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
 #include <Realtime/Time.h>
 #include <Vrui/Internal/VRDeviceDescriptor.h>
 #include <Vrui/Internal/HMDConfiguration.h>
+#include <Vrui/Internal/VRDeviceSharedState.h>
 
 #if DEBUG_PROTOCOL
 #include <iostream>
@@ -180,6 +182,15 @@ void* VRDeviceClient::streamReceiveThreadMethod(void)
 				/* Signal packet reception: */
 				packetSignalCond.broadcast();
 				
+				/* Invoke packet notification callback: */
+				if(packetNotificationCallback!=0)
+					(*packetNotificationCallback)(this);
+				}
+			else if(message==VRDevicePipe::SHAREDSTATE_UPDATE)
+				{
+				/* The server updated the shared device state; signal packet reception: */
+				packetSignalCond.broadcast();
+				
 				/* Invoke packet notification callback: */
 				if(packetNotificationCallback!=0)
 					(*packetNotificationCallback)(this);
@@ -355,11 +366,68 @@ void VRDeviceClient::initClient(void)
 		numPowerFeatures=pipe.read<Misc::UInt32>();
 		numHapticFeatures=pipe.read<Misc::UInt32>();
 		}
+	
+	/* Check if the server offers its device state in shared memory: */
+	if(serverProtocolVersionNumber>=10U)
+		{
+		/* Read the name of the server's shared memory segment: */
+		std::string sharedStateName;
+		Misc::read(pipe,sharedStateName);
+		
+		if(local&&useSharedState&&!sharedStateName.empty())
+			{
+			/* Attach to the shared device state; fall back to receiving state updates through the pipe on failure: */
+			try
+				{
+				sharedState=new VRDeviceSharedState(sharedStateName.c_str());
+				if(!sharedState->hasLayout(state))
+					throw std::runtime_error("Mismatching device state layout");
+				}
+			catch(const std::runtime_error& err)
+				{
+				delete sharedState;
+				sharedState=0;
+				}
+			}
+		
+		if(sharedState!=0)
+			{
+			/* Request to receive state updates through the shared device state: */
+			pipe.writeMessage(VRDevicePipe::SHAREDSTATE_REQUEST);
+			pipe.flush();
+			
+			/* Wait for server's reply: */
+			if(!pipe.waitForData(Misc::Time(30,0)))
+				throw ProtocolError("VRDeviceClient: Timeout while waiting for SHAREDSTATE_REPLY",this);
+			if(pipe.readMessage()!=VRDevicePipe::SHAREDSTATE_REPLY)
+				throw ProtocolError("VRDeviceClient: Mismatching message while waiting for SHAREDSTATE_REPLY",this);
+			int slot=pipe.read<Misc::SInt32>();
+			if(slot>=0)
+				sharedStateSlot=(unsigned int)slot;
+			else
+				{
+				/* Server denied the request; detach from the shared device state: */
+				delete sharedState;
+				sharedState=0;
+				}
+			}
+		}
+	}
+
+void VRDeviceClient::readSharedState(void) const
+	{
+	/* Acknowledge the most recent update notification before reading, to be notified of any later updates: */
+	sharedState->acknowledgeNotification(sharedStateSlot);
+	
+	/* Copy the shared device state into the state shadow; keep the previous state if no consistent snapshot could be taken: */
+	sharedState->readState(state);
 	}
 
 VRDeviceClient::VRDeviceClient(const char* deviceServerName,int deviceServerPort)
 	:pipe(deviceServerName,deviceServerPort),
+	 useSharedState(true),
 	 serverProtocolVersionNumber(0),serverHasTimeStamps(false),
+	 sharedState(0),sharedStateSlot(0),
 	 batteryStates(0),batteryStateUpdatedCallback(0),
 	 numHmdConfigurations(0),hmdConfigurations(0),hmdConfigurationUpdatedCallbacks(0),
 	 numPowerFeatures(0),numHapticFeatures(0),
@@ -371,7 +439,9 @@ VRDeviceClient::VRDeviceClient(const char* deviceServerName,int deviceServerPort
 
 VRDeviceClient::VRDeviceClient(const Misc::ConfigurationFileSection& configFileSection)
 	:pipe(configFileSection.retrieveString("./serverName").c_str(),configFileSection.retrieveValue<int>("./serverPort")),
+	 useSharedState(configFileSection.retrieveValue<bool>("./useSharedMemory",true)),
 	 serverProtocolVersionNumber(0),serverHasTimeStamps(false),
+	 sharedState(0),sharedStateSlot(0),
 	 batteryStates(0),batteryStateUpdatedCallback(0),
 	 numHmdConfigurations(0),hmdConfigurations(0),hmdConfigurationUpdatedCallbacks(0),
 	 numPowerFeatures(0),numHapticFeatures(0),
@@ -410,6 +480,9 @@ VRDeviceClient::~VRDeviceClient(void)
 	/* Delete battery states and HMD configurations: */
 	delete[] batteryStates;
 	delete[] hmdConfigurations;
+	
+	/* Detach from the shared device state: */
+	delete sharedState;
 	}
 
 const HMDConfiguration& VRDeviceClient::getHmdConfiguration(unsigned int index) const
@@ -449,12 +522,16 @@ void VRDeviceClient::getPacket(void)
 			if(connectionDead)
 				throw ProtocolError("VRDeviceClient: Server disconnected",this);
 			
+			/* Acknowledge the most recent shared state update notification to be notified of the next update: */
+			if(sharedState!=0)
+				sharedState->acknowledgeNotification(sharedStateSlot);
+			
 			/* Wait for arrival of next packet: */
 			packetSignalCond.wait();
 			if(connectionDead)
 				throw ProtocolError("VRDeviceClient: Server disconnected",this);
 			}
-		else
+		else if(sharedState==0)
 			{
 			/* Send packet request message: */
 			pipe.writeMessage(VRDevicePipe::PACKET_REQUEST);
@@ -570,6 +647,10 @@ void VRDeviceClient::startStream(VRDeviceClient::Callback* newPacketNotification
 				(*batteryStateUpdatedCallback)(i);
 			}
 		
+		/* Reset the shared state update notification flag so that the server notifies this client of the next update: */
+		if(sharedState!=0)
+			sharedState->acknowledgeNotification(sharedStateSlot);
+		
 		/* Start the packet receiving thread: */
 		streamReceiveThread.start(this,&VRDeviceClient::streamReceiveThreadMethod);
 		
@@ -42,6 +42,7 @@ class ConfigurationFileSection;
 namespace Vrui {
 class VRDeviceDescriptor;
 class HMDConfiguration;
+class VRDeviceSharedState;
 }
 
 namespace Vrui {
@@ -73,12 +74,15 @@ class VRDeviceClient
 	private:
 	VRDevicePipe pipe; // Pipe connected to device server
 	bool local; // Flag whether the connected device server runs on the same host, i.e., uses the same time stamp source
+	bool useSharedState; // Flag whether to receive device state updates through a local server's shared memory segment
 	unsigned int serverProtocolVersionNumber; // Version number of server protocol
 	bool serverHasTimeStamps; // Flag whether the connected device server sends tracker state time stamps
 	bool serverHasValidFlags; // Flag whether the connected device server sends tracker valid flags
 	std::vector<VRDeviceDescriptor*> virtualDevices; // List of virtual input devices managed by the server
 	mutable Threads::Mutex stateMutex; // Mutex to serialize access to current state
-	VRDeviceState state; // Shadow of server's current state
+	mutable VRDeviceState state; // Shadow of server's current state
+	VRDeviceSharedState* sharedState; // Device state shared by a local server, or null if state updates are received through the pipe
+	unsigned int sharedStateSlot; // Index of this client's update notification slot in the shared device state
 	mutable Threads::Mutex batteryStatesMutex; // Mutex to serialize access to the battery state array
 	BatteryState* batteryStates; // Array of virtual device battery states maintained by the server
 	BatteryStateUpdatedCallback* batteryStateUpdatedCallback; // Callback called when a virtual device's battery status changes
@@ -100,6 +104,7 @@ class VRDeviceClient
 	/* Private methods: */
 	void* streamReceiveThreadMethod(void); // Stream packet receiving thread method
 	void initClient(void); // Initializes communication between device server and client
+	void readSharedState(void) const; // Updates the state shadow from the shared device state
 	
 	/* Constructors and destructors: */
 	public:
@@ -120,9 +125,17 @@ class VRDeviceClient
 		{
 		return *(virtualDevices[deviceIndex]);
 		}
+	bool hasSharedState(void) const // Returns true if the client receives device state updates through a local server's shared memory segment
+		{
+		return sharedState!=0;
+		}
 	void lockState(void) const // Locks current server state
 		{
 		stateMutex.lock();
+		
+		/* Update the state shadow from the shared device state: */
+		if(sharedState!=0)
+			readSharedState();
 		}
 	void unlockState(void) const // Unlocks current server state
 		{
@@ -167,7 +180,7 @@ class VRDeviceClient
 		}
 	void activate(void); // Prepares the server for sending state packets
 	void deactivate(void); // Deactivates server
-	void getPacket(void); // Requests state packet from server; blocks until arrival
+	void getPacket(void); // Requests state packet from server; blocks until arrival, or returns immediately when not streaming from a shared device state
 	void powerOff(unsigned int powerFeatureIndex); // Requests to power off the given power feature
 	void hapticTick(unsigned int hapticFeatureIndex,unsigned int duration,unsigned int frequency,unsigned int amplitude); // Requests a haptic tick of the given duration in milliseconds, frequency in Hertz, and relative amplitude in [0, 256) on the given haptic feature
 	void setBatteryStateUpdatedCallback(BatteryStateUpdatedCallback* newBatteryStateUpdatedCallback); // Installs given callback function (device client adopts function object; battery states must be locked)
@@ -54,7 +54,10 @@ class VRDevicePipe:public Comm::TCPPipe
 		HAPTICTICK_REQUEST, // Requests a haptic tick on a virtual input device
 		TRACKER_UPDATE, // Sends new state for a single tracker
 		BUTTON_UPDATE, // Sends new state for a single button
-		VALUATOR_UPDATE // Sends new state for a single valuator
+		VALUATOR_UPDATE, // Sends new state for a single valuator
+		SHAREDSTATE_REQUEST, // Local client attached to the server's shared device state and requests to receive state updates through it
+		SHAREDSTATE_REPLY, // Reply to shared state request with client's notification slot index, or -1 if the request was denied
+		SHAREDSTATE_UPDATE // Notifies a client that the shared device state has been updated
 		};
 	
 	/* Constructors and destructors: */
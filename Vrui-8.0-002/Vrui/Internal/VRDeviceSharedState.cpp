@@ -0,0 +1,278 @@
+/***********************************************************************
+VRDeviceSharedState - Class to share the current state of a VR device
+server with local clients via a POSIX shared memory segment protected by
+a sequence lock.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#include <Vrui/Internal/VRDeviceSharedState.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <grp.h>
+#include <Misc/ThrowStdErr.h>
+
+namespace Vrui {
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+const Misc::UInt32 sharedStateMagic=0x56524401U; // Magic number of shared state segments, including layout version number
+
+inline size_t align(size_t offset) // Aligns the given offset to the next multiple of eight bytes
+	{
+	return (offset+7)&~size_t(7);
+	}
+
+}
+
+/************************************
+Methods of class VRDeviceSharedState:
+************************************/
+
+size_t VRDeviceSharedState::calcLayout(int numTrackers,int numButtons,int numValuators,size_t offsets[5])
+	{
+	size_t offset=align(sizeof(Header));
+	offsets[0]=offset;
+	offset=align(offset+size_t(numTrackers)*sizeof(VRDeviceState::TrackerState));
+	offsets[1]=offset;
+	offset=align(offset+size_t(numTrackers)*sizeof(VRDeviceState::TimeStamp));
+	offsets[2]=offset;
+	offset=align(offset+size_t(numTrackers)*sizeof(VRDeviceState::ValidFlag));
+	offsets[3]=offset;
+	offset=align(offset+size_t(numButtons)*sizeof(VRDeviceState::ButtonState));
+	offsets[4]=offset;
+	offset=align(offset+size_t(numValuators)*sizeof(VRDeviceState::ValuatorState));
+	return offset;
+	}
+
+void VRDeviceSharedState::setPointers(const size_t offsets[5])
+	{
+	header=reinterpret_cast<Header*>(memory);
+	trackerStates=reinterpret_cast<VRDeviceState::TrackerState*>(memory+offsets[0]);
+	trackerTimeStamps=reinterpret_cast<VRDeviceState::TimeStamp*>(memory+offsets[1]);
+	trackerValids=reinterpret_cast<VRDeviceState::ValidFlag*>(memory+offsets[2]);
+	buttonStates=reinterpret_cast<VRDeviceState::ButtonState*>(memory+offsets[3]);
+	valuatorStates=reinterpret_cast<VRDeviceState::ValuatorState*>(memory+offsets[4]);
+	}
+
+VRDeviceSharedState::VRDeviceSharedState(const char* sName,const VRDeviceState& state,const char* groupName)
+	:name(sName),owner(false),size(0),memory(0),
+	 numTrackers(state.getNumTrackers()),numButtons(state.getNumButtons()),numValuators(state.getNumValuators())
+	{
+	/* Calculate the segment layout: */
+	size_t offsets[5];
+	size=calcLayout(numTrackers,numButtons,numValuators,offsets);
+	
+	/* Look up the group that will be allowed to access the segment: */
+	gid_t groupId=gid_t(-1);
+	if(groupName!=0&&groupName[0]!='\0')
+		{
+		struct group* groupEntry=getgrnam(groupName);
+		if(groupEntry==0)
+			Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Unknown group %s for shared memory segment %s",groupName,name.c_str());
+		groupId=groupEntry->gr_gid;
+		}
+	
+	/* Remove a stale segment of the same name left behind by a crashed server, and create a new segment that only the current user can access: */
+	shm_unlink(name.c_str());
+	int fd=shm_open(name.c_str(),O_RDWR|O_CREAT|O_EXCL,S_IRUSR|S_IWUSR);
+	if(fd<0)
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Unable to create shared memory segment %s",name.c_str());
+	owner=true;
+	
+	/* Grant access to the segment to members of the given group: */
+	if(groupId!=gid_t(-1)&&(fchown(fd,uid_t(-1),groupId)<0||fchmod(fd,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP)<0))
+		{
+		close(fd);
+		shm_unlink(name.c_str());
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Unable to grant group %s access to shared memory segment %s",groupName,name.c_str());
+		}
+	
+	/* Size the segment and map it into the process' address space: */
+	void* address=(void*)-1;
+	if(ftruncate(fd,off_t(size))>=0)
+		address=mmap(0,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+	close(fd);
+	if(address==(void*)-1)
+		{
+		shm_unlink(name.c_str());
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Unable to map shared memory segment %s",name.c_str());
+		}
+	memory=static_cast<Misc::UInt8*>(address);
+	setPointers(offsets);
+	
+	/* Initialize the segment header: */
+	header->numTrackers=numTrackers;
+	header->numButtons=numButtons;
+	header->numValuators=numValuators;
+	header->sequence=0U;
+	for(unsigned int i=0;i<maxNumClients;++i)
+		header->notificationPending[i]=0U;
+	
+	/* Initialize the shared state: */
+	writeState(state);
+	
+	/* Mark the segment as valid: */
+	__sync_synchronize();
+	header->magic=sharedStateMagic;
+	}
+
+VRDeviceSharedState::VRDeviceSharedState(const char* sName)
+	:name(sName),owner(false),size(0),memory(0),
+	 numTrackers(0),numButtons(0),numValuators(0)
+	{
+	/* Open the shared memory segment and query its size: */
+	int fd=shm_open(name.c_str(),O_RDWR,0);
+	if(fd<0)
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Unable to access shared memory segment %s",name.c_str());
+	struct stat segmentStats;
+	if(fstat(fd,&segmentStats)<0||size_t(segmentStats.st_size)<sizeof(Header))
+		{
+		close(fd);
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Invalid shared memory segment %s",name.c_str());
+		}
+	size=size_t(segmentStats.st_size);
+	
+	/* Map the segment into the process' address space: */
+	void* address=mmap(0,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+	close(fd);
+	if(address==(void*)-1)
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Unable to map shared memory segment %s",name.c_str());
+	memory=static_cast<Misc::UInt8*>(address);
+	header=reinterpret_cast<Header*>(memory);
+	
+	/* Take a private copy of the segment layout so that a misbehaving peer can not change it after validation: */
+	numTrackers=header->numTrackers;
+	numButtons=header->numButtons;
+	numValuators=header->numValuators;
+	
+	/* Check the segment header and layout: */
+	size_t offsets[5];
+	if(header->magic!=sharedStateMagic||numTrackers<0||numButtons<0||numValuators<0||calcLayout(numTrackers,numButtons,numValuators,offsets)>size)
+		{
+		munmap(memory,size);
+		Misc::throwStdErr("VRDeviceSharedState::VRDeviceSharedState: Shared memory segment %s has wrong format",name.c_str());
+		}
+	setPointers(offsets);
+	}
+
+VRDeviceSharedState::~VRDeviceSharedState(void)
+	{
+	/* Unmap the shared memory segment: */
+	munmap(memory,size);
+	
+	/* Remove the segment if this object created it: */
+	if(owner)
+		shm_unlink(name.c_str());
+	}
+
+bool VRDeviceSharedState::hasLayout(const VRDeviceState& state) const
+	{
+	return numTrackers==state.getNumTrackers()&&numButtons==state.getNumButtons()&&numValuators==state.getNumValuators();
+	}
+
+void VRDeviceSharedState::writeState(const VRDeviceState& state)
+	{
+	beginWrite();
+	for(int i=0;i<numTrackers;++i)
+		{
+		trackerStates[i]=state.getTrackerState(i);
+		trackerTimeStamps[i]=state.getTrackerTimeStamp(i);
+		trackerValids[i]=state.getTrackerValid(i);
+		}
+	for(int i=0;i<numButtons;++i)
+		buttonStates[i]=state.getButtonState(i);
+	for(int i=0;i<numValuators;++i)
+		valuatorStates[i]=state.getValuatorState(i);
+	endWrite();
+	}
+
+void VRDeviceSharedState::writeTracker(int trackerIndex,const VRDeviceState& state)
+	{
+	beginWrite();
+	trackerStates[trackerIndex]=state.getTrackerState(trackerIndex);
+	trackerTimeStamps[trackerIndex]=state.getTrackerTimeStamp(trackerIndex);
+	trackerValids[trackerIndex]=state.getTrackerValid(trackerIndex);
+	endWrite();
+	}
+
+void VRDeviceSharedState::writeButton(int buttonIndex,const VRDeviceState& state)
+	{
+	beginWrite();
+	buttonStates[buttonIndex]=state.getButtonState(buttonIndex);
+	endWrite();
+	}
+
+void VRDeviceSharedState::writeValuator(int valuatorIndex,const VRDeviceState& state)
+	{
+	beginWrite();
+	valuatorStates[valuatorIndex]=state.getValuatorState(valuatorIndex);
+	endWrite();
+	}
+
+bool VRDeviceSharedState::readState(VRDeviceState& state) const
+	{
+	/* Retry until a snapshot was taken while the server was not writing; give up eventually in case the server died while writing: */
+	for(int attempt=0;attempt<1000;++attempt)
+		{
+		/* Wait until the server is not writing: */
+		Misc::UInt32 sequence=header->sequence;
+		if(sequence&0x1U)
+			{
+			if(attempt>=100)
+				usleep(10);
+			continue;
+			}
+		__sync_synchronize();
+		
+		/* Copy the shared state: */
+		VRDeviceState::TrackerState* tsPtr=state.getTrackerStates();
+		VRDeviceState::TimeStamp* ttsPtr=state.getTrackerTimeStamps();
+		VRDeviceState::ValidFlag* tvPtr=state.getTrackerValids();
+		for(int i=0;i<numTrackers;++i)
+			{
+			tsPtr[i]=trackerStates[i];
+			ttsPtr[i]=trackerTimeStamps[i];
+			tvPtr[i]=trackerValids[i];
+			}
+		VRDeviceState::ButtonState* bsPtr=state.getButtonStates();
+		for(int i=0;i<numButtons;++i)
+			bsPtr[i]=buttonStates[i];
+		VRDeviceState::ValuatorState* vsPtr=state.getValuatorStates();
+		for(int i=0;i<numValuators;++i)
+			vsPtr[i]=valuatorStates[i];
+		
+		/* Check that the server did not write while the snapshot was being taken: */
+		__sync_synchronize();
+		if(header->sequence==sequence)
+			return true;
+		}
+	
+	return false;
+	}
+
+}
@@ -0,0 +1,121 @@
+/***********************************************************************
+VRDeviceSharedState - Class to share the current state of a VR device
+server with local clients via a POSIX shared memory segment protected by
+a sequence lock.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef VRUI_INTERNAL_VRDEVICESHAREDSTATE_INCLUDED
+#define VRUI_INTERNAL_VRDEVICESHAREDSTATE_INCLUDED
+
+#include <stddef.h>
+#include <string>
+#include <Misc/SizedTypes.h>
+#include <Vrui/Internal/VRDeviceState.h>
+
+namespace Vrui {
+
+class VRDeviceSharedState
+	{
+	/* Embedded classes: */
+	public:
+	static const unsigned int maxNumClients=32; // Maximum number of clients that can be attached to a shared state segment at the same time
+	
+	private:
+	struct Header // Structure at the beginning of the shared memory segment
+		{
+		/* Elements: */
+		public:
+		Misc::UInt32 magic; // Magic number identifying the segment and its layout version
+		Misc::SInt32 numTrackers,numButtons,numValuators; // Layout of the shared device state
+		volatile Misc::UInt32 sequence; // Sequence number protecting the device state; odd while the server is writing
+		volatile Misc::UInt32 notificationPending[maxNumClients]; // Flags whether the server sent an update notification to the client in the respective slot that has not yet been acknowledged
+		};
+	
+	/* Elements: */
+	std::string name; // Name of the shared memory segment
+	bool owner; // Flag whether this object created the shared memory segment and removes it on destruction
+	size_t size; // Size of the mapped shared memory segment
+	Misc::UInt8* memory; // Base pointer of the mapped shared memory segment
+	Header* header; // Pointer to the segment's header
+	int numTrackers,numButtons,numValuators; // Device layout validated when the segment was created or attached; never re-read from the shared header
+	VRDeviceState::TrackerState* trackerStates; // Pointer to the shared tracker state array
+	VRDeviceState::TimeStamp* trackerTimeStamps; // Pointer to the shared tracker time stamp array
+	VRDeviceState::ValidFlag* trackerValids; // Pointer to the shared tracker valid flag array
+	VRDeviceState::ButtonState* buttonStates; // Pointer to the shared button state array
+	VRDeviceState::ValuatorState* valuatorStates; // Pointer to the shared valuator state array
+	
+	/* Private methods: */
+	static size_t calcLayout(int numTrackers,int numButtons,int numValuators,size_t offsets[5]); // Calculates the offsets of the state arrays in a segment for the given device layout; returns total segment size
+	void setPointers(const size_t offsets[5]); // Sets the state array pointers from the given offsets
+	void beginWrite(void) // Starts writing into the shared state
+		{
+		header->sequence=header->sequence+1;
+		__sync_synchronize();
+		}
+	void endWrite(void) // Finishes writing into the shared state
+		{
+		__sync_synchronize();
+		header->sequence=header->sequence+1;
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	VRDeviceSharedState(const char* sName,const VRDeviceState& state,const char* groupName =0); // Creates a new shared memory segment of the given name for the given device state's layout and initializes it from the device state; segment is only accessible by the creating user, and by members of the given group if not null
+	VRDeviceSharedState(const char* sName); // Attaches to the existing shared memory segment of the given name
+	private:
+	VRDeviceSharedState(const VRDeviceSharedState& source); // Prohibit copy constructor
+	VRDeviceSharedState& operator=(const VRDeviceSharedState& source); // Prohibit assignment operator
+	public:
+	~VRDeviceSharedState(void); // Unmaps the shared memory segment and removes it if owned
+	
+	/* Methods: */
+	const std::string& getName(void) const // Returns the name of the shared memory segment
+		{
+		return name;
+		}
+	bool hasLayout(const VRDeviceState& state) const; // Returns true if the shared state has the same layout as the given device state
+	
+	/* Server-side methods; must be called while the server's device state is locked: */
+	void writeState(const VRDeviceState& state); // Copies the entire given device state into the shared state
+	void writeTracker(int trackerIndex,const VRDeviceState& state); // Copies the state of the given tracker from the given device state into the shared state
+	void writeButton(int buttonIndex,const VRDeviceState& state); // Copies the state of the given button from the given device state into the shared state
+	void writeValuator(int valuatorIndex,const VRDeviceState& state); // Copies the state of the given valuator from the given device state into the shared state
+	void resetNotification(unsigned int clientIndex) // Resets the notification flag of the client in the given slot
+		{
+		header->notificationPending[clientIndex]=0U;
+		}
+	bool raiseNotification(unsigned int clientIndex) // Marks an update notification as pending for the client in the given slot; returns true if the client needs to be notified
+		{
+		return __sync_bool_compare_and_swap(&header->notificationPending[clientIndex],0U,1U);
+		}
+	
+	/* Client-side methods: */
+	void acknowledgeNotification(unsigned int clientIndex) // Acknowledges the most recent update notification for the client in the given slot
+		{
+		header->notificationPending[clientIndex]=0U;
+		__sync_synchronize();
+		}
+	bool readState(VRDeviceState& state) const; // Copies a consistent snapshot of the shared state into the given device state of the same layout; returns false if no consistent snapshot could be taken
+	};
+
+}
+
+#endif
@@ -116,6 +116,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Vrui/ToolManager.h>
 #include <Vrui/Internal/ToolKillZone.h>
 #include <Vrui/VisletManager.h>
+#include <Vrui/FrameProfiler.h>
 #include <Vrui/Internal/InputDeviceDataSaver.h>
 #include <Vrui/Internal/ScaleBar.h>
 
@@ -567,7 +568,7 @@ VruiState::VruiState(Cluster::Multiplexer* sMultiplexer,Cluster::MulticastPipe*
 	 upDirection(0.0,0.0,1.0),
 	 floorPlane(Vector(0.0,0.0,1.0),0.0),
 	 glyphRenderer(0),
-	 sceneGraphManager(0),
+	 sceneGraphManager(0),cullSceneGraph(true),
 	 newInputDevicePosition(0.0,0.0,0.0),
 	 virtualInputDevice(0),
 	 inputGraphManager(0),
@@ -617,6 +618,7 @@ VruiState::VruiState(Cluster::Multiplexer* sMultiplexer,Cluster::MulticastPipe*
 	 synchFrameTime(0.0),synchWait(false),
 	 numRecentFrameTimes(0),recentFrameTimes(0),nextFrameTimeIndex(0),sortedFrameTimes(0),
 	 animationFrameInterval(1.0/125.0),
+	 frameProfiler(0),
 	 activeNavigationTool(0),
 	 updateContinuously(false),
 	 predictVsync(false),vsyncInterval(0,0),numVsyncs(0),nextVsync(0,0),postVsyncDisplayDelay(0.0)
@@ -636,6 +638,7 @@ VruiState::~VruiState(void)
 	/* Delete time management: */
 	delete[] recentFrameTimes;
 	delete[] sortedFrameTimes;
+	delete frameProfiler;
 	
 	/* Deregister the popup callback: */
 	widgetManager->getWidgetPopCallbacks().remove(this,&VruiState::widgetPopCallback);
@@ -723,6 +726,9 @@ void VruiState::initialize(const Misc::ConfigurationFileSection& configFileSecti
 	commandDispatcher.addCommandCallback("loadView",&VruiState::loadViewCommandCallback,this,"<viewpoint file name>","Loads a viewpoint file");
 	commandDispatcher.addCommandCallback("loadInputGraph",&VruiState::loadInputGraphCommandCallback,this,"<input graph file name>","Loads an input graph file");
 	commandDispatcher.addCommandCallback("saveScreenshot",&VruiState::saveScreenshotCommandCallback,this,"<screenshot file name> [<window index>]","Saves a screenshot from the window of the given index to an image file of the given name");
+	commandDispatcher.addCommandCallback("enableFrameProfiler",&VruiState::enableFrameProfilerCommandCallback,this,0,"Starts recording the duration of each phase of every frame");
+	commandDispatcher.addCommandCallback("disableFrameProfiler",&VruiState::disableFrameProfilerCommandCallback,this,0,"Stops recording frame phase durations");
+	commandDispatcher.addCommandCallback("saveFrameProfile",&VruiState::saveFrameProfileCommandCallback,this,"<profile file name>","Saves recently recorded frame phase durations to a CSV file if the file name ends in .csv, or to a binary file otherwise");
 	commandDispatcher.addCommandCallback("quit",&VruiState::quitCommandCallback,this,0,"Exits from the application");
 	
 	/* Check whether the screen saver should be inhibited: */
@@ -845,16 +851,20 @@ void VruiState::initialize(const Misc::ConfigurationFileSection& configFileSecti
 	
 	/* Create the scene graph manager: */
 	sceneGraphManager=new SceneGraphManager;
+	cullSceneGraph=configFileSection.retrieveValue<bool>("./cullSceneGraph",cullSceneGraph);
 	
 	/* Initialize input graph manager: */
 	newInputDevicePosition=configFileSection.retrieveValue<Point>("./newInputDevicePosition",displayCenter);
 	virtualInputDevice=new VirtualInputDevice(glyphRenderer,configFileSection);
 	inputGraphManager=new InputGraphManager(glyphRenderer,sceneGraphManager,virtualInputDevice);
 	
+	vruiTraceStartupPhase("Vrui core and user interface setup");
+	
 	/* Initialize input device manager: */
 	inputDeviceManager=new InputDeviceManager(inputGraphManager,textEventDispatcher);
 	if(master)
 		inputDeviceManager->initialize(configFileSection);
+	vruiTraceStartupPhase("input device adapters");
 	
 	/* Initialize the text entry method: */
 	InputDeviceAdapterMouse* mouseAdapter=0;
@@ -926,7 +936,7 @@ void VruiState::initialize(const Misc::ConfigurationFileSection& configFileSecti
 	/* If in cluster mode, create a dispatcher to send input device states to the slaves: */
 	if(multiplexer!=0)
 		{
-		multipipeDispatcher=new MultipipeDispatcher(inputDeviceManager,pipe);
+		multipipeDispatcher=new MultipipeDispatcher(inputDeviceManager,pipe,configFileSection.retrieveValue<bool>("./sendInputDeviceDeltas",false));
 		if(!master)
 			{
 			/* On slaves, multipipe dispatcher is owned by input device manager: */
@@ -1116,8 +1126,11 @@ void VruiState::initialize(const Misc::ConfigurationFileSection& configFileSecti
 	/* Go to tool manager's section: */
 	Misc::ConfigurationFileSection toolSection=configFileSection.getSection(configFileSection.retrieveString("./tools").c_str());
 	
+	vruiTraceStartupPhase("display environment setup");
+	
 	/* Initialize tool manager: */
 	toolManager=new ToolManager(inputDeviceManager,toolSection);
+	vruiTraceStartupPhase("tool class plug-ins");
 	
 	try
 		{
@@ -1131,6 +1144,7 @@ void VruiState::initialize(const Misc::ConfigurationFileSection& configFileSecti
 		{
 		/* Ignore error and continue... */
 		}
+	vruiTraceStartupPhase("vislet manager");
 	
 	/* Check if there is a frame rate limit: */
 	double maxFrameRate=configFileSection.retrieveValue<double>("./maximumFrameRate",0.0);
@@ -1155,6 +1169,10 @@ void VruiState::initialize(const Misc::ConfigurationFileSection& configFileSecti
 	/* Initialize the suggested animation frame interval: */
 	animationFrameInterval=configFileSection.retrieveValue<double>("./animationFrameInterval",animationFrameInterval);
 	
+	/* Initialize the run-time frame profiler: */
+	frameProfiler=new FrameProfiler(configFileSection.retrieveValue<unsigned int>("./frameProfilerBufferSize",4096U));
+	frameProfiler->setActive(configFileSection.retrieveValue<bool>("./enableFrameProfiler",false));
+	
 	/* Initialize latency mitigation: */
 	predictVsync=configFileSection.retrieveValue<bool>("./predictVsync",predictVsync);
 	if(predictVsync)
@@ -1679,7 +1697,9 @@ void VruiState::update(void)
 			}
 		
 		/* Update all physical input devices: */
+		Realtime::TimePointMonotonic inputDevicesStart;
 		inputDeviceManager->updateInputDevices();
+		frameProfiler->addPhaseTime(FrameProfiler::InputDevices,inputDevicesStart);
 		
 		#if EVILHACK_LOCK_INPUTDEVICE_POS
 		if(lockedDevice!=0)
@@ -1709,7 +1729,9 @@ void VruiState::update(void)
 	else
 		{
 		/* Receive input device states and text events from the master: */
+		Realtime::TimePointMonotonic inputDevicesStart;
 		inputDeviceManager->updateInputDevices();
+		frameProfiler->addPhaseTime(FrameProfiler::InputDevices,inputDevicesStart);
 		textEventDispatcher->readEventQueues(*pipe);
 		}
 	
@@ -1800,10 +1822,14 @@ void VruiState::update(void)
 		}
 	
 	/* Update the input graph: */
+	Realtime::TimePointMonotonic inputGraphStart;
 	inputGraphManager->update();
+	frameProfiler->addPhaseTime(FrameProfiler::InputGraph,inputGraphStart);
 	
 	/* Update the tool manager: */
+	Realtime::TimePointMonotonic toolManagerStart;
 	toolManager->update();
+	frameProfiler->addPhaseTime(FrameProfiler::ToolManager,toolManagerStart);
 	
 	/* Check if a new input graph needs to be loaded: */
 	if(loadInputGraph)
@@ -1887,7 +1913,9 @@ void VruiState::update(void)
 	}
 	
 	/* Call frame function: */
+	Realtime::TimePointMonotonic applicationStart;
 	frameFunction(frameFunctionData);
+	frameProfiler->addPhaseTime(FrameProfiler::Application,applicationStart);
 	
 	/* Finish any pending messages on the main pipe, in case an application didn't clean up: */
 	if(multiplexer!=0)
@@ -1946,6 +1974,7 @@ void VruiState::display(DisplayState* displayState,GLContextData& contextData) c
 	/* Create the scene graph render state object: */
 	const NavTransform& mvp=displayState->modelviewPhysical;
 	SceneGraph::GLRenderState renderState(contextData,mvp,mvp.transform(mainViewer->getHeadPosition()),mvp.transform(upDirection));
+	renderState.setFrustumCulling(cullSceneGraph);
 	
 	/* Render the central scene graph in opaque mode if necessary: */
 	sceneGraphManager->glRenderAction(renderState);
@@ -1956,6 +1985,9 @@ void VruiState::display(DisplayState* displayState,GLContextData& contextData) c
 	/* Render the central scene graph in transparent mode if necessary: */
 	sceneGraphManager->glRenderAction(renderState);
 	
+	/* Report the numbers of culled and drawn scene graph nodes to the frame profiler: */
+	frameProfiler->addSceneGraphCounts(renderState.getNumCulledNodes(),renderState.getNumDrawnNodes());
+	
 	/* Execute the old-style transparency rendering pass if necessary: */
 	if(TransparentObject::needRenderPass())
 		{
@@ -2141,6 +2173,42 @@ void VruiState::saveScreenshotCommandCallback(const char* argumentBegin,const ch
 		}
 	}
 
+void VruiState::enableFrameProfilerCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData)
+	{
+	VruiState* thisPtr=static_cast<VruiState*>(userData);
+	
+	/* Start recording with the next frame: */
+	thisPtr->frameProfiler->setActive(true);
+	}
+
+void VruiState::disableFrameProfilerCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData)
+	{
+	VruiState* thisPtr=static_cast<VruiState*>(userData);
+	
+	/* Stop recording with the next frame: */
+	thisPtr->frameProfiler->setActive(false);
+	}
+
+void VruiState::saveFrameProfileCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData)
+	{
+	VruiState* thisPtr=static_cast<VruiState*>(userData);
+	
+	std::string profileFileName(argumentBegin,argumentEnd);
+	try
+		{
+		/* Save the frame profile in the format indicated by the file name: */
+		if(Misc::hasCaseExtension(profileFileName.c_str(),".csv"))
+			thisPtr->frameProfiler->saveCSV(profileFileName.c_str());
+		else
+			thisPtr->frameProfiler->saveBinary(profileFileName.c_str());
+		}
+	catch(const std::runtime_error& err)
+		{
+		/* Print an error message: */
+		std::cout<<"saveFrameProfile: Unable to save frame profile to file "<<profileFileName<<" due to exception "<<err.what()<<std::endl;
+		}
+	}
+
 void VruiState::quitCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData)
 	{
 	/* Request Vrui to shut down cleanly: */
@@ -3720,6 +3788,11 @@ double getNextAnimationTime(void)
 	return vruiState->lastFrame+vruiState->animationFrameInterval;
 	}
 
+FrameProfiler* getFrameProfiler(void)
+	{
+	return vruiState->frameProfiler;
+	}
+
 void addFrameCallback(FrameCallback newFrameCallback,void* newFrameCallbackUserData)
 	{
 	Threads::Mutex::Lock frameCallbacksLock(vruiState->frameCallbacksMutex);
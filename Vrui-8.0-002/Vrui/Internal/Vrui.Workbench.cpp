@@ -80,6 +80,7 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Vrui/ToolManager.h>
 #include <Vrui/VisletManager.h>
 #include <Vrui/ViewSpecification.h>
+#include <Vrui/FrameProfiler.h>
 
 #include <Vrui/Internal/Vrui.h>
 #include <Vrui/Internal/Config.h>
@@ -188,6 +189,8 @@ VRWindow** vruiTotalWindows=0;
 Threads::Thread* vruiRenderingThreads=0;
 Threads::Barrier vruiRenderingBarrier;
 volatile bool vruiStopRenderingThreads=false;
+bool vruiDeferredSwap=false; // Flag whether rendering threads wait for their graphics cards and swap their windows concurrently with the main thread's next frame update; drawing itself is not overlapped with the update
+Threads::Barrier vruiSwapBarrier; // Barrier to synchronize buffer swaps between rendering threads in deferred swap mode
 #endif
 int vruiNumSoundContexts=0;
 SoundContext** vruiSoundContexts=0;
@@ -199,6 +202,9 @@ int vruiSlaveArgc=0;
 char** vruiSlaveArgv=0;
 char** vruiSlaveArgvShadow=0;
 volatile bool vruiAsynchronousShutdown=false;
+bool vruiTraceStartup=false; // Flag whether to report the time spent in the phases of the startup procedure
+Realtime::TimePointMonotonic vruiStartupPhaseStart; // Time at which the current startup phase began
+std::vector<std::pair<const char*,double> > vruiStartupPhases; // List of names and durations of completed startup phases
 
 /*****************************************
 Workbench-specific private Vrui functions:
@@ -642,7 +648,31 @@ void* vruiRenderingThreadFunction(VruiWindowGroupCreator group)
 		
 		/* Draw all windows' contents: */
 		for(std::vector<VruiWindowGroupCreator::VruiWindow>::iterator wIt=group.windows.begin();wIt!=group.windows.end();++wIt)
+			{
+			Realtime::TimePointMonotonic drawStart;
 			vruiWindows[wIt->windowIndex]->draw();
+			vruiState->frameProfiler->addWindowDrawTime(wIt->windowIndex,drawStart);
+			}
+		
+		if(vruiDeferredSwap)
+			{
+			/* Release the main thread to process the next frame, as all windows' contents have been submitted: */
+			vruiRenderingBarrier.synchronize();
+			
+			/* Wait until all rendering threads are done rendering: */
+			glFinish();
+			vruiSwapBarrier.synchronize();
+			
+			/* Swap all windows' buffers: */
+			for(std::vector<VruiWindowGroupCreator::VruiWindow>::iterator wIt=group.windows.begin();wIt!=group.windows.end();++wIt)
+				{
+				vruiWindows[wIt->windowIndex]->makeCurrent();
+				vruiWindows[wIt->windowIndex]->swapBuffers();
+				}
+			
+			/* Go back to wait for the start of the next rendering cycle: */
+			continue;
+			}
 		
 		/* Wait until all threads are done rendering: */
 		glFinish();
@@ -670,6 +700,27 @@ void* vruiRenderingThreadFunction(VruiWindowGroupCreator group)
 
 #endif
 
+void vruiReportStartupTrace(void)
+	{
+	/* Print the durations of all startup phases and the total startup time: */
+	double totalTime=0.0;
+	std::ios::fmtflags prevFlags=std::cout.setf(std::ios::fixed,std::ios::floatfield);
+	std::streamsize prevPrecision=std::cout.precision(1);
+	std::cout<<"Vrui: Startup trace:"<<std::endl;
+	for(std::vector<std::pair<const char*,double> >::iterator spIt=vruiStartupPhases.begin();spIt!=vruiStartupPhases.end();++spIt)
+		{
+		std::cout<<"        "<<std::setw(9)<<spIt->second*1000.0<<" ms  "<<spIt->first<<std::endl;
+		totalTime+=spIt->second;
+		}
+	std::cout<<"        "<<std::setw(9)<<totalTime*1000.0<<" ms  total"<<std::endl;
+	std::cout.precision(prevPrecision);
+	std::cout.flags(prevFlags);
+	
+	/* Stop tracing: */
+	vruiStartupPhases.clear();
+	vruiTraceStartup=false;
+	}
+
 }
 
 /**********************************
@@ -680,6 +731,9 @@ void init(int& argc,char**& argv,char**&)
 	{
 	typedef std::vector<std::string> StringList;
 	
+	/* Start the first startup phase: */
+	vruiStartupPhaseStart.set();
+	
 	/* Determine whether this node is the master or a slave: */
 	if(argc==8&&strcmp(argv[1],"-vruiMultipipeSlave")==0)
 		{
@@ -781,6 +835,17 @@ void init(int& argc,char**& argv,char**&)
 				std::cout<<"        config files: "<<VRUI_INTERNAL_CONFIG_ETCDIR<<std::endl;
 				std::cout<<"        shared files: "<<VRUI_INTERNAL_CONFIG_SHAREDIR<<std::endl;
 				
+				/* Remove parameter from argument list: */
+				argc-=1;
+				for(int j=i;j<argc;++j)
+					argv[j]=argv[j+1];
+				--i;
+				}
+			else if(strcasecmp(argv[i],"-vruiTraceStartup")==0)
+				{
+				/* Report the time spent in each phase of the startup procedure after the first frame: */
+				vruiTraceStartup=true;
+				
 				/* Remove parameter from argument list: */
 				argc-=1;
 				for(int j=i;j<argc;++j)
@@ -796,6 +861,9 @@ void init(int& argc,char**& argv,char**&)
 				std::cout<<"  -vruiVerbose"<<std::endl;
 				std::cout<<"     Logs details about Vrui's startup and shutdown procedures to"<<std::endl;
 				std::cout<<"     stdout."<<std::endl;
+				std::cout<<"  -vruiTraceStartup"<<std::endl;
+				std::cout<<"     Reports the time spent in each phase of Vrui's startup procedure"<<std::endl;
+				std::cout<<"     to stdout after the first frame."<<std::endl;
 				std::cout<<"  -mergeConfig <configuration file name>"<<std::endl;
 				std::cout<<"     Merges the configuration file of the given name into Vrui's"<<std::endl;
 				std::cout<<"     configuration space."<<std::endl;
@@ -1024,6 +1092,7 @@ void init(int& argc,char**& argv,char**&)
 		
 		/* Go to the configuration's root section and save the root section name for later: */
 		vruiGoToRootSection(rootSectionName,vruiVerbose);
+		vruiTraceStartupPhase("configuration file processing");
 		size_t rsnLength=strlen(rootSectionName);
 		vruiConfigRootSectionName=new char[rsnLength+1];
 		memcpy(vruiConfigRootSectionName,rootSectionName,rsnLength+1);
@@ -1150,6 +1219,7 @@ void init(int& argc,char**& argv,char**&)
 				
 				if(vruiVerbose)
 					std::cout<<" Ok"<<std::endl;
+				vruiTraceStartupPhase("cluster startup");
 				
 				/* Register Vrui's cluster multiplexer with the Opener object of the Cluster library: */
 				Cluster::Opener::getOpener()->setMultiplexer(vruiMultiplexer);
@@ -1176,6 +1246,7 @@ void init(int& argc,char**& argv,char**&)
 		vruiState->initialize(vruiConfigFile->getCurrentSection());
 		if(vruiVerbose&&vruiMaster)
 			std::cout<<" Ok"<<std::endl;
+		vruiTraceStartupPhase("remaining Vrui state initialization");
 		}
 	catch(const std::runtime_error& err)
 		{
@@ -1417,10 +1488,13 @@ void init(int& argc,char**& argv,char**&)
 			std::cout<<" \""<<argv[i]<<'"';
 		std::cout<<std::endl;
 		}
+	vruiTraceStartupPhase("command line processing and plug-ins");
 	}
 
 void startDisplay(void)
 	{
+	vruiTraceStartupPhase("application initialization");
+	
 	/* Synchronize threads between here and end of function body: */
 	Cluster::ThreadSynchronizer threadSynchronizer(vruiState->pipe);
 	
@@ -1465,17 +1539,6 @@ void startDisplay(void)
 		for(int i=0;i<vruiNumWindows;++i)
 			vruiWindows[i]=0;
 		
-		/* Initialize X11 if any windows need to be opened: */
-		if(vruiNumWindows>0)
-			{
-			/* Enable thread management in X11 library: */
-			// XInitThreads(); Not necessary; Vrui never makes X calls to the same display concurrently from different threads
-			
-			/* Set error handlers: */
-			XSetErrorHandler(vruiXErrorHandler);
-			XSetIOErrorHandler(vruiXIOErrorHandler);
-			}
-		
 		/* Sort the windows into groups based on their group IDs: */
 		typedef Misc::HashTable<unsigned int,VruiWindowGroupCreator> WindowGroupMap;
 		WindowGroupMap windowGroups(7);
@@ -1542,6 +1605,27 @@ void startDisplay(void)
 		
 		/* Check if there are multiple window groups, so multiple threads can be used: */
 		vruiNumWindowGroups=int(windowGroups.getNumEntries());
+		
+		/* Initialize X11 if any windows need to be opened: */
+		if(vruiNumWindows>0)
+			{
+			#if GLSUPPORT_CONFIG_USE_TLS
+			/* Check whether deferred buffer swaps are requested; they are only supported for multiple window groups on a single node without vsync prediction: */
+			vruiDeferredSwap=vruiConfigFile->retrieveValue<bool>("./deferBufferSwaps",false)&&vruiNumWindowGroups>1&&vruiState->multiplexer==0&&!vruiState->predictVsync;
+			
+			/* Enable thread management in X11 library if buffer swaps are deferred, as rendering threads then swap buffers while the main thread handles events: */
+			if(vruiDeferredSwap)
+				XInitThreads();
+			#endif
+			
+			/* Enable thread management in X11 library: */
+			// XInitThreads(); Not necessary; Vrui never makes X calls to the same display concurrently from different threads
+			
+			/* Set error handlers: */
+			XSetErrorHandler(vruiXErrorHandler);
+			XSetIOErrorHandler(vruiXIOErrorHandler);
+			}
+		
 		bool allWindowsOk=true;
 		if(vruiNumWindowGroups>1)
 			{
@@ -1549,6 +1633,8 @@ void startDisplay(void)
 			
 			/* Initialize the rendering barrier: */
 			vruiRenderingBarrier.setNumSynchronizingThreads(vruiNumWindowGroups+1);
+			if(vruiDeferredSwap)
+				vruiSwapBarrier.setNumSynchronizingThreads(vruiNumWindowGroups);
 			
 			/* Create one rendering thread for each window group (which will in turn create the windows in their respective groups themselves): */
 			vruiRenderingThreads=new Threads::Thread[vruiNumWindowGroups];
@@ -1588,7 +1674,7 @@ void startDisplay(void)
 				{
 				std::cout<<" in "<<vruiNumWindowGroups<<" window groups";
 				#if GLSUPPORT_CONFIG_USE_TLS
-				std::cout<<" (rendering in parallel)";
+				std::cout<<(vruiDeferredSwap?" (rendering in parallel, deferred swaps)":" (rendering in parallel)");
 				#else
 				std::cout<<" (rendering serially)";
 				#endif
@@ -1907,7 +1993,12 @@ void vruiInnerLoopMultiWindow(void)
 		vruiPrintTime(false);
 		#endif
 		
+		/* Start profiling the new frame: */
+		FrameProfiler* profiler=vruiState->frameProfiler;
+		profiler->startFrame();
+		
 		/* Handle all events, blocking if there are none unless in continuous mode: */
+		Realtime::TimePointMonotonic eventsStart;
 		if(firstFrame||vruiState->updateContinuously)
 			{
 			/* Check for and handle events without blocking: */
@@ -1919,6 +2010,7 @@ void vruiInnerLoopMultiWindow(void)
 			while(!vruiHandleAllEvents(true))
 				;
 			}
+		profiler->addPhaseTime(FrameProfiler::EventHandling,eventsStart);
 		
 		/* Check for asynchronous shutdown: */
 		keepRunning=keepRunning&&!vruiAsynchronousShutdown;
@@ -1959,27 +2051,37 @@ void vruiInnerLoopMultiWindow(void)
 			#if GLSUPPORT_CONFIG_USE_TLS
 			
 			/* Start the rendering cycle by synchronizing with the render threads: */
+			Realtime::TimePointMonotonic renderStart;
 			vruiRenderingBarrier.synchronize();
 			
 			/* Wait until all threads are done rendering: */
 			vruiRenderingBarrier.synchronize();
+			profiler->addPhaseTime(FrameProfiler::Render,renderStart);
 			
-			if(vruiState->multiplexer!=0)
+			/* In deferred swap mode, the render threads wait for their graphics cards and swap buffers on their own while the main thread continues with the next frame: */
+			if(!vruiDeferredSwap)
 				{
-				/* Synchronize with other nodes: */
-				vruiState->pipe->barrier();
-				
-				#if VRUI_INSTRUMENT_MAINLOOP
-				vruiPrintTime(false);
-				#endif
+				if(vruiState->multiplexer!=0)
+					{
+					/* Synchronize with other nodes: */
+					Realtime::TimePointMonotonic waitStart;
+					vruiState->pipe->barrier();
+					
+					#if VRUI_INSTRUMENT_MAINLOOP
+					vruiPrintTime(false);
+					#endif
+					
+					/* Notify the render threads to swap buffers: */
+					vruiRenderingBarrier.synchronize();
+					profiler->addPhaseTime(FrameProfiler::RenderWait,waitStart);
+					}
 				
-				/* Notify the render threads to swap buffers: */
+				/* Wait until all threads are done swapping buffers: */
+				Realtime::TimePointMonotonic swapStart;
 				vruiRenderingBarrier.synchronize();
+				profiler->addPhaseTime(FrameProfiler::SwapBuffers,swapStart);
 				}
 			
-			/* Wait until all threads are done swapping buffers: */
-			vruiRenderingBarrier.synchronize();
-			
 			#if VRUI_INSTRUMENT_MAINLOOP
 			vruiPrintTime(true);
 			#endif
@@ -1987,17 +2089,26 @@ void vruiInnerLoopMultiWindow(void)
 			#else
 			
 			/* Render to all window groups in turn: */
+			Realtime::TimePointMonotonic renderStart;
+			int windowIndex=0;
 			for(int i=0;i<vruiNumWindowGroups;++i)
 				{
-				for(std::vector<VruiWindowGroup::Window>::iterator wgIt=vruiWindowGroups[i].windows.begin();wgIt!=vruiWindowGroups[i].windows.end();++wgIt)
+				for(std::vector<VruiWindowGroup::Window>::iterator wgIt=vruiWindowGroups[i].windows.begin();wgIt!=vruiWindowGroups[i].windows.end();++wgIt,++windowIndex)
+					{
+					Realtime::TimePointMonotonic drawStart;
 					wgIt->window->draw();
+					profiler->addWindowDrawTime(windowIndex,drawStart);
+					}
 				}
+			profiler->addPhaseTime(FrameProfiler::Render,renderStart);
 			
 			if(vruiState->multiplexer!=0)
 				{
 				/* Synchronize with other nodes: */
+				Realtime::TimePointMonotonic waitStart;
 				glFinish();
 				vruiState->pipe->barrier();
+				profiler->addPhaseTime(FrameProfiler::RenderWait,waitStart);
 				}
 			
 			#if VRUI_INSTRUMENT_MAINLOOP
@@ -2005,6 +2116,7 @@ void vruiInnerLoopMultiWindow(void)
 			#endif
 			
 			/* Swap all buffers at once: */
+			Realtime::TimePointMonotonic swapStart;
 			for(int i=0;i<vruiNumWindowGroups;++i)
 				{
 				for(std::vector<VruiWindowGroup::Window>::iterator wgIt=vruiWindowGroups[i].windows.begin();wgIt!=vruiWindowGroups[i].windows.end();++wgIt)
@@ -2013,6 +2125,7 @@ void vruiInnerLoopMultiWindow(void)
 					wgIt->window->swapBuffers();
 					}
 				}
+			profiler->addPhaseTime(FrameProfiler::SwapBuffers,swapStart);
 			
 			#if VRUI_INSTRUMENT_MAINLOOP
 			vruiPrintTime(true);
@@ -2023,14 +2136,22 @@ void vruiInnerLoopMultiWindow(void)
 		else if(vruiNumWindows>0)
 			{
 			/* Update rendering: */
+			Realtime::TimePointMonotonic renderStart;
 			for(int i=0;i<vruiNumWindows;++i)
+				{
+				Realtime::TimePointMonotonic drawStart;
 				vruiWindows[i]->draw();
+				profiler->addWindowDrawTime(i,drawStart);
+				}
+			profiler->addPhaseTime(FrameProfiler::Render,renderStart);
 			
 			if(vruiState->multiplexer!=0)
 				{
 				/* Synchronize with other nodes: */
+				Realtime::TimePointMonotonic waitStart;
 				glFinish();
 				vruiState->pipe->barrier();
+				profiler->addPhaseTime(FrameProfiler::RenderWait,waitStart);
 				}
 			
 			#if VRUI_INSTRUMENT_MAINLOOP
@@ -2038,11 +2159,13 @@ void vruiInnerLoopMultiWindow(void)
 			#endif
 			
 			/* Swap all buffers at once: */
+			Realtime::TimePointMonotonic swapStart;
 			for(int i=0;i<vruiNumWindows;++i)
 				{
 				vruiWindows[i]->makeCurrent();
 				vruiWindows[i]->swapBuffers();
 				}
+			profiler->addPhaseTime(FrameProfiler::SwapBuffers,swapStart);
 			
 			#if VRUI_INSTRUMENT_MAINLOOP
 			vruiPrintTime(true);
@@ -2051,7 +2174,9 @@ void vruiInnerLoopMultiWindow(void)
 		else if(vruiState->multiplexer!=0)
 			{
 			/* Synchronize with other nodes: */
+			Realtime::TimePointMonotonic waitStart;
 			vruiState->pipe->barrier();
+			profiler->addPhaseTime(FrameProfiler::RenderWait,waitStart);
 			
 			#if VRUI_INSTRUMENT_MAINLOOP
 			vruiPrintTime(false);
@@ -2059,6 +2184,9 @@ void vruiInnerLoopMultiWindow(void)
 			#endif
 			}
 		
+		/* Publish the frame's profile: */
+		profiler->finishFrame();
+		
 		/* Print current frame rate on head node's console for window-less Vrui processes: */
 		if(vruiNumWindows==0&&vruiMaster)
 			{
@@ -2073,6 +2201,13 @@ void vruiInnerLoopMultiWindow(void)
 				}
 			}
 		
+		if(firstFrame&&vruiTraceStartup)
+			{
+			/* Report the startup trace: */
+			vruiTraceStartupPhase("first frame, including OpenGL context initialization");
+			vruiReportStartupTrace();
+			}
+		
 		firstFrame=false;
 		}
 	if(vruiNumWindows==0&&vruiMaster)
@@ -2096,7 +2231,12 @@ void vruiInnerLoopSingleWindow(void)
 		vruiPrintTime(false);
 		#endif
 		
+		/* Start profiling the new frame: */
+		FrameProfiler* profiler=vruiState->frameProfiler;
+		profiler->startFrame();
+		
 		/* Handle all events, blocking if there are none unless in continuous mode: */
+		Realtime::TimePointMonotonic eventsStart;
 		if(firstFrame||vruiState->updateContinuously)
 			{
 			/* Check for and handle events without blocking: */
@@ -2108,6 +2248,7 @@ void vruiInnerLoopSingleWindow(void)
 			while(!vruiHandleAllEvents(true))
 				;
 			}
+		profiler->addPhaseTime(FrameProfiler::EventHandling,eventsStart);
 		
 		/* Check for asynchronous shutdown: */
 		keepRunning=keepRunning&&!vruiAsynchronousShutdown;
@@ -2144,13 +2285,18 @@ void vruiInnerLoopSingleWindow(void)
 		GLContextData::resetThingManager();
 		
 		/* Update rendering: */
+		Realtime::TimePointMonotonic renderStart;
 		vruiWindows[0]->draw();
+		profiler->addWindowDrawTime(0,renderStart);
+		profiler->addPhaseTime(FrameProfiler::Render,renderStart);
 		
 		if(vruiState->multiplexer!=0)
 			{
 			/* Synchronize with other nodes: */
+			Realtime::TimePointMonotonic waitStart;
 			glFinish();
 			vruiState->pipe->barrier();
+			profiler->addPhaseTime(FrameProfiler::RenderWait,waitStart);
 			}
 		
 		#if VRUI_INSTRUMENT_MAINLOOP
@@ -2158,12 +2304,24 @@ void vruiInnerLoopSingleWindow(void)
 		#endif
 		
 		/* Swap buffer: */
+		Realtime::TimePointMonotonic swapStart;
 		vruiWindows[0]->swapBuffers();
+		profiler->addPhaseTime(FrameProfiler::SwapBuffers,swapStart);
 		
 		#if VRUI_INSTRUMENT_MAINLOOP
 		vruiPrintTime(true);
 		#endif
 		
+		/* Publish the frame's profile: */
+		profiler->finishFrame();
+		
+		if(firstFrame&&vruiTraceStartup)
+			{
+			/* Report the startup trace: */
+			vruiTraceStartupPhase("first frame, including OpenGL context initialization");
+			vruiReportStartupTrace();
+			}
+		
 		firstFrame=false;
 		}
 	}
@@ -2180,11 +2338,13 @@ void mainLoop(void)
 	
 	/* Start the display subsystem: */
 	startDisplay();
+	vruiTraceStartupPhase("window creation");
 	
 	if(vruiState->useSound)
 		{
 		/* Start the sound subsystem: */
 		startSound();
+		vruiTraceStartupPhase("sound context creation");
 		}
 	
 	/* Initialize the navigation transformation: */
@@ -2207,6 +2367,7 @@ void mainLoop(void)
 	vruiState->prepareMainLoop();
 	if(vruiVerbose&&vruiMaster)
 		std::cout<<" Ok"<<std::endl;
+	vruiTraceStartupPhase("main loop preparation and default tools");
 	
 	/* Construct the set of file descriptors to watch for events: */
 	vruiReadFdSet.add(vruiEventPipe[0]);
@@ -2586,4 +2747,15 @@ void getMaxWindowSizes(VruiWindowGroup* windowGroup,int viewportSize[2],int fram
 		}
 	}
 
+void vruiTraceStartupPhase(const char* phaseName)
+	{
+	if(vruiTraceStartup)
+		{
+		/* Record the duration of the just-ended phase and start the next one: */
+		Realtime::TimePointMonotonic now;
+		vruiStartupPhases.push_back(std::pair<const char*,double>(phaseName,double(now-vruiStartupPhaseStart)));
+		vruiStartupPhaseStart=now;
+		}
+	}
+
 }
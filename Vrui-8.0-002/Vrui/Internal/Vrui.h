@@ -85,6 +85,7 @@ class MultipipeDispatcher;
 class Lightsource;
 class ScaleBar;
 class VisletManager;
+class FrameProfiler;
 class GUIInteractor;
 class ScreenSaverInhibitor;
 class ScreenProtectorArea;
@@ -216,6 +217,7 @@ struct VruiState
 	
 	/* Scene graph management: */
 	SceneGraphManager* sceneGraphManager;
+	bool cullSceneGraph; // Flag whether to cull the central scene graph against each window's view frustum
 	
 	/* Input graph management: */
 	Point newInputDevicePosition;
@@ -357,6 +359,7 @@ struct VruiState
 	Threads::Mutex frameCallbacksMutex; // Mutex protecting the list of extra frame callbacks
 	std::vector<FrameCallbackSlot> frameCallbacks; // List of extra frame callbacks
 	Misc::CommandDispatcher commandDispatcher; // Dispatcher for pipe and console commands
+	FrameProfiler* frameProfiler; // Run-time profiler recording the duration of each phase of recent frames
 	
 	/* Transient dragging/moving/scaling state: */
 	Misc::CallbackList navigationToolActivationCallbacks;
@@ -411,6 +414,9 @@ struct VruiState
 	static void loadViewCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
 	static void loadInputGraphCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
 	static void saveScreenshotCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
+	static void enableFrameProfilerCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
+	static void disableFrameProfilerCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
+	static void saveFrameProfileCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
 	static void quitCommandCallback(const char* argumentBegin,const char* argumentEnd,void* userData);
 	
 	/* System menu callback methods: */
@@ -483,6 +489,7 @@ extern void setDisplayCenter(const Point& newDisplayCenter,Scalar newDisplaySize
 extern void resizeWindow(VruiWindowGroup* windowGroup,const VRWindow* window,const int newViewportSize[2],const int newFrameSize[2]); // Notifies the run-time environment that a window has changed viewport and/or frame buffer size
 extern void getMaxWindowSizes(VruiWindowGroup* windowGroup,int viewportSize[2],int frameSize[2]); // Returns the maximum viewport and frame buffer sizes for the given window group
 extern void vsync(void); // Notifies the kernel that a synchronized VR window's vsync just occurred
+extern void vruiTraceStartupPhase(const char* phaseName); // Records the time spent in the startup phase of the given name, which just ended, if startup tracing is enabled
 
 }
 
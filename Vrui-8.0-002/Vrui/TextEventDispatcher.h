@@ -135,6 +135,7 @@ class TextEventDispatcher
 		}
 	void writeEventQueues(IO::File& file) const; // Writes the current event queues to the given file
 	void readEventQueues(IO::File& file); // Enqueues all events previously written to the given file
+	static void skipEventQueues(IO::File& file); // Skips all events previously written to the given file without enqueueing them
 	void dispatchEvents(GLMotif::WidgetManager& widgetManager); // Dispatches all enqueued events to the given GLMotif widget manager and re-initializes the queues
 	};
 
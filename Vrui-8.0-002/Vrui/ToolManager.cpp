@@ -667,6 +667,57 @@ void ToolManager::toolCreationDeviceMotionCallback(Misc::CallbackData* cbData)
 		}
 	}
 
+void* ToolManager::dsoPreloadThreadMethod(void)
+	{
+	/* Open all DSOs in the list; failures will be reported when the tool classes are loaded: */
+	for(std::vector<std::string>::iterator pdnIt=preloadDsoNames.begin();pdnIt!=preloadDsoNames.end();++pdnIt)
+		{
+		void* dsoHandle=dlopen(pdnIt->c_str(),RTLD_LAZY|RTLD_GLOBAL);
+		if(dsoHandle!=0)
+			preloadedDsoHandles.push_back(dsoHandle);
+		}
+	
+	return 0;
+	}
+
+void ToolManager::loadDeferredToolClasses(void)
+	{
+	/* Wait until the DSO pre-loading thread has opened all DSOs: */
+	if(!dsoPreloadThread.isJoined())
+		dsoPreloadThread.join();
+	
+	/* Destroy the current tool selection menu: */
+	delete toolMenu;
+	toolMenu=0;
+	delete toolMenuPopup;
+	toolMenuPopup=0;
+	
+	/* Load all deferred tool classes that have not been loaded on demand in the meantime: */
+	for(std::vector<std::string>::iterator dtcnIt=deferredToolClassNames.begin();dtcnIt!=deferredToolClassNames.end();++dtcnIt)
+		{
+		try
+			{
+			loadClass(dtcnIt->c_str());
+			}
+		catch(const std::runtime_error& err)
+			{
+			/* Show an error message and carry on: */
+			Misc::formattedUserError("Vrui::ToolManager: Unable to load tool class %s due to exception %s",dtcnIt->c_str(),err.what());
+			}
+		}
+	deferredToolClassNames.clear();
+	
+	/* Release the references held by the DSO pre-loading thread: */
+	for(std::vector<void*>::iterator pdhIt=preloadedDsoHandles.begin();pdhIt!=preloadedDsoHandles.end();++pdhIt)
+		dlclose(*pdhIt);
+	preloadedDsoHandles.clear();
+	
+	/* Re-create the tool selection menu to include all tool classes loaded so far: */
+	toolMenuPopup=createToolMenu();
+	toolMenu=new MutexMenu(toolMenuPopup);
+	toolCreationTool->setMenu(toolMenu);
+	}
+
 ToolManager::ToolManager(InputDeviceManager* sInputDeviceManager,const Misc::ConfigurationFileSection& sConfigFileSection)
 	:Plugins::FactoryManager<ToolFactory>(sConfigFileSection.retrieveString("./toolDsoNameTemplate",VRUI_INTERNAL_CONFIG_TOOLDIR "/" VRUI_INTERNAL_CONFIG_TOOLNAMETEMPLATE)),
 	 inputGraphManager(sInputDeviceManager->getInputGraphManager()),
@@ -699,12 +750,38 @@ ToolManager::ToolManager(InputDeviceManager* sInputDeviceManager,const Misc::Con
 	addClass(new PointingToolFactory(*this),defaultToolFactoryDestructor);
 	addClass(new UtilityToolFactory(*this),defaultToolFactoryDestructor);
 	
-	/* Load default tool classes: */
+	/* Load default tool classes, or defer loading them until the tool selection menu is first used: */
 	StringList toolClassNames=configFileSection->retrieveValue<StringList>("./toolClassNames");
-	for(StringList::const_iterator tcnIt=toolClassNames.begin();tcnIt!=toolClassNames.end();++tcnIt)
+	if(configFileSection->retrieveValue<bool>("./deferToolClassLoading",false))
 		{
-		/* Load tool class: */
-		loadClass(tcnIt->c_str());
+		deferredToolClassNames=toolClassNames;
+		
+		/* Locate the deferred tool classes' DSOs: */
+		for(StringList::const_iterator tcnIt=toolClassNames.begin();tcnIt!=toolClassNames.end();++tcnIt)
+			{
+			char dsoName[256];
+			snprintf(dsoName,sizeof(dsoName),getDsoNameTemplate().c_str(),tcnIt->c_str());
+			try
+				{
+				preloadDsoNames.push_back(getDsoLocator().locateFile(dsoName));
+				}
+			catch(const std::runtime_error&)
+				{
+				/* Ignore the error; it will be reported when the tool class is loaded */
+				}
+			}
+		
+		/* Open the DSOs in the background: */
+		if(!preloadDsoNames.empty())
+			dsoPreloadThread.start(this,&ToolManager::dsoPreloadThreadMethod);
+		}
+	else
+		{
+		for(StringList::const_iterator tcnIt=toolClassNames.begin();tcnIt!=toolClassNames.end();++tcnIt)
+			{
+			/* Load tool class: */
+			loadClass(tcnIt->c_str());
+			}
 		}
 	
 	/* Get factory for tool selection menu tools: */
@@ -754,6 +831,12 @@ ToolManager::ToolManager(InputDeviceManager* sInputDeviceManager,const Misc::Con
 
 ToolManager::~ToolManager(void)
 	{
+	/* Wait for the DSO pre-loading thread and release its DSO references: */
+	if(!dsoPreloadThread.isJoined())
+		dsoPreloadThread.join();
+	for(std::vector<void*>::iterator pdhIt=preloadedDsoHandles.begin();pdhIt!=preloadedDsoHandles.end();++pdhIt)
+		dlclose(*pdhIt);
+	
 	/* Destroy the tool kill zone: */
 	delete toolKillZone;
 	
@@ -877,6 +960,15 @@ void ToolManager::addClass(const char* className)
 		}
 	}
 
+MutexMenu* ToolManager::getToolMenu(void)
+	{
+	/* Load all deferred tool classes: */
+	if(!deferredToolClassNames.empty())
+		loadDeferredToolClasses();
+	
+	return toolMenu;
+	}
+
 void ToolManager::addAbstractClass(ToolFactory* newFactory,ToolManager::BaseClass::DestroyFactoryFunction newDestroyFactoryFunction)
 	{
 	/* Call the base class method to register the tool factory: */
@@ -977,6 +1069,10 @@ void ToolManager::enterMainLoop(void)
 
 void ToolManager::startToolCreation(const InputDeviceFeature& feature)
 	{
+	/* Load all deferred tool classes before the tool selection menu pops up: */
+	if(!deferredToolClassNames.empty())
+		loadDeferredToolClasses();
+	
 	/* Create the tool creation state: */
 	toolCreationState=new ToolManagerToolCreationState(*inputDeviceManager,feature);
 	
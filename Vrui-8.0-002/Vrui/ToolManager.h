@@ -24,9 +24,11 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #ifndef VRUI_TOOLMANAGER_INCLUDED
 #define VRUI_TOOLMANAGER_INCLUDED
 
+#include <string>
 #include <vector>
 #include <Misc/CallbackData.h>
 #include <Misc/CallbackList.h>
+#include <Threads/Thread.h>
 #include <Plugins/FactoryManager.h>
 #include <Vrui/Tool.h>
 
@@ -117,6 +119,12 @@ class ToolManager:public Plugins::FactoryManager<ToolFactory>
 	InputDeviceManager* inputDeviceManager; // Pointer to input device manager
 	const Misc::ConfigurationFileSection* configFileSection; // The tool manager's configuration file section - valid throughout the manager's entire lifetime
 	
+	/* Deferred tool class loading state: */
+	std::vector<std::string> deferredToolClassNames; // Names of default tool classes whose loading was deferred until the tool selection menu is first used
+	std::vector<std::string> preloadDsoNames; // Full path names of the DSOs of deferred tool classes
+	Threads::Thread dsoPreloadThread; // Thread opening the DSOs of deferred tool classes in the background, to take disk access and relocation off the main thread
+	std::vector<void*> preloadedDsoHandles; // Handles of DSOs opened by the DSO pre-loading thread
+	
 	/* Tool management state: */
 	ToolList tools; // List of currently instantiated tools
 	ToolManagementQueue toolManagementQueue; // Queue of management tasks that have to be performed on the next call to update
@@ -142,6 +150,8 @@ class ToolManager:public Plugins::FactoryManager<ToolFactory>
 	void inputDeviceDestructionCallback(Misc::CallbackData* cbData); // Callback called when an input device is destroyed
 	void toolMenuSelectionCallback(Misc::CallbackData* cbData); // Callback called when a tool class is selected from the selection menu; continues tool creation process
 	void toolCreationDeviceMotionCallback(Misc::CallbackData* cbData); // Callback called when the device for which a tool is being created moves during tool creation
+	void* dsoPreloadThreadMethod(void); // Thread method opening the DSOs of all deferred tool classes
+	void loadDeferredToolClasses(void); // Loads all deferred tool classes and re-creates the tool selection menu
 	
 	/* Constructors and destructors: */
 	public:
@@ -162,10 +172,7 @@ class ToolManager:public Plugins::FactoryManager<ToolFactory>
 	void addAbstractClass(ToolFactory* newFactory,DestroyFactoryFunction newDestroyFactoryFunction =0); // Same as addClass method, but does not add to tool selection menu (derived concrete tool classes will create the cascade button)
 	static void defaultToolFactoryDestructor(ToolFactory* factory); // Default destructor for tool factories; simply deletes them
 	Misc::ConfigurationFileSection getToolClassSection(const char* toolClassName) const; // Returns the configuration file section a tool class should use for its initialization
-	MutexMenu* getToolMenu(void) // Returns tool menu
-		{
-		return toolMenu;
-		}
+	MutexMenu* getToolMenu(void); // Returns tool menu; loads all deferred tool classes first
 	void loadToolBinding(const char* toolSectionName); // Loads a tool binding from a configuration file section; names are relative to tool manager's section
 	void loadDefaultTools(void); // Creates default tool associations
 	void enterMainLoop(void); // Tells the tool manager that from now on newly-created tools' frame methods need to be called
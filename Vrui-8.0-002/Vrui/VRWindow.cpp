@@ -79,7 +79,6 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Images/BaseImage.h>
 #include <Images/RGBImage.h>
 #include <Images/ReadImageFile.h>
-#include <Images/WriteImageFile.h>
 #include <GLMotif/WidgetManager.h>
 #include <Vrui/Vrui.h>
 #include <Vrui/InputDeviceManager.h>
@@ -94,6 +93,8 @@ Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 #include <Vrui/Internal/LensCorrector.h>
 #include <Vrui/Internal/ToolKillZone.h>
 #include <Vrui/Internal/MovieSaver.h>
+#include <Vrui/Internal/FrameReader.h>
+#include <Vrui/Internal/ScreenshotWriter.h>
 #include <Vrui/Internal/Vrui.h>
 #include <Vrui/Internal/Config.h>
 #if VRUI_INTERNAL_CONFIG_HAVE_XRANDR
@@ -702,8 +703,10 @@ VRWindow::VRWindow(GLContext* sContext,const OutputConfiguration& sOutputConfigu
 	 showFps(configFileSection.retrieveValue<bool>("./showFps",false)),burnMode(false),
 	 trackToolKillZone(false),
 	 dirty(true),resizeViewport(true),enabled(true),
-	 saveScreenshot(false),
-	 movieSaver(0),movieSaverRecording(configFileSection.retrieveValue<bool>("./saveMovieAutostart",false))
+	 saveScreenshot(false),screenshotWriter(0),
+	 movieSaver(0),movieSaverRecording(configFileSection.retrieveValue<bool>("./saveMovieAutostart",false)),
+	 numMovieReadbackBuffers(configFileSection.retrieveValue<unsigned int>("./movieReadbackBuffers",3U)),
+	 movieFrameReader(0)
 	{
 	/* Update the X window's event mask: */
 	{
@@ -1347,6 +1350,9 @@ VRWindow::~VRWindow(void)
 	{
 	delete movieSaver;
 	
+	/* Write all pending screen shots: */
+	delete screenshotWriter;
+	
 	#if SAVE_MOUSEMOVEMENTS
 	/* Close the mouse movement file: */
 	mouseMovementsFile=0;
@@ -1469,6 +1475,13 @@ void VRWindow::deinit(void)
 		glDeleteTextures(1,&asViewZoneTextureID);
 		glDeleteTextures(1,&asViewMapTextureID);
 		}
+	if(movieFrameReader!=0)
+		{
+		/* Deliver the last pending movie frame and release the frame reader's OpenGL resources: */
+		movieFrameReader->flush(movieSaver);
+		delete movieFrameReader;
+		movieFrameReader=0;
+		}
 	delete lensCorrector;
 	delete showFpsFont;
 	}
@@ -2487,8 +2500,10 @@ void VRWindow::draw(void)
 		/* Read the window contents into an RGB image: */
 		image.glReadPixels(0,0);
 		
-		/* Save the image buffer to the given image file: */
-		Images::writeImageFile(image,screenshotImageFileName.c_str());
+		/* Save the image buffer to the given image file in the background: */
+		if(screenshotWriter==0)
+			screenshotWriter=new ScreenshotWriter;
+		screenshotWriter->writeScreenshot(image,screenshotImageFileName);
 		
 		#if SAVE_SCREENSHOT_PROJECTION
 		
@@ -2521,22 +2536,17 @@ void VRWindow::draw(void)
 	/* Check if the window is currently saving a movie: */
 	if(movieSaverRecording)
 		{
-		/* Get a fresh frame buffer: */
-		MovieSaver::FrameBuffer& frameBuffer=movieSaver->startNewFrame();
-		
-		/* Update the frame buffer's size and prepare it for writing: */
-		frameBuffer.setFrameSize(getWindowWidth(),getWindowHeight());
-		frameBuffer.prepareWrite();
+		/* Create a frame reader on the first movie frame: */
+		if(movieFrameReader==0)
+			movieFrameReader=new FrameReader(numMovieReadbackBuffers);
 		
-		/* Read the window contents into the movie saver's frame buffer: */
-		glPixelStorei(GL_PACK_ALIGNMENT,1);
-		glPixelStorei(GL_PACK_SKIP_PIXELS,0);
-		glPixelStorei(GL_PACK_ROW_LENGTH,0);
-		glPixelStorei(GL_PACK_SKIP_ROWS,0);
-		glReadPixels(0,0,getWindowWidth(),getWindowHeight(),GL_RGB,GL_UNSIGNED_BYTE,frameBuffer.getBuffer());
-		
-		/* Post the new frame: */
-		movieSaver->postNewFrame();
+		/* Start reading the window contents, and post the most recent previously read frame that has arrived to the movie saver: */
+		movieFrameReader->readFrame(getWindowWidth(),getWindowHeight(),movieSaver);
+		}
+	else if(movieFrameReader!=0)
+		{
+		/* Post the last frame read before recording was paused: */
+		movieFrameReader->flush(movieSaver);
 		}
 	
 	/* Window is now up-to-date: */
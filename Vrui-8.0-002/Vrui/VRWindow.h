@@ -54,6 +54,8 @@ class DisplayState;
 class InputDeviceAdapterMouse;
 class InputDeviceAdapterMultitouch;
 class MovieSaver;
+class FrameReader;
+class ScreenshotWriter;
 class VruiState;
 }
 namespace Vrui {
@@ -161,8 +163,11 @@ class VRWindow:public GLWindow
 	bool enabled; // Flag if rendering to the window is enabled
 	bool saveScreenshot; // Flag if the window is to save its contents after the next draw() call
 	std::string screenshotImageFileName; // Name of the image file into which to save the next screen shot
+	ScreenshotWriter* screenshotWriter; // Pointer to a helper object writing screen shots in the background; created on first screen shot
 	MovieSaver* movieSaver; // Pointer to a movie saver object if the window is supposed to write contents to a movie
 	bool movieSaverRecording; // Flag whether the movie saver is currently recording
+	unsigned int numMovieReadbackBuffers; // Number of pixel buffer objects used to read movie frames asynchronously
+	FrameReader* movieFrameReader; // Pointer to a helper object reading window contents into movie frames; created on first movie frame
 	Time lastFrame; // Time at which the last frame was exposed in front-buffer rendering mode
 	
 	/* Private methods: */
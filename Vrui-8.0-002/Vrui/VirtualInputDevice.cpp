@@ -227,7 +227,7 @@ int VirtualInputDevice::pickButton(const InputDevice* device,const Ray& ray) con
 	return result;
 	}
 
-void VirtualInputDevice::renderDevice(const InputDevice* device,bool navigational,const GlyphRenderer::DataItem* glyphRendererContextDataItem,GLContextData&) const
+void VirtualInputDevice::renderDevice(const InputDevice* device,bool navigational,GlyphRenderer::DataItem* glyphRendererContextDataItem,GLContextData&) const
 	{
 	/* Get the device's current transformation: */
 	OGTransform transform(device->getTransformation());
@@ -239,17 +239,17 @@ void VirtualInputDevice::renderDevice(const InputDevice* device,bool navigationa
 	Vector step=buttonPanelDirection*(buttonSpacing/buttonSize);
 	for(int i=0;i<numButtons;++i)
 		{
-		glyphRenderer->renderGlyph(device->getButtonState(i)?onButtonGlyph:offButtonGlyph,buttonTransform,glyphRendererContextDataItem);
+		glyphRenderer->addGlyph(device->getButtonState(i)?onButtonGlyph:offButtonGlyph,buttonTransform,glyphRendererContextDataItem);
 		buttonTransform*=OGTransform::translate(step);
 		}
 	
 	/* Render a glyph for the device's navigational coordinate mode button: */
 	buttonTransform=OGTransform::translate(transform.getTranslation()-buttonOffset);
 	buttonTransform*=OGTransform::scale(buttonSize);
-	glyphRenderer->renderGlyph(navigational?onButtonGlyph:offButtonGlyph,buttonTransform,glyphRendererContextDataItem);
+	glyphRenderer->addGlyph(navigational?onButtonGlyph:offButtonGlyph,buttonTransform,glyphRendererContextDataItem);
 	
 	/* Render a glyph for the device itself: */
-	glyphRenderer->renderGlyph(deviceGlyph,transform,glyphRendererContextDataItem);
+	glyphRenderer->addGlyph(deviceGlyph,transform,glyphRendererContextDataItem);
 	}
 
 }
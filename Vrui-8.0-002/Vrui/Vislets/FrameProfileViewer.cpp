@@ -0,0 +1,342 @@
+/***********************************************************************
+FrameProfileViewer - Vislet class to view a live stacked graph of the
+time spent in each phase of recent Vrui frames, as recorded by Vrui's
+run-time frame profiler.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#include <Vrui/Vislets/FrameProfileViewer.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdexcept>
+#include <Misc/StandardValueCoders.h>
+#include <Misc/ConfigurationFile.h>
+#include <Misc/FileNameExtensions.h>
+#include <Misc/MessageLogger.h>
+#include <Math/Math.h>
+#include <GL/gl.h>
+#include <GL/GLColor.h>
+#include <GL/GLColorTemplates.h>
+#include <Vrui/Vrui.h>
+#include <Vrui/VisletManager.h>
+#include <Vrui/DisplayState.h>
+#include <Vrui/FrameProfiler.h>
+
+namespace Vrui {
+
+namespace Vislets {
+
+namespace {
+
+/**************************************************
+Colors to draw the individual phases of each frame:
+**************************************************/
+
+const GLColor<GLfloat,3> phaseColors[FrameProfiler::NumPhases]=
+	{
+	GLColor<GLfloat,3>(0.5f,0.5f,0.5f), // Event handling
+	GLColor<GLfloat,3>(1.0f,0.5f,0.0f), // Input devices
+	GLColor<GLfloat,3>(1.0f,1.0f,0.0f), // Input graph
+	GLColor<GLfloat,3>(0.0f,1.0f,0.0f), // Tool manager
+	GLColor<GLfloat,3>(0.0f,1.0f,1.0f), // Application frame function
+	GLColor<GLfloat,3>(0.25f,0.5f,1.0f), // Rendering
+	GLColor<GLfloat,3>(1.0f,0.0f,1.0f), // Waiting for rendering to finish
+	GLColor<GLfloat,3>(1.0f,0.0f,0.0f) // Buffer swap
+	};
+
+}
+
+/******************************************
+Methods of class FrameProfileViewerFactory:
+******************************************/
+
+FrameProfileViewerFactory::FrameProfileViewerFactory(VisletManager& visletManager)
+	:VisletFactory("FrameProfileViewer",visletManager),
+	 historySize(512),frameRateBudget(90.0)
+	{
+	/* Load class settings: */
+	Misc::ConfigurationFileSection cfs=visletManager.getVisletClassSection(getClassName());
+	
+	historySize=cfs.retrieveValue<unsigned int>("./historySize",(unsigned int)(historySize));
+	frameRateBudget=cfs.retrieveValue<double>("./frameRateBudget",frameRateBudget);
+	
+	/* Set vislet class' factory pointer: */
+	FrameProfileViewer::factory=this;
+	}
+
+FrameProfileViewerFactory::~FrameProfileViewerFactory(void)
+	{
+	/* Reset vislet class' factory pointer: */
+	FrameProfileViewer::factory=0;
+	}
+
+Vislet* FrameProfileViewerFactory::createVislet(int numArguments,const char* const arguments[]) const
+	{
+	return new FrameProfileViewer(numArguments,arguments);
+	}
+
+void FrameProfileViewerFactory::destroyVislet(Vislet* vislet) const
+	{
+	delete vislet;
+	}
+
+extern "C" void resolveFrameProfileViewerDependencies(Plugins::FactoryManager<VisletFactory>& manager)
+	{
+	}
+
+extern "C" VisletFactory* createFrameProfileViewerFactory(Plugins::FactoryManager<VisletFactory>& manager)
+	{
+	/* Get pointer to vislet manager: */
+	VisletManager* visletManager=static_cast<VisletManager*>(&manager);
+	
+	/* Create factory object and insert it into class hierarchy: */
+	FrameProfileViewerFactory* factory=new FrameProfileViewerFactory(*visletManager);
+	
+	/* Return factory object: */
+	return factory;
+	}
+
+extern "C" void destroyFrameProfileViewerFactory(VisletFactory* factory)
+	{
+	delete factory;
+	}
+
+/*******************************************
+Static elements of class FrameProfileViewer:
+*******************************************/
+
+FrameProfileViewerFactory* FrameProfileViewer::factory=0;
+
+/***********************************
+Methods of class FrameProfileViewer:
+***********************************/
+
+FrameProfileViewer::FrameProfileViewer(int numArguments,const char* const arguments[])
+	:profiler(getFrameProfiler()),profilerWasActive(false),
+	 historySize(factory->historySize),frameRateBudget(factory->frameRateBudget),
+	 max(0.0),numOverBudget(0),
+	 numberRenderer(12.0f,false)
+	{
+	/* Parse the command line: */
+	for(int i=0;i<numArguments;++i)
+		{
+		if(arguments[i][0]=='-')
+			{
+			if(strcasecmp(arguments[i]+1,"hs")==0||strcasecmp(arguments[i]+1,"historySize")==0)
+				{
+				++i;
+				if(i<numArguments)
+					historySize=atoi(arguments[i]);
+				else
+					Misc::formattedConsoleError("FrameProfileViewer: Ignoring dangling %s option",arguments[i-1]);
+				}
+			else if(strcasecmp(arguments[i]+1,"budget")==0)
+				{
+				++i;
+				if(i<numArguments)
+					frameRateBudget=atof(arguments[i]);
+				else
+					Misc::formattedConsoleError("FrameProfileViewer: Ignoring dangling %s option",arguments[i-1]);
+				}
+			else if(strcasecmp(arguments[i]+1,"save")==0)
+				{
+				++i;
+				if(i<numArguments)
+					profileFileName=arguments[i];
+				else
+					Misc::formattedConsoleError("FrameProfileViewer: Ignoring dangling %s option",arguments[i-1]);
+				}
+			else
+				Misc::formattedConsoleError("FrameProfileViewer: Ignoring unknown %s option",arguments[i]);
+			}
+		else
+			Misc::formattedConsoleError("FrameProfileViewer: Ignoring unknown %s parameter",arguments[i]);
+		}
+	
+	/* Limit the history size to the size of the profiler's ring buffer: */
+	if(historySize>profiler->getBufferSize())
+		historySize=profiler->getBufferSize();
+	if(historySize<1)
+		historySize=1;
+	}
+
+FrameProfileViewer::~FrameProfileViewer(void)
+	{
+	}
+
+VisletFactory* FrameProfileViewer::getFactory(void) const
+	{
+	return factory;
+	}
+
+void FrameProfileViewer::enable(bool startup)
+	{
+	/* Start the frame profiler: */
+	profilerWasActive=profiler->isActive();
+	profiler->setActive(true);
+	
+	/* Call the base class method: */
+	Vislet::enable(startup);
+	}
+
+void FrameProfileViewer::disable(bool shutdown)
+	{
+	if(!profileFileName.empty())
+		{
+		try
+			{
+			/* Save the frame profile in the format indicated by the file name: */
+			if(Misc::hasCaseExtension(profileFileName.c_str(),".csv"))
+				profiler->saveCSV(profileFileName.c_str());
+			else
+				profiler->saveBinary(profileFileName.c_str());
+			}
+		catch(const std::runtime_error& err)
+			{
+			Misc::formattedUserError("FrameProfileViewer: Unable to save frame profile to file %s due to exception %s",profileFileName.c_str(),err.what());
+			}
+		}
+	
+	/* Stop the frame profiler unless it was already running: */
+	if(!profilerWasActive)
+		profiler->setActive(false);
+	
+	/* Call the base class method: */
+	Vislet::disable(shutdown);
+	}
+
+void FrameProfileViewer::frame(void)
+	{
+	/* Calculate the maximum frame time and the number of over-budget frames in the displayed history: */
+	double budget=frameRateBudget>0.0?1.0/frameRateBudget:0.0;
+	max=budget;
+	numOverBudget=0;
+	unsigned int numFrames=profiler->getNumFrames();
+	FrameProfiler::Frame frame;
+	for(unsigned int frameIndex=numFrames>historySize?numFrames-historySize:0;frameIndex<numFrames;++frameIndex)
+		if(profiler->getFrame(frameIndex,frame))
+			{
+			if(max<frame.frameTime)
+				max=frame.frameTime;
+			if(budget>0.0&&frame.frameTime>budget)
+				++numOverBudget;
+			}
+	}
+
+void FrameProfileViewer::display(GLContextData& contextData) const
+	{
+	/* Get the viewport size of the current window: */
+	const DisplayState& ds=getDisplayState(contextData);
+	
+	/* Set up OpenGL state: */
+	glPushAttrib(GL_ENABLE_BIT|GL_LINE_BIT);
+	glDisable(GL_LIGHTING);
+	glLineWidth(1.0f);
+	
+	/* Go to pixel coordinates: */
+	glPushMatrix();
+	glLoadIdentity();
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0.0,ds.viewport[2],0.0,ds.viewport[3],0.0,1.0);
+	
+	/* Get graph colors: */
+	Color bg=getBackgroundColor();
+	Color fg=getForegroundColor();
+	
+	/* Round the top of the graph up to the next full millisecond: */
+	double top=Math::ceil(max*1000.0)/1000.0;
+	if(top<=0.0)
+		top=0.001;
+	
+	/* Calculate graph offsets and scaling factors: */
+	double xs=double(ds.viewport[2])*0.8/double(historySize);
+	double x0=double(ds.viewport[2])*0.15;
+	double ys=double(ds.viewport[3])*0.25/top;
+	double y0=double(ds.viewport[3])*0.05;
+	
+	/* Draw the stacked phase times of all frames in the history: */
+	unsigned int numFrames=profiler->getNumFrames();
+	unsigned int firstFrame=numFrames>historySize?numFrames-historySize:0;
+	FrameProfiler::Frame frame;
+	glBegin(GL_QUADS);
+	for(unsigned int frameIndex=firstFrame;frameIndex<numFrames;++frameIndex)
+		if(profiler->getFrame(frameIndex,frame))
+			{
+			double x=x0+double(frameIndex-firstFrame)*xs;
+			double y=y0;
+			for(int phase=0;phase<FrameProfiler::NumPhases;++phase)
+				{
+				double y1=y+frame.phaseTimes[phase]*ys;
+				glColor(phaseColors[phase]);
+				glVertex2d(x,y);
+				glVertex2d(x+xs,y);
+				glVertex2d(x+xs,y1);
+				glVertex2d(x,y1);
+				y=y1;
+				}
+			}
+	glEnd();
+	
+	/* Draw the total frame time of all frames in the history: */
+	glBegin(GL_LINE_STRIP);
+	glColor(fg);
+	for(unsigned int frameIndex=firstFrame;frameIndex<numFrames;++frameIndex)
+		if(profiler->getFrame(frameIndex,frame))
+			glVertex2d(x0+(double(frameIndex-firstFrame)+0.5)*xs,y0+frame.frameTime*ys);
+	glEnd();
+	
+	/* Draw the bottom line and the frame time budget line: */
+	glBegin(GL_LINES);
+	glColor3f(Math::mid(bg[0],fg[0]),Math::mid(bg[1],fg[1]),Math::mid(bg[2],fg[2]));
+	glVertex2d(x0-5.0,y0);
+	glVertex2d(x0+double(historySize)*xs+5.0,y0);
+	if(frameRateBudget>0.0)
+		{
+		glColor3f(1.0f,0.0f,0.0f);
+		glVertex2d(x0-5.0,y0+ys/frameRateBudget);
+		glVertex2d(x0+double(historySize)*xs+5.0,y0+ys/frameRateBudget);
+		}
+	glEnd();
+	
+	/* Draw the frame time labels in milliseconds, and the number of over-budget frames: */
+	glColor(fg);
+	numberRenderer.drawNumber(GLNumberRenderer::Vector(x0-10.0,y0,0.0),0,contextData,1,0);
+	numberRenderer.drawNumber(GLNumberRenderer::Vector(x0-10.0,y0+top*ys,0.0),top*1000.0,1,contextData,1,0);
+	if(frameRateBudget>0.0)
+		{
+		numberRenderer.drawNumber(GLNumberRenderer::Vector(x0-10.0,y0+ys/frameRateBudget,0.0),1000.0/frameRateBudget,1,contextData,1,0);
+		numberRenderer.drawNumber(GLNumberRenderer::Vector(x0+double(historySize)*xs+10.0,y0+ys/frameRateBudget,0.0),int(numOverBudget),contextData,-1,0);
+		}
+	
+	/* Restore OpenGL state: */
+	glPopAttrib();
+	
+	/* Return to physical coordinates: */
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+	}
+
+}
+
+}
@@ -0,0 +1,96 @@
+/***********************************************************************
+FrameProfileViewer - Vislet class to view a live stacked graph of the
+time spent in each phase of recent Vrui frames, as recorded by Vrui's
+run-time frame profiler.
+Copyright (c) 2026 Oliver Kreylos
+
+This file is part of the Virtual Reality User Interface Library (Vrui).
+
+The Virtual Reality User Interface Library is free software; you can
+redistribute it and/or modify it under the terms of the GNU General
+Public License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+The Virtual Reality User Interface Library is distributed in the hope
+that it will be useful, but WITHOUT ANY WARRANTY; without even the
+implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the Virtual Reality User Interface Library; if not, write to the
+Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+02111-1307 USA
+***********************************************************************/
+
+#ifndef VRUI_VISLETS_FRAMEPROFILEVIEWER_INCLUDED
+#define VRUI_VISLETS_FRAMEPROFILEVIEWER_INCLUDED
+
+#include <stddef.h>
+#include <string>
+#include <GL/GLNumberRenderer.h>
+#include <Vrui/Vislet.h>
+
+/* Forward declarations: */
+namespace Vrui {
+class FrameProfiler;
+}
+
+namespace Vrui {
+
+namespace Vislets {
+
+class FrameProfileViewer;
+
+class FrameProfileViewerFactory:public Vrui::VisletFactory
+	{
+	friend class FrameProfileViewer;
+	
+	/* Elements: */
+	size_t historySize; // Default number of recent frames to display
+	double frameRateBudget; // Default target frame rate against which frame times are compared
+	
+	/* Constructors and destructors: */
+	public:
+	FrameProfileViewerFactory(Vrui::VisletManager& visletManager);
+	virtual ~FrameProfileViewerFactory(void);
+	
+	/* Methods from VisletFactory: */
+	virtual Vislet* createVislet(int numVisletArguments,const char* const visletArguments[]) const;
+	virtual void destroyVislet(Vislet* vislet) const;
+	};
+
+class FrameProfileViewer:public Vrui::Vislet
+	{
+	friend class FrameProfileViewerFactory;
+	
+	/* Elements: */
+	private:
+	static FrameProfileViewerFactory* factory; // Pointer to the factory object for this class
+	FrameProfiler* profiler; // Pointer to Vrui's frame profiler
+	bool profilerWasActive; // Flag whether the frame profiler was already active when the vislet was enabled
+	size_t historySize; // Number of recent frames to display
+	double frameRateBudget; // Target frame rate against which frame times are compared
+	std::string profileFileName; // Name of file to which to save the frame profile when the vislet is disabled, or empty
+	double max; // Maximum frame time in the currently displayed history
+	unsigned int numOverBudget; // Number of frames in the currently displayed history that exceeded the frame time budget
+	GLNumberRenderer numberRenderer; // Helper object to draw numbers
+	
+	/* Constructors and destructors: */
+	public:
+	FrameProfileViewer(int numArguments,const char* const arguments[]);
+	virtual ~FrameProfileViewer(void);
+	
+	/* Methods from Vislet: */
+	public:
+	virtual VisletFactory* getFactory(void) const;
+	virtual void enable(bool startup);
+	virtual void disable(bool shutdown);
+	virtual void frame(void);
+	virtual void display(GLContextData& contextData) const;
+	};
+
+}
+
+}
+
+#endif
@@ -78,6 +78,7 @@ class Tool;
 class ToolManager;
 class UIManager;
 class VisletManager;
+class FrameProfiler;
 class DisplayState;
 }
 
@@ -340,6 +341,7 @@ double getApplicationTime(void); // Returns the time since the application was s
 double getFrameTime(void); // Returns the duration of the last frame in seconds
 double getCurrentFrameTime(void); // Returns the current average time between frames (1/framerate) in seconds
 double getNextAnimationTime(void); // Returns the application time at which the next frame in a general animation should be scheduled
+FrameProfiler* getFrameProfiler(void); // Returns pointer to the run-time profiler recording the duration of each phase of recent frames
 
 /* Callback management: */
 void addFrameCallback(FrameCallback newFrameCallback,void* newFrameCallbackUserData); // Adds a callback that is called once on every frame; callback is removed again if it returns true; can be called from background threads